@@ -11,6 +11,9 @@
 #include "DefaultArchivist.h"
 
 #include<limits>
+#include <unordered_set>
+
+#include <Utilities/PackedSites.h>
 
 ////// ARCHIVIST-outputMethod is actually set by Modules.h //////
 std::shared_ptr<ParameterLink<std::string>>
@@ -21,6 +24,22 @@ std::shared_ptr<ParameterLink<std::string>>
                                             // outputMethod;
 ////// ARCHIVIST-outputMethod is actually set by Modules.h //////
 
+std::shared_ptr<ParameterLink<std::string>>
+    DefaultArchivist::Arch_outputFormatPL = Parameters::register_parameter(
+        "ARCHIVIST-outputFormat", std::string("csv"),
+        "format of pop, max, snapshot data and LOD data files: csv, or columnar "
+        "(a typed binary format, much smaller and faster to read, see "
+        "Utilities/ColumnarFile.h; mabe -c converts these files to csv)");
+
+std::shared_ptr<ParameterLink<std::string>>
+    DefaultArchivist::Arch_organismFileFormatPL = Parameters::register_parameter(
+        "ARCHIVIST-organismFileFormat", std::string("text"),
+        "how genomes are written to snapshot and LOD organism files: text (in "
+        "the csv), packed (packed into bytes in a .sites file next to the csv, "
+        "which the csv refers to), or packedDelta (packed, and stored as the "
+        "changes from the previous genome in the file where that is smaller). "
+        "Genomes which can not be packed are written as text");
+
 std::shared_ptr<ParameterLink<std::string>>
     DefaultArchivist::Arch_realtimeSequencePL = Parameters::register_parameter(
         "ARCHIVIST_DEFAULT-realtimeSequence", std::string(":10"),
@@ -81,18 +100,39 @@ DefaultArchivist::DefaultArchivist(std::shared_ptr<ParametersTable> PT_,
   writePopFile = Arch_writePopFilePL->get(PT);
   writeMaxFile = Arch_writeMaxFilePL->get(PT);
 
+  auto outputFormat = Arch_outputFormatPL->get(PT);
+  if (outputFormat == "csv") {
+    dataFileExtension = ".csv";
+  } else if (outputFormat == "columnar") {
+    dataFileExtension = Columnar::fileExtension;
+  } else {
+    std::cout << "  ERROR :: ARCHIVIST-outputFormat is \"" << outputFormat
+              << "\", but must be csv or columnar.\n  Exiting." << std::endl;
+    exit(1);
+  }
+
+  auto organismFileFormat = Arch_organismFileFormatPL->get(PT);
+  if (organismFileFormat != "text" && organismFileFormat != "packed" &&
+      organismFileFormat != "packedDelta") {
+    std::cout << "  ERROR :: ARCHIVIST-organismFileFormat is \"" << organismFileFormat
+              << "\", but must be text, packed or packedDelta.\n  Exiting." << std::endl;
+    exit(1);
+  }
+  packOrganisms = organismFileFormat != "text";
+  deltaOrganisms = organismFileFormat == "packedDelta";
+
   PopFileName =
       (group_prefix_.empty())
-          ? "pop.csv"
-          : group_prefix_.substr(0, group_prefix_.size() - 2) + "__pop.csv";
+          ? "pop" + dataFileExtension
+          : group_prefix_.substr(0, group_prefix_.size() - 2) + "__pop" + dataFileExtension;
   PopFileName = (Arch_FilePrefixPL->get(PT) == "NONE")
                     ? PopFileName
                     : Arch_FilePrefixPL->get(PT) + PopFileName;
 
   MaxFileName =
       (group_prefix_.empty())
-          ? "max.csv"
-          : group_prefix_.substr(0, group_prefix_.size() - 2) + "__max.csv";
+          ? "max" + dataFileExtension
+          : group_prefix_.substr(0, group_prefix_.size() - 2) + "__max" + dataFileExtension;
   MaxFileName = (Arch_FilePrefixPL->get(PT) == "NONE")
                     ? MaxFileName
                     : Arch_FilePrefixPL->get(PT) + MaxFileName;
@@ -151,6 +191,8 @@ DefaultArchivist::DefaultArchivist(std::vector<std::string> & popFileColumns,
 
   convertCSVListToVector(PopFileColumnNames, default_pop_file_columns_);
   max_formula_ = std::move(max_formula);
+  if (max_formula_ != nullptr)
+    max_program_ = MTreeProgram(max_formula_);
 
   if (default_pop_file_columns_.empty()) // hack because somehow getting passed empty string
     default_pop_file_columns_ = popFileColumns;
@@ -183,13 +225,21 @@ void DefaultArchivist::writeRealTimeFiles(
     std::vector<std::shared_ptr<Organism>> &population) {
   // write out population data
 
+  if (!writePopFile && !(writeMaxFile && max_formula_ != nullptr))
+    return;
+
+  // the organisms which are written out are the rows of the table
+  std::vector<std::shared_ptr<Organism>> archived;
+  for (auto const &org : population)
+    if (org->timeOfBirth < Global::update || save_new_orgs_)
+      archived.push_back(org);
+  populationTable->refresh(archived);
+
   if (writePopFile) {
     DataMap PopMap;
     for (auto &kv : unique_column_name_to_output_behaviors_) {
-      if (kv.first != "update")
-        for (auto const &org : population)
-          if (org->timeOfBirth < Global::update || save_new_orgs_)
-            PopMap.append(kv.first, org->dataMap.getAverage(kv.first));
+      if (kv.first != "update" && !archived.empty())
+        PopMap.set(kv.first, populationTable->averages(kv.first));
 
       PopMap.setOutputBehavior(kv.first, kv.second);
     }
@@ -203,14 +253,15 @@ void DefaultArchivist::writeRealTimeFiles(
 
     std::shared_ptr<Organism> best_org;
     auto score = std::numeric_limits<double>::lowest();
-    for (auto const &org : population)
-      if (org->timeOfBirth < Global::update || save_new_orgs_) {
-        auto sc = max_formula_->eval(org->dataMap, org->PT)[0];
-        if (sc > score) {
-          score = sc;
-          best_org = org;
+    if (!archived.empty()) {
+      // same group PT the optimizer evaluates the formula with
+      auto scores = max_program_.evalAll(*populationTable, PT);
+      for (size_t i = 0; i < archived.size(); i++)
+        if (scores[i] > score) {
+          score = scores[i];
+          best_org = archived[i];
         }
-      }
+    }
 
     if (score == std::numeric_limits<double>::lowest()) {
       std::cout
@@ -229,7 +280,7 @@ void DefaultArchivist::saveSnapshotData(
 
   	// write out data
   std::string dataFileName =
-      DataFilePrefix + "_" + std::to_string(Global::update) + ".csv";
+      DataFilePrefix + "_" + std::to_string(Global::update) + dataFileExtension;
 
   if (files_.find("snapshotData") ==
       files_.end()) { // first make sure that the dataFile has been set up.
@@ -261,6 +312,9 @@ void DefaultArchivist::saveSnapshotData(
                                     return org->timeOfBirth >= Global::update;
                                   }),
                    std::end(saveList));
+  std::vector<bool> saving(Phylogeny::get().capacity(), false);
+  for (auto const &org : saveList)
+    saving[org->phylogenyRecord] = true;
 
   // now for each org, update ancestors and save if in saveList
   for (auto const &org : population) {
@@ -270,7 +324,7 @@ void DefaultArchivist::saveSnapshotData(
 
       org->snapshotAncestors.clear();
 
-	  resolveAncestors(org,saveList,minBirthTime);
+	  resolveAncestors(org,saving,minBirthTime);
 
 
     } else {                      // org has exactly self for ancestor
@@ -326,7 +380,7 @@ void DefaultArchivist::saveOrgToFile(const std::shared_ptr<Organism> &org,
 
 void DefaultArchivist::resolveAncestors(
     const std::shared_ptr<Organism> &org,
-    std::vector<std::shared_ptr<Organism>> &save_list, int min_birth_time) {
+    const std::vector<bool> &saving, int min_birth_time) {
       // if this org does not only contain only itself in snapshotAncestors then
       // it has not been saved before.
       // we must confirm that snapshotAncestors is correct because things may
@@ -347,30 +401,31 @@ void DefaultArchivist::resolveAncestors(
       // if they are at least as old as the oldest org being saved to this file
       // then we can simply append their ancestors
 
-  auto parent_check_list = org->parents;
+  auto &phylogeny = Phylogeny::get();
+  auto parent_check_list = phylogeny.parents(org->phylogenyRecord);
 
   while (!parent_check_list.empty()) {
     auto parent = parent_check_list.back(); // this is "this parent"
     parent_check_list.pop_back();           // remove this parent from checklist
 
-    if (find(save_list.begin(), save_list.end(), parent) !=
-        save_list.end()) { // if this parent is being saved, they will serve
+    if (saving[parent]) { // if this parent is being saved, they will serve
                           // as an ancestor
-      org->snapshotAncestors.insert(parent->ID);
+      org->snapshotAncestors.insert(phylogeny.ID(parent));
       continue;
     }
 
 	// this parent is not being saved
-    if (parent->timeOfBirth < min_birth_time ||
-        (parent->snapshotAncestors.size() == 1 &&
-         parent->snapshotAncestors.find(parent->ID) !=
-             parent->snapshotAncestors.end())) {
+    auto const &parent_ancestors = phylogeny.snapshotAncestors(parent);
+    if (phylogeny.timeOfBirth(parent) < min_birth_time ||
+        (parent_ancestors.size() == 1 &&
+         parent_ancestors.find(phylogeny.ID(parent)) !=
+             parent_ancestors.end())) {
       // if this parent is old enough that it can not have a parent in the
       // save list (and is not in save list),
       // or this parent has self in it's ancestor list (i.e. it has
       // already been saved to another file),
       // copy ancestors from this parent
-      for (auto ancestor_id : parent->snapshotAncestors) {
+      for (auto ancestor_id : parent_ancestors) {
         org->snapshotAncestors.insert(ancestor_id);
       }
       continue;
@@ -378,7 +433,7 @@ void DefaultArchivist::resolveAncestors(
 
 	// this parent not old enough (see if above), add this
     // parents parents to check list (we need to keep looking)
-    for (auto const &p : parent->parents) {
+    for (auto p : phylogeny.parents(parent)) {
       parent_check_list.push_back(p);
     }
   }
@@ -392,24 +447,46 @@ void DefaultArchivist::saveSnapshotOrganisms(
 
   for (auto const &org : population) {
     if (org->timeOfBirth < Global::update || save_new_orgs_) {
-      DataMap OrgMap;
-      OrgMap.set("ID", org->ID);
-      std::string tempName;
-
-      for (auto genome : org->genomes) {
-        tempName = "GENOME_" + genome.first;
-        OrgMap.merge(genome.second->serialize(tempName));
-      }
-      for (auto brain : org->brains) {
-        tempName = "BRAIN_" + brain.first;
-        OrgMap.merge(brain.second->serialize(tempName));
-      }
-      OrgMap.writeToFile(organismFileName); // append new data to the file
+      DataMap OrgMap = organismData(*org);
+      writeOrganism(OrgMap, organismFileName); // append new data to the file
     }
   }
-  FileManager::closeFile(organismFileName); // since this is a snapshot, we will
-                                            // not be writting to this file
-                                            // again.
+  closeOrganismFile(organismFileName); // since this is a snapshot, we will
+                                       // not be writting to this file
+                                       // again.
+}
+
+DataMap DefaultArchivist::organismData(Organism &org) {
+  DataMap OrgMap;
+  OrgMap.set("ID", org.ID);
+  std::string tempName;
+
+  for (auto const &genome : org.genomes) {
+    tempName = "GENOME_" + genome.first;
+    OrgMap.merge(packOrganisms ? genome.second->serializePacked(tempName)
+                               : genome.second->serialize(tempName));
+  }
+  for (auto const &brain : org.brains) {
+    tempName = "BRAIN_" + brain.first;
+    OrgMap.merge(brain.second->serialize(tempName));
+  }
+  return OrgMap;
+}
+
+void DefaultArchivist::writeOrganism(DataMap &OrgMap, const std::string &fileName) {
+  if (packOrganisms) {
+    PackedSites::writeOrganism(OrgMap, fileName, deltaOrganisms);
+  } else {
+    OrgMap.writeToFile(fileName);
+  }
+}
+
+void DefaultArchivist::closeOrganismFile(const std::string &fileName) {
+  if (packOrganisms) {
+    PackedSites::closeFile(fileName);
+  } else {
+    FileManager::closeFile(fileName);
+  }
 }
 
 void DefaultArchivist::writeDefArchFiles(
@@ -458,7 +535,7 @@ bool DefaultArchivist::archive(
     // we don't need to worry about tracking parents or
     // lineage, so we clear out this data every generation.
     for (auto const &org : population)
-      org->parents.clear();
+      org->clearParents();
   } else {
 	cleanUpParents(population);
   }
@@ -471,17 +548,18 @@ bool DefaultArchivist::archive(
 void DefaultArchivist::cleanUpParents(
     std::vector<std::shared_ptr<Organism>> &population) {
 
-  auto need_to_clean = population;
-  need_to_clean.clear(); // we haven't cleaned anything yet
+  auto &phylogeny = Phylogeny::get();
+  std::vector<int> need_to_clean; // we haven't cleaned anything yet
 
   for (auto const &org : population)
     if (org->snapshotAncestors.find(org->ID) != org->snapshotAncestors.end())
       // if ancestors contains self, then this org has been saved
       // and it's ancestor list has been collapsed
-      org->parents.clear();
-    else                            // org has not ever been saved to file...
-      need_to_clean.push_back(org); // we will need to check to see if we can do
-                                    // clean up related to this org
+      org->clearParents();
+    else // org has not ever been saved to file...
+      need_to_clean.push_back(org->phylogenyRecord); // we will need to check to
+                                                     // see if we can do clean up
+                                                     // related to this org
 
   auto const minBirthTime = // no generic lambdas in c++11 :(
       (*std::min_element(
@@ -491,25 +569,32 @@ void DefaultArchivist::cleanUpParents(
            }))
           ->timeOfBirth;
 
-  auto logged = population;
+  std::unordered_set<int> logged;
+  for (auto const &org : population)
+    logged.insert(org->phylogenyRecord);
+  // records are only released after the search, so none are freed (and
+  // their index reused) while they are still on need_to_clean
+  std::vector<int> release;
 
   while (!need_to_clean.empty()) {
-    auto org = need_to_clean.back();
+    auto record = need_to_clean.back();
     need_to_clean.pop_back();
-    if (org->timeOfBirth < minBirthTime)
+    if (phylogeny.timeOfBirth(record) < minBirthTime)
       // no living org can be this orgs ancestor
-      org->parents.clear(); // so we can safely release parents
+      release.push_back(record); // so we can safely release parents
     else
-      for (auto const &parent : org->parents) // we need to check parents (if any)
-        if (std::find(std::begin(logged), std::end(logged), parent) ==
-            logged.end()) { // if parent is not already in
-                            // logged list (i.e. either
-                            // logged or going to be)
+      for (auto parent : phylogeny.parents(record)) // we need to check parents (if any)
+        if (logged.insert(parent).second) { // if parent is not already in
+                                            // logged list (i.e. either
+                                            // logged or going to be)
           need_to_clean.push_back(parent);
-          logged.push_back(parent); // make a note, so we don't clean twice
         }
   }
-}
-
-
+  for (auto record : release)
+    phylogeny.clearParents(record);
 
+  // ancestors are followed through the phylogeny records, so the organisms do
+  // not need to hold on to their parents
+  for (auto const &org : population)
+    org->parents.clear();
+}
@@ -20,6 +20,8 @@
 #include <Global.h>
 #include <Organism/Organism.h>
 #include <Utilities/MTree.h>
+#include <Utilities/MTreeProgram.h>
+#include <Utilities/PopulationTable.h>
 
 class DefaultArchivist {
 //protected:
@@ -36,9 +38,12 @@ public:
                                   // values that can generate an average)
 
   std::string DataFilePrefix;     // name of the Data file
+  std::string dataFileExtension;  // .csv, or .mcol for columnar data files
   std::string OrganismFilePrefix; // name of the Genome file (genomes on LOD)
   bool writeSnapshotDataFiles;    // if true, write data file
   bool writeSnapshotGenomeFiles;  // if true, write genome file
+  bool packOrganisms;  // if true, organism files keep packed genomes out of line
+  bool deltaOrganisms; // if true, packed genomes are delta encoded
 
   std::vector<int> realtimeSequence; // how often to write out data
   std::vector<int> realtimeDataSequence;
@@ -52,6 +57,7 @@ public:
   std::shared_ptr<Abstract_MTree>
       max_formula_; // what value will be used to determine
                     // which organism to write to max file
+  MTreeProgram max_program_; // max_formula_, compiled
 
   bool save_new_orgs_ = false;
 
@@ -63,6 +69,10 @@ public:
 
   std::map<std::string, int> unique_column_name_to_output_behaviors_;
 
+  // columns of population data (shared with the optimizer by Group)
+  std::shared_ptr<PopulationTable> populationTable =
+      std::make_shared<PopulationTable>();
+
   bool finished_ =
       false; // if finished, then as far as the archivist is concerned, we
              // can stop the run.
@@ -86,14 +96,26 @@ public:
   void saveOrgToFile(const std::shared_ptr<Organism> &/*org*/,
                      const std::string & /*data_file_name*/);
 
+  // a row of an organism file: org's ID, genomes (packed if packOrganisms)
+  // and brains
+  DataMap organismData(Organism & /*org*/);
+  // append a row to an organism file (packed genomes go to its sites file)
+  void writeOrganism(DataMap & /*OrgMap*/, const std::string & /*fileName*/);
+  void closeOrganismFile(const std::string & /*fileName*/);
+
   void cleanUpParents(std::vector<std::shared_ptr<Organism>> & /*population*/);
 
+  // saving[r] is true if the organism with phylogeny record r is being saved
   void resolveAncestors(const std::shared_ptr<Organism> &/*org*/,
-                        std::vector<std::shared_ptr<Organism>> & /*save_file*/,
+                        const std::vector<bool> & /*saving*/,
                         int /*min_birth_time*/);
 
   static std::shared_ptr<ParameterLink<std::string>>
       Arch_outputMethodStrPL; // string parameter for outputMethod;
+  static std::shared_ptr<ParameterLink<std::string>>
+      Arch_outputFormatPL; // csv or columnar data files
+  static std::shared_ptr<ParameterLink<std::string>>
+      Arch_organismFileFormatPL; // text, packed or packedDelta genomes
 
   static std::shared_ptr<ParameterLink<bool>>
       Arch_writeMaxFilePL; // if true, Max file will be created
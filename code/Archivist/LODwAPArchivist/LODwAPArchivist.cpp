@@ -60,9 +60,9 @@ LODwAPArchivist::LODwAPArchivist(std::vector<std::string> popFileColumns,
                       ? ""
                       : LODwAP_Arch_FilePrefixPL->get(PT)) +
                  (group_prefix_.empty()
-                       ? "LOD_data.csv"
+                       ? "LOD_data" + dataFileExtension
                        : group_prefix_.substr(0, group_prefix_.size() - 2) +
-                             "__" + "LOD_data.csv");
+                             "__" + "LOD_data" + dataFileExtension);
   organism_file_name_ = (LODwAP_Arch_FilePrefixPL->get(PT) == "NONE"
                           ? ""
                           : LODwAP_Arch_FilePrefixPL->get(PT)) +
@@ -82,6 +82,12 @@ LODwAPArchivist::LODwAPArchivist(std::vector<std::string> popFileColumns,
 
   next_data_write_ = dataSequence[data_seq_index];
   next_organism_write_ = organismSequence[organism_seq_index];
+
+  // so that ancestors keep what will be written about them
+  if (writeDataFile)
+    Phylogeny::get().keepDataAt(dataSequence);
+  if (writeOrganismFile)
+    Phylogeny::get().keepOrganismsAt(organismSequence, packOrganisms);
 }
 
 void LODwAPArchivist::constructLODFiles(const std::shared_ptr<Organism> &org) {
@@ -94,84 +100,81 @@ void LODwAPArchivist::constructLODFiles(const std::shared_ptr<Organism> &org) {
   }
 }
 
-void LODwAPArchivist::writeLODDataFile(
-    std::vector<std::shared_ptr<Organism>> &LOD,
-    const std::shared_ptr<Organism> &real_MRCA,
-    const std::shared_ptr<Organism> &effective_MRCA) {
+void LODwAPArchivist::writeLODDataFile(const std::vector<int> &LOD,
+                                       int real_MRCA, int effective_MRCA) {
+  auto &phylogeny = Phylogeny::get();
+  size_t next = 0; // LOD[next] is the oldest born at or after the write time
 
   while (next_data_write_ <=
          std::min(
-             effective_MRCA->timeOfBirth,
+             phylogeny.timeOfBirth(effective_MRCA),
              Global::updatesPL->get())) { // if there is convergence before the
                                           // next data interval
 
     // old version does not allow for overlapping generations
     //auto current = LOD[(next_data_write_ - last_prune_) - 1];
 
-    // new version
-    std::shared_ptr<Organism> current;
-    int currentIndex = 0;
-    while (LOD[currentIndex]->timeOfBirth < next_data_write_) {
-        currentIndex++;
+    // new version (write times only increase, so the search carries on
+    // from where the last one stopped)
+    while (phylogeny.timeOfBirth(LOD[next]) < next_data_write_) {
+        next++;
     }
-    currentIndex--;
-    current = LOD[currentIndex];
+    int current = LOD[next - 1];
     // end new version
 
-    current->dataMap.set("update", next_data_write_);
-    current->dataMap.setOutputBehavior("update", DataMap::FIRST);
-    time_to_coalescence =
-        std::max(0, current->timeOfBirth - real_MRCA->timeOfBirth);
-    current->dataMap.set("timeToCoalescence", time_to_coalescence);
-    current->dataMap.setOutputBehavior("timeToCoalescence", DataMap::FIRST);
-    current->dataMap.writeToFile(
-        data_file_name_,
-        files_[data_file_name_]); // append new data to the file
-    current->dataMap.clear("update");
-    current->dataMap.clear("timeToCoalescence");
+    auto &dataMap = phylogeny.dataMap(current);
+    dataMap.set("update", next_data_write_);
+    dataMap.setOutputBehavior("update", DataMap::FIRST);
+    time_to_coalescence = std::max(0, phylogeny.timeOfBirth(current) -
+                                          phylogeny.timeOfBirth(real_MRCA));
+    dataMap.set("timeToCoalescence", time_to_coalescence);
+    dataMap.setOutputBehavior("timeToCoalescence", DataMap::FIRST);
+    dataMap.writeToFile(data_file_name_,
+                        files_[data_file_name_]); // append new data to the file
+    dataMap.clear("update");
+    dataMap.clear("timeToCoalescence");
 
 	next_data_write_ = dataSequence[++data_seq_index];
   }
 }
 
 
-void LODwAPArchivist::writeLODOrganismFile(
-    std::vector<std::shared_ptr<Organism>> &LOD,
-    const std::shared_ptr<Organism> &effective_MRCA) {
+void LODwAPArchivist::writeLODOrganismFile(const std::vector<int> &LOD,
+                                           int effective_MRCA) {
+  auto &phylogeny = Phylogeny::get();
+  size_t next = 0; // LOD[next] is the oldest born at or after the write time
 
   while (next_organism_write_ <=
          std::min(
-             effective_MRCA->timeOfBirth,
+             phylogeny.timeOfBirth(effective_MRCA),
              Global::updatesPL->get())) { // if there is convergence before the
                                           // next data interval
 
     // old version does not allow for overlapping generations
     //auto current = LOD[(next_organism_write_ - last_prune_) - 1];
 
-    // new version
-    std::shared_ptr<Organism> current;
-    int currentIndex = 0;
-    while (LOD[currentIndex]->timeOfBirth < next_organism_write_) {
-        currentIndex++;
+    // new version (write times only increase, so the search carries on
+    // from where the last one stopped)
+    while (phylogeny.timeOfBirth(LOD[next]) < next_organism_write_) {
+        next++;
     }
-    currentIndex--;
-    current = LOD[currentIndex];
+    int current = LOD[next - 1];
     // end new version
 
     DataMap OrgMap;
-    OrgMap.set("ID", current->ID);
+    auto org = phylogeny.organism(current);
+    if (org != nullptr) {
+      OrgMap = organismData(*org);
+    } else {
+      OrgMap.set("ID", phylogeny.ID(current));
+      if (phylogeny.packedOrganism(current) != nullptr) {
+        // serialized when the organism was deleted
+        OrgMap.merge(*phylogeny.packedOrganism(current));
+      }
+    }
     OrgMap.set("update", next_organism_write_);
     OrgMap.setOutputBehavior("update", DataMap::FIRST);
-
-    for (auto & genome : current->genomes) {
-      auto name = "GENOME_" + genome.first;
-      OrgMap.merge(genome.second->serialize(name));
-    }
-    for (auto & brain : current->brains) {
-      auto name = "BRAIN_" + brain.first;
-      OrgMap.merge(brain.second->serialize(name));
-    }
-    OrgMap.writeToFile(organism_file_name_); // append new data to the file
+    writeOrganism(OrgMap, organism_file_name_); // append new data to the file
 
     next_organism_write_ = organismSequence[++organism_seq_index];
   }
@@ -202,6 +205,12 @@ bool LODwAPArchivist::archive(std::vector<std::shared_ptr<Organism>> &population
                                 // turn on genome tracking.
       org->trackOrganism = true;
 
+  // lines of descent are followed through the phylogeny records, so the
+  // organisms do not need to hold on to their parents (which lets dead
+  // ancestors be deleted, leaving only their records)
+  for (auto const &org : population)
+    org->parents.clear();
+
   if (Global::update % pruneInterval && flush != 1) 
   return finished_;
 
@@ -209,30 +218,30 @@ bool LODwAPArchivist::archive(std::vector<std::shared_ptr<Organism>> &population
       files_.end()) // if file has not be initialized yet
     constructLODFiles(population[0]);
 
-  // get the MRCA
-  auto some_org = population[0];
-  auto LOD = some_org->getLOD(some_org); // get line of descent
+  // get the MRCA, and the line of descent up to it (the part of the line of
+  // descent which can be written out)
+  auto &phylogeny = Phylogeny::get();
+  auto some_org = population[0]->phylogenyRecord;
+  std::vector<int> LOD;
+  auto real_MRCA = phylogeny.mostRecentCommonAncestor(
+      some_org, LOD); // find the convergence point in the LOD.
+  auto effective_MRCA = real_MRCA;
 
-  if (flush) // if flush then we don't care about coalescence
+  if (flush) { // if flush then we don't care about coalescence
     std::cout << "flushing LODwAP: organism with ID " << population[0]->ID <<
       " has been selected to generate Line of Descent."
       << std::endl;
-
-  auto effective_MRCA =
-      flush // this assumes that a population was created, but not tested at
-          // the end of the evolution loop!
-          ? some_org->parents[0]
-          : some_org->getMostRecentCommonAncestor(
-                LOD); // find the convergence point in the LOD.
-  auto real_MRCA =
-      flush ? some_org->getMostRecentCommonAncestor(LOD)
-            : effective_MRCA; // find the convergence point in the LOD.
+    // this assumes that a population was created, but not tested at the end
+    // of the evolution loop!
+    LOD = phylogeny.lineOfDescent(some_org); // get line of descent
+    effective_MRCA = LOD[LOD.size() > 1 ? LOD.size() - 2 : 0];
+  }
 
   // Save Data
   if (writeDataFile) {
 	  writeLODDataFile(LOD, real_MRCA, effective_MRCA);
 	  if (flush) {
-		  if (real_MRCA->timeOfBirth == -2) {
+		  if (phylogeny.timeOfBirth(real_MRCA) == -2) {
 			  std::cout << "This run has not coalesced. There is no Most Recent Common Ancestor.\n" <<
 				  "None of the organisms in LOD_data.csv are guaranteed to be on LOD." << std::endl;
 		  }
@@ -259,9 +268,10 @@ bool LODwAPArchivist::archive(std::vector<std::shared_ptr<Organism>> &population
 
   // data and genomes have now been written out up till the MRCA
   // so all data and genomes from before the MRCA can be deleted
-  effective_MRCA->parents.clear();
-  last_prune_ = effective_MRCA->timeOfBirth; // this will hold the time of the
-                                             // oldest genome in RAM
+  phylogeny.clearParents(effective_MRCA);
+  last_prune_ = phylogeny.timeOfBirth(effective_MRCA); // this will hold the time
+                                                       // of the oldest genome
+                                                       // in RAM
 
   return finished_;
 
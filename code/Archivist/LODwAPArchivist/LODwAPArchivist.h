@@ -41,13 +41,13 @@ public:
 
   void constructLODFiles(const std::shared_ptr<Organism> &/*org*/);
 
-  void writeLODDataFile(std::vector<std::shared_ptr<Organism>> & /*LOD*/,
-                        const std::shared_ptr<Organism> &/*real_MRCA*/,
-                        const std::shared_ptr<Organism> &/*effective_MRCA*/);
+  // LOD, real_MRCA and effective_MRCA are records in Phylogeny::get(). LOD
+  // only needs to reach effective_MRCA
+  void writeLODDataFile(const std::vector<int> & /*LOD*/, int /*real_MRCA*/,
+                        int /*effective_MRCA*/);
 
-  void
-  writeLODOrganismFile(std::vector<std::shared_ptr<Organism>> & /*LOD*/,
-                       const std::shared_ptr<Organism> & /*effective_MRCA*/);
+  void writeLODOrganismFile(const std::vector<int> & /*LOD*/,
+                            int /*effective_MRCA*/);
 
   LODwAPArchivist() = delete;
   LODwAPArchivist(std::vector<std::string> popFileColumns = {},
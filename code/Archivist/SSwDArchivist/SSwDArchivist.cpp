@@ -419,19 +419,8 @@ bool SSwDArchivist::archive(std::vector<std::shared_ptr<Organism>> &population,
         if (auto org = checkpoints[nextOrganismWrite][index]
                            .lock()) { // this ptr is still good
 
-          DataMap OrgMap;
-          OrgMap.set("ID", org->ID);
-          std::string tempName;
-
-          for (auto genome : org->genomes) {
-            tempName = "GENOME_" + genome.first;
-            OrgMap.merge(genome.second->serialize(tempName));
-          }
-          for (auto brain : org->brains) {
-            tempName = "BRAIN_" + brain.first;
-            OrgMap.merge(brain.second->serialize(tempName));
-          }
-          OrgMap.writeToFile(organismFileName); // append new data to the file
+          DataMap OrgMap = organismData(*org);
+          writeOrganism(OrgMap, organismFileName); // append new data to the file
           index++;
         } else { // this ptr is expired - cut it out of the vector
           swap(checkpoints[nextOrganismWrite][index],
@@ -442,9 +431,9 @@ bool SSwDArchivist::archive(std::vector<std::shared_ptr<Organism>> &population,
         }
       }
 
-      FileManager::closeFile(organismFileName); // since this is a snapshot, we
-                                                // will not be writting to this
-                                                // file again.
+      closeOrganismFile(organismFileName); // since this is a snapshot, we
+                                           // will not be writting to this
+                                           // file again.
 
       if ((int)organismSequence.size() > writeOrganismSeqIndex + 1) {
         writeOrganismSeqIndex++;
@@ -462,7 +451,7 @@ bool SSwDArchivist::archive(std::vector<std::shared_ptr<Organism>> &population,
         writeDataFiles) { // now it's time to write data in the checkpoint at
                           // time nextDataWrite
       std::string dataFileName =
-          DataFilePrefix + "_" + std::to_string(nextDataWrite) + ".csv";
+          DataFilePrefix + "_" + std::to_string(nextDataWrite) + dataFileExtension;
 
       // if file info has not been initialized yet, find a valid org and extract
       // it's keys
@@ -551,7 +540,7 @@ bool SSwDArchivist::archive(std::vector<std::shared_ptr<Organism>> &population,
        population) { // we don't need to worry about tracking parents or
                      // lineage, so we clear out this data every generation.
     if (!writeSnapshotDataFiles && !writeDataFiles && !writeOrganismFiles) {
-      org->parents.clear();
+      org->clearParents();
       // cout << "HERE?" << endl;
     } else if (org->snapshotAncestors.find(org->ID) !=
                    org->snapshotAncestors.end() &&
@@ -563,7 +552,7 @@ bool SSwDArchivist::archive(std::vector<std::shared_ptr<Organism>> &population,
                                          // contains self, then this org has
                                          // been saved and it's ancestor list
                                          // has been collapsed
-      org->parents.clear();
+      org->clearParents();
       checked.insert(org); // make a note, so we don't check this org later
       minBirthTime = std::min(org->timeOfBirth, minBirthTime);
     } else { // org has not ever been saved to either snapshot_Data or SSwD_Data
@@ -588,7 +577,7 @@ bool SSwDArchivist::archive(std::vector<std::shared_ptr<Organism>> &population,
       // org->timeOfBirth << " org->timeOfDeath: " << org->timeOfDeath <<
       // "max(dataDelay, organismDelay): " << max(dataDelay, organismDelay) <<
       // endl;
-      org->parents.clear(); // we can safely release parents
+      org->clearParents(); // we can safely release parents
     } else {
       for (auto p : org->parents) { // we need to check parents (if any)
         if (checked.find(p) == checked.end()) { // if parent is not already in
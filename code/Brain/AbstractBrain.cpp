@@ -125,6 +125,12 @@ void AbstractBrain::resetInputs() {
     }
 }
 
+void AbstractBrain::updateBatch(std::vector<std::shared_ptr<AbstractBrain>>& brains) {
+    for (auto& brain : brains) {
+        brain->update();
+    }
+}
+
 void AbstractBrain::resetBrain() {
     resetInputs();
     resetOutputs();
@@ -41,6 +41,11 @@ public:
 
     virtual void update() = 0;
 
+    // update every brain in brains once, the same as calling update() on
+    // each of them. Brain types that can run many brains together override
+    // this (see MarkovBrain). Call on any brain, i.e. brains[0]->updateBatch(brains)
+    virtual void updateBatch(std::vector<std::shared_ptr<AbstractBrain>>& brains);
+
     // make a copy of the brain that called this
     virtual std::shared_ptr<AbstractBrain> makeCopy(std::shared_ptr<ParametersTable> PT_);
 
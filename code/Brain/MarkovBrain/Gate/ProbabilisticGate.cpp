@@ -10,6 +10,10 @@
 
 #include "ProbabilisticGate.h"
 
+#include <Utilities/AliasTable.h>
+
+#include <algorithm>
+
 shared_ptr<ParameterLink<string>> ProbabilisticGate::IO_RangesPL = Parameters::register_parameter("BRAIN_MARKOV_GATES_PROBABILISTIC-IO_Ranges", (string)"1-4,1-4", "range of number of inputs and outputs (min inputs-max inputs,min outputs-max outputs)");
 
 ProbabilisticGate::ProbabilisticGate(pair<vector<int>, vector<int>> addresses, vector<vector<int>> rawTable, int _ID, shared_ptr<ParametersTable> _PT) :
@@ -40,17 +44,30 @@ ProbabilisticGate::ProbabilisticGate(pair<vector<int>, vector<int>> addresses, v
 				table[i][j] = (double) rawTable[i][j] / S;
 		}
 	}
+	buildAliasTables();
+}
 
+// each row is split into 2^outputs equal cells, each holding at most two
+// columns, so picking an output takes one random number and no search
+void ProbabilisticGate::buildAliasTables() {
+	int columns = 1 << outputs.size();
+	aliasProbability.assign(table.size() * columns, 1.0);
+	aliasColumn.assign(table.size() * columns, 0);
+	vector<int> small, large;
+	for (size_t row = 0; row < table.size(); row++) {
+		// rows are normalized, so every row has weight to build from
+		AliasTable::build(table[row].data(), columns, &aliasProbability[row * columns], &aliasColumn[row * columns], small, large);
+	}
 }
 
 void ProbabilisticGate::update(vector<double> & nodes, vector<double> & nextNodes) {  //this translates the input bits of the current states to the output bits of the next states
 	int input = vectorToBitToInt(nodes,inputs,true); // converts the input values into an index (true indicates to reverse order)
-	int outputColumn = 0;
-	double r = Random::getDouble(1);  // r will determine with set of outputs will be chosen
-	while (r > table[input][outputColumn]) {
-		r -= table[input][outputColumn];  // this goes across the probability table in row for the given input and subtracts each
-		// value in the table from r until r is less than a value it reaches
-		outputColumn++;  // we have not found the correct output so move to the next output
+	int columns = 1 << outputs.size();
+	double r = Random::getDouble(columns);  // whole part picks a cell in the alias table, fraction picks the column in that cell
+	int outputColumn = std::min(static_cast<int>(r), columns - 1);
+	int cell = input * columns + outputColumn;
+	if (r - outputColumn >= aliasProbability[cell]) {
+		outputColumn = aliasColumn[cell];
 	}
 	for (size_t i = 0; i < outputs.size(); i++)  //for each output...
 		nextNodes[outputs[i]] += 1.0 * ((outputColumn >> (outputs.size() - 1 - i)) & 1);  // convert output (the column number) to bits and pack into next states
@@ -67,5 +84,7 @@ shared_ptr<AbstractGate> ProbabilisticGate::makeCopy(shared_ptr<ParametersTable>
 	newGate->ID = ID;
 	newGate->inputs = inputs;
 	newGate->outputs = outputs;
+	newGate->aliasProbability = aliasProbability;
+	newGate->aliasColumn = aliasColumn;
 	return newGate;
 }
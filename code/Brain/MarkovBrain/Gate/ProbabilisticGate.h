@@ -20,6 +20,14 @@ public:
 	static shared_ptr<ParameterLink<string>> IO_RangesPL;
 
 	vector<vector<double>> table;
+
+	// Walker/Vose alias tables made from table (one AliasTable::build per row,
+	// see buildAliasTables). Cell row * 2^outputs + column keeps column with
+	// aliasProbability, else aliasColumn is used.
+	vector<double> aliasProbability;
+	vector<int> aliasColumn;
+	void buildAliasTables();
+
 	ProbabilisticGate() = delete;
 	ProbabilisticGate(shared_ptr<ParametersTable> _PT = nullptr) :
 		AbstractGate(_PT) {
@@ -10,6 +10,9 @@
 
 #include "GateListBuilder.h"
 
+#include <algorithm>
+#include <climits>
+
 vector<shared_ptr<AbstractGate>> ClassicGateListBuilder::buildGateListAndGetAllValues(shared_ptr<AbstractGenome> genome, int nrOfBrainStates, int maxValue, vector<int> &genomeHeadValues, int genomeHeadValuesCount, vector<vector<int>> &genomePerGateValues, int genomePerGateValuesCount, shared_ptr<ParametersTable> gatePT) {
 
 	vector<shared_ptr<AbstractGate>> gates;
@@ -36,6 +39,46 @@ vector<shared_ptr<AbstractGate>> ClassicGateListBuilder::buildGateListAndGetAllV
 
 		int gateCount = 0;
 
+		// read a gate after the start codon which gateGenomeHandler has just read
+		auto readGate = [&](int startCodon) {
+			shared_ptr<AbstractGate> newGate = gateBuilder.makeGate[startCodon](gateGenomeHandler, gateCount, gatePT);
+
+			if (newGate != nullptr) {
+				// now read perGate values from genome
+				vector<int> thisGatesValues;
+				int i = 0;
+				while (i < genomePerGateValuesCount && !gateGenomeHandler->atEOC()) {
+					thisGatesValues.push_back(gateGenomeHandler->readInt(0, maxValue));
+					i++;
+				}
+				if (!gateGenomeHandler->atEOC()) {  // we may run out of space while reading the perGate sites...
+					gates.push_back(newGate);
+					genomePerGateValues.push_back(thisGatesValues);
+				}
+			}
+			gateCount++;
+		};
+
+		// if the genome can find start codons itself, jump straight to each one
+		vector<int> starts;
+		if (!mustReadAll && genome->findCodonPairs(secondStartCodons(), codonMax, 0, genome->countSites() - 3, starts)) {
+			// the scan below never clears EOC on gateGenomeHandler, so once a gate
+			// has read past the end of the genome, no more gates are kept
+			bool gateHandlerAtEOC = gateGenomeHandler->atEOC();
+			for (int site : starts) {
+				if (gateHandlerAtEOC) {
+					gateCount++;
+					continue;
+				}
+				gateGenomeHandler->setSiteIndex(site);
+				int startCodon = gateGenomeHandler->readInt(0, codonMax, AbstractGate::START_CODE, gateCount);  // mark start codon in genomes coding region
+				gateGenomeHandler->readInt(0, codonMax, AbstractGate::START_CODE, gateCount);
+				readGate(startCodon);
+				gateHandlerAtEOC = gateGenomeHandler->atEOC();
+			}
+			return gates;
+		}
+
 		int testSite1Value, testSite2Value;
 		testSite1Value = genomeHandler->readInt(0, codonMax);
 		testSite2Value = genomeHandler->readInt(0, codonMax);
@@ -55,22 +98,7 @@ vector<shared_ptr<AbstractGate>> ClassicGateListBuilder::buildGateListAndGetAllV
 					gateGenomeHandler->toggleReadDirection();  // reverse the read direction again
 					gateGenomeHandler->readInt(0, codonMax, AbstractGate::START_CODE, gateCount);  // mark start codon in genomes coding region
 					gateGenomeHandler->readInt(0, codonMax, AbstractGate::START_CODE, gateCount);
-					shared_ptr<AbstractGate> newGate = gateBuilder.makeGate[testSite1Value](gateGenomeHandler, gateCount, gatePT);
-
-					if (newGate != nullptr) {
-						// now read perGate values from genome
-						vector<int> thisGatesValues;
-						int i = 0;
-						while (i < genomePerGateValuesCount && !gateGenomeHandler->atEOC()) {
-							thisGatesValues.push_back(gateGenomeHandler->readInt(0, maxValue));
-							i++;
-						}
-						if (!gateGenomeHandler->atEOC()) {  // we may run out of space while reading the perGate sites...
-							gates.push_back(newGate);
-							genomePerGateValues.push_back(thisGatesValues);
-						}
-					}
-					gateCount++;
+					readGate(testSite1Value);
 			}
 			if (mustReadAll) {  // if start codon values are bigger then the alphabetSize of the genome, we must step forward one genome site at a time (slow)
 				placeHolderGenomeHandler->advanceIndex();
@@ -89,3 +117,206 @@ vector<shared_ptr<AbstractGate>> ClassicGateListBuilder::buildGateListAndGetAllV
 	return gates;
 }
 
+
+
+bool ClassicGateListBuilder::canTranslateBySite(shared_ptr<AbstractGenome> genome, shared_ptr<ParametersTable> gatePT) {
+	int codonMax = (1 << Gate_Builder::bitsPerCodonPL->get(PT)) - 1;
+	vector<int> noStarts;
+	if (codonMax > genome->getAlphabetSize() || genome->countSites() < 3 || !genome->findCodonPairs(secondStartCodons(), codonMax, 0, -1, noStarts)) {
+		return false;
+	}
+	// epsilon and void gates with a negative epsilon source read a site near the start of the genome
+	if ((gateBuilder.inUseGateNames.count("Epsilon") && EpsilonGate::EpsilonSourcePL->get(gatePT) < 0) ||
+	    (gateBuilder.inUseGateNames.count("Void") && VoidGate::voidGate_ProbabilityPL->get(gatePT) < 0)) {
+		return false;
+	}
+	return true;
+}
+
+int ClassicGateListBuilder::readCodon(shared_ptr<AbstractGenome::Handler> handler, int site) {
+	handler->setSiteIndex(site);
+	return handler->readInt(0, (1 << Gate_Builder::bitsPerCodonPL->get(PT)) - 1);
+}
+
+vector<int> ClassicGateListBuilder::secondStartCodons() {
+	vector<int> secondCodons(1 << Gate_Builder::bitsPerCodonPL->get(PT), -1);
+	for (int codon = 0; codon < (int)secondCodons.size() && codon < (int)gateBuilder.gateStartCodes.size(); codon++) {
+		if (gateBuilder.gateStartCodes[codon].size() != 0) {
+			secondCodons[codon] = gateBuilder.gateStartCodes[codon][1];
+		}
+	}
+	return secondCodons;
+}
+
+shared_ptr<AbstractGate> ClassicGateListBuilder::readGate(shared_ptr<AbstractGenome::Handler> handler, int site, int gateID, int &end, bool &reachedEnd, shared_ptr<ParametersTable> gatePT) {
+	int codon = readCodon(handler, site);
+	handler->setSiteIndex(site + 2);
+	shared_ptr<AbstractGate> newGate = gateBuilder.makeGate[codon](handler, gateID, gatePT);
+	reachedEnd = handler->atEOC();
+	if (newGate == nullptr || reachedEnd) {
+		return nullptr;
+	}
+	end = handler->getSiteIndex();
+	return newGate;
+}
+
+// buildGateList checks the pair of sites starting at every site but the last two
+// and reads a gate after each start codon it finds. Here we do the same by site.
+// Note that in buildGateList, once a gate has run past the end of the genome the
+// gate handler stays at EOC, so no gates are made from any later start codons.
+shared_ptr<GateTranslation> ClassicGateListBuilder::translateGates(shared_ptr<AbstractGenome> genome, int nrOfBrainStates, shared_ptr<ParametersTable> gatePT) {
+	auto handler = genome->newHandler(genome, true);
+	if (!canTranslateBySite(genome, gatePT)) {
+		return AbstractGateListBuilder::translateGates(genome, nrOfBrainStates, gatePT);
+	}
+	auto translation = make_shared<GateTranslation>();
+	translation->hasLayout = true;
+	translation->genomeSize = genome->countSites();
+
+	int codonMax = (1 << Gate_Builder::bitsPerCodonPL->get(PT)) - 1;
+	genome->findCodonPairs(secondStartCodons(), codonMax, 0, translation->genomeSize - 3, translation->startSites);
+	bool reachedEnd = false;
+	for (int start = 0; start < (int)translation->startSites.size(); start++) {
+		int end;
+		shared_ptr<AbstractGate> newGate;
+		if (!reachedEnd) {
+			newGate = readGate(handler, translation->startSites[start], start, end, reachedEnd, gatePT);
+		}
+		translation->startGates.push_back(newGate == nullptr ? -1 : (int)translation->gates.size());
+		if (newGate != nullptr) {
+			translation->gates.push_back(newGate);
+			translation->gateEnds.push_back(end);
+		}
+	}
+	return translation;
+}
+
+// follow the start codons (and the sites read by their gates) in parent through the
+// edits. Start codons which were not changed are still start codons, and gates whose
+// sites were not changed are still the same gates (if they still end before the end
+// of the genome). New start codons can only be in or next to changed sites.
+shared_ptr<GateTranslation> ClassicGateListBuilder::retranslateGates(shared_ptr<AbstractGenome> genome, int nrOfBrainStates,
+                                                                    const vector<AbstractGenome::SiteEdit> &edits,
+                                                                    const GateTranslation &parent, shared_ptr<ParametersTable> gatePT) {
+	auto handler = genome->newHandler(genome, true);
+	if (!parent.hasLayout || !canTranslateBySite(genome, gatePT)) {
+		return translateGates(genome, nrOfBrainStates, gatePT);
+	}
+	int genomeSize = genome->countSites();
+
+	int parentStarts = (int)parent.startSites.size();
+	vector<int> starts = parent.startSites;  // where each parent start codon is now
+	vector<int> ends(parentStarts, -1);      // where its gate ends now, or -1 if the gate must be read again
+	vector<bool> startKept(parentStarts, true);
+	for (int start = 0; start < parentStarts; start++) {
+		if (parent.startGates[start] >= 0) {
+			ends[start] = parent.gateEnds[parent.startGates[start]];
+		}
+	}
+	// [first, last) site ranges which may have changed. The pair of sites at the end of
+	// parent was never checked, so it starts out as changed.
+	vector<pair<int, int>> changed = { { parent.genomeSize - 1, parent.genomeSize } };
+	int changedSites = 0;
+
+	for (auto &edit : edits) {
+		int position = edit.position;
+		int removed = edit.removed;
+		int inserted = edit.inserted;
+		auto touches = [&](int first, int last) {
+			return (removed > 0 && position < last && position + removed > first) || (inserted > 0 && position > first && position < last);
+		};
+		auto moveFirst = [&](int site) {
+			return site < position ? site : (site < position + removed ? position : site - removed + inserted);
+		};
+		auto moveLast = [&](int site) {
+			return site <= position ? site : (site <= position + removed ? position + inserted : site - removed + inserted);
+		};
+		for (int start = 0; start < parentStarts; start++) {
+			if (!startKept[start]) {
+				continue;
+			}
+			if (touches(starts[start], starts[start] + 2)) {
+				startKept[start] = false;
+				continue;
+			}
+			if (ends[start] >= 0) {
+				ends[start] = touches(starts[start], ends[start]) ? -1 : moveLast(ends[start]);
+			}
+			starts[start] = moveFirst(starts[start]);
+		}
+		for (auto &range : changed) {
+			range = { moveFirst(range.first), moveLast(range.second) };
+		}
+		changed.push_back({ position, position + inserted });
+		changedSites += inserted + 1;
+		if (changedSites > genomeSize / 4) {  // it will be faster to read everything
+			return translateGates(genome, nrOfBrainStates, gatePT);
+		}
+	}
+
+	// (site, parent start or -1) for every start codon in genome
+	vector<pair<int, int>> allStarts;
+	for (int start = 0; start < parentStarts; start++) {
+		if (startKept[start] && starts[start] < genomeSize - 2) {
+			allStarts.push_back({ starts[start], start });
+		}
+	}
+	// a pair of sites may be a new start codon if either site changed
+	vector<pair<int, int>> checkRanges;  // [first, last] pair starts
+	for (auto &range : changed) {
+		int first = max(0, range.first - 1);
+		int last = min(range.second - 1, genomeSize - 3);
+		if (first <= last) {
+			checkRanges.push_back({ first, last });
+		}
+	}
+	sort(checkRanges.begin(), checkRanges.end());
+	vector<int> newStarts;
+	vector<int> secondCodons = secondStartCodons();
+	int codonMax = (1 << Gate_Builder::bitsPerCodonPL->get(PT)) - 1;
+	int checkedTo = -1;
+	for (auto &range : checkRanges) {
+		if (range.second > checkedTo) {
+			genome->findCodonPairs(secondCodons, codonMax, max(range.first, checkedTo + 1), range.second, newStarts);
+			checkedTo = range.second;
+		}
+	}
+	size_t keptCount = allStarts.size();
+	for (int site : newStarts) {
+		if (!binary_search(allStarts.begin(), allStarts.begin() + keptCount, make_pair(site, INT_MIN),
+		                   [](const pair<int, int> &a, const pair<int, int> &b) { return a.first < b.first; })) {
+			allStarts.push_back({ site, -1 });
+		}
+	}
+	sort(allStarts.begin(), allStarts.end());
+
+	auto translation = make_shared<GateTranslation>();
+	translation->hasLayout = true;
+	translation->genomeSize = genomeSize;
+	bool reachedEnd = false;
+	for (int start = 0; start < (int)allStarts.size(); start++) {
+		int site = allStarts[start].first;
+		int parentStart = allStarts[start].second;
+		shared_ptr<AbstractGate> newGate;
+		int end = -1;
+		if (reachedEnd) {
+			// no more gates (see translateGates)
+		} else if (parentStart >= 0 && ends[parentStart] >= 0 && ends[parentStart] < genomeSize) {
+			newGate = parent.gates[parent.startGates[parentStart]];
+			end = ends[parentStart];
+			if (newGate->ID != start) {
+				newGate = newGate->makeCopy();
+				newGate->ID = start;
+			}
+		} else {
+			newGate = readGate(handler, site, start, end, reachedEnd, gatePT);
+		}
+		translation->startSites.push_back(site);
+		translation->startGates.push_back(newGate == nullptr ? -1 : (int)translation->gates.size());
+		if (newGate != nullptr) {
+			translation->gates.push_back(newGate);
+			translation->gateEnds.push_back(end);
+		}
+	}
+	return translation;
+}
@@ -22,6 +22,20 @@
 #include <Utilities/Parameters.h>
 
 using namespace std;
+
+// gates read from a genome (before inOutReMap). If hasLayout is set, this
+// also holds where in the genome each gate was read from, so that the gates
+// of a mutated copy of the genome can be found by only reading the sites which
+// changed (see retranslateGates).
+struct GateTranslation {
+	vector<shared_ptr<AbstractGate>> gates;
+	bool hasLayout = false;
+	int genomeSize = 0;
+	vector<int> startSites;  // first site of every start codon, in order (gate ID is the index)
+	vector<int> startGates;  // [start] index in gates of gate read from this start codon, or -1
+	vector<int> gateEnds;    // [gate] one past the last site read by this gate
+};
+
 class AbstractGateListBuilder {
 
  public:
@@ -64,6 +78,22 @@ class AbstractGateListBuilder {
             int maxValue, vector<int> &genomeHeadValues, int genomeHeadValuesCount,
             vector<vector<int>> &genomePerGateValues, int genomePerGateValuesCount, shared_ptr<ParametersTable> gatePT) = 0;
 
+	// same gates as buildGateList. By default there is no layout.
+	virtual shared_ptr<GateTranslation> translateGates(shared_ptr<AbstractGenome> genome, int nrOfBrainStates, shared_ptr<ParametersTable> gatePT) {
+		auto translation = make_shared<GateTranslation>();
+		translation->gates = buildGateList(genome, nrOfBrainStates, gatePT);
+		return translation;
+	}
+
+	// same gates as translateGates(genome...), given parent (the translation of
+	// the genome that genome was copied from) and the edits made to genome since
+	// the copy (see AbstractGenome::getEditsFrom). Gates in parent may be used in
+	// the result, so they must not be changed.
+	virtual shared_ptr<GateTranslation> retranslateGates(shared_ptr<AbstractGenome> genome, int nrOfBrainStates,
+	                                                     const vector<AbstractGenome::SiteEdit> &edits,
+	                                                     const GateTranslation &parent, shared_ptr<ParametersTable> gatePT) {
+		return translateGates(genome, nrOfBrainStates, gatePT);
+	}
 };
 
 class ClassicGateListBuilder : public AbstractGateListBuilder {
@@ -80,5 +110,23 @@ class ClassicGateListBuilder : public AbstractGateListBuilder {
 	virtual vector<shared_ptr<AbstractGate>> buildGateListAndGetAllValues(shared_ptr<AbstractGenome> genome, int nrOfBrainStates,
 	                                               int maxValue, vector<int> &genomeHeadValues, int genomeHeadValuesCount,
 	                                               vector<vector<int>> &genomePerGateValues, int genomePerGateValuesCount, shared_ptr<ParametersTable> gatePT);
+
+	// if the genome can be read by site (a start codon value is one site and
+	// the handler can jump to a site) and every gate only reads the sites after
+	// its start codon, gates are found by site and the layout is kept.
+	// Otherwise this is buildGateList.
+	virtual shared_ptr<GateTranslation> translateGates(shared_ptr<AbstractGenome> genome, int nrOfBrainStates, shared_ptr<ParametersTable> gatePT) override;
+	virtual shared_ptr<GateTranslation> retranslateGates(shared_ptr<AbstractGenome> genome, int nrOfBrainStates,
+	                                                     const vector<AbstractGenome::SiteEdit> &edits,
+	                                                     const GateTranslation &parent, shared_ptr<ParametersTable> gatePT) override;
+
+ private:
+	bool canTranslateBySite(shared_ptr<AbstractGenome> genome, shared_ptr<ParametersTable> gatePT);
+	int readCodon(shared_ptr<AbstractGenome::Handler> handler, int site);
+	// [first codon] second codon of the start codon, or -1
+	vector<int> secondStartCodons();
+	// read a gate from the start codon at site, set end to where reading stopped and
+	// reachedEnd if reading ran past the end of the genome. nullptr if no gate could be made
+	shared_ptr<AbstractGate> readGate(shared_ptr<AbstractGenome::Handler> handler, int site, int gateID, int &end, bool &reachedEnd, shared_ptr<ParametersTable> gatePT);
 };
 
@@ -0,0 +1,169 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+#include "GateProgram.h"
+
+#include <Brain/MarkovBrain/Gate/DeterministicGate.h>
+
+#include <algorithm>
+
+// returns true if gate is a DeterministicGate (and not a gate derived from it)
+// with a table of 0s and 1s that fits in a row mask
+static std::shared_ptr<DeterministicGate>
+asLowerableGate(const std::shared_ptr<AbstractGate> &gate) {
+  if (gate->gateType() != "Deterministic") {
+    return nullptr;
+  }
+  auto detGate = std::dynamic_pointer_cast<DeterministicGate>(gate);
+  if (detGate == nullptr || detGate->outputs.size() > 32 ||
+      detGate->inputs.size() > 24 ||
+      detGate->table.size() != (size_t(1) << detGate->inputs.size())) {
+    return nullptr;
+  }
+  for (auto &row : detGate->table) {
+    if (row.size() != detGate->outputs.size()) {
+      return nullptr;
+    }
+    for (auto value : row) {
+      if (value != 0 && value != 1) {
+        return nullptr;
+      }
+    }
+  }
+  return detGate;
+}
+
+void GateProgram::compile(
+    const std::vector<std::shared_ptr<AbstractGate>> &gates, int nrInputNodes,
+    int nrOutputNodes) {
+  inStart.clear();
+  inCount.clear();
+  outStart.clear();
+  outCount.clear();
+  tableStart.clear();
+  fallbackGates.clear();
+  inputAddresses.clear();
+  outputAddresses.clear();
+  tables.clear();
+  countMask.clear();
+  compiledCount = 0;
+  fallbackCount = 0;
+  firstOutputNode = nrInputNodes;
+
+  for (auto &gate : gates) {
+    auto detGate = asLowerableGate(gate);
+    inStart.push_back(inputAddresses.size());
+    outStart.push_back(outputAddresses.size());
+    tableStart.push_back(tables.size());
+    if (detGate == nullptr) {
+      inCount.push_back(0);
+      outCount.push_back(0);
+      fallbackGates.push_back(gate.get());
+      fallbackCount++;
+      continue;
+    }
+    inCount.push_back(detGate->inputs.size());
+    outCount.push_back(detGate->outputs.size());
+    fallbackGates.push_back(nullptr);
+    inputAddresses.insert(inputAddresses.end(), detGate->inputs.begin(),
+                          detGate->inputs.end());
+    outputAddresses.insert(outputAddresses.end(), detGate->outputs.begin(),
+                           detGate->outputs.end());
+    for (auto &row : detGate->table) {
+      uint32_t mask = 0;
+      for (size_t i = 0; i < row.size(); i++) {
+        mask |= static_cast<uint32_t>(row[i]) << i;
+      }
+      tables.push_back(mask);
+    }
+    compiledCount++;
+  }
+
+  // find brain outputs which are written by more then one gate output
+  std::vector<int> writers(nrOutputNodes, 0);
+  for (auto address : outputAddresses) {
+    if (address >= firstOutputNode && address < firstOutputNode + nrOutputNodes) {
+      writers[address - firstOutputNode]++;
+    }
+  }
+  outputIsCounted.assign(nrOutputNodes, false);
+  for (int i = 0; i < nrOutputNodes; i++) {
+    outputIsCounted[i] = writers[i] > 1;
+  }
+  for (size_t g = 0; g < fallbackGates.size(); g++) {
+    uint32_t mask = 0;
+    for (int i = 0; i < outCount[g]; i++) {
+      int node = outputAddresses[outStart[g] + i] - firstOutputNode;
+      if (node >= 0 && node < nrOutputNodes && outputIsCounted[node]) {
+        mask |= uint32_t(1) << i;
+      }
+    }
+    countMask.push_back(mask);
+  }
+}
+
+void GateProgram::run(std::vector<double> &nodes,
+                      std::vector<double> &nextNodes) const {
+  const size_t gateCount = fallbackGates.size();
+  double *next = nextNodes.data();
+  const double *current = nodes.data();
+  for (size_t g = 0; g < gateCount; g++) {
+    if (fallbackGates[g] != nullptr) {
+      fallbackGates[g]->update(nodes, nextNodes);
+      continue;
+    }
+    // vectorToBitToInt(nodes, inputs, true): first input is the low bit
+    const int *in = inputAddresses.data() + inStart[g];
+    const int ins = inCount[g];
+    int row = 0;
+    for (int i = 0; i < ins; i++) {
+      row |= (current[in[i]] > 0.0) << i;
+    }
+    const uint32_t mask = tables[tableStart[g] + row];
+    const int *out = outputAddresses.data() + outStart[g];
+    const int outs = outCount[g];
+    for (int i = 0; i < outs; i++) {
+      next[out[i]] += (mask >> i) & 1;
+    }
+  }
+}
+
+void GateProgram::runBits(const std::vector<uint64_t> &nodeBits,
+                          std::vector<uint64_t> &nextNodeBits,
+                          std::vector<double> &outputCounts) const {
+  std::fill(nextNodeBits.begin(), nextNodeBits.end(), 0);
+  std::fill(outputCounts.begin(), outputCounts.end(), 0.0);
+  const uint64_t *current = nodeBits.data();
+  uint64_t *next = nextNodeBits.data();
+  const size_t gateCount = fallbackGates.size();
+  for (size_t g = 0; g < gateCount; g++) {
+    const int *in = inputAddresses.data() + inStart[g];
+    const int ins = inCount[g];
+    int row = 0;
+    for (int i = 0; i < ins; i++) {
+      row |= static_cast<int>((current[in[i] >> 6] >> (in[i] & 63)) & 1) << i;
+    }
+    const uint32_t mask = tables[tableStart[g] + row];
+    const int *out = outputAddresses.data() + outStart[g];
+    const int outs = outCount[g];
+    for (int i = 0; i < outs; i++) {
+      next[out[i] >> 6] |= static_cast<uint64_t>((mask >> i) & 1) << (out[i] & 63);
+    }
+    uint32_t counted = mask & countMask[g];
+    while (counted) { // almost always 0
+      int i = 0;
+      while (!((counted >> i) & 1)) {
+        i++;
+      }
+      outputCounts[out[i] - firstOutputNode] += 1.0;
+      counted &= counted - 1;
+    }
+  }
+}
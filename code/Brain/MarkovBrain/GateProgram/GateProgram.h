@@ -0,0 +1,72 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <Brain/MarkovBrain/Gate/AbstractGate.h>
+
+// A GateProgram is a flat form of a Markov brain's gate list which is used to
+// run the brain. Deterministic gates are lowered into plain arrays (input
+// addresses, one packed row of output bits per input pattern, output
+// addresses) and run in a tight loop with no virtual calls. All other gates
+// are run by calling their update, in gate list order, so a compiled brain
+// gives exactly the same results as running the gate list.
+// The gate objects are still used for descriptions, stats and copies, and must
+// outlive the program. If the gate list is changed, compile again.
+class GateProgram {
+private:
+  friend class GateProgramBatch;
+
+  // one entry per gate (struct of arrays)
+  std::vector<int> inStart;    // first input address in inputAddresses
+  std::vector<int> inCount;
+  std::vector<int> outStart;   // first output address in outputAddresses
+  std::vector<int> outCount;
+  std::vector<int> tableStart; // first row in tables
+  std::vector<AbstractGate *> fallbackGates; // nullptr if gate was lowered
+
+  std::vector<int> inputAddresses;
+  std::vector<int> outputAddresses;
+  std::vector<uint32_t> tables; // bit i of a row is the value of output i
+
+  // used by runBits. Brain outputs are sums of the gate outputs written to
+  // them, so for output nodes with more then one writer, countMask marks the
+  // gate outputs which must be counted rather then ORed.
+  int firstOutputNode = 0;
+  std::vector<uint32_t> countMask;  // per gate
+  std::vector<bool> outputIsCounted; // per brain output
+
+public:
+  int compiledCount = 0; // number of gates lowered into arrays
+  int fallbackCount = 0; // number of gates which are run through update
+
+  GateProgram() = default;
+
+  // nrInputNodes and nrOutputNodes locate the brain outputs in the nodes
+  void compile(const std::vector<std::shared_ptr<AbstractGate>> &gates,
+               int nrInputNodes = 0, int nrOutputNodes = 0);
+
+  // same as calling update(nodes, nextNodes) on each gate in the gate list
+  void run(std::vector<double> &nodes, std::vector<double> &nextNodes) const;
+
+  // the same as run, but with each node held as one bit (node n is bit n%64
+  // of word n/64). Only possible if every gate was lowered (fallbackCount is
+  // 0). nextNodeBits is cleared and then filled. outputCounts is filled with
+  // the sums for brain outputs where countsOutput(i) is true.
+  void runBits(const std::vector<uint64_t> &nodeBits,
+               std::vector<uint64_t> &nextNodeBits,
+               std::vector<double> &outputCounts) const;
+
+  bool countsOutput(int output) const { return outputIsCounted[output]; }
+};
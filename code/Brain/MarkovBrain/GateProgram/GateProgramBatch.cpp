@@ -0,0 +1,216 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+#include "GateProgramBatch.h"
+
+#include <algorithm>
+#include <iostream>
+
+// the vector kernels are compiled for their instruction sets with target
+// attributes and picked at run time, so a stock build uses them on machines
+// which have them
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define GATE_PROGRAM_BATCH_X86 1
+#include <immintrin.h>
+#endif
+
+int GateProgramBatch::laneWidth() {
+#ifdef GATE_PROGRAM_BATCH_X86
+  static const int width = __builtin_cpu_supports("avx512f") ? 16
+                           : __builtin_cpu_supports("avx2")  ? 8
+                                                             : 1;
+  return width;
+#else
+  return 1;
+#endif
+}
+
+void GateProgramBatch::build(const std::vector<const GateProgram *> &programs,
+                             int nrNodes) {
+  usedLanes = static_cast<int>(programs.size());
+  const int width = laneWidth();
+  lanes = ((usedLanes + width - 1) / width) * width;
+  stride = nrNodes + 1;
+  const int spare = nrNodes;
+
+  gateSlots = 0;
+  for (auto program : programs) {
+    if (program->fallbackCount != 0) {
+      std::cout << "  ERROR! GateProgramBatch can only run programs where "
+                   "every gate was compiled.\n  Exiting." << std::endl;
+      exit(1);
+    }
+    gateSlots = std::max(gateSlots, static_cast<int>(program->inCount.size()));
+  }
+
+  slotInputs.assign(gateSlots, 0);
+  slotOutputs.assign(gateSlots, 0);
+  for (auto program : programs) {
+    for (size_t g = 0; g < program->inCount.size(); g++) {
+      slotInputs[g] = std::max(slotInputs[g], program->inCount[g]);
+      slotOutputs[g] = std::max(slotOutputs[g], program->outCount[g]);
+    }
+  }
+  slotInStart.assign(gateSlots, 0);
+  slotOutStart.assign(gateSlots, 0);
+  int inRows = 0;
+  int outRows = 0;
+  for (int g = 0; g < gateSlots; g++) {
+    slotInStart[g] = inRows;
+    slotOutStart[g] = outRows;
+    inRows += slotInputs[g];
+    outRows += slotOutputs[g];
+  }
+
+  // start with every lane pointing at its spare node and the 0 table row
+  inIndex.assign(static_cast<size_t>(inRows) * lanes, 0);
+  outIndex.assign(static_cast<size_t>(outRows) * lanes, 0);
+  for (int l = 0; l < lanes; l++) {
+    for (int r = 0; r < inRows; r++) {
+      inIndex[static_cast<size_t>(r) * lanes + l] = l * stride + spare;
+    }
+    for (int r = 0; r < outRows; r++) {
+      outIndex[static_cast<size_t>(r) * lanes + l] = l * stride + spare;
+    }
+  }
+  tableIndex.assign(static_cast<size_t>(gateSlots) * lanes, 0);
+  tables.assign(1, 0);
+
+  for (int l = 0; l < usedLanes; l++) {
+    auto program = programs[l];
+    for (size_t g = 0; g < program->inCount.size(); g++) {
+      for (int i = 0; i < program->inCount[g]; i++) {
+        inIndex[static_cast<size_t>(slotInStart[g] + i) * lanes + l] =
+            l * stride + program->inputAddresses[program->inStart[g] + i];
+      }
+      for (int i = 0; i < program->outCount[g]; i++) {
+        outIndex[static_cast<size_t>(slotOutStart[g] + i) * lanes + l] =
+            l * stride + program->outputAddresses[program->outStart[g] + i];
+      }
+      tableIndex[g * lanes + l] = static_cast<int32_t>(tables.size());
+      auto first = program->tables.begin() + program->tableStart[g];
+      tables.insert(tables.end(), first, first + (1 << program->inCount[g]));
+    }
+  }
+
+  rows.assign(lanes, 0);
+  masks.assign(lanes, 0);
+  state.assign(static_cast<size_t>(lanes) * stride, 0);
+  nextState.assign(state.size(), 0);
+}
+
+void GateProgramBatch::step() {
+  std::fill(nextState.begin(), nextState.end(), 0);
+#ifdef GATE_PROGRAM_BATCH_X86
+  switch (laneWidth()) {
+  case 16:
+    runAVX512();
+    break;
+  case 8:
+    runAVX2();
+    break;
+  default:
+    runScalar();
+  }
+#else
+  runScalar();
+#endif
+  // unused outputs only ever add 0 to the spare node, so it stays 0
+  std::swap(state, nextState);
+}
+
+void GateProgramBatch::runScalar() {
+  for (int g = 0; g < gateSlots; g++) {
+    std::fill(rows.begin(), rows.end(), 0);
+    for (int i = 0; i < slotInputs[g]; i++) {
+      const int32_t *index = &inIndex[static_cast<size_t>(slotInStart[g] + i) * lanes];
+      for (int l = 0; l < lanes; l++) {
+        rows[l] |= static_cast<int32_t>(state[index[l]] != 0) << i;
+      }
+    }
+    const int32_t *table = &tableIndex[g * lanes];
+    for (int l = 0; l < lanes; l++) {
+      masks[l] = tables[table[l] + rows[l]];
+    }
+    for (int i = 0; i < slotOutputs[g]; i++) {
+      const int32_t *index = &outIndex[static_cast<size_t>(slotOutStart[g] + i) * lanes];
+      for (int l = 0; l < lanes; l++) {
+        nextState[index[l]] += (masks[l] >> i) & 1;
+      }
+    }
+  }
+}
+
+#ifdef GATE_PROGRAM_BATCH_X86
+
+__attribute__((target("avx512f"))) void GateProgramBatch::runAVX512() {
+  const int *current = reinterpret_cast<const int *>(state.data());
+  int *next = reinterpret_cast<int *>(nextState.data());
+  const int *tableRows = reinterpret_cast<const int *>(tables.data());
+  const __m512i zero = _mm512_setzero_si512();
+  const __m512i one = _mm512_set1_epi32(1);
+  for (int g = 0; g < gateSlots; g++) {
+    const int32_t *table = &tableIndex[g * lanes];
+    for (int l = 0; l < lanes; l += 16) {
+      __m512i row = zero;
+      for (int i = 0; i < slotInputs[g]; i++) {
+        const __m512i index = _mm512_loadu_si512(
+            &inIndex[static_cast<size_t>(slotInStart[g] + i) * lanes + l]);
+        const __m512i value = _mm512_i32gather_epi32(index, current, 4);
+        const __mmask16 on = _mm512_cmpneq_epi32_mask(value, zero);
+        row = _mm512_mask_or_epi32(row, on, row, _mm512_set1_epi32(1 << i));
+      }
+      const __m512i rowIndex = _mm512_add_epi32(_mm512_loadu_si512(table + l), row);
+      const __m512i mask = _mm512_i32gather_epi32(rowIndex, tableRows, 4);
+      for (int i = 0; i < slotOutputs[g]; i++) {
+        // lanes never share nodes, so the scatter has no collisions
+        const __m512i index = _mm512_loadu_si512(
+            &outIndex[static_cast<size_t>(slotOutStart[g] + i) * lanes + l]);
+        const __m512i bit = _mm512_and_si512(_mm512_srli_epi32(mask, i), one);
+        const __m512i sum = _mm512_add_epi32(_mm512_i32gather_epi32(index, next, 4), bit);
+        _mm512_i32scatter_epi32(next, index, sum, 4);
+      }
+    }
+  }
+}
+
+__attribute__((target("avx2"))) void GateProgramBatch::runAVX2() {
+  const int *current = reinterpret_cast<const int *>(state.data());
+  const int *tableRows = reinterpret_cast<const int *>(tables.data());
+  const __m256i zero = _mm256_setzero_si256();
+  for (int g = 0; g < gateSlots; g++) {
+    const int32_t *table = &tableIndex[g * lanes];
+    for (int l = 0; l < lanes; l += 8) {
+      __m256i row = zero;
+      for (int i = 0; i < slotInputs[g]; i++) {
+        const __m256i index = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(
+            &inIndex[static_cast<size_t>(slotInStart[g] + i) * lanes + l]));
+        const __m256i value = _mm256_i32gather_epi32(current, index, 4);
+        // all ones where value is 0, so andnot leaves the bit where value != 0
+        const __m256i off = _mm256_cmpeq_epi32(value, zero);
+        row = _mm256_or_si256(row, _mm256_andnot_si256(off, _mm256_set1_epi32(1 << i)));
+      }
+      const __m256i rowIndex = _mm256_add_epi32(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(table + l)), row);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(&masks[l]),
+                          _mm256_i32gather_epi32(tableRows, rowIndex, 4));
+    }
+    // AVX2 has no scatter
+    for (int i = 0; i < slotOutputs[g]; i++) {
+      const int32_t *index = &outIndex[static_cast<size_t>(slotOutStart[g] + i) * lanes];
+      for (int l = 0; l < lanes; l++) {
+        nextState[index[l]] += (masks[l] >> i) & 1;
+      }
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,75 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "GateProgram.h"
+
+// Runs many fully compiled GatePrograms (fallbackCount == 0) in lockstep.
+// Each program gets a lane. Gate g of every lane is run at the same time, so
+// finding input rows, looking up tables and adding outputs are each one loop
+// over lanes. On CPUs with AVX2 (or AVX-512) these loops use gathers (and
+// scatters); otherwise they are plain loops.
+// Node values are held as counts (one uint32_t per node per lane, lane l's
+// nodes start at l * stride), which gives the same brain outputs as
+// GateProgram::run. Lanes are padded with empty programs up to a multiple of
+// laneWidth(), and every lane has a spare node (which is always 0) to point
+// unused inputs and outputs at.
+class GateProgramBatch {
+private:
+  int lanes = 0;     // padded lane count
+  int usedLanes = 0; // number of programs
+  int stride = 0;    // nodes per lane (including the spare node)
+  int gateSlots = 0; // most gates in any program
+
+  // per gate slot
+  std::vector<int> slotInputs;  // most inputs of any gate in this slot
+  std::vector<int> slotOutputs; // most outputs of any gate in this slot
+  std::vector<int> slotInStart; // first row of inIndex for this slot
+  std::vector<int> slotOutStart;
+
+  // [row][lane]. A row of inIndex is one input of one gate slot and holds the
+  // position in state of that input in each lane.
+  std::vector<int32_t> inIndex;
+  std::vector<int32_t> outIndex;
+  std::vector<int32_t> tableIndex; // [gate slot][lane], first row in tables
+  std::vector<uint32_t> tables;    // tables[0] is a 0 row for padding
+
+  std::vector<int32_t> rows;   // [lane] work space
+  std::vector<uint32_t> masks; // [lane] work space
+
+  void runScalar();
+  void runAVX2();   // laneWidth() == 8
+  void runAVX512(); // laneWidth() == 16
+
+public:
+  // number of lanes processed together by the vector code this CPU can run
+  static int laneWidth();
+
+  std::vector<uint32_t> state;
+  std::vector<uint32_t> nextState;
+
+  GateProgramBatch() = default;
+
+  // all programs must have fallbackCount == 0 and use nodes < nrNodes
+  void build(const std::vector<const GateProgram *> &programs, int nrNodes);
+
+  int laneCount() const { return usedLanes; }
+
+  // nodes for lane
+  uint32_t *laneNodes(int lane) { return state.data() + lane * stride; }
+
+  // run every lane once: nextState is cleared and filled from state, then
+  // state and nextState are swapped
+  void step();
+};
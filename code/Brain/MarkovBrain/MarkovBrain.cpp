@@ -9,6 +9,9 @@
 //         github.com/Hintzelab/MABE/wiki/License
 
 #include "MarkovBrain.h"
+#include "GateProgram/GateProgramBatch.h"
+
+#include <algorithm>
 
 std::shared_ptr<ParameterLink<bool>> MarkovBrain::recordIOMapPL=
     Parameters::register_parameter(
@@ -51,6 +54,24 @@ std::shared_ptr<ParameterLink<std::string>> MarkovBrain::genomeNamePL =
                                    "namespace used to set parameters for "
                                    "genome used to encode this brain");
 
+std::shared_ptr<ParameterLink<int>> MarkovBrain::gateCacheSizePL =
+    Parameters::register_parameter(
+        "BRAIN_MARKOV_ADVANCED-gateCacheSize", 0,
+        "if > 0, gates built from genomes are saved in a cache which holds "
+        "this many gate lists.\nbrains made from a genome already in the "
+        "cache copy the saved gates and skip reading the genome.\ncache hits "
+        "and misses are saved in pop.csv");
+
+std::shared_ptr<ParameterLink<bool>> MarkovBrain::incrementalTranslationPL =
+    Parameters::register_parameter(
+        "BRAIN_MARKOV_ADVANCED-incrementalTranslation", false,
+        "if true, offspring brains find their gates by only reading the "
+        "parts of their genome which were changed by mutation (and reusing "
+        "the rest of their parent's gates).\nthis gives the same gates as "
+        "reading the whole genome");
+
+LRUCache<uint64_t, std::shared_ptr<const MarkovBrain::GateCacheEntry>> MarkovBrain::gateCache;
+
 void MarkovBrain::readParameters() {
   randomizeUnconnectedOutputs = randomizeUnconnectedOutputsPL->get(PT);
   randomizeUnconnectedOutputsType = randomizeUnconnectedOutputsTypePL->get(PT);
@@ -59,6 +80,9 @@ void MarkovBrain::readParameters() {
   hiddenNodes = hiddenNodesPL->get(PT);
 
   genomeName = genomeNamePL->get(PT);
+  gateCacheSize = gateCacheSizePL->get(PT);
+  incrementalTranslation = incrementalTranslationPL->get(PT);
+  recordIOMap.bind(recordIOMapPL);
 
   nrNodes = nrInputValues + nrOutputValues + hiddenNodes;
   nodes.resize(nrNodes, 0);
@@ -83,6 +107,7 @@ MarkovBrain::MarkovBrain(std::vector<std::shared_ptr<AbstractGate>> _gates,
   }
 
   fillInConnectionsLists();
+  compileGates();
 }
 
 MarkovBrain::MarkovBrain(std::shared_ptr<AbstractGateListBuilder> GLB_,
@@ -103,21 +128,71 @@ MarkovBrain::MarkovBrain(std::shared_ptr<AbstractGateListBuilder> GLB_,
   for (auto name : GLB->getInUseGateNames()) {
     popFileColumns.push_back("markovBrain" + name + "Gates");
   }
+  if (gateCacheSize > 0) {
+    popFileColumns.push_back("markovBrainCacheHits_SUM");
+    popFileColumns.push_back("markovBrainCacheMisses_SUM");
+  }
 
   fillInConnectionsLists();
+  compileGates();
 }
 
 MarkovBrain::MarkovBrain(
     std::shared_ptr<AbstractGateListBuilder> GLB_,
     std::unordered_map<std::string, std::shared_ptr<AbstractGenome>> &_genomes, int _nrInNodes,
-    int _nrOutNodes, std::shared_ptr<ParametersTable> PT_)
+    int _nrOutNodes, std::shared_ptr<ParametersTable> PT_,
+    std::shared_ptr<MarkovBrain> parent)
     : MarkovBrain(GLB_, _nrInNodes, _nrOutNodes, PT_) {
   // cout << "in MarkovBrain::MarkovBrain(std::shared_ptr<Base_GateListBuilder> GLB_,
   // std::shared_ptr<AbstractGenome> genome, int _nrOfBrainStates)\n\tabout to -
   // gates = GLB->buildGateList(genome, nrOfBrainStates);" << endl;
-  gates = GLB->buildGateList(_genomes[genomeName], nrNodes, PT_);
+  auto genome = _genomes[genomeName];
+  std::string cacheSource = gateCacheSize > 0 ? gateCacheSource(genome) : "";
+  uint64_t cacheKey = std::hash<std::string>()(cacheSource);
+  if (cacheSource.empty() && !incrementalTranslation) {
+    gates = GLB->buildGateList(genome, nrNodes, PT_);
+  } else {
+    // translation gates are kept as read (they are shared with the cache and
+    // offspring), so this brain gets copies
+    std::shared_ptr<const GateTranslation> newTranslation;
+    std::shared_ptr<const GateCacheEntry> cached;
+    if (!cacheSource.empty() && gateCache.get(cacheKey, cached) &&
+        cached->source == cacheSource) {
+      newTranslation = cached->translation;
+      gateCacheResult = 1;
+    } else {
+      std::vector<AbstractGenome::SiteEdit> edits;
+      std::shared_ptr<AbstractGenome> parentGenome =
+          (incrementalTranslation && parent != nullptr && parent->translation != nullptr)
+              ? parent->translatedGenome.lock()
+              : nullptr;
+      if (parentGenome != nullptr &&
+          genome->getEditsFrom(parentGenome, parent->translatedGenomeVersion, edits)) {
+        newTranslation = GLB->retranslateGates(genome, nrNodes, edits,
+                                               *parent->translation, PT_);
+      } else {
+        newTranslation = GLB->translateGates(genome, nrNodes, PT_);
+      }
+      if (!cacheSource.empty()) {
+        gateCache.put(cacheKey, std::make_shared<const GateCacheEntry>(
+                                    GateCacheEntry{std::move(cacheSource), newTranslation}));
+      }
+      if (gateCacheSize > 0) {
+        gateCacheResult = 0;
+      }
+    }
+    for (auto &g : newTranslation->gates) {
+      gates.push_back(g->makeCopy());
+    }
+    if (incrementalTranslation) {
+      translation = newTranslation;
+      translatedGenome = genome;
+      translatedGenomeVersion = genome->getSitesVersion();
+    }
+  }
   inOutReMap(); // map ins and outs from genome values to brain states
   fillInConnectionsLists();
+  compileGates();
 }
 
 // Make a brain like the brain that called this function, using genomes and
@@ -129,40 +204,56 @@ std::shared_ptr<AbstractBrain> MarkovBrain::makeBrain(
   return newBrain;
 }
 
+std::shared_ptr<AbstractBrain> MarkovBrain::makeBrainFrom(
+    std::shared_ptr<AbstractBrain> parent,
+    std::unordered_map<std::string, std::shared_ptr<AbstractGenome>> &_genomes) {
+  return std::make_shared<MarkovBrain>(GLB, _genomes, nrInputValues, nrOutputValues,
+                                       PT, std::dynamic_pointer_cast<MarkovBrain>(parent));
+}
+
 void MarkovBrain::resetBrain() {
   AbstractBrain::resetBrain();
   nodes.assign(nrNodes, 0.0);
+  std::fill(nodeBits.begin(), nodeBits.end(), 0);
+  nodesStale = false;
   for (auto &g :gates)
 	  g->resetGate();
 }
 
 void MarkovBrain::resetInputs() {
   AbstractBrain::resetInputs(); 
+  syncNodes();
   for (int i = 0; i < nrInputValues; i++)
     nodes[i] = 0.0;
+  loadNodeBits();
 }
 
 void MarkovBrain::resetOutputs() {
   AbstractBrain::resetOutputs();
   // note nrInputValues+i gets us the index for the node related to each output
+  syncNodes();
   for (int i = 0; i < nrOutputValues; i++) 
     nodes[nrInputValues + i] = 0.0;
+  loadNodeBits();
 }
 
 
 void MarkovBrain::update() {
+  if (packedNodes) {
+    updatePacked();
+    return;
+  }
   nextNodes.assign(nrNodes, 0.0);
 	DataMap IOMap;
 
   for (int i = 0; i < nrInputValues; i++)  
     nodes[i] = inputValues[i];
   
-  if (recordIOMapPL->get())
+  if (recordIOMap.get())
     for (int i = 0; i < nrInputValues; i++)
      IOMap.append("input", Bit(nodes[i]));
 
-  for (auto &g :gates) // update each gate
-	  g->update(nodes, nextNodes);
+  program.run(nodes, nextNodes); // update each gate
 
   if (randomizeUnconnectedOutputs) {
     switch (randomizeUnconnectedOutputsType) {
@@ -192,7 +283,7 @@ void MarkovBrain::update() {
     outputValues[i] = nodes[nrInputValues + i];
   }
 
-  if (recordIOMapPL->get()){
+  if (recordIOMap.get()){
    for (int i = 0; i < nrOutputValues; i++ )
       IOMap.append("output", Bit(nodes[nrInputValues + i]));
 	
@@ -206,6 +297,123 @@ void MarkovBrain::update() {
   }
 }
 
+// same as update, but with node states held in nodeBits. Gates only ever
+// read Bit(node), so the only values that need more then one bit are brain
+// outputs with several writers, which GateProgram counts into outputCounts.
+void MarkovBrain::updatePacked() {
+  for (int i = 0; i < nrInputValues; i++) {
+    uint64_t bit = uint64_t(1) << (i & 63);
+    if (inputValues[i] > 0.0) {
+      nodeBits[i >> 6] |= bit;
+    } else {
+      nodeBits[i >> 6] &= ~bit;
+    }
+  }
+  program.runBits(nodeBits, nextNodeBits, outputCounts);
+  swap(nodeBits, nextNodeBits);
+  for (int i = 0; i < nrOutputValues; i++) {
+    int n = nrInputValues + i;
+    outputValues[i] = program.countsOutput(i)
+                          ? outputCounts[i]
+                          : static_cast<double>((nodeBits[n >> 6] >> (n & 63)) & 1);
+  }
+  nodesStale = true;
+}
+
+// the last batch built on this thread, used again while updateBatch is called
+// with the same brains
+namespace {
+struct BatchCache {
+  std::vector<std::weak_ptr<AbstractBrain>> brains;
+  GateProgramBatch batch;
+};
+thread_local BatchCache batchCache;
+}
+
+void MarkovBrain::updateBatch(std::vector<std::shared_ptr<AbstractBrain>> &brains) {
+  std::vector<std::shared_ptr<AbstractBrain>> laneBrains;
+  std::vector<MarkovBrain *> lanes;
+  int maxNodes = 0;
+  for (auto &brain : brains) {
+    auto markov = std::dynamic_pointer_cast<MarkovBrain>(brain);
+    if (markov && markov->packedNodes) {
+      laneBrains.push_back(brain);
+      lanes.push_back(markov.get());
+      maxNodes = std::max(maxNodes, markov->nrNodes);
+    } else {
+      brain->update();
+    }
+  }
+  if (lanes.empty()) {
+    return;
+  }
+
+  auto &cache = batchCache;
+  bool sameBrains = cache.brains.size() == lanes.size();
+  for (size_t l = 0; sameBrains && l < lanes.size(); l++) {
+    sameBrains = cache.brains[l].lock() == laneBrains[l];
+  }
+  if (!sameBrains) {
+    std::vector<const GateProgram *> programs;
+    for (auto markov : lanes) {
+      programs.push_back(&markov->program);
+    }
+    cache.batch.build(programs, maxNodes);
+    cache.brains.assign(laneBrains.begin(), laneBrains.end());
+  }
+
+  // the brains own their node states, so copy them in and out of the batch
+  for (size_t l = 0; l < lanes.size(); l++) {
+    auto markov = lanes[l];
+    uint32_t *laneNodes = cache.batch.laneNodes(l);
+    for (int n = 0; n < markov->nrNodes; n++) {
+      laneNodes[n] = (markov->nodeBits[n >> 6] >> (n & 63)) & 1;
+    }
+    for (int i = 0; i < markov->nrInputValues; i++) {
+      laneNodes[i] = markov->inputValues[i] > 0.0;
+    }
+  }
+  cache.batch.step();
+  for (size_t l = 0; l < lanes.size(); l++) {
+    auto markov = lanes[l];
+    const uint32_t *laneNodes = cache.batch.laneNodes(l);
+    std::fill(markov->nodeBits.begin(), markov->nodeBits.end(), 0);
+    for (int n = 0; n < markov->nrNodes; n++) {
+      markov->nodeBits[n >> 6] |= static_cast<uint64_t>(laneNodes[n] != 0) << (n & 63);
+    }
+    for (int i = 0; i < markov->nrOutputValues; i++) {
+      markov->outputValues[i] = laneNodes[markov->nrInputValues + i];
+    }
+    markov->nodesStale = true;
+  }
+}
+
+// copy nodeBits into nodes (outputs get their full values)
+void MarkovBrain::syncNodes() {
+  if (!packedNodes || !nodesStale) {
+    return;
+  }
+  for (int n = 0; n < nrNodes; n++) {
+    nodes[n] = static_cast<double>((nodeBits[n >> 6] >> (n & 63)) & 1);
+  }
+  for (int i = 0; i < nrOutputValues; i++) {
+    nodes[nrInputValues + i] = outputValues[i];
+  }
+  nodesStale = false;
+}
+
+// copy nodes into nodeBits
+void MarkovBrain::loadNodeBits() {
+  if (!packedNodes) {
+    return;
+  }
+  std::fill(nodeBits.begin(), nodeBits.end(), 0);
+  for (int n = 0; n < nrNodes; n++) {
+    nodeBits[n >> 6] |= static_cast<uint64_t>(Bit(nodes[n])) << (n & 63);
+  }
+  nodesStale = false;
+}
+
 void MarkovBrain::inOutReMap() { // remaps genome site values to valid brain
                                  // state addresses
   for (auto &g : gates)
@@ -231,6 +439,36 @@ void MarkovBrain::fillInConnectionsLists() {
   }
 }
 
+std::string MarkovBrain::gateCacheSource(std::shared_ptr<AbstractGenome> genome) {
+  std::string source = genome->sitesBytes();
+  if (source.empty()) {
+    return source;
+  }
+  // the same genome gives different gates with different parameters or sizes
+  for (uint64_t value : {static_cast<uint64_t>(reinterpret_cast<uintptr_t>(PT.get())),
+                         static_cast<uint64_t>(reinterpret_cast<uintptr_t>(GLB.get())),
+                         static_cast<uint64_t>(nrInputValues),
+                         static_cast<uint64_t>(nrOutputValues),
+                         static_cast<uint64_t>(nrNodes)}) {
+    source.append(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+  return source;
+}
+
+void MarkovBrain::compileGates() {
+  program.compile(gates, nrInputValues, nrOutputValues);
+  // the bit kernel can not run fallback gates and does not know about the
+  // IOMap or randomized outputs, so those brains stay on doubles
+  packedNodes = program.fallbackCount == 0 && !randomizeUnconnectedOutputs &&
+                !recordIOMap.get();
+  nodesStale = false;
+  if (packedNodes) {
+    nodeBits.assign((nrNodes + 63) / 64, 0);
+    nextNodeBits.assign(nodeBits.size(), 0);
+    outputCounts.assign(nrOutputValues, 0.0);
+    loadNodeBits();
+  }
+}
 
 DataMap MarkovBrain::getStats(std::string &prefix) {
   DataMap dataMap;
@@ -254,6 +492,11 @@ DataMap MarkovBrain::getStats(std::string &prefix) {
     nodesConnectionsList.push_back(nodesConnections[i]);
     nextNodesConnectionsList.push_back(nextNodesConnections[i]);
   }
+  if (gateCacheResult >= 0) {
+    dataMap.set(prefix + "markovBrainCacheHits", gateCacheResult == 1 ? 1 : 0);
+    dataMap.set(prefix + "markovBrainCacheMisses", gateCacheResult == 0 ? 1 : 0);
+  }
+
   dataMap.set(prefix + "markovBrain_nodesConnections", nodesConnectionsList);
   dataMap.setOutputBehavior(prefix + "markovBrain_nodesConnections", DataMap::LIST);
   dataMap.set(prefix + "markovBrain_nextNodesConnections",
@@ -287,6 +530,7 @@ int MarkovBrain::brainSize() { return gates.size(); }
 int MarkovBrain::numGates() { return brainSize(); }
 
 std::vector<int> MarkovBrain::getHiddenNodes() {
+  syncNodes();
   std::vector<int> temp ;
   for (size_t i = nrInputValues + nrOutputValues; i < nodes.size(); i++) 
     temp.push_back(Bit(nodes[i]));
@@ -17,9 +17,11 @@
 #include <vector>
 
 #include "GateListBuilder/GateListBuilder.h"
+#include "GateProgram/GateProgram.h"
 #include "../../Genome/AbstractGenome.h"
 
 #include "../../Utilities/Random.h"
+#include "../../Utilities/LRUCache.h"
 
 #include "../AbstractBrain.h"
 
@@ -27,6 +29,7 @@ class MarkovBrain : public AbstractBrain {
 
 public:
   std::vector<std::shared_ptr<AbstractGate>> gates;
+  GateProgram program; // flat form of gates used by update (see compileGates)
 
   //	static shared_ptr<ParameterLink<int>> bitsPerBrainAddressPL;  // how
   //many bits are evaluated to determine the brain addresses.
@@ -42,6 +45,18 @@ public:
       randomizeUnconnectedOutputsMaxPL;
   static std::shared_ptr<ParameterLink<int>> hiddenNodesPL;
   static std::shared_ptr<ParameterLink<std::string>> genomeNamePL;
+  static std::shared_ptr<ParameterLink<int>> gateCacheSizePL;
+  static std::shared_ptr<ParameterLink<bool>> incrementalTranslationPL;
+
+  // gate translations of recently built brains, keyed by a hash of what they
+  // were translated from (see gateCacheSource), which is kept with them and
+  // compared on a hit. Shared by all Markov brains, sized when a template
+  // brain is made (MarkovBrain_brainFactory).
+  struct GateCacheEntry {
+    std::string source;
+    std::shared_ptr<const GateTranslation> translation;
+  };
+  static LRUCache<uint64_t, std::shared_ptr<const GateCacheEntry>> gateCache;
 
   bool randomizeUnconnectedOutputs;
   bool randomizeUnconnectedOutputsType;
@@ -49,10 +64,33 @@ public:
   double randomizeUnconnectedOutputsMax;
   int hiddenNodes;
   std::string genomeName;
+  int gateCacheSize;
+  int gateCacheResult = -1; // 1 if gates came from gateCache, 0 if not, -1 if cache is off
+  bool incrementalTranslation;
+  ParameterValue<bool> recordIOMap; // recordIOMapPL, read every update
+
+  // if incrementalTranslation is on, the translation gates was made from and
+  // the genome (at translatedGenomeVersion) it was read from. Offspring use
+  // this to only read the parts of their genome which were mutated.
+  std::shared_ptr<const GateTranslation> translation;
+  std::weak_ptr<AbstractGenome> translatedGenome;
+  int translatedGenomeVersion = 0;
 
   std::vector<double> nodes;
   std::vector<double> nextNodes;
 
+  // if every gate could be compiled, update keeps the node states as bits
+  // (node n is bit n%64 of nodeBits[n/64]) and nodes is only brought up to
+  // date by syncNodes when something asks for it.
+  bool packedNodes = false;
+  bool nodesStale = false;
+  std::vector<uint64_t> nodeBits;
+  std::vector<uint64_t> nextNodeBits;
+  std::vector<double> outputCounts;
+  void updatePacked();
+  void syncNodes();
+  void loadNodeBits();
+
   int nrNodes;
 
   std::shared_ptr<AbstractGateListBuilder> GLB;
@@ -87,10 +125,13 @@ public:
               int _nrOutNodes, std::shared_ptr<ParametersTable> PT_ = nullptr);
   MarkovBrain(std::shared_ptr<AbstractGateListBuilder> GLB_, int _nrInNodes,
               int _nrOutNodes, std::shared_ptr<ParametersTable> PT_ = nullptr);
+  // if parent is given, and the genome was made from parent's genome by
+  // mutation, gates may be built from parent's translation
   MarkovBrain(std::shared_ptr<AbstractGateListBuilder> GLB_,
               std::unordered_map<std::string, std::shared_ptr<AbstractGenome>> &_genomes,
               int _nrInNodes, int _nrOutNodes,
-              std::shared_ptr<ParametersTable> PT_ = nullptr);
+              std::shared_ptr<ParametersTable> PT_ = nullptr,
+              std::shared_ptr<MarkovBrain> parent = nullptr);
 
   virtual ~MarkovBrain() = default;
 
@@ -100,6 +141,8 @@ public:
   void readParameters();
 
   virtual void update() override;
+  // runs brains where packedNodes is set together with a GateProgramBatch
+  virtual void updateBatch(std::vector<std::shared_ptr<AbstractBrain>> &brains) override;
 
   void inOutReMap();
 
@@ -107,9 +150,17 @@ public:
   // initalizing other elements.
   virtual std::shared_ptr<AbstractBrain> makeBrain(
       std::unordered_map<std::string, std::shared_ptr<AbstractGenome>> &_genomes) override;
+  virtual std::shared_ptr<AbstractBrain> makeBrainFrom(
+      std::shared_ptr<AbstractBrain> parent,
+      std::unordered_map<std::string, std::shared_ptr<AbstractGenome>> &_genomes) override;
 
   virtual std::string description() override;
   void fillInConnectionsLists();
+  // what gates are translated from: genome's sitesBytes and the settings of
+  // this brain which change its gates ("" if genome has no sitesBytes)
+  std::string gateCacheSource(std::shared_ptr<AbstractGenome> genome);
+  // build program from gates. This must be called again if gates is changed.
+  void compileGates();
   virtual DataMap getStats(std::string &prefix) override;
   virtual std::string getType() override { return "Markov"; }
 
@@ -138,6 +189,9 @@ public:
     bool fbState=DecomposableFeedbackGate::feedbackON;
     int maxReps=1000;//100;
     cout << maxReps << endl;
+    bool packedState=packedNodes;
+    syncNodes();
+    packedNodes=false; // nodes is written directly below
     vector<double> recoverState=nodes;
     vector<double> recoverNextNodeStates=nextNodes;
     vector<double> recoverI=inputValues;
@@ -170,6 +224,8 @@ public:
     inputValues=recoverI;
     outputValues=recoverO;
     DecomposableFeedbackGate::feedbackON=fbState;
+    packedNodes=packedState;
+    loadNodeBits();
     return TPM;
   }
   
@@ -203,6 +259,9 @@ public:
 
 inline std::shared_ptr<AbstractBrain>
 MarkovBrain_brainFactory(int ins, int outs, std::shared_ptr<ParametersTable> PT) {
+  if (MarkovBrain::gateCacheSizePL->get(PT) > 0) {
+    MarkovBrain::gateCache.setCapacity(MarkovBrain::gateCacheSizePL->get(PT));
+  }
   return std::make_shared<MarkovBrain>(std::make_shared<ClassicGateListBuilder>(PT), ins,
                                   outs, PT);
 }
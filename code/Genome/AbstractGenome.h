@@ -11,6 +11,7 @@
 #pragma once
 
 #include <cstdlib>
+#include <cstdint>
 #include <vector>
 
 #include <fstream>
@@ -123,6 +124,21 @@ public:
     virtual bool inTelomere(int length) { return false; }
 
     virtual void randomize() = 0;
+
+    // for genomes which are one list of sites. getSiteIndex returns the site
+    // that will be read next and setSiteIndex moves there (and clears EOC and
+    // EOG). -1 and false mean the genome does not support this.
+    virtual int getSiteIndex() { return -1; }
+    virtual bool setSiteIndex(int index) { return false; }
+  };
+
+  // a change made to sites by mutate(). Sites [position, position + removed)
+  // were replaced by inserted new sites (a point mutation removes 1 and
+  // inserts 1).
+  struct SiteEdit {
+    int position;
+    int removed;
+    int inserted;
   };
 
   DataMap dataMap;
@@ -173,6 +189,13 @@ public:
     exit(1);
   }
 
+  // serialize, but with the sites packed into bytes (under name +
+  // PackedSites::packedSuffix) for organism files which keep sites out of
+  // line (see Utilities/PackedSites.h). deserialize must then accept a
+  // PackedSites reference in place of the sites. By default the same as
+  // serialize
+  virtual DataMap serializePacked(std::string &name) { return serialize(name); }
+
   // given a an unordered_map<string, string> and PT, load data into this genome
   virtual void deserialize(std::shared_ptr<ParametersTable> PT,
                            std::unordered_map<std::string, std::string> &orgData,
@@ -222,6 +245,35 @@ public:
   virtual std::shared_ptr<AbstractGenome>
   makeMutatedGenomeFromMany(std::vector<std::shared_ptr<AbstractGenome>> parents) = 0;
 
+  // if this genome was made by copying base, when base was at baseVersion
+  // (see getSitesVersion), and then only changed by mutate(), set edits to
+  // those changes (in the order they were made) and return true.
+  virtual bool getEditsFrom(std::shared_ptr<AbstractGenome> base, int baseVersion,
+                            std::vector<SiteEdit> &edits) {
+    return false;
+  }
+
+  // changes every time this genome's sites change
+  virtual int getSitesVersion() { return 0; }
+
+  // for genomes which are one list of sites where readInt(0, codonMax) reads
+  // one site (these must also support Handler::setSiteIndex): add to starts,
+  // in order, every site i in [first, last] where the codon read from site i
+  // is c and the codon read from site i + 1 is secondCodon[c] (use -1 for
+  // codons which do not start a pair). Site i + 1 wraps to the first site.
+  // Returns false if this genome can not do this (first > last can be used
+  // to ask).
+  virtual bool findCodonPairs(const std::vector<int> &secondCodon, int codonMax,
+                              int first, int last, std::vector<int> &starts) {
+    return false;
+  }
+
+  // the bytes of everything in the genome that a brain could read (sites,
+  // alphabet size...), so that genomes with equal sitesBytes are identical to
+  // a brain (i.e. for brain caches). Empty means this genome type does not
+  // support it.
+  virtual std::string sitesBytes() { return ""; }
+
   virtual int countSites() {
     std::cout << "Warning! In AbstractGenome::countSites()...\n";
     return 0;
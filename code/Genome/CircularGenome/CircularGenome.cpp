@@ -10,8 +10,15 @@
 
 #include "CircularGenome.h"
 #include <Global.h>
+#include <Utilities/PackedSites.h>
 #include <cmath> // std::nextbefore
 #include <cfloat> // DBL_MAX
+#include <cstring> // std::memcpy
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 // Initialize Parameters
 std::shared_ptr<ParameterLink<int>> CircularGenomeParameters::sizeInitialPL = Parameters::register_parameter("GENOME_CIRCULAR-sizeInitial", 5000, "starting size for genome");
@@ -36,6 +43,25 @@ std::shared_ptr<ParameterLink<double>> CircularGenomeParameters::mutationPointOf
 std::shared_ptr<ParameterLink<double>> CircularGenomeParameters::mutationPointOffsetRangePL = Parameters::register_parameter("GENOME_CIRCULAR-mutationPointOffsetRange", 1.0, "range of PointOffset mutation");
 std::shared_ptr<ParameterLink<bool>> CircularGenomeParameters::mutationPointOffsetUniformPL = Parameters::register_parameter("GENOME_CIRCULAR-mutationPointOffsetUniform", true, "if true, offset will be from a uniform distribution, if false, from a normal distribution (where mean is 0 and std_dev is mutationPointOffsetRange)");
 
+CircularGenomeParameters::MutationValues::MutationValues(const std::shared_ptr<ParametersTable>& PT)
+	: pointRate(mutationPointRatePL, PT), pointOffsetRate(mutationPointOffsetRatePL, PT),
+	  pointOffsetRange(mutationPointOffsetRangePL, PT), pointOffsetUniform(mutationPointOffsetUniformPL, PT),
+	  copyRate(mutationCopyRatePL, PT), copyMinSize(mutationCopyMinSizePL, PT), copyMaxSize(mutationCopyMaxSizePL, PT),
+	  deleteRate(mutationDeleteRatePL, PT), deleteMinSize(mutationDeleteMinSizePL, PT), deleteMaxSize(mutationDeleteMaxSizePL, PT),
+	  sizeMax(sizeMaxPL, PT), sizeMin(sizeMinPL, PT), crossCount(mutationCrossCountPL, PT),
+	  indelRate(mutationIndelRatePL, PT), indelMinSize(mutationIndelMinSizePL, PT), indelMaxSize(mutationIndelMaxSizePL, PT),
+	  indelInsertMethod(mutationIndelInsertMethodPL, PT), indelCopyFirst(mutationIndelCopyFirstPL, PT) {}
+
+std::shared_ptr<const CircularGenomeParameters::MutationValues> CircularGenomeParameters::getMutationValues(const std::shared_ptr<ParametersTable>& PT) {
+	static std::mutex valuesMutex;
+	static std::map<long long, std::shared_ptr<const MutationValues>> valuesByTable;
+	std::lock_guard<std::mutex> lock(valuesMutex);
+	auto& values = valuesByTable[PT->getID()];
+	if (values == nullptr) {
+		values = std::make_shared<const MutationValues>(PT);
+	}
+	return values;
+}
 
 // constructor
 template<class T>
@@ -220,6 +246,7 @@ void CircularGenome<T>::Handler::writeInt(int value, int valueMin, int valueMax)
 		writeValueBase = (int)((double)writeValueBase / genome->alphabetSize);
 	}
 	decomposedValue.push_back(value);
+	genome->sitesChanged();
 	while ((int)decomposedValue.size() > 0) {  // starting with the last element in decomposedValue, copy into genome.
 		genome->sites[siteIndex] = decomposedValue[(int)decomposedValue.size() - 1];
 		advanceIndex();
@@ -242,6 +269,7 @@ void CircularGenome<double>::Handler::writeInt(int value, int valueMin, int valu
 	//	cout << "ERROR : attempting to write value to <double> Circular Genome. \n value is too large!" << endl;
 	//	exit(1);
 	//}
+	genome->sitesChanged();
 	genome->sites[siteIndex] = (((double)(value - valueMin) / (double)(valueMax - valueMin)) * genome->alphabetSize);
 	advanceIndex();
 }
@@ -264,6 +292,7 @@ void CircularGenome<T>::Handler::writeDouble(double value, double valueMin, doub
 	//std::cout << value << "   " << valueMax << "   " << valueMin << " = ";
 	value = ((value - valueMin) / (valueMax - valueMin)) * (genome->alphabetSize - 1.0);
 	//std::cout << value << std::endl;
+	genome->sitesChanged();
 	genome->sites[siteIndex] = (T)value;
 	advanceIndex();
 }
@@ -280,11 +309,20 @@ void CircularGenome<double>::Handler::writeDouble(double value, double valueMin,
 		exit(1);
 	}
 	value = ((value - valueMin) / (valueMax - valueMin)) * genome->alphabetSize;
+	genome->sitesChanged();
 	genome->sites[siteIndex] = value;
 	advanceIndex();
 }
 
 
+template<class T>
+bool CircularGenome<T>::Handler::setSiteIndex(int index) {
+	siteIndex = index;
+	resetEOG();
+	modulateIndex();
+	return true;
+}
+
 template<class T>
 std::shared_ptr<AbstractGenome::Handler> CircularGenome<T>::Handler::makeCopy() {
 	auto newGenomeHandler = std::make_shared<CircularGenome<T>::Handler>(genome, readDirection);
@@ -457,18 +495,21 @@ double CircularGenome<T>::getAlphabetSize() {
 // randomize this genomes contents
 template<class T>
 void CircularGenome<T>::fillRandom() {
+	sitesChanged();
 	for (size_t i = 0; i < sites.size(); i++) {
 		sites[i] = (T) Random::getDouble(alphabetSize);
 	}
 }
 
 template<> inline void CircularGenome<double>::fillRandom() {
+	sitesChanged();
 	for (size_t i = 0; i < sites.size(); i++) {
 		sites[i] = Random::getDouble(0, alphabetSize);
 	}
 }
 
 template<> inline void CircularGenome<bool>::fillRandom() {
+	sitesChanged();
 	for (size_t i = 0; i < sites.size(); i++) {
 		sites[i] = (bool)((int)Random::getDouble(alphabetSize));
 	}
@@ -478,6 +519,7 @@ template<> inline void CircularGenome<bool>::fillRandom() {
 // This function is to make testing easy.
 template<class T>
 void CircularGenome<T>::fillAcending() {
+	sitesChanged();
 	for (size_t i = 0; i < sites.size(); i++) {
 		sites[i] = ((int)i) % (int) alphabetSize;
 	}
@@ -488,6 +530,7 @@ void CircularGenome<T>::fillAcending() {
 // This function is to make testing easy.
 template<class T>
 void CircularGenome<T>::fillConstant(int value) {
+	sitesChanged();
 	for (size_t i = 0; i < sites.size(); i++) {
 		sites[i] = value;
 	}
@@ -500,6 +543,9 @@ void CircularGenome<T>::fillConstant(int value) {
 template<class T>
 void CircularGenome<T>::copyFrom(std::shared_ptr<AbstractGenome> from) {
 	auto castFrom = std::dynamic_pointer_cast<CircularGenome<T>>(from);  // we will be pulling all sorts of stuff from this genome so lets just cast it once.
+	sitesChanged();
+	editBase = from;
+	editBaseVersion = castFrom->sitesVersion;
 	alphabetSize = castFrom->alphabetSize;
 	sites.clear();
 	for (auto site : castFrom->sites) {
@@ -519,6 +565,100 @@ int CircularGenome<T>::countSites() {
 	return (int)sites.size();
 }
 
+template<class T>
+std::string CircularGenome<T>::sitesBytes() {
+	std::string bytes(reinterpret_cast<const char*>(&alphabetSize), sizeof(alphabetSize));
+	bytes.reserve(sizeof(alphabetSize) + sites.size() * sizeof(T));
+	if constexpr (std::is_same<T, bool>::value) { // vector<bool> has no data()
+		for (bool site : sites) {
+			bytes += static_cast<char>(site);
+		}
+	} else {
+		bytes.append(reinterpret_cast<const char*>(sites.data()), sites.size() * sizeof(T));
+	}
+	return bytes;
+}
+
+// the codon Handler::readInt(0, codonMax) returns for site, if it reads one site
+template<class T>
+static inline int siteCodon(T site, double alphabetSize, int codonMax) {
+	return (int)site % (codonMax + 1);
+}
+
+static inline int siteCodon(double site, double alphabetSize, int codonMax) {
+	return (int)((site / alphabetSize) * (codonMax + 1));
+}
+
+template<class T>
+static void findCodonPairsInSites(const std::vector<T> &sites, double alphabetSize, int codonMax, const std::vector<int> &secondCodon, int first, int last, std::vector<int> &starts) {
+	int size = (int)sites.size();
+	int nextCodon = siteCodon(sites[first], alphabetSize, codonMax);
+	for (int i = first; i <= last; i++) {
+		int codon = nextCodon;
+		nextCodon = siteCodon(sites[(i + 1) % size], alphabetSize, codonMax);
+		if (codon < (int)secondCodon.size() && secondCodon[codon] == nextCodon) {
+			starts.push_back(i);
+		}
+	}
+}
+
+// when every site is its own codon, 16 pairs of sites can be checked at once
+static void findCodonPairsInSites(const std::vector<unsigned char> &sites, double alphabetSize, int codonMax, const std::vector<int> &secondCodon, int first, int last, std::vector<int> &starts) {
+	int i = first;
+#if defined(__SSE2__)
+	if (codonMax + 1 == alphabetSize) {
+		std::vector<char> firstCodons, secondCodons;
+		for (int codon = 0; codon < (int)secondCodon.size() && codon <= codonMax; codon++) {
+			if (secondCodon[codon] >= 0 && secondCodon[codon] <= codonMax) {
+				firstCodons.push_back((char)codon);
+				secondCodons.push_back((char)secondCodon[codon]);
+			}
+		}
+		const unsigned char *data = sites.data();
+		// i + 16 <= (int)sites.size() - 1, so the second load does not wrap
+		for (; i + 16 <= last + 1 && i + 17 <= (int)sites.size(); i += 16) {
+			__m128i firstSites = _mm_loadu_si128((const __m128i *)(data + i));
+			__m128i secondSites = _mm_loadu_si128((const __m128i *)(data + i + 1));
+			int found = 0;
+			for (size_t pair = 0; pair < firstCodons.size(); pair++) {
+				found |= _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(firstSites, _mm_set1_epi8(firstCodons[pair])),
+				                                         _mm_cmpeq_epi8(secondSites, _mm_set1_epi8(secondCodons[pair]))));
+			}
+			for (int bit = 0; found != 0; bit++, found >>= 1) {
+				if (found & 1) {
+					starts.push_back(i + bit);
+				}
+			}
+		}
+	}
+#endif
+	if (i <= last) {
+		findCodonPairsInSites<unsigned char>(sites, alphabetSize, codonMax, secondCodon, i, last, starts);
+	}
+}
+
+template<class T>
+bool CircularGenome<T>::findCodonPairs(const std::vector<int> &secondCodon, int codonMax, int first, int last, std::vector<int> &starts) {
+	if (codonMax + 1 > alphabetSize) {  // readInt would read more then one site
+		return false;
+	}
+	first = std::max(first, 0);
+	last = std::min(last, (int)sites.size() - 1);
+	if (first <= last) {
+		findCodonPairsInSites(sites, alphabetSize, codonMax, secondCodon, first, last, starts);
+	}
+	return true;
+}
+
+template<class T>
+bool CircularGenome<T>::getEditsFrom(std::shared_ptr<AbstractGenome> base, int baseVersion, std::vector<AbstractGenome::SiteEdit> &_edits) {
+	if (base == nullptr || editBase.lock() != base || editBaseVersion != baseVersion) {
+		return false;
+	}
+	_edits = edits;
+	return true;
+}
+
 template<class T>
 bool CircularGenome<T>::isEmpty() {
 	//cout << "in Genome::isEmpty(): " << to_string(countSites() == 0) << " : " << to_string(countSites()) << endl;
@@ -537,12 +677,16 @@ bool CircularGenome<T>::isEmpty() {
 template<class T>
 void CircularGenome<T>::pointMutate(double range) {
 	if (range == -1) {
-		sites[Random::getIndex((int)sites.size())] = Random::getIndex((int)alphabetSize);
+		// the new value is drawn before the site (as in sites[getIndex()] = value)
+		auto newValue = Random::getIndex((int)alphabetSize);
+		int siteIndex = Random::getIndex((int)sites.size());
+		sites[siteIndex] = newValue;
+		recordEdit(siteIndex, 1, 1);
 	}
 	else {
 		int siteIndex = Random::getIndex((int)sites.size());
 		int offsetValue;
-		if (CircularGenomeParameters::mutationPointOffsetUniformPL->get(PT) == true) {
+		if (getMutationValues().pointOffsetUniform.get() == true) {
 			offsetValue = Random::getInt(1, range) * ((Random::getIndex(2) * 2.0) - 1.0);
 			// note! if range < 1 then all offsetValues will be 0, if range >= 1 offsetValues
 			// will always be either >= 1 or <= -1
@@ -551,19 +695,24 @@ void CircularGenome<T>::pointMutate(double range) {
 			offsetValue = (int)Random::getNormal(0, range);
 		}
 		sites[siteIndex] = std::max(0, std::min((int)alphabetSize - 1, sites[siteIndex] + offsetValue));
+		recordEdit(siteIndex, 1, 1);
 	}
 }
 
 template<>
 void CircularGenome<double>::pointMutate(double range) {
 	if (range == -1) {
-		sites[Random::getIndex((int)sites.size())] = Random::getDouble(alphabetSize);
+		// the new value is drawn before the site (as in sites[getIndex()] = value)
+		auto newValue = Random::getDouble(alphabetSize);
+		int siteIndex = Random::getIndex((int)sites.size());
+		sites[siteIndex] = newValue;
+		recordEdit(siteIndex, 1, 1);
 	}
 	else {
 		int siteIndex = Random::getIndex((int)sites.size());
 		bool pointOffsetUniform = false;
 		double offsetValue;
-		if (CircularGenomeParameters::mutationPointOffsetUniformPL->get(PT) == true) {
+		if (getMutationValues().pointOffsetUniform.get() == true) {
 			offsetValue = Random::getDouble(-range, range);
 		}
 		else { //normal/gaussian
@@ -571,6 +720,7 @@ void CircularGenome<double>::pointMutate(double range) {
 		}
 		double maxValue = alphabetSize - (std::nextafter(alphabetSize, DBL_MAX) - alphabetSize); // next smallest double value for alphabetSize
 		sites[siteIndex] = std::max(0.0, std::min(maxValue, sites[siteIndex] + (offsetValue)));
+		recordEdit(siteIndex, 1, 1);
 	}
 }
 
@@ -602,26 +752,28 @@ int CircularGenome<T>::incrementIndel() {
 // apply mutations to this genome
 template<class T>
 void CircularGenome<T>::mutate() {
-	int howManyPoint = Random::getBinomial((int)sites.size(), CircularGenomeParameters::mutationPointRatePL->get(PT));
-	int howManyPointOffset = Random::getBinomial((int)sites.size(), CircularGenomeParameters::mutationPointOffsetRatePL->get(PT));
-	int howManyCopy = Random::getBinomial((int)sites.size(), CircularGenomeParameters::mutationCopyRatePL->get(PT));
-	int howManyDelete = Random::getBinomial((int)sites.size(), CircularGenomeParameters::mutationDeleteRatePL->get(PT));
-	int howManyIndel = Random::getBinomial((int)sites.size(), CircularGenomeParameters::mutationIndelRatePL->get(PT));
+	const auto& values = getMutationValues();
+	int howManyPoint = Random::getBinomial((int)sites.size(), values.pointRate.get());
+	int howManyPointOffset = Random::getBinomial((int)sites.size(), values.pointOffsetRate.get());
+	int howManyCopy = Random::getBinomial((int)sites.size(), values.copyRate.get());
+	int howManyDelete = Random::getBinomial((int)sites.size(), values.deleteRate.get());
+	int howManyIndel = Random::getBinomial((int)sites.size(), values.indelRate.get());
+	sitesVersion++;
 	// do some point mutations
 	for (int i = 0; i < howManyPoint; i++) {
 		pointMutate();
 		incrementPoint();
 	}
 	// do some pointOffset mutations
-	double pointOffsetRange = CircularGenomeParameters::mutationPointOffsetRangePL->get(PT);
+	double pointOffsetRange = values.pointOffsetRange.get();
 	for (int i = 0; i < howManyPointOffset; i++) {
 		pointMutate(pointOffsetRange);
 		incrementPointOffset();
 	}
 	// do some copy mutations
-	int MaxGenomeSize = CircularGenomeParameters::sizeMaxPL->get(PT);
-	int IMax = CircularGenomeParameters::mutationCopyMaxSizePL->get(PT);
-	int IMin = CircularGenomeParameters::mutationCopyMinSizePL->get(PT);
+	int MaxGenomeSize = values.sizeMax.get();
+	int IMax = values.copyMaxSize.get();
+	int IMin = values.copyMinSize.get();
 	for (int i = 0; (i < howManyCopy) && (((int)sites.size()) < MaxGenomeSize); i++) {
 		//chromosome->mutateCopy(PT.lookup("mutationCopyMinSize"), PT.lookup("mutationCopyMaxSize"), PT.lookup("chromosomeSizeMax"));
 
@@ -643,16 +795,18 @@ void CircularGenome<T>::mutate() {
 
 		////insertSegment(segment);
 		it = sites.begin();
-		sites.insert(it + Random::getInt((int)sites.size()), segment.begin(), segment.end());
+		int insertStart = Random::getInt((int)sites.size());
+		sites.insert(it + insertStart, segment.begin(), segment.end());
+		recordEdit(insertStart, 0, segmentSize);
 
 		//cout << sites.size() << endl;
 
 		incrementCopy();
 	}
 	// do some deletion mutations
-	int MinGenomeSize = CircularGenomeParameters::sizeMinPL->get(PT);
-	int DMax = CircularGenomeParameters::mutationDeleteMaxSizePL->get(PT);
-	int DMin = CircularGenomeParameters::mutationDeleteMinSizePL->get(PT);
+	int MinGenomeSize = values.sizeMin.get();
+	int DMax = values.deleteMaxSize.get();
+	int DMin = values.deleteMinSize.get();
 	for (int i = 0; (i < howManyDelete) && (((int)sites.size()) > MinGenomeSize); i++) {
 		//chromosome->mutateDelete(PT.lookup("mutationDeletionMinSize"), PT.lookup("mutationDeletionMaxSize"), PT.lookup("chromosomeSizeMin"));
 
@@ -666,14 +820,15 @@ void CircularGenome<T>::mutate() {
 		}
 		int segmentStart = Random::getInt(((int)sites.size()) - segmentSize);
 		sites.erase(sites.begin() + segmentStart, sites.begin() + segmentStart + segmentSize);
+		recordEdit(segmentStart, segmentSize, 0);
 
 		incrementDelete();
 	}
 	// do some combination insertion-deletion (indel) mutations
-	int IDMax = CircularGenomeParameters::mutationIndelMaxSizePL->get(PT);
-	int IDMin = CircularGenomeParameters::mutationIndelMinSizePL->get(PT);
-	bool copyFirst = CircularGenomeParameters::mutationIndelCopyFirstPL->get(PT);
-	int insertMethod = CircularGenomeParameters::mutationIndelInsertMethodPL->get(PT);
+	int IDMax = values.indelMaxSize.get();
+	int IDMin = values.indelMinSize.get();
+	bool copyFirst = values.indelCopyFirst.get();
+	int insertMethod = values.indelInsertMethod.get();
 
 	for (int i = 0; i < howManyIndel; i++) {
 
@@ -712,6 +867,7 @@ void CircularGenome<T>::mutate() {
 
 			// delete a portion of the genome of the same size
 			sites.erase(it + deleteStart, it + deleteStart + segmentSize);
+			recordEdit(deleteStart, segmentSize, 0);
 
 /*
 			std::cout << "\ngenome after delete: ";
@@ -722,11 +878,14 @@ void CircularGenome<T>::mutate() {
 			// insert the copied sites back into genome
 			if (insertMethod == 0) {
 				// copy to random location
-				sites.insert(it + Random::getInt((int)sites.size()), segment.begin(), segment.end());
+				int insertStart = Random::getInt((int)sites.size());
+				sites.insert(it + insertStart, segment.begin(), segment.end());
+				recordEdit(insertStart, 0, segmentSize);
 			}
 			else if (insertMethod == 1) {
 				// replace deleted segment
 				sites.insert(it + deleteStart, segment.begin(), segment.end());
+				recordEdit(deleteStart, 0, segmentSize);
 			}
 			else if (insertMethod == 2) {
 				// insert segment just in front of copied sites
@@ -734,6 +893,7 @@ void CircularGenome<T>::mutate() {
 					segmentStart -= deleteStart;  // but no matter what we do, it's going to be weird...
 				}
 				sites.insert(it + segmentStart, segment.begin(), segment.end());
+				recordEdit(segmentStart, 0, segmentSize);
 			}
 /*
 			std::cout << "\ngenome after insert: ";
@@ -747,6 +907,7 @@ void CircularGenome<T>::mutate() {
 			// delete a portion of the genome
 			int deleteStart = Random::getInt((int)sites.size() - segmentSize); // where to delete from
 			sites.erase(it + deleteStart, it + deleteStart + segmentSize);
+			recordEdit(deleteStart, segmentSize, 0);
 
             if (segmentSize > sites.size()){
                 std::cout << "ERROR: in curlarGenome<T>::mutate(), segmentSize for indel is > then sites.size() after deletion!\nUse a larger genome relitive to Indel min/max.\nExiting!" << std::endl;
@@ -761,15 +922,19 @@ void CircularGenome<T>::mutate() {
 			// insert the copied sites back into genome
 			if (insertMethod == 0) {
 				// copy to random location
-				sites.insert(it + Random::getInt((int)sites.size()), segment.begin(), segment.end());
+				int insertStart = Random::getInt((int)sites.size());
+				sites.insert(it + insertStart, segment.begin(), segment.end());
+				recordEdit(insertStart, 0, segmentSize);
 			}
 			else if (insertMethod == 1) {
 				// replace deleted segment
 				sites.insert(it + deleteStart, segment.begin(), segment.end());
+				recordEdit(deleteStart, 0, segmentSize);
 			}
 			else if (insertMethod == 2) {
 				// insert segment just in front of copied sites
 				sites.insert(it + segmentStart, segment.begin(), segment.end());
+				recordEdit(segmentStart, 0, segmentSize);
 			}
 		}
 		incrementIndel();
@@ -781,6 +946,7 @@ void CircularGenome<T>::mutate() {
 template<class T>
 std::shared_ptr<AbstractGenome> CircularGenome<T>::makeMutatedGenomeFrom(std::shared_ptr<AbstractGenome> parent) {
 	auto newGenome = std::make_shared<CircularGenome<T>>(PT);
+	newGenome->mutationValues = mutationValues;
 	newGenome->copyFrom(parent);
     newGenome->mutate();
 	newGenome->recordDataMap();
@@ -801,6 +967,7 @@ std::shared_ptr<AbstractGenome> CircularGenome<T>::makeMutatedGenomeFromMany(std
 	auto castParent0 = std::dynamic_pointer_cast<CircularGenome<T>>(parents[0]);  // we will be pulling all sorts of stuff from this genome so lets just cast it once.
 
 	auto newGenome = std::make_shared<CircularGenome<T>>(castParent0->alphabetSize,0,PT);
+	newGenome->mutationValues = mutationValues;
 	//newGenome->alphabetSize = castParent0->alphabetSize;
 
 //	vector<std::shared_ptr<AbstractChromosome>> parentChromosomes;
@@ -828,7 +995,7 @@ std::shared_ptr<AbstractGenome> CircularGenome<T>::makeMutatedGenomeFromMany(std
 
 		// randomly determine crossCount number crossLocations
 		std::vector<double> crossLocations;
-		int crossCount = CircularGenomeParameters::mutationCrossCountPL->get(PT);
+		int crossCount = newGenome->getMutationValues().crossCount.get(); // (parents are only read)
 		for (int i = 0; i < crossCount; i++) {  // get some cross locations (% of length of chromosome)
 			crossLocations.push_back(Random::getDouble(1.0));
 		}
@@ -893,6 +1060,59 @@ DataMap CircularGenome<T>::serialize(std::string& name) {
 	return serialDataMap;
 }
 
+template<class T>
+DataMap CircularGenome<T>::serializePacked(std::string& name) {
+	DataMap serialDataMap;
+	serialDataMap.set(name + "_genomeLength", countSites());
+	std::string packed;
+	uint32_t count = static_cast<uint32_t>(sites.size());
+	packed.reserve(4 + sites.size() * sizeof(T));
+	for (int i = 0; i < 4; i++) {
+		packed += static_cast<char>((count >> (8 * i)) & 0xff);
+	}
+	if constexpr (std::is_same<T, bool>::value) { // vector<bool> has no data()
+		for (bool site : sites) {
+			packed += static_cast<char>(site);
+		}
+	} else {
+		packed.append(reinterpret_cast<const char*>(sites.data()), sites.size() * sizeof(T));
+	}
+	serialDataMap.set(name + PackedSites::packedSuffix, packed);
+	return serialDataMap;
+}
+
+template<class T>
+bool CircularGenome<T>::deserializePacked(std::unordered_map<std::string, std::string>& orgData, std::string& name) {
+	const std::string& reference = orgData[name + "_sites"];
+	if (!PackedSites::isReference(reference)) {
+		return false;
+	}
+	if (orgData.find("loadedFrom.File") == orgData.end()) {
+		std::cout << "  In CircularGenome<T>::deserialize :: " + name + "_sites is packed, but the organism file it came from is not known.\n  exiting" << std::endl;
+		exit(1);
+	}
+	std::string packed = PackedSites::read(orgData["loadedFrom.File"], reference);
+	uint32_t count = 0;
+	for (int i = 0; i < 4 && i < static_cast<int>(packed.size()); i++) {
+		count |= static_cast<uint32_t>(static_cast<unsigned char>(packed[i])) << (8 * i);
+	}
+	size_t siteBytes = std::is_same<T, bool>::value ? 1 : sizeof(T);
+	if (packed.size() < 4 || packed.size() != 4 + count * siteBytes) {
+		std::cout << "  In CircularGenome<T>::deserialize :: the packed " + name + "_sites are not the right size for this type of genome.\n  exiting" << std::endl;
+		exit(1);
+	}
+	sitesChanged();
+	sites.resize(count);
+	if constexpr (std::is_same<T, bool>::value) {
+		for (uint32_t i = 0; i < count; i++) {
+			sites[i] = packed[4 + i] != 0;
+		}
+	} else {
+		std::memcpy(sites.data(), packed.data() + 4, count * sizeof(T));
+	}
+	return true;
+}
+
 // given a DataMap and PT, return genome [name] from the DataMap
 template<class T>
 void CircularGenome<T>::deserialize(std::shared_ptr<ParametersTable> PT, std::unordered_map<std::string, std::string>& orgData, std::string& name) {
@@ -904,6 +1124,9 @@ void CircularGenome<T>::deserialize(std::shared_ptr<ParametersTable> PT, std::un
 		std::cout << "  In CircularGenome<T>::deserialize :: can not find either " + name + "_sites or " + name + "_genomeLength.\n  exiting" << std::endl;
 		exit(1);
 	}
+	if (deserializePacked(orgData, name)) {
+		return;
+	}
 	int genomeLength;
 	convertString(orgData[name + "_genomeLength"], genomeLength);
 
@@ -911,6 +1134,7 @@ void CircularGenome<T>::deserialize(std::shared_ptr<ParametersTable> PT, std::un
 	std::stringstream ss(allSites);
 
   bool streamNotEmpty(true);
+	sitesChanged();
 	sites.clear();
   streamNotEmpty = static_cast<bool>(ss >> nextChar);
 	for (int i = 0; i < genomeLength; i++) {
@@ -933,16 +1157,20 @@ void CircularGenome<unsigned char>::deserialize(std::shared_ptr<ParametersTable>
 	std::string nextString;
 	int value;
 	// make sure that data has needed columns
-	if (orgData.find("GENOME_" + name + "_sites") == orgData.end() || orgData.find("GENOME_" + name + "_genomeLength") == orgData.end()) {
-		std::cout << "  In CircularGenome<T>::deserialize :: can not find either GENOME_" + name + "_sites or GENOME_" + name + "_genomeLength.\n  exiting" << std::endl;
+	if (orgData.find(name + "_sites") == orgData.end() || orgData.find(name + "_genomeLength") == orgData.end()) {
+		std::cout << "  In CircularGenome<T>::deserialize :: can not find either " + name + "_sites or " + name + "_genomeLength.\n  exiting" << std::endl;
 		exit(1);
 	}
+	if (deserializePacked(orgData, name)) {
+		return;
+	}
 	int genomeLength;
-	convertString(orgData["GENOME_" + name + "_genomeLength"], genomeLength);
+	convertString(orgData[name + "_genomeLength"], genomeLength);
 
-	std::string allSites = orgData["GENOME_" + name + "_sites"];
+	std::string allSites = orgData[name + "_sites"];
 	std::stringstream ss(allSites);
 
+	sitesChanged();
 	sites.clear();
   bool streamNotEmpty(true);
   streamNotEmpty = static_cast<bool>(ss >> nextChar);
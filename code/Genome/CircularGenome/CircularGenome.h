@@ -49,6 +49,23 @@ public:
 	static std::shared_ptr<ParameterLink<int>> mutationIndelInsertMethodPL;
 	static std::shared_ptr<ParameterLink<bool>> mutationIndelCopyFirstPL;
 
+	// the parameters read while mutating, bound for one ParametersTable
+	struct MutationValues {
+		ParameterValue<double> pointRate, pointOffsetRate, pointOffsetRange;
+		ParameterValue<bool> pointOffsetUniform;
+		ParameterValue<double> copyRate;
+		ParameterValue<int> copyMinSize, copyMaxSize;
+		ParameterValue<double> deleteRate;
+		ParameterValue<int> deleteMinSize, deleteMaxSize;
+		ParameterValue<int> sizeMax, sizeMin, crossCount;
+		ParameterValue<double> indelRate;
+		ParameterValue<int> indelMinSize, indelMaxSize, indelInsertMethod;
+		ParameterValue<bool> indelCopyFirst;
+
+		MutationValues(const std::shared_ptr<ParametersTable>& PT);
+	};
+	// bound once for each table and then shared
+	static std::shared_ptr<const MutationValues> getMutationValues(const std::shared_ptr<ParametersTable>& PT);
 };
 
 template<class T>
@@ -107,11 +124,39 @@ public:
 		virtual void randomize() override;
 		virtual std::vector<std::vector<int>> readTable(std::pair<int, int> tableSize, std::pair<int, int> tableMaxSize, std::pair<int, int> valueRange, int code = -1, int CodingRegionIndex = 0) override;
 
+		virtual int getSiteIndex() override { return siteIndex; }
+		virtual bool setSiteIndex(int index) override;
+
 	};
 
 	std::vector<T> sites;
 	double alphabetSize;
 
+	// mutate() records what it changes in edits, so that a brain made from
+	// editBase (at editBaseVersion) can be updated rather than rebuilt (see
+	// getEditsFrom). Any other change to sites must call sitesChanged().
+	int sitesVersion = 0;
+	std::weak_ptr<AbstractGenome> editBase;
+	int editBaseVersion = 0;
+	std::vector<AbstractGenome::SiteEdit> edits;
+	void sitesChanged() {
+		sitesVersion++;
+		editBase.reset();
+		edits.clear();
+	}
+	void recordEdit(int position, int removed, int inserted) {
+		edits.push_back({ position, removed, inserted });
+	}
+
+	// mutation parameters for PT (offspring made with the same PT share them)
+	std::shared_ptr<const CircularGenomeParameters::MutationValues> mutationValues;
+	const CircularGenomeParameters::MutationValues& getMutationValues() {
+		if (mutationValues == nullptr) {
+			mutationValues = CircularGenomeParameters::getMutationValues(PT);
+		}
+		return *mutationValues;
+	}
+
 	CircularGenome() = delete;
 
 	CircularGenome(std::shared_ptr<ParametersTable> PT_) : AbstractGenome(PT_) {
@@ -161,6 +206,12 @@ public:
 
 	virtual int countSites();
 
+	virtual std::string sitesBytes() override;
+
+	virtual bool getEditsFrom(std::shared_ptr<AbstractGenome> base, int baseVersion, std::vector<AbstractGenome::SiteEdit> &_edits) override;
+	virtual int getSitesVersion() override { return sitesVersion; }
+	virtual bool findCodonPairs(const std::vector<int> &secondCodon, int codonMax, int first, int last, std::vector<int> &starts) override;
+
 	virtual bool isEmpty() override;
 
 	virtual void pointMutate(double range = -1);
@@ -205,7 +256,13 @@ public:
 	}
 
 	virtual DataMap serialize(std::string& name) override;
+	// the sites packed as a uint32 site count and then the bytes of each site
+	// (in the byte order of the machine)
+	virtual DataMap serializePacked(std::string& name) override;
 	virtual void deserialize(std::shared_ptr<ParametersTable> PT, std::unordered_map<std::string, std::string>& orgData, std::string& name) override;
+	// if orgData has a PackedSites reference for the sites, load them from it
+	// and return true
+	bool deserializePacked(std::unordered_map<std::string, std::string>& orgData, std::string& name);
 
 	virtual void recordDataMap() override;
 
@@ -28,7 +28,9 @@ std::shared_ptr<ParameterLink<std::string>> Global::initPopPL =
 std::shared_ptr<ParameterLink<std::string>> Global::modePL =
     Parameters::register_parameter(
         "GLOBAL-mode", std::string("run"),
-        "mode to run MABE in [run,visualize,analyze]");
+        "mode to run MABE in [run,visualize,analyze,steadyState]\n"
+        "steadyState evolves without generations (see STEADY_STATE-*), "
+        "worlds must provide evaluateSolo");
 
 std::shared_ptr<ParameterLink<int>> Global::maxLineLengthPL =
     Parameters::register_parameter("PARAMETER_FILES-maxLineLength", 160,
@@ -41,6 +43,26 @@ std::shared_ptr<ParameterLink<std::string>> Global::outputPrefixPL =
     Parameters::register_parameter(
         "GLOBAL-outputPrefix", std::string("./"),
         "Directory and prefix specifying where data files will be written");
+std::shared_ptr<ParameterLink<bool>> Global::bufferedOutputPL =
+    Parameters::register_parameter(
+        "GLOBAL-bufferedOutput", false,
+        "if true, data files are buffered and written by a background thread. "
+        "Files are only sure to be complete after archivists flush and when "
+        "MABE exits");
+std::shared_ptr<ParameterLink<int>> Global::outputBufferSizePL =
+    Parameters::register_parameter(
+        "GLOBAL-outputBufferSize", 1024,
+        "if bufferedOutput, KB of data held for each file before it is written");
+std::shared_ptr<ParameterLink<bool>> Global::columnarCompressionPL =
+    Parameters::register_parameter(
+        "GLOBAL-columnarCompression", true,
+        "if true, columnar data files (see ARCHIVIST-outputFormat) are written "
+        "with bit packed bools, delta encoded ints and varint string lengths");
+std::shared_ptr<ParameterLink<int>> Global::columnarRowGroupSizePL =
+    Parameters::register_parameter(
+        "GLOBAL-columnarRowGroupSize", 1000,
+        "rows in each row group of a columnar data file. A row group only ends "
+        "between updates, so it may hold more rows than this");
 
 // shared_ptr<ParameterLink<string>> Global::groupNameSpacesPL =
 // Parameters::register_parameter("GLOBAL-groups", (string) "[]", "name spaces
@@ -54,5 +76,5 @@ std::shared_ptr<ParameterLink<std::string>> Global::outputPrefixPL =
 // Parameters::register_parameter("BRAIN-bitsPerCodon", 8, "how many bits are
 // evaluated to determine the codon addresses");
 
-int Global::update = 0;
+std::atomic<int> Global::update{0};
 
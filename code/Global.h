@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <set>
@@ -41,6 +42,14 @@ public:
 
   static std::shared_ptr<ParameterLink<std::string>>
       outputPrefixPL; // where files will be written
+  static std::shared_ptr<ParameterLink<bool>>
+      bufferedOutputPL; // write data files from a background thread
+  static std::shared_ptr<ParameterLink<int>>
+      outputBufferSizePL; // KB held for each file before it is written
+  static std::shared_ptr<ParameterLink<bool>>
+      columnarCompressionPL; // compress columnar data files
+  static std::shared_ptr<ParameterLink<int>>
+      columnarRowGroupSizePL; // rows in a columnar data file row group
 
   // static shared_ptr<ParameterLink<string>> groupNameSpacesPL;
 
@@ -53,6 +62,8 @@ public:
   // Below are non configurable values (not set directly by Parameters.h
   // methods)
   //////////
-  static int update; // the current "time"
+  // the current "time". Atomic because in steadyState mode it is advanced
+  // while other threads are evaluating organisms (see Group/SteadyState.h)
+  static std::atomic<int> update;
 };
 
@@ -19,11 +19,19 @@ Group::Group(std::vector<std::shared_ptr<Organism>> _population,
   population = std::move(_population);
   optimizer = std::move(_optimizer);
   archivist = std::move(_archivist);
+  populationTable = optimizer->populationTable;
+  archivist->populationTable = populationTable;
 }
 
 Group::~Group() {}
 
-bool Group::archive(int flush) { return archivist->archive(population, flush); }
+bool Group::archive(int flush) {
+  bool finished = archivist->archive(population, flush);
+  if (flush) {
+    FileManager::flush(); // make sure buffered data is on disk
+  }
+  return finished;
+}
 
 void Group::optimize() { optimizer->optimize(population); }
 
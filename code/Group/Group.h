@@ -21,6 +21,8 @@ public:
   std::shared_ptr<Organism> templateOrg;
   std::shared_ptr<DefaultArchivist> archivist;
   std::shared_ptr<AbstractOptimizer> optimizer;
+  // columns of population data read by the optimizer and the archivist
+  std::shared_ptr<PopulationTable> populationTable;
 
   Group();
   Group(std::vector<std::shared_ptr<Organism>> _population,
@@ -0,0 +1,253 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+#include "SteadyState.h"
+
+#include <Utilities/Random.h>
+#include <Utilities/ThreadPool.h>
+
+std::shared_ptr<ParameterLink<int>> SteadyState::threadsPL =
+    Parameters::register_parameter(
+        "STEADY_STATE-threads", 1,
+        "(steadyState mode) number of threads making and evaluating offspring. "
+        "0 = use all available cores. With more than 1 thread, results depend "
+        "on the order evaluations finish in");
+std::shared_ptr<ParameterLink<int>> SteadyState::birthsPerUpdatePL =
+    Parameters::register_parameter(
+        "STEADY_STATE-birthsPerUpdate", -1,
+        "(steadyState mode) number of offspring inserted into the population "
+        "per update (the archivist is run at the end of each update). -1 = "
+        "population size");
+std::shared_ptr<ParameterLink<std::string>> SteadyState::optimizeValuePL =
+    Parameters::register_parameter(
+        "STEADY_STATE-optimizeValue", std::string("DM_AVE[score]"),
+        "(steadyState mode) value to optimize (MTree), saved to each "
+        "organism's dataMap as optimizeValue");
+std::shared_ptr<ParameterLink<int>> SteadyState::tournamentSizePL =
+    Parameters::register_parameter(
+        "STEADY_STATE-tournamentSize", 5,
+        "(steadyState mode) each parent is the highest scoring of this many "
+        "random organisms");
+std::shared_ptr<ParameterLink<int>> SteadyState::replaceTournamentSizePL =
+    Parameters::register_parameter(
+        "STEADY_STATE-replaceTournamentSize", 2,
+        "(steadyState mode) each offspring replaces the lowest scoring of this "
+        "many random organisms (1 = replace a random organism)");
+std::shared_ptr<ParameterLink<int>> SteadyState::numberParentsPL =
+    Parameters::register_parameter(
+        "STEADY_STATE-numberParents", 1,
+        "(steadyState mode) number of parents of each offspring");
+
+const std::vector<std::string> SteadyState::popFileColumns = {"optimizeValue"};
+
+SteadyState::SteadyState(std::shared_ptr<AbstractWorld> _world,
+                         std::map<std::string, std::shared_ptr<Group>> &groups)
+    : world(std::move(_world)) {
+  if (groups.size() != 1) {
+    std::cout << "  ERROR :: steadyState mode can only be used with worlds "
+                 "which use one group, but this world uses "
+              << groups.size() << ".\n  Exiting." << std::endl;
+    exit(1);
+  }
+  group = groups.begin()->second;
+  auto PT = group->optimizer->PT;
+  threads = threadsPL->get(PT);
+  birthsPerUpdate = birthsPerUpdatePL->get(PT);
+  if (birthsPerUpdate == -1) {
+    birthsPerUpdate = static_cast<int>(group->population.size());
+  }
+  tournamentSize = tournamentSizePL->get(PT);
+  replaceTournamentSize = replaceTournamentSizePL->get(PT);
+  numberParents = numberParentsPL->get(PT);
+  if (birthsPerUpdate < 1 || tournamentSize < 1 || replaceTournamentSize < 1 ||
+      numberParents < 1) {
+    std::cout << "  ERROR :: STEADY_STATE-birthsPerUpdate, tournamentSize, "
+                 "replaceTournamentSize and numberParents must be at least 1."
+                 "\n  Exiting."
+              << std::endl;
+    exit(1);
+  }
+  optimizeValueProgram = MTreeProgram(stringToMTree(optimizeValuePL->get(PT)));
+}
+
+double SteadyState::scoreOf(const std::shared_ptr<Organism> &org) {
+  double score = optimizeValueProgram.evalFirst(org->dataMap, group->optimizer->PT);
+  org->dataMap.set("optimizeValue", score);
+  return score;
+}
+
+int SteadyState::selectParent() {
+  int popSize = static_cast<int>(scores.size());
+  int best = Random::getIndex(popSize);
+  for (int i = 1; i < tournamentSize; i++) {
+    int challenger = Random::getIndex(popSize);
+    if (scores[challenger] > scores[best]) {
+      best = challenger;
+    }
+  }
+  return best;
+}
+
+int SteadyState::selectReplaced() {
+  int popSize = static_cast<int>(scores.size());
+  int worst = Random::getIndex(popSize);
+  for (int i = 1; i < replaceTournamentSize; i++) {
+    int challenger = Random::getIndex(popSize);
+    if (scores[challenger] < scores[worst]) {
+      worst = challenger;
+    }
+  }
+  return worst;
+}
+
+void SteadyState::releaseParents(std::vector<std::shared_ptr<Organism>> &parents) {
+  for (auto const &parent : parents) {
+    if (--parentReaders[parent.get()] == 0) {
+      parentReaders.erase(parent.get());
+      if (killWhenRead.erase(parent)) {
+        parent->kill();
+      }
+    }
+  }
+  parents.clear();
+}
+
+bool SteadyState::insert(std::shared_ptr<Organism> &offspring) {
+  double score = scoreOf(offspring);
+  int replaced = selectReplaced();
+  auto &old = group->population[replaced];
+  if (parentReaders.count(old.get())) {
+    killWhenRead.insert(old);
+  } else {
+    old->kill();
+  }
+  old = offspring;
+  scores[replaced] = score;
+
+  if (++birthsThisUpdate == birthsPerUpdate) {
+    birthsThisUpdate = 0;
+    Global::update++;
+    return true;
+  }
+  return false;
+}
+
+void SteadyState::archiveUnlocked(std::unique_lock<std::mutex> &lock) {
+  archiving = true;
+  size_t next = 0;
+  bool archiveDue = true;
+  while (archiveDue) {
+    lock.unlock();
+    bool finished = archive();
+    lock.lock();
+    done = done || finished;
+    // insert what was queued, stopping if another update is completed
+    archiveDue = false;
+    while (!archiveDue && next < waitingInserts.size()) {
+      if (!done && !*stopFlag) {
+        archiveDue = insert(waitingInserts[next]);
+      }
+      waitingInserts[next++].reset();
+    }
+  }
+  waitingInserts.clear();
+  archiving = false;
+  archiveDone.notify_all();
+}
+
+bool SteadyState::archive() {
+  std::cout << "update: " << Global::update << "   max = "
+            << std::to_string(PopulationTable::max(scores))
+            << "   ave = " << std::to_string(PopulationTable::mean(scores))
+            << std::endl;
+  return group->archive();
+}
+
+void SteadyState::worker() {
+  std::vector<std::shared_ptr<Organism>> parents;
+  std::unordered_map<std::string, std::shared_ptr<AbstractGenome>> newGenomes;
+  std::unordered_map<std::string, std::shared_ptr<AbstractBrain>> newBrains;
+  std::shared_ptr<Organism> offspring;
+  while (true) {
+    int birth;
+    {
+      std::lock_guard<std::mutex> lock(populationMutex);
+      if (done || *stopFlag) {
+        done = true;
+        return;
+      }
+      birth = birthsStarted++;
+      for (int i = 0; i < numberParents; i++) {
+        parents.push_back(group->population[selectParent()]);
+        parentReaders[parents.back().get()]++;
+      }
+    }
+
+    // make the genomes and brains (this only reads the parents)
+    {
+      Random::StreamGenerator stream(Random::getStreamSeed("steadyState"), 0,
+                                     birth);
+      Random::ScopedStream useStream(stream);
+      if (numberParents == 1) {
+        parents[0]->makeMutatedPartsFrom(parents[0], newGenomes, newBrains);
+      } else {
+        parents[0]->makeMutatedPartsFromMany(parents, newGenomes, newBrains);
+      }
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(populationMutex);
+      archiveDone.wait(lock, [this] { return !archiving; });
+      if (numberParents == 1) {
+        offspring = std::make_shared<Organism>(parents[0], newGenomes, newBrains,
+                                               parents[0]->PT);
+      } else {
+        offspring = std::make_shared<Organism>(parents, newGenomes, newBrains,
+                                               parents[0]->PT);
+      }
+      releaseParents(parents);
+    }
+    newGenomes.clear();
+    newBrains.clear();
+
+    // evaluate, as evaluatePopulation would
+    {
+      Random::StreamGenerator orgStream(Random::getStreamSeed(),
+                                        offspring->timeOfBirth, offspring->ID);
+      Random::ScopedStream useOrgStream(orgStream);
+      world->evaluateSolo(offspring, 0, 0, 0);
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(populationMutex);
+      if (archiving) {
+        waitingInserts.push_back(offspring);
+      } else if (!done && !*stopFlag && insert(offspring)) {
+        archiveUnlocked(lock);
+      }
+      offspring.reset(); // (so that organisms are only deleted here)
+    }
+  }
+}
+
+void SteadyState::run(std::map<std::string, std::shared_ptr<Group>> &groups,
+                      const volatile std::sig_atomic_t &stop) {
+  stopFlag = &stop;
+
+  world->evaluate(groups, 0, 0, AbstractWorld::debugPL->get());
+  scores.clear();
+  for (auto const &org : group->population) {
+    scores.push_back(scoreOf(org));
+  }
+  done = archive();
+
+  ThreadPool workers(threads);
+  workers.parallelFor(workers.size(), [&](int) { worker(); });
+}
@@ -0,0 +1,124 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+// Steady state evolution (GLOBAL-mode = steadyState). There is no generational
+// barrier: each worker thread repeatedly selects parents from the population,
+// makes an offspring, evaluates it with the world's evaluateSolo, and then puts
+// it into the population in place of a poorly scoring organism. Workers only
+// wait for each other to select parents and to insert offspring, so a slow
+// evaluation does not hold up the other threads.
+//
+// For the archivist, an update is STEADY_STATE-birthsPerUpdate births. When an
+// update is complete Global::update is advanced and the group is archived by
+// whichever worker inserted the last offspring. populationMutex is not held
+// while the archivist runs: the other workers keep selecting parents, making
+// genomes and brains and evaluating, and offspring which are ready to be
+// inserted are queued and inserted when the archivist is done. Only making
+// organisms waits for the archivist (as this changes the parents). Organisms
+// are only put in the population once they have been evaluated, so the
+// archivist sees the same kind of population as in run mode.
+//
+// An offspring's timeOfBirth is the update in which it was made (read while
+// populationMutex is held). Its genomes and brains are made on the
+// "steadyState" stream keyed (seed, 0, birth index), where the birth index
+// counts births since the start of the run, and it is evaluated on the stream
+// keyed (timeOfBirth, ID). A world reading Global::update during evaluateSolo
+// sees the update in progress when it reads it, which may move on before the
+// evaluation is finished (worlds which need one value for a whole evaluation
+// should use org->timeOfBirth).
+//
+// With STEADY_STATE-threads = 1 runs are repeatable. With more threads, which
+// organisms are chosen depends on the order evaluations finish in.
+
+#pragma once
+
+#include <condition_variable>
+#include <csignal>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <Group/Group.h>
+#include <Utilities/MTreeProgram.h>
+#include <World/AbstractWorld.h>
+
+class SteadyState {
+public:
+  static std::shared_ptr<ParameterLink<int>> threadsPL;
+  static std::shared_ptr<ParameterLink<int>> birthsPerUpdatePL;
+  static std::shared_ptr<ParameterLink<std::string>> optimizeValuePL;
+  static std::shared_ptr<ParameterLink<int>> tournamentSizePL;
+  static std::shared_ptr<ParameterLink<int>> replaceTournamentSizePL;
+  static std::shared_ptr<ParameterLink<int>> numberParentsPL;
+
+  // the organism data set in this mode (used in place of the optimizer's
+  // popFileColumns, as the optimizer is never run)
+  static const std::vector<std::string> popFileColumns;
+
+protected: // (so that tests can reach the selection and insert steps)
+  std::shared_ptr<AbstractWorld> world;
+  std::shared_ptr<Group> group;
+
+  int threads;
+  int birthsPerUpdate;
+  int tournamentSize;
+  int replaceTournamentSize;
+  int numberParents;
+  MTreeProgram optimizeValueProgram;
+
+  // populationMutex guards the population and scores and the members below,
+  // and Global::update is only advanced while it is held. Organisms are only
+  // made, changed (other than by their own evaluation) and destroyed while it
+  // is held and archiving is false. While archiving is true, the population,
+  // scores and Global::update do not change.
+  std::mutex populationMutex;
+  std::vector<double> scores; // [i] is the score of group->population[i]
+  int birthsStarted = 0;
+  int birthsThisUpdate = 0;
+  bool done = false;
+  bool archiving = false;
+  std::condition_variable archiveDone; // notified when archiving is cleared
+  std::vector<std::shared_ptr<Organism>> waitingInserts; // while archiving
+  const volatile std::sig_atomic_t *stopFlag = nullptr;
+  // genomes and brains of parents are read without populationMutex, so an
+  // organism which is replaced while it is some offspring's parent is only
+  // killed once all of those offspring have been made
+  std::unordered_map<Organism *, int> parentReaders;
+  std::unordered_set<std::shared_ptr<Organism>> killWhenRead;
+
+  void worker();
+
+  // the rest must be called with populationMutex held
+  double scoreOf(const std::shared_ptr<Organism> &org);
+  // both return an index into group->population
+  int selectParent();   // highest score of tournamentSize random organisms
+  int selectReplaced(); // lowest score of replaceTournamentSize random organisms
+  void releaseParents(std::vector<std::shared_ptr<Organism>> &parents);
+  // true if this completes an update (and so the group should be archived)
+  bool insert(std::shared_ptr<Organism> &offspring);
+  // archives the group with lock released (other workers keep going), and
+  // then inserts the offspring which were queued in the meantime
+  void archiveUnlocked(std::unique_lock<std::mutex> &lock);
+
+  // does not need populationMutex if the population is not changing. true if
+  // the archivist is finished.
+  bool archive();
+
+public:
+  SteadyState(std::shared_ptr<AbstractWorld> _world,
+              std::map<std::string, std::shared_ptr<Group>> &groups);
+
+  // evaluate the population (with the world's evaluate), then evolve until
+  // the group's archivist is finished or stop is set
+  void run(std::map<std::string, std::shared_ptr<Group>> &groups,
+           const volatile std::sig_atomic_t &stop);
+};
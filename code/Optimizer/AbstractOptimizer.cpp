@@ -19,6 +19,83 @@
 */
 
 ////// OPTIMIZER-optimizer is actually set by Modules.h //////
+
+std::shared_ptr<ParameterLink<int>> AbstractOptimizer::offspringThreadsPL =
+    Parameters::register_parameter(
+        "OPTIMIZER-offspringThreads", -1,
+        "number of threads used to make offspring (copy and mutate genomes "
+        "and build brains) once parents have been selected (results do not "
+        "depend on the number of threads). 0 = use all available cores, -1 = "
+        "do not use threads, make each offspring as soon as its parents are "
+        "selected with the common random number generator (results will not "
+        "be the same as with threads)");
+
+void AbstractOptimizer::addOffspring(
+    std::vector<std::shared_ptr<Organism>> &offspring,
+    const std::shared_ptr<Organism> &parent) {
+  if (offspringThreads < 0) {
+    offspring.push_back(parent->makeMutatedOffspringFrom(parent));
+    return;
+  }
+  pendingParents.push_back({parent});
+  pendingFromMany.push_back(false);
+}
+
+void AbstractOptimizer::addOffspring(
+    std::vector<std::shared_ptr<Organism>> &offspring,
+    const std::vector<std::shared_ptr<Organism>> &parents) {
+  if (offspringThreads < 0) {
+    offspring.push_back(parents[0]->makeMutatedOffspringFromMany(parents));
+    return;
+  }
+  pendingParents.push_back(parents);
+  pendingFromMany.push_back(true);
+}
+
+void AbstractOptimizer::finishOffspring(
+    std::vector<std::shared_ptr<Organism>> &offspring) {
+  if (pendingParents.empty()) {
+    return;
+  }
+  if (offspringPool == nullptr) {
+    offspringPool = std::make_shared<ThreadPool>(offspringThreads);
+  }
+  int count = static_cast<int>(pendingParents.size());
+  std::vector<std::unordered_map<std::string, std::shared_ptr<AbstractGenome>>>
+      newGenomes(count);
+  std::vector<std::unordered_map<std::string, std::shared_ptr<AbstractBrain>>>
+      newBrains(count);
+
+  // offspring i will be given ID firstID + i (below), and its stream is keyed
+  // on that ID
+  int firstID = Organism::getNextID();
+  offspringPool->parallelFor(count, [&](int i) {
+    Random::StreamGenerator stream(Random::getStreamSeed("offspring"),
+                                   Global::update, firstID + i);
+    Random::ScopedStream useStream(stream);
+    auto &parents = pendingParents[i];
+    if (pendingFromMany[i]) {
+      parents[0]->makeMutatedPartsFromMany(parents, newGenomes[i], newBrains[i]);
+    } else {
+      parents[0]->makeMutatedPartsFrom(parents[0], newGenomes[i], newBrains[i]);
+    }
+  });
+
+  // organisms are made here, by one thread, since this changes the parents
+  // (offspringCount) and gives out IDs
+  for (int i = 0; i < count; i++) {
+    auto &parents = pendingParents[i];
+    if (pendingFromMany[i]) {
+      offspring.push_back(std::make_shared<Organism>(
+          parents, newGenomes[i], newBrains[i], parents[0]->PT));
+    } else {
+      offspring.push_back(std::make_shared<Organism>(
+          parents[0], newGenomes[i], newBrains[i], parents[0]->PT));
+    }
+  }
+  pendingParents.clear();
+  pendingFromMany.clear();
+}
 std::shared_ptr<ParameterLink<std::string>>
     AbstractOptimizer::Optimizer_MethodStrPL = Parameters::register_parameter(
         "OPTIMIZER-optimizer", std::string("This_string_is_set_by_modules.h"),
@@ -18,47 +18,61 @@
 #include <Organism/Organism.h>
 
 #include <Utilities/Utilities.h>
+#include <Utilities/KillList.h>
 #include <Utilities/MTree.h>
 #include <Utilities/Parameters.h>
+#include <Utilities/PopulationTable.h>
 #include <Utilities/Random.h>
+#include <Utilities/ThreadPool.h>
 
 class AbstractOptimizer {
 public:
   std::shared_ptr<Abstract_MTree> optimizeFormula;
 
   static std::shared_ptr<ParameterLink<std::string>> Optimizer_MethodStrPL;
+  static std::shared_ptr<ParameterLink<int>> offspringThreadsPL;
 
   const std::shared_ptr<ParametersTable> PT;
   std::vector<std::string> popFileColumns;
 
-  std::unordered_set<std::shared_ptr<Organism>>
-      killList; // set of organisms to be killed after archive
+  // columns of population data (shared with the archivist by Group)
+  std::shared_ptr<PopulationTable> populationTable =
+      std::make_shared<PopulationTable>();
 
-  AbstractOptimizer(std::shared_ptr<ParametersTable> PT_) : PT(PT_) {}
+  // population indices of organisms to be killed after archive
+  KillList killList;
+
+  AbstractOptimizer(std::shared_ptr<ParametersTable> PT_)
+      : PT(PT_), offspringThreads(offspringThreadsPL->get(PT_)) {}
 
   virtual ~AbstractOptimizer() = default;
   // virtual vector<shared_ptr<Organism>>
   // makeNextGeneration(vector<shared_ptr<Organism>> &population) = 0;
   virtual void optimize(std::vector<std::shared_ptr<Organism>> &population) = 0;
 
+  // kill the organisms in killList and remove them from population
   virtual void cleanup(std::vector<std::shared_ptr<Organism>> &population) {
-    std::vector<std::shared_ptr<Organism>> newPopulation;
-    for (auto org : population) {
-      if (killList.find(org) == killList.end()) { // if not in kill list
-        newPopulation.push_back(org);             // move into new population
-      } else {
-        org->kill(); // if in kill list, call kill
-      }
-    }
-
-    population = newPopulation;
-    killList.clear();
+    killList.apply(population);
   }
 
   // virtual string maxValueName() {
   //	return("score");
   //}
 
+  // Optimizers choose parents for each offspring and pass them to
+  // addOffspring, then call finishOffspring once every offspring has its
+  // parents. If OPTIMIZER-offspringThreads is -1 each offspring is made (and
+  // added to offspring) right away. Otherwise, the genomes and brains of all
+  // of the offspring are made by that many threads in finishOffspring, each
+  // offspring drawing from its own random stream, and then the organisms are
+  // made in the order they were added (so IDs and results do not depend on
+  // the number of threads).
+  void addOffspring(std::vector<std::shared_ptr<Organism>> &offspring,
+                    const std::shared_ptr<Organism> &parent);
+  void addOffspring(std::vector<std::shared_ptr<Organism>> &offspring,
+                    const std::vector<std::shared_ptr<Organism>> &parents);
+  void finishOffspring(std::vector<std::shared_ptr<Organism>> &offspring);
+
   virtual bool requireGenome() { return false; }
   virtual bool requireBrain() { return false; }
 
@@ -69,5 +83,13 @@ public:
     // "blah" = use "blah namespace at root level
     // "Group::blah" = use "blah" name space inside of group name space
   }
+
+private:
+  int offspringThreads;
+  std::shared_ptr<ThreadPool> offspringPool; // created on first use
+  // parents of offspring waiting for finishOffspring, and if each was added
+  // with a list of parents (makeMutatedOffspringFromMany)
+  std::vector<std::vector<std::shared_ptr<Organism>>> pendingParents;
+  std::vector<bool> pendingFromMany;
 };
 
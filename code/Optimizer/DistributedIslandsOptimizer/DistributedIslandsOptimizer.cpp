@@ -0,0 +1,251 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+#include "DistributedIslandsOptimizer.h"
+
+#include "MigrantMessage.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+std::shared_ptr<ParameterLink<int>> DistributedIslandsOptimizer::islandIDPL =
+Parameters::register_parameter(
+	"OPTIMIZER_DISTRIBUTED-islandID", 0,
+	"which island this process is (0 to islandCount - 1). Start one MABE process per island,\n"
+	"each with its own islandID, randomSeed and outputPrefix, for example:\n"
+	"  for i in 0 1 2 3; do mkdir -p island$i; ./mabe -p OPTIMIZER_DISTRIBUTED-islandID $i \\\n"
+	"    GLOBAL-randomSeed $i GLOBAL-outputPrefix island$i/ > island$i/log.txt & done; wait");
+std::shared_ptr<ParameterLink<int>> DistributedIslandsOptimizer::islandCountPL =
+Parameters::register_parameter(
+	"OPTIMIZER_DISTRIBUTED-islandCount", 2,
+	"number of islands (processes). Every process must use the same islandCount, sharedMemoryName,\n"
+	"inboxMegabytes, migrationInterval, topology and waitForMigrants");
+std::shared_ptr<ParameterLink<std::string>> DistributedIslandsOptimizer::optimizerNameSpacePL =
+Parameters::register_parameter(
+	"OPTIMIZER_DISTRIBUTED-optimizerNameSpace", static_cast<std::string>("Island::"),
+	"name space of the optimizer used on each island, for example (in settings):\n"
+	"%                                           # close catagory (if one is open)\n"
+	"Island::OPTIMIZER-optimizer = Tournament    # each island uses a tournament optimizer\n"
+	"Island::OPTIMIZER_TOURNAMENT-tournamentSize = 7");
+std::shared_ptr<ParameterLink<std::string>> DistributedIslandsOptimizer::sharedMemoryNamePL =
+Parameters::register_parameter(
+	"OPTIMIZER_DISTRIBUTED-sharedMemoryName", static_cast<std::string>("/mabe_islands"),
+	"name of the POSIX shared memory the islands exchange migrants through (must start with /).\n"
+	"Use a different name for each set of islands running at the same time. If a run is killed,\n"
+	"remove the shared memory it left behind (on linux, /dev/shm/<name>) before starting again");
+std::shared_ptr<ParameterLink<int>> DistributedIslandsOptimizer::inboxMegabytesPL =
+Parameters::register_parameter(
+	"OPTIMIZER_DISTRIBUTED-inboxMegabytes", 8,
+	"size of each island's inbox (migrants which have been sent but not yet received)");
+std::shared_ptr<ParameterLink<int>> DistributedIslandsOptimizer::migrationIntervalPL =
+Parameters::register_parameter(
+	"OPTIMIZER_DISTRIBUTED-migrationInterval", 10,
+	"migrants are exchanged every this many updates");
+std::shared_ptr<ParameterLink<int>> DistributedIslandsOptimizer::migrantsPerNeighborPL =
+Parameters::register_parameter(
+	"OPTIMIZER_DISTRIBUTED-migrantsPerNeighbor", 5,
+	"number of new offspring sent to each neighboring island at each migration");
+std::shared_ptr<ParameterLink<std::string>> DistributedIslandsOptimizer::topologyPL =
+Parameters::register_parameter(
+	"OPTIMIZER_DISTRIBUTED-topology", static_cast<std::string>("ring"),
+	"which islands are neighbors [ring, all]. ring: each island sends to islandID + 1 (wrapping around),\n"
+	"all: each island sends to every other island");
+std::shared_ptr<ParameterLink<bool>> DistributedIslandsOptimizer::waitForMigrantsPL =
+Parameters::register_parameter(
+	"OPTIMIZER_DISTRIBUTED-waitForMigrants", true,
+	"if true, at each migration an island waits for the migrants its neighbors send that update\n"
+	"(islands stay in step and runs are repeatable). If false, islands never wait: migrants are\n"
+	"used whenever they arrive, and are lost if an inbox is full");
+
+DistributedIslandsOptimizer::DistributedIslandsOptimizer(std::shared_ptr<ParametersTable> PT_)
+	: AbstractOptimizer(PT_) {
+
+	islandID = islandIDPL->get(PT);
+	islandCount = islandCountPL->get(PT);
+	migrationInterval = migrationIntervalPL->get(PT);
+	migrantsPerNeighbor = migrantsPerNeighborPL->get(PT);
+	waitForMigrants = waitForMigrantsPL->get(PT);
+	if (islandCount < 1 || islandID < 0 || islandID >= islandCount) {
+		std::cout << "  ERROR :: OPTIMIZER_DISTRIBUTED-islandID must be at least 0 and less than islandCount.\n  Exiting." << std::endl;
+		exit(1);
+	}
+	if (migrationInterval < 1 || migrantsPerNeighbor < 0 || inboxMegabytesPL->get(PT) < 1) {
+		std::cout << "  ERROR :: OPTIMIZER_DISTRIBUTED-migrationInterval and inboxMegabytes must be at least 1,\n"
+			"  and migrantsPerNeighbor must be at least 0.\n  Exiting." << std::endl;
+		exit(1);
+	}
+
+	auto topology = topologyPL->get(PT);
+	for (int other = 0; other < islandCount; other++) {
+		if (other == islandID) {
+			continue;
+		}
+		if (topology == "all") {
+			sendTo.push_back(other);
+			receiveFrom.push_back(other);
+		}
+		else if (topology == "ring") {
+			if (other == (islandID + 1) % islandCount) {
+				sendTo.push_back(other);
+			}
+			if (other == (islandID + islandCount - 1) % islandCount) {
+				receiveFrom.push_back(other);
+			}
+		}
+		else {
+			std::cout << "  ERROR :: OPTIMIZER_DISTRIBUTED-topology must be ring or all, but is \"" << topology << "\".\n  Exiting." << std::endl;
+			exit(1);
+		}
+	}
+
+	auto islandPT = Parameters::root->getTable(optimizerNameSpacePL->get(PT));
+	if (islandPT->lookupString("OPTIMIZER-optimizer") == "DistributedIslands") {
+		std::cout << "  ERROR :: the optimizer in name space \"" << optimizerNameSpacePL->get(PT)
+			<< "\" (OPTIMIZER_DISTRIBUTED-optimizerNameSpace) is DistributedIslands.\n"
+			"  Set it to the optimizer each island should use, e.g. Island::OPTIMIZER-optimizer = Tournament\n  Exiting." << std::endl;
+		exit(1);
+	}
+	islandOptimizer = makeOptimizer(islandPT);
+	std::cout << "  setting up DistributedIslandsOptimizer: island " << islandID << " of " << islandCount
+		<< ", island optimizer: " << islandPT->lookupString("OPTIMIZER-optimizer") << std::endl;
+
+	mailbox = std::make_unique<SharedMemoryMailbox>(sharedMemoryNamePL->get(PT), islandID, islandCount,
+		static_cast<uint64_t>(inboxMegabytesPL->get(PT)) << 20);
+
+	// the island optimizer decides what the archivist sees
+	optimizeFormula = islandOptimizer->optimizeFormula;
+	popFileColumns = islandOptimizer->popFileColumns;
+	populationTable = islandOptimizer->populationTable;
+}
+
+void DistributedIslandsOptimizer::optimize(std::vector<std::shared_ptr<Organism>> &population) {
+	islandOptimizer->optimize(population);
+	// migrants replace organisms in place, so the island optimizer's indices
+	// are still right
+	killList = islandOptimizer->killList;
+	islandOptimizer->killList.clear();
+
+	if (Global::update % migrationInterval == 0 && !receiveFrom.empty()) {
+		migrate(population);
+	}
+}
+
+void DistributedIslandsOptimizer::migrate(std::vector<std::shared_ptr<Organism>> &population) {
+	// migrants are new offspring, and arriving migrants replace new offspring.
+	// In shuffled order, so (if all islands send the same number) an island's
+	// emigrants are the ones replaced
+	std::vector<int> newborn;
+	for (int i = 0; i < static_cast<int>(population.size()); i++) {
+		if (population[i]->timeOfBirth == Global::update) {
+			newborn.push_back(i);
+		}
+	}
+	Random::withGenerator([&](auto &gen) { std::shuffle(newborn.begin(), newborn.end(), gen); });
+
+	// a message is sent to each neighbor even if it is empty, since neighbors
+	// may be waiting for it
+	int sent = 0;
+	size_t next = 0;
+	for (int to : sendTo) {
+		std::vector<std::shared_ptr<Organism>> migrants;
+		for (int m = 0; m < migrantsPerNeighbor && !newborn.empty(); m++) {
+			migrants.push_back(population[newborn[next++ % newborn.size()]]);
+		}
+		if (mailbox->send(to, Global::update, MigrantMessage::pack(migrants), waitForMigrants, held)) {
+			sent += static_cast<int>(migrants.size());
+		}
+	}
+
+	std::vector<SharedMemoryMailbox::Message> arrived;
+	if (waitForMigrants) {
+		arrived = waitForMessages();
+	}
+	else {
+		mailbox->receive(held);
+		arrived.swap(held);
+	}
+
+	int received = 0;
+	size_t replaced = 0;
+	for (auto &message : arrived) {
+		for (auto &orgData : MigrantMessage::unpack(message.payload)) {
+			if (replaced == newborn.size()) {
+				break; // no room
+			}
+			auto &resident = population[newborn[replaced++]];
+			auto migrant = makeMigrant(resident, orgData);
+			resident->kill();
+			resident = migrant;
+			received++;
+		}
+	}
+	std::cout << "\n  migration: sent " << sent << " migrants, received " << received;
+}
+
+std::vector<SharedMemoryMailbox::Message> DistributedIslandsOptimizer::waitForMessages() {
+	std::vector<SharedMemoryMailbox::Message> arrived;
+	auto warnAt = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	for (int from : receiveFrom) {
+		while (true) {
+			auto found = std::find_if(held.begin(), held.end(), [&](const SharedMemoryMailbox::Message &message) {
+				return message.from == from && message.update == Global::update;
+			});
+			if (found != held.end()) {
+				arrived.push_back(std::move(*found));
+				held.erase(found);
+				break;
+			}
+			if (mailbox->closed(from)) {
+				// the message may have arrived before the island finished
+				mailbox->receive(held);
+				if (std::none_of(held.begin(), held.end(), [&](const SharedMemoryMailbox::Message &message) {
+					return message.from == from && message.update == Global::update; })) {
+					std::cout << "\n  island " << from << " has finished, so no migrants will come from it";
+					break;
+				}
+				continue;
+			}
+			if (std::chrono::steady_clock::now() > warnAt) {
+				std::cout << "\n  waiting for migrants from island " << from << "..." << std::flush;
+				warnAt = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+			}
+			mailbox->receive(held);
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+		}
+	}
+	return arrived;
+}
+
+std::shared_ptr<Organism> DistributedIslandsOptimizer::makeMigrant(const std::shared_ptr<Organism> &like,
+	std::unordered_map<std::string, std::string> &orgData) {
+	// as organisms are loaded in main
+	std::unordered_map<std::string, std::shared_ptr<AbstractGenome>> newGenomes;
+	std::unordered_map<std::string, std::shared_ptr<AbstractBrain>> newBrains;
+	for (auto const &genome : like->genomes) {
+		auto name = "GENOME_" + genome.first;
+		newGenomes[genome.first] = genome.second->makeLike();
+		newGenomes[genome.first]->deserialize(genome.second->PT, orgData, name);
+	}
+	for (auto const &brain : like->brains) {
+		auto name = "BRAIN_" + brain.first;
+		newBrains[brain.first] = brain.second->makeBrain(newGenomes);
+		newBrains[brain.first]->deserialize(brain.second->PT, orgData, name);
+	}
+	// the migrant takes like's place in this island's phylogeny, so that
+	// archivists which track lines of descent still work
+	if (like->parents.size() == 1) {
+		return std::make_shared<Organism>(like->parents[0], newGenomes, newBrains, like->PT);
+	}
+	if (like->parents.size() > 1) {
+		return std::make_shared<Organism>(like->parents, newGenomes, newBrains, like->PT);
+	}
+	return std::make_shared<Organism>(newGenomes, newBrains, like->PT);
+}
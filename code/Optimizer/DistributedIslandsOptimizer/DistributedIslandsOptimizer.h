@@ -0,0 +1,74 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+// An island model where each island is its own MABE process on the same host.
+// Each process evolves its population with an ordinary optimizer (set up in
+// OPTIMIZER_DISTRIBUTED-optimizerNameSpace) and, every migrationInterval
+// updates, sends copies of some of its new offspring to its neighboring
+// islands. Migrants travel as the same genome and brain data the archivists
+// save (serialize/deserialize) through a SharedMemoryMailbox, and take the
+// place of new offspring on the island they arrive at (including their
+// parents, so each island's lines of descent stay within the island).
+
+#pragma once
+
+#include <module_factories.h>
+
+#include <Optimizer/AbstractOptimizer.h>
+
+#include "SharedMemoryMailbox.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class DistributedIslandsOptimizer : public AbstractOptimizer {
+public:
+  static std::shared_ptr<ParameterLink<int>> islandIDPL;
+  static std::shared_ptr<ParameterLink<int>> islandCountPL;
+  static std::shared_ptr<ParameterLink<std::string>> optimizerNameSpacePL;
+  static std::shared_ptr<ParameterLink<std::string>> sharedMemoryNamePL;
+  static std::shared_ptr<ParameterLink<int>> inboxMegabytesPL;
+  static std::shared_ptr<ParameterLink<int>> migrationIntervalPL;
+  static std::shared_ptr<ParameterLink<int>> migrantsPerNeighborPL;
+  static std::shared_ptr<ParameterLink<std::string>> topologyPL;
+  static std::shared_ptr<ParameterLink<bool>> waitForMigrantsPL;
+
+  std::shared_ptr<AbstractOptimizer> islandOptimizer;
+  int islandID;
+  int islandCount;
+  int migrationInterval;
+  int migrantsPerNeighbor;
+  bool waitForMigrants;
+  std::vector<int> sendTo;      // islands migrants are sent to
+  std::vector<int> receiveFrom; // islands migrants arrive from
+
+  DistributedIslandsOptimizer(std::shared_ptr<ParametersTable> PT_ = nullptr);
+
+  virtual void optimize(std::vector<std::shared_ptr<Organism>> &population) override;
+
+private:
+  std::unique_ptr<SharedMemoryMailbox> mailbox;
+  // messages which have arrived but not been used yet (with
+  // waitForMigrants, messages for a later migration can arrive early)
+  std::vector<SharedMemoryMailbox::Message> held;
+
+  // replace new offspring in population with migrants
+  void migrate(std::vector<std::shared_ptr<Organism>> &population);
+  // wait for the message each island in receiveFrom sent this update
+  std::vector<SharedMemoryMailbox::Message> waitForMessages();
+
+  // make an organism from migrant data, with genomes, brains and parents like
+  // like's
+  std::shared_ptr<Organism>
+  makeMigrant(const std::shared_ptr<Organism> &like,
+              std::unordered_map<std::string, std::string> &orgData);
+};
@@ -0,0 +1,92 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+#include "MigrantMessage.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+
+void putCount(std::string &bytes, uint32_t count) {
+	bytes.append(reinterpret_cast<const char *>(&count), sizeof(count));
+}
+
+void putString(std::string &bytes, const std::string &s) {
+	putCount(bytes, static_cast<uint32_t>(s.size()));
+	bytes += s;
+}
+
+// unpacking stops the run if a message is cut short
+uint32_t getCount(const std::string &bytes, size_t &pos) {
+	uint32_t count;
+	if (pos + sizeof(count) > bytes.size()) {
+		std::cout << "  ERROR :: DistributedIslandsOptimizer received a damaged message.\n  Exiting." << std::endl;
+		exit(1);
+	}
+	std::copy_n(bytes.data() + pos, sizeof(count), reinterpret_cast<char *>(&count));
+	pos += sizeof(count);
+	return count;
+}
+
+std::string getString(const std::string &bytes, size_t &pos) {
+	uint32_t size = getCount(bytes, pos);
+	if (pos + size > bytes.size()) {
+		std::cout << "  ERROR :: DistributedIslandsOptimizer received a damaged message.\n  Exiting." << std::endl;
+		exit(1);
+	}
+	pos += size;
+	return bytes.substr(pos - size, size);
+}
+
+} // namespace
+
+namespace MigrantMessage {
+
+std::string pack(const std::vector<std::shared_ptr<Organism>> &migrants) {
+	std::string bytes;
+	putCount(bytes, static_cast<uint32_t>(migrants.size()));
+	for (auto const &org : migrants) {
+		DataMap orgMap;
+		for (auto const &genome : org->genomes) {
+			auto name = "GENOME_" + genome.first;
+			orgMap.merge(genome.second->serialize(name));
+		}
+		for (auto const &brain : org->brains) {
+			auto name = "BRAIN_" + brain.first;
+			orgMap.merge(brain.second->serialize(name));
+		}
+		auto keys = orgMap.getKeys();
+		putCount(bytes, static_cast<uint32_t>(keys.size()));
+		for (auto const &key : keys) {
+			putString(bytes, key);
+			putString(bytes, orgMap.getStringOfVector(key));
+		}
+	}
+	return bytes;
+}
+
+std::vector<std::unordered_map<std::string, std::string>> unpack(const std::string &payload) {
+	std::vector<std::unordered_map<std::string, std::string>> migrants;
+	size_t pos = 0;
+	uint32_t count = getCount(payload, pos);
+	for (uint32_t m = 0; m < count; m++) {
+		migrants.emplace_back();
+		uint32_t pairs = getCount(payload, pos);
+		for (uint32_t p = 0; p < pairs; p++) {
+			auto key = getString(payload, pos);
+			migrants.back()[key] = getString(payload, pos);
+		}
+	}
+	return migrants;
+}
+
+} // namespace MigrantMessage
@@ -0,0 +1,33 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+// The messages DistributedIslandsOptimizer sends migrants in. A message is a
+// count of migrants, then for each migrant a count of key/value pairs followed
+// by the pairs (each string is a length and bytes). The pairs are the
+// migrant's genomes and brains, as serialize writes them for the archivists.
+
+#pragma once
+
+#include <Organism/Organism.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace MigrantMessage {
+
+std::string pack(const std::vector<std::shared_ptr<Organism>> &migrants);
+
+// the data of each migrant, for deserialize. Stops the run if payload is cut
+// short.
+std::vector<std::unordered_map<std::string, std::string>> unpack(const std::string &payload);
+
+} // namespace MigrantMessage
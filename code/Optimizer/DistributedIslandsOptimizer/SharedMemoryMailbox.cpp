@@ -0,0 +1,294 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+#include "SharedMemoryMailbox.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MABE_HAVE_SHARED_MEMORY
+#endif
+
+namespace {
+
+const uint64_t mailboxMagic = 0x4d4142456d61696cULL; // "MABEmail"
+const size_t alignment = 64;
+const int attachSeconds = 30; // how long to wait for another process to set up
+
+// message header: payload length, from, update
+const uint64_t messageHeaderBytes = 3 * sizeof(int32_t);
+
+enum InboxState : uint32_t { UNUSED = 0, OPEN = 1, CLOSED = 2 };
+
+size_t aligned(size_t bytes) {
+  return (bytes + alignment - 1) / alignment * alignment;
+}
+
+void waitABit() { std::this_thread::sleep_for(std::chrono::microseconds(100)); }
+
+} // namespace
+
+struct SharedMemoryMailbox::Header {
+  uint64_t magic;
+  int32_t boxCount;
+  uint64_t inboxBytes;
+  std::atomic<uint32_t> ready;
+  std::atomic<int32_t> closedCount;
+};
+
+// readPos and writePos count every byte ever read and written, so
+// writePos - readPos bytes are waiting
+struct SharedMemoryMailbox::Inbox {
+  std::atomic<uint32_t> lock;
+  std::atomic<uint32_t> state;
+  uint64_t readPos;
+  uint64_t writePos;
+
+  void acquire() {
+    while (lock.exchange(1, std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+  }
+  void release() { lock.store(0, std::memory_order_release); }
+};
+
+SharedMemoryMailbox::Header *SharedMemoryMailbox::header() {
+  return static_cast<Header *>(mapped);
+}
+
+SharedMemoryMailbox::Inbox *SharedMemoryMailbox::inbox(int box) {
+  return reinterpret_cast<Inbox *>(static_cast<char *>(mapped) + aligned(sizeof(Header)) +
+                                   box * aligned(sizeof(Inbox)));
+}
+
+unsigned char *SharedMemoryMailbox::inboxData(int box) {
+  return reinterpret_cast<unsigned char *>(mapped) + aligned(sizeof(Header)) +
+         boxCount * aligned(sizeof(Inbox)) + box * aligned(inboxBytes);
+}
+
+namespace {
+
+// copy to and from a ring buffer of size bytes, starting at byte pos (which
+// is wrapped)
+void copyIn(unsigned char *ring, uint64_t size, uint64_t pos, const void *from,
+            uint64_t count) {
+  uint64_t start = pos % size;
+  uint64_t first = std::min(count, size - start);
+  std::memcpy(ring + start, from, first);
+  std::memcpy(ring, static_cast<const unsigned char *>(from) + first, count - first);
+}
+
+void copyOut(const unsigned char *ring, uint64_t size, uint64_t pos, void *to,
+             uint64_t count) {
+  uint64_t start = pos % size;
+  uint64_t first = std::min(count, size - start);
+  std::memcpy(to, ring + start, first);
+  std::memcpy(static_cast<unsigned char *>(to) + first, ring, count - first);
+}
+
+} // namespace
+
+#ifdef MABE_HAVE_SHARED_MEMORY
+
+SharedMemoryMailbox::SharedMemoryMailbox(const std::string &_name, int _boxID,
+                                         int _boxCount, uint64_t _inboxBytes)
+    : name(_name), boxID(_boxID), boxCount(_boxCount), inboxBytes(_inboxBytes) {
+  if (name.size() < 2 || name[0] != '/' || name.find('/', 1) != std::string::npos) {
+    std::cout << "  ERROR :: shared memory name \"" << name
+              << "\" must start with / and contain no other /.\n  Exiting."
+              << std::endl;
+    exit(1);
+  }
+  if (boxID < 0 || boxID >= boxCount || inboxBytes < messageHeaderBytes) {
+    std::cout << "  ERROR :: bad mailbox settings (box " << boxID << " of "
+              << boxCount << ", " << inboxBytes << " bytes per inbox).\n  Exiting."
+              << std::endl;
+    exit(1);
+  }
+  mappedBytes = aligned(sizeof(Header)) + boxCount * aligned(sizeof(Inbox)) +
+                boxCount * aligned(inboxBytes);
+
+  bool creator = true;
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0 && errno == EEXIST) {
+    creator = false;
+    fd = shm_open(name.c_str(), O_RDWR, 0600);
+  }
+  if (fd < 0) {
+    std::cout << "  ERROR :: could not open shared memory " << name << ": "
+              << std::strerror(errno) << "\n  Exiting." << std::endl;
+    exit(1);
+  }
+  auto giveUp = std::chrono::steady_clock::now() + std::chrono::seconds(attachSeconds);
+  if (creator) {
+    if (ftruncate(fd, static_cast<off_t>(mappedBytes)) != 0) {
+      std::cout << "  ERROR :: could not size shared memory " << name << ": "
+                << std::strerror(errno) << "\n  Exiting." << std::endl;
+      shm_unlink(name.c_str());
+      exit(1);
+    }
+  } else {
+    // wait for the creator to size it
+    struct stat info;
+    while (fstat(fd, &info) == 0 && info.st_size == 0 &&
+           std::chrono::steady_clock::now() < giveUp) {
+      waitABit();
+    }
+    if (static_cast<size_t>(info.st_size) != mappedBytes) {
+      std::cout << "  ERROR :: shared memory " << name
+                << " exists but was made with different settings (or by a run "
+                   "which did not finish). If no other process is using it, "
+                   "remove /dev/shm" << name << "\n  Exiting." << std::endl;
+      exit(1);
+    }
+  }
+  mapped = mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED) {
+    std::cout << "  ERROR :: could not map shared memory " << name << ": "
+              << std::strerror(errno) << "\n  Exiting." << std::endl;
+    exit(1);
+  }
+
+  if (creator) {
+    auto h = new (mapped) Header;
+    h->magic = mailboxMagic;
+    h->boxCount = boxCount;
+    h->inboxBytes = inboxBytes;
+    h->closedCount.store(0);
+    for (int box = 0; box < boxCount; box++) {
+      auto in = new (inbox(box)) Inbox;
+      in->lock.store(0);
+      in->state.store(UNUSED);
+      in->readPos = 0;
+      in->writePos = 0;
+    }
+    h->ready.store(1, std::memory_order_release);
+  } else {
+    while (header()->ready.load(std::memory_order_acquire) != 1 &&
+           std::chrono::steady_clock::now() < giveUp) {
+      waitABit();
+    }
+    if (header()->ready.load(std::memory_order_acquire) != 1 ||
+        header()->magic != mailboxMagic || header()->boxCount != boxCount ||
+        header()->inboxBytes != inboxBytes) {
+      std::cout << "  ERROR :: shared memory " << name
+                << " was not set up by a MABE process with the same settings. "
+                   "If no other process is using it, remove /dev/shm"
+                << name << "\n  Exiting." << std::endl;
+      exit(1);
+    }
+  }
+
+  uint32_t unused = UNUSED;
+  if (!inbox(boxID)->state.compare_exchange_strong(unused, OPEN)) {
+    std::cout << "  ERROR :: mailbox " << boxID << " in shared memory " << name
+              << " is already in use (two processes with the same island ID, "
+                 "or a run which did not finish - if so remove /dev/shm"
+              << name << ").\n  Exiting." << std::endl;
+    exit(1);
+  }
+}
+
+SharedMemoryMailbox::~SharedMemoryMailbox() {
+  if (mapped == nullptr) {
+    return;
+  }
+  inbox(boxID)->state.store(CLOSED);
+  if (header()->closedCount.fetch_add(1) + 1 == boxCount) {
+    shm_unlink(name.c_str());
+  }
+  munmap(mapped, mappedBytes);
+}
+
+#else
+
+SharedMemoryMailbox::SharedMemoryMailbox(const std::string &_name, int _boxID,
+                                         int _boxCount, uint64_t _inboxBytes)
+    : name(_name), boxID(_boxID), boxCount(_boxCount), inboxBytes(_inboxBytes) {
+  std::cout << "  ERROR :: shared memory mailboxes need POSIX shared memory, "
+               "which this system does not have.\n  Exiting."
+            << std::endl;
+  exit(1);
+}
+
+SharedMemoryMailbox::~SharedMemoryMailbox() {}
+
+#endif
+
+bool SharedMemoryMailbox::closed(int box) {
+  return inbox(box)->state.load() == CLOSED;
+}
+
+bool SharedMemoryMailbox::send(int to, int update, const std::string &payload,
+                               bool wait, std::vector<Message> &held) {
+  uint64_t size = messageHeaderBytes + payload.size();
+  if (size > inboxBytes) {
+    std::cout << "  ERROR :: a " << size << " byte message does not fit in a "
+              << inboxBytes << " byte inbox. Make the inboxes bigger.\n  Exiting."
+              << std::endl;
+    exit(1);
+  }
+  int32_t messageHeader[3] = {static_cast<int32_t>(payload.size()), boxID, update};
+  auto in = inbox(to);
+  auto ring = inboxData(to);
+  while (true) {
+    in->acquire();
+    if (in->state.load() == CLOSED) {
+      in->release();
+      return false;
+    }
+    if (inboxBytes - (in->writePos - in->readPos) >= size) {
+      copyIn(ring, inboxBytes, in->writePos, messageHeader, messageHeaderBytes);
+      copyIn(ring, inboxBytes, in->writePos + messageHeaderBytes, payload.data(),
+             payload.size());
+      in->writePos += size;
+      in->release();
+      return true;
+    }
+    in->release();
+    if (!wait) {
+      return false;
+    }
+    readInbox(held);
+    waitABit();
+  }
+}
+
+int SharedMemoryMailbox::readInbox(std::vector<Message> &messages) {
+  auto in = inbox(boxID);
+  auto ring = inboxData(boxID);
+  int count = 0;
+  in->acquire();
+  while (in->readPos < in->writePos) {
+    int32_t messageHeader[3];
+    copyOut(ring, inboxBytes, in->readPos, messageHeader, messageHeaderBytes);
+    Message message{messageHeader[1], messageHeader[2], std::string(messageHeader[0], '\0')};
+    copyOut(ring, inboxBytes, in->readPos + messageHeaderBytes, &message.payload[0],
+            message.payload.size());
+    in->readPos += messageHeaderBytes + message.payload.size();
+    messages.push_back(std::move(message));
+    count++;
+  }
+  in->release();
+  return count;
+}
@@ -0,0 +1,71 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+// Mailboxes for MABE processes running on the same host. Every process opens
+// the same POSIX shared memory object (the first one to get there creates
+// it), which holds one inbox per process. An inbox is a ring buffer of bytes
+// guarded by a spin lock, and any process can append a message to any inbox.
+// The last process to close the mailbox removes the shared memory object.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class SharedMemoryMailbox {
+public:
+  struct Message {
+    int from;
+    int update;
+    std::string payload;
+  };
+
+private:
+  struct Header;
+  struct Inbox;
+
+  std::string name;
+  int boxID;
+  int boxCount;
+  uint64_t inboxBytes;
+  size_t mappedBytes = 0;
+  void *mapped = nullptr;
+
+  Header *header();
+  Inbox *inbox(int box);
+  unsigned char *inboxData(int box);
+
+  // move every message in this process's inbox to messages (returns how many)
+  int readInbox(std::vector<Message> &messages);
+
+public:
+  // name must start with '/' (e.g. "/mabe_islands"). Every process must use
+  // the same boxCount and inboxBytes, and a different boxID.
+  SharedMemoryMailbox(const std::string &_name, int _boxID, int _boxCount,
+                      uint64_t _inboxBytes);
+  ~SharedMemoryMailbox();
+
+  SharedMemoryMailbox(const SharedMemoryMailbox &) = delete;
+  SharedMemoryMailbox &operator=(const SharedMemoryMailbox &) = delete;
+
+  // put a message in box to's inbox. If the inbox is full, either wait for
+  // room (reading this process's own inbox into held so two processes can
+  // not wait for each other) or drop the message. Returns false if the
+  // message was dropped or the owner of box to has closed its mailbox.
+  bool send(int to, int update, const std::string &payload, bool wait,
+            std::vector<Message> &held);
+
+  // move every message which has arrived for this process to held
+  void receive(std::vector<Message> &held) { readInbox(held); }
+
+  // true once the process with this box has closed its mailbox
+  bool closed(int box);
+};
@@ -80,6 +80,7 @@ void IslandsOptimizer::optimize(std::vector<std::shared_ptr<Organism>> &populati
 	for (size_t island = 0; island < islands; island++){
 		std::cout << "\n    island " << island << " : " << islandOptimizers[island]->PT->getTableNameSpace() << "   (" << islandPopulations[island].size() << ")  ";
 		islandOptimizers[island]->optimize(islandPopulations[island]);
+		size_t offset = population.size(); // where this island starts in population
 		for (auto org : islandPopulations[island]) {
 			population.push_back(org);
 			if (org->timeOfBirth == Global::update) { // if an org is brand new there is a chance is will migrate
@@ -91,9 +92,8 @@ void IslandsOptimizer::optimize(std::vector<std::shared_ptr<Organism>> &populati
 				}
 			}
 		}
-		for (auto org : islandOptimizers[island]->killList) {
-			killList.insert(org);
-		}
+		killList.merge(islandOptimizers[island]->killList, offset);
+		islandOptimizers[island]->killList.clear();
 	}
 
 	// now, look at how dataMaps were changed by island optimizers, and figure out what will
@@ -10,7 +10,6 @@
 
 #include "LexicaseOptimizer.h"
 #include <iostream>
-#include <numeric>
 #include <algorithm>
 #include <vector>
 #include <memory>
@@ -42,11 +41,13 @@ Parameters::register_parameter("OPTIMIZER_LEXICASE-epsilon", .1,
 	"e.g. 0.1 = organisms in the top 90% are kept. use 0.0 for classic Lexicase.");
 std::shared_ptr<ParameterLink<std::string>> LexicaseOptimizer::epsilonRelativeToPL =
 Parameters::register_parameter("OPTIMIZER_LEXICASE-epsilonRelativeTo", (std::string)"rank",
-	"determines how epsilon is calculated [rank,score]"
+	"determines how epsilon is calculated [rank,score,mad]"
 	"\nif rank, epsilon will be relative to organism ranks"
 	"\n  i.e. keep (best current keepers count * epsilon) organisms"
 	"\nif score epsilon will be relative to min and max score"
 	"\n  i.e. keep orgs with score >= maxScore - ( (maxScore-minScore) * epsilon )"
+	"\nif mad, epsilon is the median absolute deviation of each formula's scores over the population"
+	"\n  i.e. keep orgs with score >= maxScore - MAD (the epsilon parameter is not used)"
 );
 
 std::shared_ptr<ParameterLink<int>> LexicaseOptimizer::poolSizePL = 
@@ -57,6 +58,11 @@ std::shared_ptr<ParameterLink<bool>> LexicaseOptimizer::recordOptimizeValuesPL =
 Parameters::register_parameter("OPTIMIZER_LEXICASE-recordOptimizeValues", true,
 	"record optimize values to data files using optimizeFormulaNames");
 
+std::shared_ptr<ParameterLink<int>> LexicaseOptimizer::selectionThreadsPL =
+Parameters::register_parameter("OPTIMIZER_LEXICASE-selectionThreads", -1,
+	"number of threads used to select all parents before any offspring is made (results do not depend on the number of threads). "
+	"0 = use all available cores, -1 = do not use threads, select each parent just before its offspring is made");
+
 
 LexicaseOptimizer::LexicaseOptimizer(std::shared_ptr<ParametersTable> PT_)
     : AbstractOptimizer(PT_) {
@@ -66,6 +72,7 @@ LexicaseOptimizer::LexicaseOptimizer(std::shared_ptr<ParametersTable> PT_)
 
 	for (auto s : optimizeFormulasStrings) {
 		optimizeFormulasMTs.push_back(stringToMTree(s));
+		optimizeFormulasPrograms.emplace_back(optimizeFormulasMTs.back());
 	}
 
 	// get names to use with scores
@@ -83,14 +90,17 @@ LexicaseOptimizer::LexicaseOptimizer(std::shared_ptr<ParametersTable> PT_)
 
 	epsilon = epsilonPL->get(PT);
 	if (epsilonRelativeToPL->get(PT) == "score") {
-		epsilonRelativeTo = true;
+		epsilonMode = LexicaseSelector::SCORE;
 	}
 	else if (epsilonRelativeToPL->get(PT) == "rank") {
-		epsilonRelativeTo = false;
+		epsilonMode = LexicaseSelector::RANK;
+	}
+	else if (epsilonRelativeToPL->get(PT) == "mad") {
+		epsilonMode = LexicaseSelector::MAD;
 	}
 	else {
 		std::cout << "  while setting up LexicaseOptimizer, found epsilonRelativeTo value \"" <<
-			epsilonRelativeToPL->get(PT) << "\" but this value must be either \"score\" or \"rank\"."
+			epsilonRelativeToPL->get(PT) << "\" but this value must be \"score\", \"rank\" or \"mad\"."
 			"\n  exiting.";
 		exit(1);
 	}
@@ -98,6 +108,7 @@ LexicaseOptimizer::LexicaseOptimizer(std::shared_ptr<ParametersTable> PT_)
 	nextPopSizeFormula = stringToMTree(nextPopSizePL->get(PT));
 	numberParents = numberParentsPL->get(PT);
 	recordOptimizeValues = recordOptimizeValuesPL->get(PT);
+	selectionThreads = selectionThreadsPL->get(PT);
 	
 	// leave this undefined so that max.csv is not generated
 	//optimizeFormula = optimizeValueMT;
@@ -110,75 +121,6 @@ LexicaseOptimizer::LexicaseOptimizer(std::shared_ptr<ParametersTable> PT_)
 	}
 }
 
-// return n nonrepeating elements for [0..m)
-auto m_choose_n = [](auto const m, auto const n) {
-	std::vector<int> v(m);
-	std::iota(std::begin(v), std::end(v), 0);
-	std::shuffle(std::begin(v), std::end(v), Random::getCommonGenerator());
-	std::vector<int> r;
-	std::copy_n(std::begin(v), n, std::back_inserter(r));
-	return r;
-};
-
-
-int LexicaseOptimizer::lexiSelect(const std::vector<int> &orgIndexList) {
-	if (!scoresHaveDelta) { // if all scores are the same! pick random
-		return Random::getIndex(orgIndexList.size());
-	}
-
-	// generate a vector with formulasSize and fill with values from 0 to formulasSize - 1, in a random order.
-	std::vector<int> formulasOrder(optimizeFormulasMTs.size());
-	iota(formulasOrder.begin(), formulasOrder.end(), 0);
-	std::shuffle(formulasOrder.begin(), formulasOrder.end(), Random::getCommonGenerator());
-	// now we have a random order in formulasOrder
-
-	// keepers is the current list of indexes into population for orgs which
-	// have passed all tests so far.
-	std::vector<int> keepers  = orgIndexList;
-
-	while (keepers.size() > 1 && formulasOrder.size() > 0) {
-		// while there are still atleast one keeper and there are still formulas
-		int formulaIndex = formulasOrder.back();
-		formulasOrder.pop_back();
-
-		double scoreCutoff;
-
-		// create a vector of remaning scores
-		std::vector<double> keeperScores;
-		for (size_t i = 0; i < keepers.size(); i++) {
-			keeperScores.push_back(scores[formulaIndex][keepers[i]]);
-		}
-
-		if (epsilonRelativeTo) { // get scoreCutoff relitive to score
-			auto scoreRange = std::minmax_element(std::begin(keeperScores), std::end(keeperScores));
-			scoreCutoff = (*scoreRange.second - ((*scoreRange.second - *scoreRange.first) * epsilon));
-		}
-		else { // get scoreCutoff relitive to rank
-			// based on the number of keepers, calculate how many to keep.
-			size_t cull_index = std::ceil(std::max((((1.0 - epsilon) * keeperScores.size()) - 1.0), 0.0));
-
-			// get score at the cull index position
-			std::nth_element(std::begin(keeperScores),
-				std::begin(keeperScores) + cull_index,
-				std::end(keeperScores));
-			scoreCutoff = keeperScores[cull_index];
-
-			//std::cout << "cull_index: " << cull_index << "  keeperScores.size(): " << keeperScores.size() << std::endl;
-			//std::cout << "scoreCutoff: " << scoreCutoff << std::endl;
-		}
-
-		// for each keeper, see if there are still a keeper, i.e. they have score >= scoreCutoff. remove if not
-		keepers.erase(std::remove_if(std::begin(keepers), std::end(keepers), [&](auto k) {
-			return scores[formulaIndex][k] < scoreCutoff;
-		}), std::end(keepers));
-	}
-	int pickHere = Random::getIndex(keepers.size()); 
-	//std::cout << "    keeping: " << tournamentPopulation[keepers[pickHere]]->ID << std::endl;
-	// if there is only one keeper left, return that, otherwise select randomly from keepers.
-	return keepers[pickHere];
-}
-
-
 void LexicaseOptimizer::optimize(
     std::vector<std::shared_ptr<Organism>> &population) {
 
@@ -189,28 +131,19 @@ void LexicaseOptimizer::optimize(
   std::vector<double> minScores;
   minScores.reserve(optimizeFormulasMTs.size());
 
-  scoresHaveDelta = false;
-
   scores.clear();
-  for (auto &opt_formula : optimizeFormulasMTs) {
-
-    std::vector<double> pop_scores;
-    pop_scores.reserve(population.size());
+  populationTable->refresh(population);
+  for (auto &opt_formula : optimizeFormulasPrograms) {
 
-    for (auto &org : population)
-      pop_scores.push_back(opt_formula->eval(org->dataMap, PT)[0]);
+    std::vector<double> pop_scores = opt_formula.evalAll(*populationTable, PT);
 
     scores.push_back(pop_scores);
 
-    aveScores.push_back(
-        std::accumulate(std::begin(pop_scores), std::end(pop_scores), 0.0) /
-        population.size());
+    aveScores.push_back(PopulationTable::mean(pop_scores));
 
     auto const minmax =
         std::minmax_element(std::begin(pop_scores), std::end(pop_scores));
 
-    scoresHaveDelta |= *minmax.first < *minmax.second;
-
     minScores.push_back(*minmax.first);
     maxScores.push_back(*minmax.second);
   }
@@ -220,6 +153,8 @@ void LexicaseOptimizer::optimize(
       for (size_t fIndex = 0; fIndex < optimizeFormulasMTs.size(); fIndex++)
         population[i]->dataMap.set(scoreNames[fIndex], scores[fIndex][i]);
 
+  selector.setScores(scores, epsilonMode, epsilon);
+
   poolSize = poolSize == -1 ? population.size() : poolSize;
 
 
@@ -236,19 +171,35 @@ void LexicaseOptimizer::optimize(
 
   // generate a list of 'nextPopulationTargetSize' new orgs into 'newPopulation'
   // for each, generate a 'parents' vector with 'numberParents' parent orgs
-  // parents are selected with lexiSelect( m_choose_n(population.size(), poolSize))
-  //   where the m_choose_n command selects 'poolSize' number of population indexes
-  std::generate_n(
-      std::back_inserter(newPopulation), nextPopulationTargetSize, [&] {
-        std::vector<std::shared_ptr<Organism>> parents;
-        std::generate_n(std::back_inserter(parents), numberParents, [&] {
-          return population[lexiSelect(m_choose_n(population.size(), poolSize))];
-        });
-        return parents[0]->makeMutatedOffspringFromMany(parents);
-      });
-
-  oldPopulation = population;
+  // parents are selected by lexicase from 'poolSize' randomly picked organisms
+  if (selectionThreads >= 0) {
+    if (selectionPool == nullptr) {
+      selectionPool = std::make_shared<ThreadPool>(selectionThreads);
+    }
+    auto selected = selector.selectMany(nextPopulationTargetSize * numberParents,
+                                        poolSize, *selectionPool);
+    auto next = selected.begin();
+    for (size_t i = 0; i < nextPopulationTargetSize; i++) {
+      std::vector<std::shared_ptr<Organism>> parents;
+      std::generate_n(std::back_inserter(parents), numberParents,
+                      [&] { return population[*next++]; });
+      addOffspring(newPopulation, parents);
+    }
+  } else {
+    for (size_t i = 0; i < nextPopulationTargetSize; i++) {
+      std::vector<std::shared_ptr<Organism>> parents;
+      std::generate_n(std::back_inserter(parents), numberParents,
+                      [&] { return population[selector.select(poolSize)]; });
+      addOffspring(newPopulation, parents);
+    }
+  }
+  finishOffspring(newPopulation);
+
+  // the current generation is killed in cleanup
+  killList.clear();
+  killList.insertRange(0, population.size());
   population.insert(population.end(), newPopulation.begin(), newPopulation.end());
+  newPopulation.clear();
   for (size_t fIndex = 0; fIndex < optimizeFormulasMTs.size(); fIndex++) {
     std::cout << std::endl
               << "   " << scoreNames[fIndex]
@@ -257,11 +208,4 @@ void LexicaseOptimizer::optimize(
   }
 }
 
-void LexicaseOptimizer::cleanup(std::vector<std::shared_ptr<Organism>> &population) {
-	for (auto org : oldPopulation) {
-		org->kill();
-	}
-	population.swap(newPopulation);
-	newPopulation.clear();
-}
 
@@ -12,6 +12,10 @@
 
 #include <Optimizer/AbstractOptimizer.h>
 #include <Utilities/MTree.h>
+#include <Utilities/MTreeProgram.h>
+#include <Utilities/ThreadPool.h>
+
+#include "LexicaseSelector.h"
 
 #include <iostream>
 #include <numeric>
@@ -29,30 +33,29 @@ public:
 	static std::shared_ptr<ParameterLink<std::string>> nextPopSizePL;
 	static std::shared_ptr<ParameterLink<int>> numberParentsPL;
 	static std::shared_ptr<ParameterLink<bool>> recordOptimizeValuesPL;
+	static std::shared_ptr<ParameterLink<int>> selectionThreadsPL;
 
 	std::vector<std::vector<double>> scores;
 	std::vector<std::string> scoreNames;
-	bool scoresHaveDelta = false;
 	double epsilon;
-	bool epsilonRelativeTo;
+	LexicaseSelector::EpsilonMode epsilonMode;
 	int poolSize;
 
+	LexicaseSelector selector; // selects parents from scores
+	int selectionThreads;
+	std::shared_ptr<ThreadPool> selectionPool; // created on first use
+
 	std::shared_ptr<Abstract_MTree> nextPopSizeFormula;
 	std::vector<std::shared_ptr<Organism>> newPopulation;
-	std::vector<std::shared_ptr<Organism>> oldPopulation;
 
 	int numberParents;
 
 	bool recordOptimizeValues;
 
 	std::vector<std::shared_ptr<Abstract_MTree>> optimizeFormulasMTs;
+	std::vector<MTreeProgram> optimizeFormulasPrograms; // optimizeFormulasMTs, compiled
 
 	LexicaseOptimizer(std::shared_ptr<ParametersTable> PT_ = nullptr);
 
 	virtual void optimize(std::vector<std::shared_ptr<Organism>> &population) override;
-
-	virtual void cleanup(std::vector<std::shared_ptr<Organism>> &population) override;
-
-
-	int lexiSelect(const std::vector<int> &tournamentIndexList);
 };
@@ -0,0 +1,292 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+#include "LexicaseSelector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include <Global.h>
+#include <Utilities/Random.h>
+
+namespace {
+
+inline int lowestBit(uint64_t bits) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(bits);
+#else
+  int bit = 0;
+  while (!(bits & 1)) {
+    bits >>= 1;
+    bit++;
+  }
+  return bit;
+#endif
+}
+
+// call f(p) for each set bit p
+template <class Function>
+inline void forEachKeeper(const std::vector<uint64_t> &keep, Function f) {
+  for (size_t w = 0; w < keep.size(); w++) {
+    uint64_t bits = keep[w];
+    while (bits) {
+      f(static_cast<int>(w * 64) + lowestBit(bits));
+      bits &= bits - 1;
+    }
+  }
+}
+
+// clear each set bit p where drop(p), and return how many were cleared
+template <class Function>
+inline int dropKeepers(std::vector<uint64_t> &keep, Function drop) {
+  int dropped = 0;
+  for (size_t w = 0; w < keep.size(); w++) {
+    uint64_t bits = keep[w];
+    while (bits) {
+      int bit = lowestBit(bits);
+      if (drop(static_cast<int>(w * 64) + bit)) {
+        keep[w] &= ~(1ULL << bit);
+        dropped++;
+      }
+      bits &= bits - 1;
+    }
+  }
+  return dropped;
+}
+
+// median of values (which are reordered)
+double median(std::vector<double> &values) {
+  size_t middle = values.size() / 2;
+  std::nth_element(values.begin(), values.begin() + middle, values.end());
+  double upper = values[middle];
+  if (values.size() % 2) {
+    return upper;
+  }
+  return (*std::max_element(values.begin(), values.begin() + middle) + upper) / 2;
+}
+
+// position of the cutoff in sorted keeper values, based on the number of
+// keepers (for RANK)
+inline size_t cullIndexFor(size_t keepCount, double epsilon) {
+  return static_cast<size_t>(std::ceil(std::max((((1.0 - epsilon) * keepCount) - 1.0), 0.0)));
+}
+
+} // namespace
+
+double LexicaseSelector::cutoffFor(std::vector<double> &values, int c) const {
+  if (mode == RANK) {
+    size_t cullIndex = cullIndexFor(values.size(), epsilon);
+    std::nth_element(values.begin(), values.begin() + cullIndex, values.end());
+    return values[cullIndex];
+  }
+  auto const range = std::minmax_element(values.begin(), values.end());
+  if (mode == SCORE) {
+    return *range.second - ((*range.second - *range.first) * epsilon);
+  }
+  return *range.second - madEpsilons[c];
+}
+
+int32_t LexicaseSelector::cutoffFor(std::vector<int32_t> &values) const {
+  size_t cullIndex = cullIndexFor(values.size(), epsilon);
+  std::nth_element(values.begin(), values.begin() + cullIndex, values.end());
+  return values[cullIndex];
+}
+
+void LexicaseSelector::setScores(const std::vector<std::vector<double>> &scores,
+                                 EpsilonMode _mode, double _epsilon) {
+  mode = _mode;
+  epsilon = _epsilon;
+  caseCount = static_cast<int>(scores.size());
+  orgCount = scores.empty() ? 0 : static_cast<int>(scores[0].size());
+  matrix.resize(static_cast<size_t>(caseCount) * orgCount);
+  haveDelta = false;
+  bool hasNaN = false;
+  for (int c = 0; c < caseCount; c++) {
+    std::copy(scores[c].begin(), scores[c].end(), matrix.begin() + (size_t)c * orgCount);
+    if (orgCount > 0) {
+      auto const minmax = std::minmax_element(scores[c].begin(), scores[c].end());
+      haveDelta |= *minmax.first < *minmax.second;
+    }
+    for (double s : scores[c]) {
+      hasNaN |= std::isnan(s);
+    }
+  }
+
+  // ranks compare the same way as scores, so the rank cutoff can be found
+  // with integers
+  useRanks = mode == RANK && !hasNaN;
+  if (useRanks) {
+    ranks.resize(matrix.size());
+    std::vector<int> byScore(orgCount);
+    for (int c = 0; c < caseCount; c++) {
+      const double *row = &matrix[(size_t)c * orgCount];
+      int32_t *rankRow = &ranks[(size_t)c * orgCount];
+      std::iota(byScore.begin(), byScore.end(), 0);
+      std::sort(byScore.begin(), byScore.end(),
+                [&](int a, int b) { return row[a] < row[b]; });
+      int32_t rank = 0;
+      for (int i = 0; i < orgCount; i++) {
+        if (i > 0 && row[byScore[i - 1]] < row[byScore[i]]) {
+          rank++;
+        }
+        rankRow[byScore[i]] = rank;
+      }
+    }
+  }
+
+  if (mode == MAD) {
+    madEpsilons.assign(caseCount, 0);
+    std::vector<double> values(orgCount);
+    for (int c = 0; c < caseCount && orgCount > 0; c++) {
+      const double *row = &matrix[(size_t)c * orgCount];
+      values.assign(row, row + orgCount);
+      double caseMedian = median(values);
+      for (int i = 0; i < orgCount; i++) {
+        values[i] = std::abs(row[i] - caseMedian);
+      }
+      madEpsilons[c] = median(values);
+    }
+  }
+
+  words = (orgCount + 63) / 64;
+  firstCutoffs.assign(caseCount, 0);
+  firstRankCutoffs.assign(caseCount, 0);
+  firstKeepers.assign(static_cast<size_t>(caseCount) * words, 0);
+  firstKeepCounts.assign(caseCount, 0);
+  std::vector<double> values;
+  std::vector<int32_t> rankValues;
+  for (int c = 0; c < caseCount && orgCount > 0; c++) {
+    const double *row = &matrix[(size_t)c * orgCount];
+    const int32_t *rankRow = useRanks ? &ranks[(size_t)c * orgCount] : nullptr;
+    if (useRanks) {
+      rankValues.assign(rankRow, rankRow + orgCount);
+      firstRankCutoffs[c] = cutoffFor(rankValues);
+    } else {
+      values.assign(row, row + orgCount);
+      firstCutoffs[c] = cutoffFor(values, c);
+    }
+    uint64_t *keep = &firstKeepers[(size_t)c * words];
+    for (int i = 0; i < orgCount; i++) {
+      bool kept = useRanks ? !(rankRow[i] < firstRankCutoffs[c]) : !(row[i] < firstCutoffs[c]);
+      if (kept) {
+        keep[i / 64] |= 1ULL << (i % 64);
+        firstKeepCounts[c]++;
+      }
+    }
+  }
+}
+
+template <class Engine, class MakePool>
+int LexicaseSelector::selectWith(int poolSize, Engine &gen, Scratch &scratch,
+                                 MakePool makePool) const {
+  const bool poolIsEveryone = makePool(scratch.pool);
+  poolSize = std::min(poolSize, orgCount); // the pool can not be bigger than the population
+  if (!haveDelta) { // if all scores are the same! pick random
+    return scratch.pool[Random::getIndex(poolSize, gen)];
+  }
+
+  // cases are used in a random order
+  scratch.order.resize(caseCount);
+  std::iota(scratch.order.begin(), scratch.order.end(), 0);
+  std::shuffle(scratch.order.begin(), scratch.order.end(), gen);
+
+  scratch.keep.assign((poolSize + 63) / 64, ~0ULL);
+  if (poolSize % 64) {
+    scratch.keep.back() = (1ULL << (poolSize % 64)) - 1;
+  }
+  int keepCount = poolSize;
+
+  while (keepCount > 1 && !scratch.order.empty()) {
+    const int c = scratch.order.back();
+    scratch.order.pop_back();
+    const double *row = &matrix[(size_t)c * orgCount];
+    const int32_t *rankRow = useRanks ? &ranks[(size_t)c * orgCount] : nullptr;
+    const bool everyoneKept = keepCount == orgCount;
+
+    if (everyoneKept && poolIsEveryone) {
+      std::copy_n(firstKeepers.begin() + (size_t)c * words, words, scratch.keep.begin());
+      keepCount = firstKeepCounts[c];
+    } else if (useRanks) {
+      scratch.rankValues.clear();
+      if (!everyoneKept) {
+        forEachKeeper(scratch.keep,
+                      [&](int p) { scratch.rankValues.push_back(rankRow[scratch.pool[p]]); });
+      }
+      const int32_t cutoff = everyoneKept ? firstRankCutoffs[c] : cutoffFor(scratch.rankValues);
+      keepCount -= dropKeepers(scratch.keep,
+                               [&](int p) { return rankRow[scratch.pool[p]] < cutoff; });
+    } else {
+      scratch.values.clear();
+      if (!everyoneKept) {
+        forEachKeeper(scratch.keep,
+                      [&](int p) { scratch.values.push_back(row[scratch.pool[p]]); });
+      }
+      const double cutoff = everyoneKept ? firstCutoffs[c] : cutoffFor(scratch.values, c);
+      keepCount -=
+          dropKeepers(scratch.keep, [&](int p) { return row[scratch.pool[p]] < cutoff; });
+    }
+  }
+
+  // pick one of the keepers (in pool order)
+  int pick = Random::getIndex(keepCount, gen);
+  int picked = -1;
+  forEachKeeper(scratch.keep, [&](int p) {
+    if (pick-- == 0) {
+      picked = scratch.pool[p];
+    }
+  });
+  return picked;
+}
+
+int LexicaseSelector::select(int poolSize) {
+  return Random::withGenerator([&](auto &gen) {
+    return selectWith(poolSize, gen, serialScratch, [&](std::vector<int> &pool) {
+      // shuffle everyone and use the first poolSize
+      pool.resize(orgCount);
+      std::iota(pool.begin(), pool.end(), 0);
+      std::shuffle(pool.begin(), pool.end(), gen);
+      return false;
+    });
+  });
+}
+
+std::vector<int> LexicaseSelector::selectMany(int count, int poolSize,
+                                              ThreadPool &threadPool) {
+  std::vector<int> selected(count);
+  threadPool.parallelFor(count, [&](int i) {
+    static thread_local Scratch scratch;
+    Random::StreamGenerator stream(Random::getStreamSeed("lexicase"),
+                                   Global::update, i);
+    selected[i] = selectWith(poolSize, stream, scratch, [&](std::vector<int> &pool) {
+      // pool is left as 0..orgCount-1 between selections. Keepers are a set,
+      // so if everyone is in the pool it does not need to be shuffled.
+      if (static_cast<int>(pool.size()) != orgCount) {
+        pool.resize(orgCount);
+        std::iota(pool.begin(), pool.end(), 0);
+      }
+      scratch.swaps.clear();
+      if (poolSize >= orgCount) {
+        return true;
+      }
+      // otherwise shuffle the first poolSize places (and put them back after)
+      for (int p = 0; p < poolSize; p++) {
+        int other = p + static_cast<int>(stream.nextBelow(orgCount - p));
+        std::swap(pool[p], pool[other]);
+        scratch.swaps.push_back(other);
+      }
+      return false;
+    });
+    for (int p = static_cast<int>(scratch.swaps.size()) - 1; p >= 0; p--) {
+      std::swap(scratch.pool[p], scratch.pool[scratch.swaps[p]]);
+    }
+  });
+  return selected;
+}
@@ -0,0 +1,89 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <Utilities/ThreadPool.h>
+
+// Lexicase selection over a dense score matrix. setScores copies the scores
+// (one row per case, one value per organism in each row) into one array and
+// works out what each case needs which does not depend on the keepers (ranks
+// and median absolute deviations). A selection then keeps its keepers in a
+// bitset over the selection pool, so it allocates nothing.
+class LexicaseSelector {
+public:
+  // how the cutoff for each case is found from the current keepers
+  enum EpsilonMode {
+    RANK,  // keep the best (keepers * epsilon)
+    SCORE, // keep score >= best - ((best - worst) * epsilon)
+    MAD    // keep score >= best - (median absolute deviation of the case)
+  };
+
+  // work space for one selection at a time
+  struct Scratch {
+    std::vector<int> pool;       // organisms in the selection pool
+    std::vector<int> order;      // cases, used from the back
+    std::vector<uint64_t> keep;  // bit p is set if pool[p] is a keeper
+    std::vector<double> values;  // current keepers' scores
+    std::vector<int32_t> rankValues; // current keepers' ranks
+    std::vector<int> swaps;      // to undo the pool shuffle in selectMany
+  };
+
+private:
+  int caseCount = 0;
+  int orgCount = 0;
+  EpsilonMode mode = RANK;
+  double epsilon = 0;
+  bool haveDelta = false;
+  bool useRanks = false;            // false if any score is NaN
+  std::vector<double> matrix;       // [case][organism]
+  std::vector<int32_t> ranks;       // [case][organism], equal scores share a rank
+  std::vector<double> madEpsilons;  // [case]
+  // the first case used by a selection where everyone is in the pool always
+  // has the same cutoff and keepers, so these are worked out once
+  std::vector<double> firstCutoffs;       // [case]
+  std::vector<int32_t> firstRankCutoffs;  // [case]
+  std::vector<uint64_t> firstKeepers;     // [case][organism bits]
+  std::vector<int> firstKeepCounts;       // [case]
+  int words = 0;                          // uint64_t per organism bitset
+  Scratch serialScratch;
+
+  // cutoff for keepers with these values in case c
+  double cutoffFor(std::vector<double> &values, int c) const;
+  int32_t cutoffFor(std::vector<int32_t> &values) const;
+
+  // one selection with poolSize organisms (at most everyone) drawn with gen.
+  // makePool fills scratch.pool, and returns true if pool[p] == p for everyone
+  // in the pool.
+  template <class Engine, class MakePool>
+  int selectWith(int poolSize, Engine &gen, Scratch &scratch, MakePool makePool) const;
+
+public:
+  LexicaseSelector() = default;
+
+  void setScores(const std::vector<std::vector<double>> &scores, EpsilonMode _mode,
+                 double _epsilon);
+
+  // false if every organism has the same score on every case
+  bool scoresHaveDelta() const { return haveDelta; }
+
+  // one parent. Draws from Random::withGenerator's generator (the same
+  // numbers, and the same parent, as selecting with a shuffled pool and
+  // keeper vectors).
+  int select(int poolSize);
+
+  // count parents, using threadPool. Selection i draws from its own stream
+  // (keyed on seed, update and i) so results do not depend on the number of
+  // threads.
+  std::vector<int> selectMany(int count, int poolSize, ThreadPool &threadPool);
+};
@@ -23,6 +23,12 @@ Parameters::register_parameter("OPTIMIZER_ROULETTE-remapFunction", (std::string)
 	"$minOptVal$ = minimum score in population\n"
     "$aveOptVal$ = average score in population\n"
 	"if NONE, no remap is preformed.");
+std::shared_ptr<ParameterLink<std::string>> RouletteOptimizer::selectionMethodPL =
+Parameters::register_parameter("OPTIMIZER_ROULETTE-selectionMethod", (std::string) "rejection", "how parents are drawn in proportion to their (remapped) score [rejection,alias]\n"
+	"rejection: draw a random organism and keep it with probability score / max score, else draw again\n"
+	"  (the number of draws per parent grows as max score / average score)\n"
+	"alias: build an alias table once per update, then draw each parent with one index and one double\n"
+	"with either method, organisms with scores <= 0 are never selected (unless all are, then selection is random)");
 
 
 int RouletteOptimizer::selectParent(std::vector<double>& scores, double maxScore, double minScore, int popSize){
@@ -30,6 +36,9 @@ int RouletteOptimizer::selectParent(std::vector<double>& scores, double maxScore
 	if (maxScore <= 0 || maxScore == minScore) {
 		return Random::getIndex(popSize);
 	}
+	if (aliasTableReady) {
+		return aliasTable.draw();
+	}
 	int parent;
 	int countTries = 0;
 	do {
@@ -54,7 +63,22 @@ RouletteOptimizer::RouletteOptimizer(std::shared_ptr<ParametersTable> PT_)
 
 	numberParents = numberParentsPL->get(PT);
 
+	if (selectionMethodPL->get(PT) == "rejection") {
+		useAliasTable = false;
+	}
+	else if (selectionMethodPL->get(PT) == "alias") {
+		useAliasTable = true;
+	}
+	else {
+		std::cout << "  while setting up RouletteOptimizer, found selectionMethod value \"" <<
+			selectionMethodPL->get(PT) << "\" but this value must be \"rejection\" or \"alias\"."
+			"\n  exiting." << std::endl;
+		exit(1);
+	}
+	aliasTableReady = false;
+
 	optimizeValueMT = stringToMTree(optimizeValuePL->get(PT));
+	optimizeValueProgram = MTreeProgram(optimizeValueMT);
 
 	if (remapFunctionPL->get(PT) == "NONE") {
 		doRemap = false;
@@ -67,6 +91,7 @@ RouletteOptimizer::RouletteOptimizer(std::shared_ptr<ParametersTable> PT_)
 		stringReplace(remapString, "$maxOptVal$", "VECT[0,2]");
 		stringReplace(remapString, "$optVal$", "VECT[0,3]");
 		remapFunctionMT = stringToMTree(remapString);
+		remapFunctionProgram = MTreeProgram(remapFunctionMT);
 	}
 	popFileColumns.clear();
 	popFileColumns.push_back("optimizeValue");
@@ -81,30 +106,30 @@ void RouletteOptimizer::optimize(std::vector<std::shared_ptr<Organism>>& populat
 	std::vector<double> scores(popSize, 0);
 	std::vector<double> remappedScores(popSize, 0);
 	double aveScore = 0;
-	double maxScore = optimizeValueMT->eval(population[0]->dataMap, PT)[0];
+	double maxScore = optimizeValueProgram.evalFirst(population[0]->dataMap, PT);
 	double minScore = maxScore;
 
 	killList.clear();
+	killList.insertRange(0, popSize); // the whole current generation
 
+	populationTable->refresh(population);
+	scores = optimizeValueProgram.evalAll(*populationTable, PT);
 	for (size_t i = 0; i < popSize; i++) {
-		killList.insert(population[i]);
-		double opVal = optimizeValueMT->eval(population[i]->dataMap, PT)[0];
-		scores[i] = opVal;
-		aveScore += opVal;
-		population[i]->dataMap.set("optimizeValue", opVal);
-		maxScore = std::max(maxScore, opVal);
-		minScore = std::min(minScore, opVal);
+		population[i]->dataMap.set("optimizeValue", scores[i]);
 	}
-
-	aveScore /= popSize;
+	populationTable->setColumn("optimizeValue", scores);
+	aveScore = PopulationTable::mean(scores);
+	maxScore = std::max(maxScore, PopulationTable::max(scores));
+	minScore = std::min(minScore, PopulationTable::min(scores));
 
 	std::vector<std::vector<double>> remapVect({ { minScore, aveScore, maxScore, 0 } });
 	if (doRemap) {
 		for (size_t i = 0; i < popSize; i++) {
 			remapVect[0][3] = scores[i];
-			remappedScores[i] = remapFunctionMT->eval(population[i]->dataMap, PT, remapVect)[0];
+			remappedScores[i] = remapFunctionProgram.evalFirst(population[i]->dataMap, PT, remapVect);
 			population[i]->dataMap.set("remappedOptimizeValue", remappedScores[i]);
 		}
+		populationTable->setColumn("remappedOptimizeValue", remappedScores);
 	}
 	else {
 		remappedScores = scores;
@@ -113,23 +138,25 @@ void RouletteOptimizer::optimize(std::vector<std::shared_ptr<Organism>>& populat
 
 	double remappedScoresMax = *std::max_element(remappedScores.begin(), remappedScores.end());
 	double remappedScoresMin = *std::min_element(remappedScores.begin(), remappedScores.end());
+	aliasTableReady = useAliasTable && aliasTable.build(remappedScores);
 
 	std::vector<std::shared_ptr<Organism>> parents;
 
 	for (int i = 0; i < popSize; i++) {
 		if (numberParents == 1) {
 			auto parent = population[selectParent(remappedScores, remappedScoresMax, remappedScoresMin, popSize)];
-			population.push_back(parent->makeMutatedOffspringFrom(parent)); // add to population
+			addOffspring(population, parent); // add to population
 		}
 		else {
 			parents.clear();
 			do {
 				parents.push_back(population[selectParent(remappedScores, remappedScoresMax, remappedScoresMin, popSize)]); // select from culled
 			} while (static_cast<int>(parents.size()) < numberParents);
-			population.push_back(parents[0]->makeMutatedOffspringFromMany(parents)); // push to population
+			addOffspring(population, parents); // push to population
 		}
 
 	}
+	finishOffspring(population);
 	for (int i = 0; i < popSize; i++) {
 		population[i]->dataMap.set("roulette_numOffspring", population[i]->offspringCount);
 	}
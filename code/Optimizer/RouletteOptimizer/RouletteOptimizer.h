@@ -10,6 +10,8 @@
 
 #include "../AbstractOptimizer.h"
 #include "../../Utilities/MTree.h"
+#include "../../Utilities/MTreeProgram.h"
+#include "../../Utilities/AliasTable.h"
 
 #include <iostream>
 #include <sstream>
@@ -19,6 +21,7 @@ public:
 	static std::shared_ptr<ParameterLink<int>> numberParentsPL;
 	static std::shared_ptr<ParameterLink<std::string>> optimizeValuePL;
 	static std::shared_ptr<ParameterLink<std::string>> remapFunctionPL;
+	static std::shared_ptr<ParameterLink<std::string>> selectionMethodPL;
 
 	int selectParent(std::vector<double>& scores, double maxScore, double minScore, int popSize);
 
@@ -27,7 +30,12 @@ public:
 	int numberParents;
 	std::shared_ptr<Abstract_MTree> optimizeValueMT;
 	std::shared_ptr<Abstract_MTree> remapFunctionMT;
+	MTreeProgram optimizeValueProgram; // optimizeValueMT, compiled
+	MTreeProgram remapFunctionProgram; // remapFunctionMT, compiled
 	bool doRemap;
+	bool useAliasTable; // else rejection sampling
+	bool aliasTableReady; // aliasTable holds this update's scores
+	AliasTable aliasTable;
 
 	RouletteOptimizer(std::shared_ptr<ParametersTable> PT_ = nullptr);
 
@@ -44,6 +44,7 @@ TournamentOptimizer::TournamentOptimizer(std::shared_ptr<ParametersTable> PT_)
 	minimizeError = minimizeErrorPL->get(PT);
 
 	optimizeValueMT = stringToMTree(optimizeValuePL->get(PT));
+	optimizeValueProgram = MTreeProgram(optimizeValueMT);
 
 	if (!minimizeError) {
 		optimizeFormula = optimizeValueMT; // set this so Archivist knows which org is max
@@ -61,29 +62,28 @@ void TournamentOptimizer::optimize(std::vector<std::shared_ptr<Organism>> &popul
 
 	std::vector<double> scores(popSize, 0);
 	double aveScore = 0;
-	double maxScore = optimizeValueMT->eval(population[0]->dataMap, PT)[0];
+	double maxScore = optimizeValueProgram.evalFirst(population[0]->dataMap, PT);
 	double minScore = maxScore;
 
 	killList.clear();
+	killList.insertRange(0, popSize); // the whole current generation
 
+	populationTable->refresh(population);
+	scores = optimizeValueProgram.evalAll(*populationTable, PT);
 	for (size_t i = 0; i < popSize; i++) {
-		killList.insert(population[i]);
-		double opVal = optimizeValueMT->eval(population[i]->dataMap, PT)[0];
-		scores[i] = opVal;
-		aveScore += opVal;
-		population[i]->dataMap.set("optimizeValue", opVal);
-		maxScore = std::max(maxScore, opVal);
-		minScore = std::min(minScore, opVal);
+		population[i]->dataMap.set("optimizeValue", scores[i]);
 	}
+	populationTable->setColumn("optimizeValue", scores);
+	aveScore = PopulationTable::mean(scores);
+	maxScore = std::max(maxScore, PopulationTable::max(scores));
+	minScore = std::min(minScore, PopulationTable::min(scores));
 	
-	aveScore /= popSize;
-
 	std::vector<std::shared_ptr<Organism>> parents;
 
 	for (int i = 0; i < popSize; i++) {
 		if (numberParents == 1) {
 			auto parent = population[selectParent(tournamentSize, minimizeError, scores, popSize)];
-			population.push_back(parent->makeMutatedOffspringFrom(parent)); // add to population
+			addOffspring(population, parent); // add to population
 		}
 		else {
 			parents.clear();
@@ -91,9 +91,10 @@ void TournamentOptimizer::optimize(std::vector<std::shared_ptr<Organism>> &popul
 			while (static_cast<int>(parents.size()) < numberParents) {
 				parents.push_back(population[selectParent(tournamentSize, minimizeError, scores, popSize)]); // select from culled
 			}
-			population.push_back(parents[0]->makeMutatedOffspringFromMany(parents)); // push to population
+			addOffspring(population, parents); // push to population
 		}
 	}
+	finishOffspring(population);
 
 	for (int i = 0; i < popSize; i++) {
 		population[i]->dataMap.set("tournament_numOffspring", population[i]->offspringCount);
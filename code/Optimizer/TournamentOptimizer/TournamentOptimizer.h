@@ -10,6 +10,7 @@
 
 #include "../AbstractOptimizer.h"
 #include "../../Utilities/MTree.h"
+#include "../../Utilities/MTreeProgram.h"
 
 #include <iostream>
 #include <sstream>
@@ -25,6 +26,7 @@ public:
 	int numberParents;
 	bool minimizeError;
 	std::shared_ptr<Abstract_MTree> optimizeValueMT;
+	MTreeProgram optimizeValueProgram; // optimizeValueMT, compiled
 
 	int selectParent(int tournamentSize, bool minimizeError, std::vector<double> scores, int popSize);
 
@@ -0,0 +1,265 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+// The parent links between Phylogeny records (see Phylogeny.h), without
+// anything about the organisms. Records are indices into one vector and are
+// reused once freed. A record is freed when it has been released (its
+// organism is gone) and no record has it as a parent, and then its parents
+// lose an offspring, which may free them in turn.
+//
+// Each record also keeps the XOR of its offspring's indices, so a record
+// with one offspring knows which it is, and the tree keeps the XOR of the
+// roots (records without parents) which have offspring. Once there is only
+// one such root, every record with a parent descends from it, and the most
+// recent common ancestor can be found by walking down from that root
+// through records with one offspring, rather than up the whole line of
+// descent (see mostRecentCommonAncestor).
+
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+class LineageTree {
+public:
+  virtual ~LineageTree() = default;
+
+  // make a record (with no parents) for an organism born at timeOfBirth
+  int add(int timeOfBirth) {
+    int record;
+    if (freeRecords.empty()) {
+      record = static_cast<int>(records.size());
+      records.emplace_back();
+    } else {
+      record = freeRecords.back();
+      freeRecords.pop_back();
+    }
+    records[record] = Record();
+    records[record].timeOfBirth = timeOfBirth;
+    records[record].released = false;
+    return record;
+  }
+
+  void addParent(int record, int parent) {
+    auto &r = records[record];
+    if (r.parent == -1) {
+      if (r.offspringCount > 0) {
+        trunkRootOut(record);
+      }
+      r.parent = parent;
+    } else {
+      otherParents[record].push_back(parent);
+    }
+    gainedOffspring(parent, record);
+  }
+
+  // give record the same parents as from
+  void copyParents(int from, int record) {
+    for (int parent : parents(from)) {
+      addParent(record, parent);
+    }
+  }
+
+  // forget record's parents (its line of descent will end at record)
+  void clearParents(int record) {
+    std::vector<int> toFree;
+    for (int parent : parents(record)) {
+      lostOffspring(parent, record, toFree);
+    }
+    if (records[record].parent != -1 && records[record].offspringCount > 0) {
+      trunkRootIn(record);
+    }
+    records[record].parent = -1;
+    otherParents.erase(record);
+    freeAll(toFree);
+  }
+
+  // record's organism is gone
+  void release(int record) {
+    records[record].released = true;
+    if (records[record].offspringCount == 0) {
+      std::vector<int> toFree = {record};
+      freeAll(toFree);
+    }
+  }
+
+  bool released(int record) const { return records[record].released; }
+  int timeOfBirth(int record) const { return records[record].timeOfBirth; }
+  void setTimeOfBirth(int record, int time) { records[record].timeOfBirth = time; }
+  // timeOfBirth of the newest offspring (-1 if none)
+  int lastOffspringBirth(int record) const { return records[record].lastOffspringBirth; }
+  // the number of records with record as a parent
+  int offspringCount(int record) const { return records[record].offspringCount; }
+
+  int parentCount(int record) const {
+    if (records[record].parent == -1) {
+      return 0;
+    }
+    auto others = otherParents.find(record);
+    return 1 + (others == otherParents.end() ? 0 : static_cast<int>(others->second.size()));
+  }
+
+  std::vector<int> parents(int record) const {
+    std::vector<int> list;
+    if (records[record].parent != -1) {
+      list.push_back(records[record].parent);
+      auto others = otherParents.find(record);
+      if (others != otherParents.end()) {
+        list.insert(list.end(), others->second.begin(), others->second.end());
+      }
+    }
+    return list;
+  }
+
+  // record and all of its ancestors, oldest first. Fails if any of them has
+  // more than one parent (!not for sexual reproduction!)
+  std::vector<int> lineOfDescent(int record) const {
+    int length = 1;
+    int oldest = record;
+    while (parentCount(oldest) == 1) {
+      oldest = records[oldest].parent;
+      length++;
+    }
+    checkOneParent(oldest);
+    std::vector<int> LOD(length);
+    for (int i = length - 1; i >= 0; i--) {
+      LOD[i] = record;
+      record = records[record].parent;
+    }
+    return LOD;
+  }
+
+  // the oldest record in LOD with more than one offspring, else the last
+  int mostRecentCommonAncestor(const std::vector<int> &LOD) const {
+    for (int record : LOD) { // starting at the oldest, moving to the youngest
+      if (records[record].offspringCount > 1) {
+        // the first (oldest) ancestor with more then one surviving offspring
+        return record;
+      }
+    }
+    return LOD.back(); // a living organism with no offspring may be the MRCA
+  }
+
+  // the same as mostRecentCommonAncestor(lineOfDescent(record)), with trunk
+  // set to the start of that line of descent, up to and including the MRCA.
+  // If there is one root with offspring and record has a parent, this walks
+  // down from the root, so it only visits the trunk (which is only as long
+  // as the MRCA has moved since the line of descent was last cut with
+  // clearParents)
+  int mostRecentCommonAncestor(int record, std::vector<int> &trunk) const {
+    trunk.clear();
+    if (trunkRoots != 1 || records[record].parent == -1) {
+      trunk = lineOfDescent(record);
+      int MRCA = mostRecentCommonAncestor(trunk);
+      trunk.resize(std::find(trunk.begin(), trunk.end(), MRCA) - trunk.begin() + 1);
+      return MRCA;
+    }
+    checkOneParent(record);
+    int MRCA = trunkRootXor;
+    trunk.push_back(MRCA);
+    while (records[MRCA].offspringCount == 1) {
+      MRCA = records[MRCA].offspringXor; // the one offspring
+      checkOneParent(MRCA);
+      trunk.push_back(MRCA);
+    }
+    return MRCA;
+  }
+
+  // records in use, and the size of the tree (all record indices are less)
+  size_t size() const { return records.size() - freeRecords.size(); }
+  size_t capacity() const { return records.size(); }
+
+protected:
+  // record is about to be freed
+  virtual void freeing(int /*record*/) {}
+  // one of record's offspring was freed while record is not released
+  virtual void offspringFreed(int /*record*/) {}
+
+private:
+  struct Record {
+    int timeOfBirth = -1;
+    int lastOffspringBirth = -1;
+    int parent = -1; // first parent (-1 if none)
+    int offspringCount = 0;
+    int offspringXor = 0; // XOR of the offspring's indices
+    bool released = true;
+  };
+
+  std::vector<Record> records;
+  std::vector<int> freeRecords;
+  // parents past the first (only with sexual reproduction)
+  std::unordered_map<int, std::vector<int>> otherParents;
+  // roots (records without parents) with offspring
+  int trunkRoots = 0;
+  int trunkRootXor = 0;
+
+  void trunkRootIn(int record) {
+    trunkRoots++;
+    trunkRootXor ^= record;
+  }
+  void trunkRootOut(int record) {
+    trunkRoots--;
+    trunkRootXor ^= record;
+  }
+
+  void checkOneParent(int record) const {
+    if (parentCount(record) > 1) { // if more than one parent we have a problem!
+      std::cout << "In LineageTree::lineOfDescent()\n Looks like you "
+                   "have enabled sexual reproduction.\nLOD only works with "
+                   "asexual populations. i.e. an offspring may have at most one "
+                   "parent.\nExiting!\n";
+      exit(1);
+    }
+  }
+
+  void gainedOffspring(int record, int offspring) {
+    auto &r = records[record];
+    if (r.offspringCount++ == 0 && r.parent == -1) {
+      trunkRootIn(record);
+    }
+    r.offspringXor ^= offspring;
+    r.lastOffspringBirth = std::max(r.lastOffspringBirth, records[offspring].timeOfBirth);
+  }
+
+  void lostOffspring(int record, int offspring, std::vector<int> &toFree) {
+    auto &r = records[record];
+    r.offspringXor ^= offspring;
+    if (--r.offspringCount == 0) {
+      if (r.parent == -1) {
+        trunkRootOut(record);
+      }
+      if (r.released) {
+        toFree.push_back(record);
+      }
+    }
+  }
+
+  // free the records in toFree, and then any of their ancestors which are
+  // left released and with no offspring
+  void freeAll(std::vector<int> &toFree) {
+    while (!toFree.empty()) {
+      int record = toFree.back();
+      toFree.pop_back();
+      freeing(record);
+      for (int parent : parents(record)) {
+        if (!records[parent].released) {
+          offspringFreed(parent);
+        }
+        lostOffspring(parent, record, toFree);
+      }
+      otherParents.erase(record);
+      records[record] = Record();
+      freeRecords.push_back(record);
+    }
+  }
+};
@@ -36,6 +36,7 @@ void Organism::initOrganism(std::shared_ptr<ParametersTable> PT_) {
   dataMap.set("ID", ID);
   dataMap.set("alive", alive);
   dataMap.set("timeOfBirth", timeOfBirth);
+  phylogenyRecord = Phylogeny::get().add(this);
 }
 
 /*
@@ -113,6 +114,7 @@ Organism::Organism(
 
   parents.push_back(from);
   from->offspringCount++; // this parent has an(other) offspring
+  Phylogeny::get().addParent(phylogenyRecord, from->phylogenyRecord);
   for (auto ancestorID : from->ancestors) {
     ancestors.insert(ancestorID); // union all parents ancestors into this
                                   // organisms ancestor set.
@@ -155,6 +157,7 @@ Organism::Organism(
   for (auto const &parent : from) {
     parents.push_back(parent); // add this parent to the parents set
     parent->offspringCount++;  // this parent has an(other) offspring
+    Phylogeny::get().addParent(phylogenyRecord, parent->phylogenyRecord);
     for (auto ancestorID : parent->ancestors) {
       ancestors.insert(ancestorID); // union all parents ancestors into this
                                     // organisms ancestor set
@@ -173,10 +176,14 @@ int Organism::registerOrganism() {
 }
 
 Organism::~Organism() {
-  for (auto const &parent : parents) {
-    parent->offspringCount--; // this parent has one less child in memory
-  }
+  // the parents' offspringCounts go down when the record is freed (which may
+  // be later, if this organism has offspring with records)
+  Phylogeny::get().release(phylogenyRecord, *this);
+}
+
+void Organism::clearParents() {
   parents.clear();
+  Phylogeny::get().clearParents(phylogenyRecord);
 }
 
 /*
@@ -185,6 +192,7 @@ Organism::~Organism() {
 void Organism::kill() {
   alive = false;
   timeOfDeath = Global::update;
+  Phylogeny::get().setTimeOfDeath(phylogenyRecord, timeOfDeath);
   if (!trackOrganism) { // if the archivist is not tracking is organism, we can
                         // clear it's genomes and brains.
     genomes.clear();
@@ -192,11 +200,10 @@ void Organism::kill() {
   }
 }
 
-std::shared_ptr<Organism>
-Organism::makeMutatedOffspringFrom(std::shared_ptr<Organism> from) {
-
-  std::unordered_map<std::string, std::shared_ptr<AbstractGenome>> newGenomes;
-  std::unordered_map<std::string, std::shared_ptr<AbstractBrain>> newBrains;
+void Organism::makeMutatedPartsFrom(
+    std::shared_ptr<Organism> from,
+    std::unordered_map<std::string, std::shared_ptr<AbstractGenome>> &newGenomes,
+    std::unordered_map<std::string, std::shared_ptr<AbstractBrain>> &newBrains) {
 
   for (auto genome : from->genomes) {
     newGenomes[genome.first] =
@@ -208,21 +215,18 @@ Organism::makeMutatedOffspringFrom(std::shared_ptr<Organism> from) {
         brain.second->makeBrainFrom(brain.second, newGenomes);
     newBrains[brain.first]->mutate();
   }
-
-  return std::make_shared<Organism>(from, newGenomes, newBrains, PT);
 }
 
-std::shared_ptr<Organism> Organism::makeMutatedOffspringFromMany(
-    std::vector<std::shared_ptr<Organism>> from) {
-
-  std::unordered_map<std::string, std::shared_ptr<AbstractGenome>> newGenomes;
-  std::unordered_map<std::string, std::shared_ptr<AbstractBrain>> newBrains;
+void Organism::makeMutatedPartsFromMany(
+    std::vector<std::shared_ptr<Organism>> from,
+    std::unordered_map<std::string, std::shared_ptr<AbstractGenome>> &newGenomes,
+    std::unordered_map<std::string, std::shared_ptr<AbstractBrain>> &newBrains) {
 
   for (auto genome : from[0]->genomes) {
     std::vector<std::shared_ptr<AbstractGenome>>
         parentGenomes; // make a list of parents genomes
     for (auto const &p : from) {
-      parentGenomes.push_back(p->genomes[genome.first]);
+      parentGenomes.push_back(p->genomes.at(genome.first));
     }
     newGenomes[genome.first] =
         genome.second->makeMutatedGenomeFromMany(parentGenomes);
@@ -232,85 +236,31 @@ std::shared_ptr<Organism> Organism::makeMutatedOffspringFromMany(
     std::vector<std::shared_ptr<AbstractBrain>>
         parentBrains; // make a list of parents genomes
     for (auto const &p : from) {
-      parentBrains.push_back(p->brains[brain.first]);
+      parentBrains.push_back(p->brains.at(brain.first));
     }
 
     newBrains[brain.first] =
         brain.second->makeBrainFromMany(parentBrains, newGenomes);
     newBrains[brain.first]->mutate();
   }
+}
 
+std::shared_ptr<Organism>
+Organism::makeMutatedOffspringFrom(std::shared_ptr<Organism> from) {
+
+  std::unordered_map<std::string, std::shared_ptr<AbstractGenome>> newGenomes;
+  std::unordered_map<std::string, std::shared_ptr<AbstractBrain>> newBrains;
+  makeMutatedPartsFrom(from, newGenomes, newBrains);
   return std::make_shared<Organism>(from, newGenomes, newBrains, PT);
 }
 
-/*
- * Given a genome return a list of Organisms containing this Organism and all if
- * this Organisms ancestors ordered oldest first
- * it will fail if any organism in the LOD has more then one parent. (!not for
- * sexual reproduction!)
- */
-std::vector<std::shared_ptr<Organism>>
-Organism::getLOD(std::shared_ptr<Organism> org) {
-  std::vector<std::shared_ptr<Organism>> list;
-
-  list.push_back(org); // add this organism to the front of the LOD list
-  while (org->parents.size() ==
-         1) {              // while the current org has one and only one parent
-    org = org->parents[0]; // move to the next ancestor (since there is only one
-                           // parent it is the element in the first position).
-    list.push_back(org);   // add that ancestor to the front of the LOD list
-  }
-  reverse(list.begin(), list.end());
-  for (size_t i = 0; i < list.size(); i++) {
-  }
-  if (org->parents.size() > 1) { // if more than one parent we have a problem!
-    std::cout
-        << "In Organism::getLOD(shared_ptr<Organism> org)\n Looks like you "
-           "have enabled sexual reproduction.\nLOD only works with asexual "
-           "populations. i.e. an offspring may have at most one "
-           "parent.\nExiting!\n";
-    exit(1);
-  }
-  return list;
-}
+std::shared_ptr<Organism> Organism::makeMutatedOffspringFromMany(
+    std::vector<std::shared_ptr<Organism>> from) {
 
-/*
- * find the Most Recent Common Ancestor
- * uses getLOD to get a list of ancestors (oldest first). seaches the list for
- * the first ancestor with a referenceCounter > 1
- * that is the first reference counter with more then one offspring.
- * If none are found, then return "from"
- * Note: a currently active genome has a referenceCounter = 1 (it has not
- * reproduced yet, it only has 1 for it's self)
- *       a dead Organism with a referenceCounter = 0 will not be in the LOD (it
- * has no offspring and will have been pruned)
- *       a dead Organism with a referenceCounter = 1 has only one offspring.
- *       a dead Organism with a referenceCounter > 1 has more then one spring
- * with surviving lines of decent.
- */
-std::shared_ptr<Organism>
-Organism::getMostRecentCommonAncestor(std::shared_ptr<Organism> org) {
-  std::vector<std::shared_ptr<Organism>> LOD =
-      getLOD(org); // get line of decent parent "parent"
-  for (auto org :
-       LOD) { // starting at the oldest parent, moving to the youngest
-    if (org->offspringCount >
-        1) // the first (oldest) ancestor with more then one surviving offspring
-      return org;
-  }
-  return org; // a currently active genome will have referenceCounter = 1 but
-              // may be the Most Recent Common Ancestor
-}
-std::shared_ptr<Organism> Organism::getMostRecentCommonAncestor(
-    std::vector<std::shared_ptr<Organism>> LOD) {
-  for (auto org :
-       LOD) { // starting at the oldest parent, moving to the youngest
-    if (org->offspringCount >
-        1) // the first (oldest) ancestor with more then one surviving offspring
-      return org;
-  }
-  return LOD.back(); // a currently active genome will have referenceCounter = 1
-                     // but may be the Most Recent Common Ancestor
+  std::unordered_map<std::string, std::shared_ptr<AbstractGenome>> newGenomes;
+  std::unordered_map<std::string, std::shared_ptr<AbstractBrain>> newBrains;
+  makeMutatedPartsFromMany(from, newGenomes, newBrains);
+  return std::make_shared<Organism>(from, newGenomes, newBrains, PT);
 }
 
 std::shared_ptr<Organism>
@@ -327,11 +277,16 @@ Organism::makeCopy(std::shared_ptr<ParametersTable> PT_) {
   newOrg->snapShotDataMaps = snapShotDataMaps;
   newOrg->offspringCount = offspringCount;
   newOrg->parents = parents;
-  for (auto const &parent : parents) {
-    parent->offspringCount++;
-  }
   newOrg->ancestors = ancestors;
   newOrg->timeOfBirth = timeOfBirth;
+  auto &phylogeny = Phylogeny::get();
+  phylogeny.setTimeOfBirth(newOrg->phylogenyRecord, timeOfBirth);
+  phylogeny.copyParents(phylogenyRecord, newOrg->phylogenyRecord);
+  for (int parent : phylogeny.parents(phylogenyRecord)) {
+    if (phylogeny.organism(parent) != nullptr) {
+      phylogeny.organism(parent)->offspringCount++;
+    }
+  }
   newOrg->timeOfDeath = timeOfDeath;
   newOrg->alive = alive;
   return newOrg;
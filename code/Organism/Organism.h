@@ -16,6 +16,7 @@
 
 #include <Brain/AbstractBrain.h>
 #include <Genome/AbstractGenome.h>
+#include <Organism/Phylogeny.h>
 
 #include <Utilities/Data.h>
 #include <Utilities/Parameters.h>
@@ -26,6 +27,9 @@ private:
   int registerOrganism();       // get an Organism_id (uses organismIDCounter)
 
 public:
+  // the ID the next organism made will have
+  static int getNextID() { return organismIDCounter; }
+
   DataMap dataMap; // holds all data (genome size, score, world data, etc.)
   std::map<int, DataMap> snapShotDataMaps; // Used only with SnapShot with Delay
   // (SSwD) stores contents of dataMap when
@@ -43,7 +47,10 @@ public:
   std::vector<std::shared_ptr<Organism>>
       parents; // parents are pointers to parents of
                // this organism. In asexual populations
-               // this will have one element
+               // this will have one element. Archivists which
+               // follow lines of descent use phylogenyRecord
+               // and may clear these once the offspring are made.
+  int phylogenyRecord; // this organisms record in Phylogeny::get()
   std::unordered_set<int>
       ancestors; // list of the IDs of organisms in the last data
                  // files who are ancestors of this organism
@@ -97,12 +104,20 @@ public:
 
   virtual void kill(); // sets alive = 0 (on org and in dataMap)
 
-  virtual std::vector<std::shared_ptr<Organism>>
-  getLOD(std::shared_ptr<Organism> org);
-  virtual std::shared_ptr<Organism>
-  getMostRecentCommonAncestor(std::shared_ptr<Organism> org);
-  virtual std::shared_ptr<Organism>
-  getMostRecentCommonAncestor(std::vector<std::shared_ptr<Organism>> LOD);
+  // forget parents (both the pointers and the phylogeny record links)
+  void clearParents();
+
+  // the genomes and brains of a mutated offspring of from (everything
+  // makeMutatedOffspringFrom(Many) does except make the organism). These only
+  // read from the parents, so more than one thread may call them at a time.
+  virtual void makeMutatedPartsFrom(
+      std::shared_ptr<Organism> from,
+      std::unordered_map<std::string, std::shared_ptr<AbstractGenome>> &newGenomes,
+      std::unordered_map<std::string, std::shared_ptr<AbstractBrain>> &newBrains);
+  virtual void makeMutatedPartsFromMany(
+      std::vector<std::shared_ptr<Organism>> from,
+      std::unordered_map<std::string, std::shared_ptr<AbstractGenome>> &newGenomes,
+      std::unordered_map<std::string, std::shared_ptr<AbstractBrain>> &newBrains);
   virtual std::shared_ptr<Organism>
   makeMutatedOffspringFrom(std::shared_ptr<Organism> parent);
   virtual std::shared_ptr<Organism>
@@ -0,0 +1,117 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+#include <Organism/Phylogeny.h>
+
+#include <algorithm>
+#include <iostream>
+
+#include <Organism/Organism.h>
+
+Phylogeny &Phylogeny::get() {
+  // never deleted, so organisms deleted at exit can still release records
+  static Phylogeny *phylogeny = new Phylogeny;
+  return *phylogeny;
+}
+
+int Phylogeny::add(Organism *organism) {
+  int record = LineageTree::add(organism->timeOfBirth);
+  if (payloads.size() < capacity()) {
+    payloads.resize(capacity());
+  }
+  auto &p = payloads[record];
+  p.ID = organism->ID;
+  p.timeOfDeath = organism->timeOfDeath;
+  p.organism = organism;
+  return record;
+}
+
+void Phylogeny::freeing(int record) { payloads[record] = Payload(); }
+
+void Phylogeny::offspringFreed(int record) { payloads[record].organism->offspringCount--; }
+
+bool Phylogeny::timeIn(const std::vector<int> &times, int from, int to) {
+  auto next = std::upper_bound(times.begin(), times.end(), from);
+  return next != times.end() && *next <= to;
+}
+
+void Phylogeny::addTimes(std::vector<int> &to, const std::vector<int> &times) {
+  to.insert(to.end(), times.begin(), times.end());
+  std::sort(to.begin(), to.end());
+  to.erase(std::unique(to.begin(), to.end()), to.end());
+}
+
+void Phylogeny::keepDataAt(const std::vector<int> &times) { addTimes(dataTimes, times); }
+
+void Phylogeny::keepOrganismsAt(const std::vector<int> &times, bool packed) {
+  addTimes(organismTimes, times);
+  packGenomes = packGenomes && packed;
+}
+
+void Phylogeny::release(int record, Organism &organism) {
+  payloads[record].organism = nullptr;
+  if (offspringCount(record) == 0) {
+    LineageTree::release(record);
+    return;
+  }
+
+  // the record is an ancestor of a record in use. An LOD file written at
+  // time T uses the newest ancestor born before T, so this one is only
+  // needed for times after its birth up to its newest offspring's birth
+  payloads[record].kept = std::make_unique<Kept>();
+  auto &kept = *payloads[record].kept;
+  kept.snapshotAncestors = std::move(organism.snapshotAncestors);
+  if (timeIn(dataTimes, timeOfBirth(record), lastOffspringBirth(record))) {
+    kept.dataMap = std::make_unique<DataMap>(std::move(organism.dataMap));
+  }
+  if (!organism.genomes.empty() &&
+      timeIn(organismTimes, timeOfBirth(record), lastOffspringBirth(record))) {
+    kept.packedOrganism = std::make_unique<DataMap>();
+    for (auto &genome : organism.genomes) {
+      auto name = "GENOME_" + genome.first;
+      kept.packedOrganism->merge(packGenomes ? genome.second->serializePacked(name)
+                                             : genome.second->serialize(name));
+    }
+    for (auto &brain : organism.brains) {
+      auto name = "BRAIN_" + brain.first;
+      kept.packedOrganism->merge(brain.second->serialize(name));
+    }
+  }
+  LineageTree::release(record);
+}
+
+DataMap &Phylogeny::dataMap(int record) {
+  auto &p = payloads[record];
+  if (p.organism != nullptr) {
+    return p.organism->dataMap;
+  }
+  if (!p.kept || !p.kept->dataMap) {
+    std::cout << "  ERROR :: the data of organism " << p.ID
+              << " was not kept after it was deleted (it was not expected to be "
+                 "written).\n  Exiting."
+              << std::endl;
+    exit(1);
+  }
+  return *p.kept->dataMap;
+}
+
+DataMap *Phylogeny::packedOrganism(int record) {
+  auto &p = payloads[record];
+  return p.kept ? p.kept->packedOrganism.get() : nullptr;
+}
+
+const std::unordered_set<int> &Phylogeny::snapshotAncestors(int record) const {
+  static const std::unordered_set<int> none;
+  auto &p = payloads[record];
+  if (p.organism != nullptr) {
+    return p.organism->snapshotAncestors;
+  }
+  return p.kept ? p.kept->snapshotAncestors : none;
+}
@@ -0,0 +1,100 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+// Who descends from whom, for the archivists which follow lines of descent.
+// Every organism has a small record (ID, times, parent record) in one arena;
+// records are linked to their parents by index (see LineageTree) rather than
+// by holding on to the parent Organisms, so an ancestor costs a record rather
+// than a whole organism once it has died.
+//
+// A record lives as long as its organism does or any record has it as a
+// parent (the same lifetime an Organism had when offspring held shared_ptrs
+// to their parents). When an organism is deleted but its record lives on, the
+// record keeps only what an archivist may still write about it: its
+// snapshotAncestors, its dataMap if an LOD data file may be written while it
+// is the newest ancestor on a line of descent (see keepDataAt), and its
+// serialized genomes and brains likewise for LOD organism files
+// (see keepOrganismsAt).
+//
+// Records are made and released as organisms are made and deleted, and like
+// organisms that happens on one thread at a time.
+
+#pragma once
+
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include <Organism/LineageTree.h>
+#include <Utilities/Data.h>
+
+class Organism;
+
+class Phylogeny : public LineageTree {
+public:
+  // the one store all organisms use
+  static Phylogeny &get();
+
+  int add(Organism *organism); // make a record for organism (with no parents)
+  // organism (which has record) is being deleted
+  void release(int record, Organism &organism);
+
+  // which times LOD files will be written at (from all archivists, sorted).
+  // Genomes are kept packed (see AbstractGenome::serializePacked) if every
+  // archivist writing organisms wants them packed
+  void keepDataAt(const std::vector<int> &times);
+  void keepOrganismsAt(const std::vector<int> &times, bool packed);
+
+  int ID(int record) const { return payloads[record].ID; }
+  int timeOfDeath(int record) const { return payloads[record].timeOfDeath; }
+  void setTimeOfDeath(int record, int time) { payloads[record].timeOfDeath = time; }
+  // nullptr once the organism has been deleted
+  Organism *organism(int record) const { return payloads[record].organism; }
+
+  // the organism's dataMap, or the one kept when it was deleted
+  DataMap &dataMap(int record);
+  // serialized genomes and brains kept when the organism was deleted (nullptr
+  // if none were kept)
+  DataMap *packedOrganism(int record);
+  const std::unordered_set<int> &snapshotAncestors(int record) const;
+
+protected:
+  void freeing(int record) override;
+  // an offspring record being freed is when the offspring Organism used to be
+  // deleted (while offspring held on to their parents), so this is when the
+  // parent's offspringCount goes down
+  void offspringFreed(int record) override;
+
+private:
+  // what a record keeps once its organism has been deleted
+  struct Kept {
+    std::unordered_set<int> snapshotAncestors;
+    std::unique_ptr<DataMap> dataMap;
+    std::unique_ptr<DataMap> packedOrganism;
+  };
+
+  // everything a record has besides its links (kept in step with the
+  // records, by index)
+  struct Payload {
+    int ID = -1;
+    int timeOfDeath = -1;
+    Organism *organism = nullptr;
+    std::unique_ptr<Kept> kept;
+  };
+
+  std::vector<Payload> payloads;
+  std::vector<int> dataTimes;
+  std::vector<int> organismTimes;
+  bool packGenomes = true;
+
+  // is there a time in times after from and no later than to
+  static bool timeIn(const std::vector<int> &times, int from, int to);
+  static void addTimes(std::vector<int> &to, const std::vector<int> &times);
+};
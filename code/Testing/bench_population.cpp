@@ -0,0 +1,113 @@
+// Removing killed organisms from a 100000 organism population: the
+// std::unordered_set<std::shared_ptr<Organism>> kill list AbstractOptimizer
+// used to keep (and the cleanup which copied the survivors into a new
+// vector) against KillList. Reports the time to mark the organisms to kill
+// and the time cleanup takes, for a generational optimizer (the whole old
+// generation is killed after its offspring are added) and for one which
+// kills a random 10% of the population.
+// build and run with "make bench"
+
+#include <Utilities/KillList.h>
+#include <Utilities/Random.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+const int popSize = 100000;
+const int repeats = 20;
+
+// stands in for Organism
+struct Org {
+	int ID;
+	bool alive = true;
+	explicit Org(int _ID) : ID(_ID) {}
+	void kill() { alive = false; }
+};
+
+using Population = std::vector<std::shared_ptr<Org>>;
+
+double seconds(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// as AbstractOptimizer::cleanup was
+void setCleanup(Population &population, std::unordered_set<std::shared_ptr<Org>> &killList) {
+	Population newPopulation;
+	for (auto org : population) {
+		if (killList.find(org) == killList.end()) {
+			newPopulation.push_back(org);
+		}
+		else {
+			org->kill();
+		}
+	}
+	population = newPopulation;
+	killList.clear();
+}
+
+// killed lists which organisms (by index) to kill in population
+void compare(const std::string &name, const Population &start, const std::vector<int> &killed) {
+	double setMark = 0, setClean = 0, listMark = 0, listClean = 0;
+	size_t setLeft = 0, listLeft = 0;
+	for (int r = 0; r < repeats; r++) {
+		Population population = start;
+		std::unordered_set<std::shared_ptr<Org>> killSet;
+		auto t = std::chrono::steady_clock::now();
+		for (int i : killed) {
+			killSet.insert(population[i]);
+		}
+		setMark += seconds(t);
+		t = std::chrono::steady_clock::now();
+		setCleanup(population, killSet);
+		setClean += seconds(t);
+		setLeft = population.size();
+
+		population = start;
+		KillList killList;
+		t = std::chrono::steady_clock::now();
+		for (int i : killed) {
+			killList.insert(i);
+		}
+		listMark += seconds(t);
+		t = std::chrono::steady_clock::now();
+		killList.apply(population);
+		listClean += seconds(t);
+		listLeft = population.size();
+	}
+	std::cout << name << "  (" << start.size() << " organisms, " << killed.size() << " killed)" << std::endl;
+	std::cout << std::fixed << std::setprecision(3)
+		<< "  unordered_set: mark " << std::setw(8) << setMark * 1e3 / repeats << " ms   cleanup "
+		<< std::setw(8) << setClean * 1e3 / repeats << " ms   (" << setLeft << " left)" << std::endl
+		<< "  KillList:      mark " << std::setw(8) << listMark * 1e3 / repeats << " ms   cleanup "
+		<< std::setw(8) << listClean * 1e3 / repeats << " ms   (" << listLeft << " left)" << std::endl;
+}
+
+int main() {
+	Random::getCommonGenerator().seed(101);
+
+	// old generation followed by its offspring
+	Population population;
+	for (int i = 0; i < 2 * popSize; i++) {
+		population.push_back(std::make_shared<Org>(i));
+	}
+	std::vector<int> killed;
+	for (int i = 0; i < popSize; i++) {
+		killed.push_back(i);
+	}
+	compare("generational", population, killed);
+
+	population.resize(popSize);
+	killed.clear();
+	for (int i = 0; i < popSize; i++) {
+		if (Random::P(.1)) {
+			killed.push_back(i);
+		}
+	}
+	compare("random 10%", population, killed);
+	return 0;
+}
@@ -0,0 +1,66 @@
+// Throughput of the common generator (mt19937 + std distributions) against
+// Random::StreamGenerator, both called directly and through a ScopedStream.
+// build and run with "make bench"
+
+#include <Utilities/Random.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+template <typename Function>
+void timeIt(const std::string &name, Function f) {
+	const int draws = 50000000;
+	double sink = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < draws; i++) {
+		sink += f();
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "  " << name << ": " << (elapsed.count() * 1e9 / draws) << " ns/draw"
+		<< "  (" << (draws / elapsed.count() / 1e6) << " M draws/s)  [" << sink << "]" << std::endl;
+}
+
+int main() {
+	Random::getCommonGenerator().seed(101);
+	Random::StreamGenerator stream(101, 0, 0);
+
+	std::cout << "getDouble(1)" << std::endl;
+	timeIt("mt19937 (common)        ", [] { return Random::getDouble(1); });
+	timeIt("StreamGenerator (passed)", [&] { return Random::getDouble(1, stream); });
+	{
+		Random::ScopedStream useStream(stream);
+		timeIt("StreamGenerator (scoped)", [] { return Random::getDouble(1); });
+	}
+
+	std::cout << "getInt(0, 99)" << std::endl;
+	timeIt("mt19937 (common)        ", [] { return Random::getInt(0, 99); });
+	timeIt("StreamGenerator (passed)", [&] { return Random::getInt(0, 99, stream); });
+	{
+		Random::ScopedStream useStream(stream);
+		timeIt("StreamGenerator (scoped)", [] { return Random::getInt(0, 99); });
+	}
+
+	std::cout << "P(.25)" << std::endl;
+	timeIt("mt19937 (common)        ", [] { return Random::P(.25); });
+	{
+		Random::ScopedStream useStream(stream);
+		timeIt("StreamGenerator (scoped)", [] { return Random::P(.25); });
+	}
+
+	std::cout << "new stream per organism + 100 draws" << std::endl;
+	int id = 0;
+	timeIt("mt19937 seeded per org  ", [&] {
+		Random::Generator gen(id++);
+		double total = 0;
+		for (int i = 0; i < 100; i++) total += Random::getDouble(1, gen);
+		return total;
+	});
+	timeIt("StreamGenerator per org ", [&] {
+		Random::StreamGenerator orgStream(101, 0, id++);
+		double total = 0;
+		for (int i = 0; i < 100; i++) total += Random::getDouble(1, orgStream);
+		return total;
+	});
+	return 0;
+}
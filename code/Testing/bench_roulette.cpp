@@ -0,0 +1,90 @@
+// Roulette (fitness proportional) parent selection: the rejection sampling
+// RouletteOptimizer uses by default against an AliasTable, over score
+// distributions with more and more skew. Reports random draws per parent,
+// time per parent, and the largest difference between how often an organism
+// was picked and how often it should have been.
+// build and run with "make bench"
+
+#include <Utilities/AliasTable.h>
+#include <Utilities/Random.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+const int popSize = 1000;
+const int parents = 2000000;
+
+// as RouletteOptimizer::selectParent, counting the numbers drawn
+int rejectionSelect(const std::vector<double> &scores, double maxScore, long long &draws) {
+	int parent;
+	do {
+		parent = Random::getIndex(popSize);
+		draws += 2;
+	} while (!Random::P(scores[parent] / maxScore));
+	return parent;
+}
+
+template <typename Function>
+void timeIt(const std::string &name, const std::vector<double> &scores, long long &draws, Function f) {
+	std::vector<long long> picks(popSize, 0);
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < parents; i++) {
+		picks[f()]++;
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	double total = 0;
+	for (double s : scores) total += s;
+	double worst = 0;
+	for (int i = 0; i < popSize; i++) {
+		worst = std::max(worst, std::abs(picks[i] / (double)parents - scores[i] / total));
+	}
+	std::cout << "  " << name << ": " << std::setw(10) << (draws / (double)parents) << " draws/parent  "
+		<< std::setw(9) << (elapsed.count() * 1e9 / parents) << " ns/parent  (max frequency error "
+		<< worst << ")" << std::endl;
+}
+
+void compare(const std::string &name, const std::vector<double> &scores) {
+	double maxScore = *std::max_element(scores.begin(), scores.end());
+	double total = 0;
+	for (double s : scores) total += s;
+	std::cout << name << "  (max / average score = " << maxScore / (total / popSize) << ")" << std::endl;
+
+	long long draws = 0;
+	timeIt("rejection", scores, draws, [&] { return rejectionSelect(scores, maxScore, draws); });
+
+	AliasTable table;
+	draws = 0;
+	auto start = std::chrono::steady_clock::now();
+	table.build(scores);
+	std::chrono::duration<double> built = std::chrono::steady_clock::now() - start;
+	timeIt("alias    ", scores, draws, [&] { draws += 2; return table.draw(); });
+	std::cout << "  (alias table built in " << built.count() * 1e6 << " us)" << std::endl;
+}
+
+int main() {
+	Random::getCommonGenerator().seed(101);
+	std::vector<double> scores(popSize);
+
+	for (int i = 0; i < popSize; i++) scores[i] = Random::getDouble(1, 2);
+	compare("uniform [1,2)", scores);
+
+	for (int i = 0; i < popSize; i++) scores[i] = std::exp(Random::getDouble(0, 5));
+	compare("exp(uniform [0,5))", scores);
+
+	// POW[1.05, score] style remaps of scores with a long tail
+	for (int i = 0; i < popSize; i++) scores[i] = std::pow(1.05, 100 / Random::getDouble(0.05, 1));
+	compare("1.05^(100 / uniform [.05,1))", scores);
+
+	for (int i = 0; i < popSize; i++) scores[i] = 1;
+	scores[popSize / 2] = 10000;
+	compare("one organism 10000x the rest", scores);
+
+	for (int i = 0; i < popSize; i++) scores[i] = (i < 10) ? 1 : 1e-6;
+	compare("1% of organisms score 1e6x the rest", scores);
+	return 0;
+}
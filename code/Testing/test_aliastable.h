@@ -0,0 +1,79 @@
+#include <Utilities/AliasTable.h>
+#include <Utilities/Random.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// how often each index is drawn in draws draws
+std::vector<int> drawCounts(const AliasTable &table, int draws, uint64_t seed) {
+	Random::StreamGenerator stream(seed);
+	std::vector<int> counts(table.size(), 0);
+	for (int i = 0; i < draws; i++) {
+		counts[table.draw(stream)]++;
+	}
+	return counts;
+}
+
+TEST(aliasTable, DrawsInProportionToWeights) {
+	const int draws = 400000;
+	for (auto weights : std::vector<std::vector<double>>{
+	         { 1, 2, 3, 4 },
+	         { 0.001, 1000, 1, 0, 7.5 },
+	         std::vector<double>(100, 1.0),
+	         { 1e-9, 1e-9, 3e-9 },
+	     }) {
+		AliasTable table;
+		ASSERT_TRUE(table.build(weights));
+		ASSERT_EQ(table.size(), (int)weights.size());
+		double total = 0;
+		for (double w : weights) {
+			total += w;
+		}
+		auto counts = drawCounts(table, draws, 1);
+		for (size_t i = 0; i < weights.size(); i++) {
+			double p = weights[i] / total;
+			double sigma = std::sqrt(p * (1 - p) / draws);
+			EXPECT_NEAR((double)counts[i] / draws, p, 5 * sigma + 1e-12) << "index " << i << " of " << weights.size();
+		}
+	}
+}
+
+TEST(aliasTable, SingleNonzeroWeightIsAlwaysDrawn) {
+	AliasTable table;
+	ASSERT_TRUE(table.build({ 0, 0, 0.25, 0, 0 }));
+	auto counts = drawCounts(table, 10000, 2);
+	EXPECT_EQ(counts[2], 10000);
+}
+
+TEST(aliasTable, AllZeroWeightsDoNotBuild) {
+	AliasTable table;
+	EXPECT_FALSE(table.build({ 0, 0, 0 }));
+	EXPECT_EQ(table.size(), 0);
+	EXPECT_FALSE(table.build({}));
+	EXPECT_EQ(table.size(), 0);
+	// and a failed build empties a table which was built before
+	ASSERT_TRUE(table.build({ 1, 1 }));
+	EXPECT_FALSE(table.build({ 0, 0 }));
+	EXPECT_EQ(table.size(), 0);
+}
+
+TEST(aliasTable, NegativeAndNaNWeightsAreNeverDrawn) {
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	AliasTable table;
+	ASSERT_TRUE(table.build({ -5, 1, nan, 3, -0.5 }));
+	auto counts = drawCounts(table, 100000, 3);
+	EXPECT_EQ(counts[0], 0);
+	EXPECT_EQ(counts[2], 0);
+	EXPECT_EQ(counts[4], 0);
+	EXPECT_NEAR(counts[3] / 100000.0, 0.75, 0.01);
+	// only negative and NaN weights is the same as all zero
+	EXPECT_FALSE(table.build({ -1, nan, -2 }));
+	EXPECT_EQ(table.size(), 0);
+}
+
+TEST(aliasTable, InfiniteTotalDoesNotBuild) {
+	AliasTable table;
+	EXPECT_FALSE(table.build({ 1, std::numeric_limits<double>::infinity() }));
+	EXPECT_FALSE(table.build({ std::numeric_limits<double>::max(), std::numeric_limits<double>::max() }));
+}
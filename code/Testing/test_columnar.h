@@ -0,0 +1,167 @@
+#include <Utilities/ColumnarFile.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// writes rows of (update, ID, alive, score, name) through a ColumnarWriter to
+// fileName, the way FileManager does, and returns the csv MABE would have
+// written for the same rows
+std::string writeColumnarFile(const std::string &fileName, bool compress, size_t rowGroupRows,
+                              int updates, int rowsPerUpdate) {
+	ColumnarWriter writer({{"update", Columnar::INT},
+	                       {"ID", Columnar::INT},
+	                       {"alive", Columnar::BOOL},
+	                       {"score", Columnar::DOUBLE},
+	                       {"name", Columnar::STRING}},
+	                      compress, rowGroupRows);
+	std::ofstream file(fileName, std::ios::binary);
+	file << writer.fileHeader();
+	std::string csv = "update,ID,alive,score,name\n";
+	int ID = -5;
+	for (int update = 0; update < updates; update++) {
+		for (int row = 0; row < rowsPerUpdate; row++, ID += 3) {
+			double score = (ID % 4) / 3.0 - 0.5;
+			std::string name = (row % 3 == 0) ? "" : "org " + std::to_string(ID % 7);
+			writer.add(update);
+			writer.add(ID);
+			writer.add(row % 2 == 0);
+			writer.add(score);
+			writer.add(name);
+			if (writer.endRow()) {
+				file << writer.takeRowGroup();
+			}
+			csv += std::to_string(update) + "," + std::to_string(ID) + "," +
+			       std::to_string(row % 2 == 0) + "," + std::to_string(score) + ",\"" + name + "\"\n";
+		}
+	}
+	file << writer.takeRowGroup(true);
+	return csv;
+}
+
+void checkColumnarRoundTrip(bool compress, size_t rowGroupRows, int updates, int rowsPerUpdate) {
+	std::string fileName = "test_columnar.mcol";
+	std::string csv = writeColumnarFile(fileName, compress, rowGroupRows, updates, rowsPerUpdate);
+	ColumnarReader reader(fileName);
+	EXPECT_EQ(reader.rowCount(), static_cast<size_t>(updates * rowsPerUpdate));
+	auto const &groups = reader.getRowGroups();
+	for (auto const &group : groups) {
+		if (&group != &groups.back()) {
+			EXPECT_GE(group.rows, rowGroupRows) << "only the last row group may be short";
+		}
+		EXPECT_EQ(group.rows % rowsPerUpdate, 0u) << "a row group should hold whole updates";
+		EXPECT_EQ(static_cast<int>(group.rows), (group.lastUpdate - group.firstUpdate + 1) * rowsPerUpdate);
+	}
+	std::ostringstream out;
+	reader.writeCSV(out);
+	EXPECT_EQ(out.str(), csv) << "the csv should be just what MABE would have written";
+
+	auto IDs = reader.readColumn("ID");
+	ASSERT_EQ(IDs.ints.size(), reader.rowCount());
+	EXPECT_EQ(IDs.ints.front(), -5);
+	EXPECT_EQ(IDs.ints.back(), -5 + 3 * (updates * rowsPerUpdate - 1));
+	EXPECT_EQ(reader.findColumn("missing"), -1);
+	std::remove(fileName.c_str());
+}
+
+TEST(columnarFile, RoundTripCompressed) {
+	checkColumnarRoundTrip(true, 10, 20, 7);
+	checkColumnarRoundTrip(true, 1, 5, 3);
+	checkColumnarRoundTrip(true, 1000, 3, 600); // dictionary and bit packed columns
+}
+
+TEST(columnarFile, RoundTripPlain) {
+	checkColumnarRoundTrip(false, 10, 20, 7);
+	checkColumnarRoundTrip(false, 1000, 3, 600);
+}
+
+TEST(columnarFile, CompressionMakesSmallerFiles) {
+	writeColumnarFile("test_columnar_plain.mcol", false, 1000, 3, 600);
+	writeColumnarFile("test_columnar_compressed.mcol", true, 1000, 3, 600);
+	std::ifstream plain("test_columnar_plain.mcol", std::ios::binary | std::ios::ate);
+	std::ifstream compressed("test_columnar_compressed.mcol", std::ios::binary | std::ios::ate);
+	EXPECT_LT(compressed.tellg() * 2, plain.tellg());
+	std::remove("test_columnar_plain.mcol");
+	std::remove("test_columnar_compressed.mcol");
+}
+
+// the file's values of column, as text
+std::vector<std::string> columnText(ColumnarReader &reader, const std::string &column) {
+	auto values = reader.readColumn(column);
+	std::vector<std::string> text;
+	for (size_t row = 0; row < values.size(); row++) {
+		text.push_back(values.text(row));
+	}
+	return text;
+}
+
+TEST(columnarFile, NumbersInAStringColumnAreText) {
+	std::string fileName = "test_columnar_strings.mcol";
+	ColumnarWriter writer({{"update", Columnar::INT}, {"name", Columnar::STRING}, {"score", Columnar::DOUBLE}},
+	                      true, 2);
+	std::ofstream file(fileName, std::ios::binary);
+	file << writer.fileHeader();
+	for (int update = 0; update < 4; update++) {
+		writer.add(update);
+		switch (update) {
+		case 0: writer.add(std::string("a")); break;
+		case 1: writer.add(true); break;
+		case 2: writer.add(-7); break;
+		default: writer.add(0.25);
+		}
+		writer.add(update + 0.5);
+		if (writer.endRow()) {
+			file << writer.takeRowGroup();
+		}
+	}
+	file << writer.takeRowGroup(true);
+	file.close();
+
+	ColumnarReader reader(fileName);
+	ASSERT_EQ(reader.rowCount(), 4u);
+	EXPECT_EQ(reader.getColumns()[1].type, Columnar::STRING);
+	EXPECT_EQ(columnText(reader, "name"), std::vector<std::string>({"\"a\"", "\"1\"", "\"-7\"", "\"0.250000\""}));
+	EXPECT_EQ(columnText(reader, "score"),
+	          std::vector<std::string>({"0.500000", "1.500000", "2.500000", "3.500000"}));
+	std::remove(fileName.c_str());
+}
+
+TEST(columnarFile, ColumnsWidenUntilTheFirstRowGroup) {
+	std::string fileName = "test_columnar_widen.mcol";
+	ColumnarWriter writer({{"update", Columnar::INT}, {"count", Columnar::INT}, {"flag", Columnar::BOOL}},
+	                      false, 3);
+	// rows 0 and 1 are held when row 1 widens count to double and flag to int
+	writer.add(0);
+	writer.add(4);
+	writer.add(true);
+	writer.endRow();
+	writer.add(1);
+	writer.add(2.5);
+	writer.add(9);
+	writer.endRow();
+	for (int update = 2; update < 5; update++) {
+		writer.add(update);
+		writer.add(update);
+		writer.add(false);
+		if (writer.endRow()) {
+			std::ofstream file(fileName, std::ios::binary);
+			file << writer.fileHeader() << writer.takeRowGroup() << writer.takeRowGroup(true);
+		}
+	}
+	{
+		ColumnarReader reader(fileName);
+		ASSERT_EQ(reader.rowCount(), 4u);
+		EXPECT_EQ(reader.getColumns()[1].type, Columnar::DOUBLE);
+		EXPECT_EQ(reader.getColumns()[2].type, Columnar::INT);
+		EXPECT_EQ(columnText(reader, "count"),
+		          std::vector<std::string>({"4.000000", "2.500000", "2.000000", "3.000000"}));
+		EXPECT_EQ(columnText(reader, "flag"), std::vector<std::string>({"1", "9", "0", "0"}));
+	}
+	std::remove(fileName.c_str());
+
+	// once a row group has been taken (and the header written) the columns
+	// are fixed, and a double in an int column (update) stops the run
+	EXPECT_EXIT(writer.add(0.5), ::testing::ExitedWithCode(1), "");
+}
@@ -0,0 +1,60 @@
+#include <Utilities/CSV.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+void writeTestFile(const std::string &fileName, const std::string &contents) {
+	std::ofstream file(fileName, std::ios::binary);
+	file << contents;
+}
+
+TEST(mappedCSV, MatchesCSV) {
+	std::string fileName = "test_mapped.csv";
+	writeTestFile(fileName, "ID,sites, name ,score\n"
+	                        "1,\"1,2,3\",a,0.5\n"
+	                        "2, \"\" ,  b  ,\"\"\n"
+	                        "3,\"x y\",c\",-1\n"
+	                        "4,,,\n"
+	                        "5,\"a\"  ,\"d,e\", 7");
+	CSV csv(fileName);
+	MappedCSV mapped(fileName);
+	EXPECT_EQ(mapped.column_names(), csv.column_names());
+	ASSERT_EQ(mapped.row_count(), csv.row_count());
+	auto rows = csv.rows();
+	for (size_t row = 0; row < rows.size(); row++) {
+		EXPECT_EQ(mapped.row(row), rows[row]);
+		for (int column = 0; column < static_cast<int>(mapped.column_names().size()); column++) {
+			EXPECT_EQ(mapped.field(row, column), rows[row][column]) << "row " << row << " column " << column;
+		}
+	}
+	EXPECT_EQ(mapped.columnIndex("score"), 3);
+	EXPECT_EQ(mapped.columnIndex("missing"), -1);
+	std::remove(fileName.c_str());
+}
+
+TEST(mappedCSV, RejectsWhatCSVRejects) {
+	CSVReader reader;
+	std::string spaced = "1,a b,2";
+	EXPECT_EXIT(reader.parseLine(spaced), ::testing::ExitedWithCode(1), "");
+	EXPECT_EXIT(reader.parseField(&spaced[2], &spaced[0] + spaced.size(), nullptr),
+	            ::testing::ExitedWithCode(1), "");
+	std::string unclosed = "1,\"a,2";
+	EXPECT_EXIT(reader.parseLine(unclosed), ::testing::ExitedWithCode(1), "");
+	EXPECT_EXIT(reader.parseField(&unclosed[2], &unclosed[0] + unclosed.size(), nullptr),
+	            ::testing::ExitedWithCode(1), "");
+
+	// rows are checked when the file is indexed, as CSV checks them on reading
+	std::string fileName = "test_mapped_bad.csv";
+	writeTestFile(fileName, "ID,name,score\n1,a b,2\n");
+	EXPECT_EXIT(MappedCSV{ fileName }, ::testing::ExitedWithCode(1), "");
+	writeTestFile(fileName, "ID,name,score\n1,a,2\n2,short\n");
+	EXPECT_EXIT(MappedCSV{ fileName }, ::testing::ExitedWithCode(1), "");
+	writeTestFile(fileName, "ID,name,score\n1,a,2\n2,\"b,c\",3,4\n3,d,5\n");
+	EXPECT_EXIT(MappedCSV{ fileName }, ::testing::ExitedWithCode(1), "");
+	writeTestFile(fileName, "ID,name,score\n1,a,2\n2,\"b,c\",3\n");
+	MappedCSV mapped(fileName);
+	EXPECT_EQ(mapped.field(1, 1), "b,c");
+	EXPECT_EXIT(mapped.field(1, 3), ::testing::ExitedWithCode(1), "");
+	std::remove(fileName.c_str());
+}
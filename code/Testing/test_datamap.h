@@ -0,0 +1,225 @@
+#include <Utilities/Data.h>
+
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// DataMap with its symbol table in reach
+class DataMapSymbols : public DataMap {
+public:
+	using DataMap::findSymbol;
+	using DataMap::intern;
+	using DataMap::symbolCount;
+};
+
+TEST(dataMap, SetAppendAndClear) {
+	DataMap dataMap;
+	dataMap.set("ID", 7);
+	dataMap.set("name", std::string("abc"));
+	dataMap.append("score", 1.5);
+	dataMap.append("score", 2.5);
+	dataMap.append("alive", true);
+	dataMap.append("alive", false);
+	dataMap.set("hidden", 3);
+	dataMap.setOutputBehavior("hidden", DataMap::NO_OUTPUT);
+	// keys are listed sorted, without NO_OUTPUT keys
+	EXPECT_EQ(dataMap.getKeys(), std::vector<std::string>({ "ID", "alive", "name", "score" }));
+	EXPECT_EQ(dataMap.getIntVector("ID"), std::vector<int>({ 7 }));
+	EXPECT_EQ(dataMap.getDoubleVector("score"), std::vector<double>({ 1.5, 2.5 }));
+	EXPECT_EQ(dataMap.getAverage("score"), 2.0);
+	EXPECT_EQ(dataMap.getSum("alive"), 1.0);
+	EXPECT_EQ(dataMap.getStringOfVector("alive"), "1,0");
+	EXPECT_TRUE(dataMap.isKeySolo("ID"));
+	EXPECT_FALSE(dataMap.isKeySolo("score"));
+
+	dataMap.clear("score");
+	EXPECT_FALSE(dataMap.fieldExists("score"));
+	EXPECT_EQ(dataMap.getKeys(), std::vector<std::string>({ "ID", "alive", "name" }));
+	// a cleared key can be used again, with another type
+	dataMap.append("score", 4);
+	EXPECT_EQ(dataMap.getIntVector("score"), std::vector<int>({ 4 }));
+	dataMap.clearMap();
+	EXPECT_TRUE(dataMap.getKeys().empty());
+	EXPECT_FALSE(dataMap.fieldExists("ID"));
+}
+
+TEST(dataMap, CopyAndMerge) {
+	auto source = std::make_shared<DataMap>();
+	source->set("a", 1);
+	source->append("b", 2.0);
+	DataMap copy(source);
+	copy.set("a", 5);
+	copy.set("c", 6);
+	EXPECT_EQ(source->getIntVector("a"), std::vector<int>({ 1 }));
+	EXPECT_FALSE(source->fieldExists("c"));
+	EXPECT_EQ(copy.getDoubleVector("b"), std::vector<double>({ 2.0 }));
+
+	DataMap keep(source), replace(source);
+	keep.merge(copy, 1);    // keep this map's values
+	replace.merge(copy, 2); // take the other map's values
+	EXPECT_EQ(keep.getIntVector("a"), std::vector<int>({ 1 }));
+	EXPECT_EQ(replace.getIntVector("a"), std::vector<int>({ 5 }));
+	EXPECT_EQ(keep.getIntVector("c"), std::vector<int>({ 6 }));
+	// merged keys keep the other map's output behavior
+	EXPECT_EQ(keep.getOutputBehavior("c"), (int)DataMap::FIRST);
+	EXPECT_EQ(keep.getKeys(), std::vector<std::string>({ "a", "b", "c" }));
+}
+
+TEST(dataMap, HeaderAndDataStrings) {
+	DataMap dataMap;
+	dataMap.set("ID", 12);
+	dataMap.set("name", std::string("x y"));
+	dataMap.append("score", 1);
+	dataMap.append("score", 2);
+	dataMap.append("alive", true);
+	dataMap.append("ratio", 0.25);
+	dataMap.append("ratio", 0.75);
+	dataMap.setOutputBehavior("ratio", DataMap::AVE | DataMap::VAR | DataMap::SUM);
+	std::string header, data;
+	dataMap.constructHeaderAndDataStrings(header, data, dataMap.getKeys());
+	EXPECT_EQ(header, "ID,alive_AVE,alive_LIST,name,ratio_AVE,ratio_VAR,ratio_SUM,score_AVE,score_LIST");
+	// (a list of one short value keeps its trailing comma, as it always has)
+	EXPECT_EQ(data, "12,1.000000,\"1,\",\"x y\",0.500000,0.125000,1.000000,1.500000,\"1,2\"");
+	dataMap.constructHeaderAndDataStrings(header, data, dataMap.getKeys(), true);
+	EXPECT_EQ(header, "ID,alive_AVE,ratio_AVE,score_AVE");
+	EXPECT_EQ(data, "12,1.000000,0.500000,1.500000");
+	dataMap.constructHeaderAndDataStrings(header, data, { "score", "ID" });
+	EXPECT_EQ(header, "score_AVE,score_LIST,ID");
+	EXPECT_EQ(data, "1.500000,\"1,2\",12");
+}
+
+TEST(dataMap, FindSymbolDoesNotAddKeys) {
+	DataMap dataMap;
+	int symbols = DataMapSymbols::symbolCount();
+	std::string key = "DATAMAP_TEST_never_set";
+	EXPECT_EQ(DataMapSymbols::findSymbol(key), -1);
+	EXPECT_FALSE(dataMap.fieldExists(key));
+	EXPECT_EQ(dataMap.getOutputBehavior(key), 0);
+	dataMap.clear(key);
+	EXPECT_EQ(DataMapSymbols::findSymbol(key), -1);
+	EXPECT_EQ(DataMapSymbols::symbolCount(), symbols);
+
+	dataMap.set(key, 1);
+	EXPECT_EQ(DataMapSymbols::symbolCount(), symbols + 1);
+	EXPECT_EQ(DataMapSymbols::findSymbol(key), DataMapSymbols::intern(key));
+	EXPECT_EQ(DataMapSymbols::symbolCount(), symbols + 1);
+}
+
+// int values of a DataMap, kept the way the DataMap should keep them
+struct ReferenceDataMap {
+	struct Entry {
+		std::vector<int> values;
+		int outputBehavior;
+	};
+	std::map<std::string, Entry> entries; // sorted, as getKeys lists them
+
+	void set(const std::string &key, int value) { entries[key] = { { value }, DataMap::FIRST }; }
+	void append(const std::string &key, int value) {
+		entries[key].values.push_back(value);
+		entries[key].outputBehavior = DataMap::LIST | DataMap::AVE;
+	}
+	void merge(const ReferenceDataMap &other, int replace) {
+		for (auto &otherEntry : other.entries) {
+			if (replace == 2 || !entries.count(otherEntry.first)) {
+				entries[otherEntry.first] = otherEntry.second;
+			}
+		}
+	}
+	std::vector<std::string> keys() const {
+		std::vector<std::string> keys;
+		for (auto &entry : entries) {
+			keys.push_back(entry.first);
+		}
+		return keys;
+	}
+	// what constructHeaderAndDataStrings makes from all keys
+	void headerAndData(std::string &header, std::string &data) const {
+		header = data = "";
+		for (auto &entry : entries) {
+			auto &values = entry.second.values;
+			if (entry.second.outputBehavior & DataMap::FIRST) {
+				header += "," + entry.first;
+				data += "," + std::to_string(values[0]);
+			}
+			if (entry.second.outputBehavior & DataMap::AVE) {
+				double sum = 0;
+				std::string list;
+				for (int v : values) {
+					sum += v;
+					list += std::to_string(v) + ",";
+				}
+				if (list.size() > 2) { // as getStringOfVector drops the last comma
+					list.pop_back();
+				}
+				header += "," + entry.first + "_AVE," + entry.first + "_LIST";
+				data += "," + std::to_string(sum / values.size()) + ",\"" + list + "\"";
+			}
+		}
+		header.erase(0, 1);
+		data.erase(0, 1);
+	}
+};
+
+TEST(dataMap, RandomSequencesMatchReference) {
+	const std::vector<std::string> keys = { "a", "b", "ID", "score", "score_2", "z" };
+	std::mt19937 gen(13);
+	std::uniform_int_distribution<int> op(0, 9), key(0, (int)keys.size() - 1), value(-50, 50), replace(1, 2);
+	for (int run = 0; run < 50; run++) {
+		DataMap dataMap, other;
+		ReferenceDataMap reference, otherReference;
+		for (int step = 0; step < 40; step++) {
+			auto &k = keys[key(gen)];
+			int v = value(gen);
+			switch (op(gen)) {
+			case 0:
+			case 1:
+				dataMap.set(k, v);
+				reference.set(k, v);
+				break;
+			case 2:
+			case 3:
+			case 4:
+				dataMap.append(k, v);
+				reference.append(k, v);
+				break;
+			case 5:
+				dataMap.clear(k);
+				reference.entries.erase(k);
+				break;
+			case 6: { // work on a copy from here on
+				DataMap copy(std::make_shared<DataMap>(dataMap));
+				dataMap.clearMap();
+				dataMap = copy;
+				break;
+			}
+			case 7:
+				other.append(k, v);
+				otherReference.append(k, v);
+				break;
+			case 8: {
+				int r = replace(gen);
+				dataMap.merge(other, r);
+				reference.merge(otherReference, r);
+				break;
+			}
+			default:
+				other.set(k, v);
+				otherReference.set(k, v);
+			}
+			std::string where = "run " + std::to_string(run) + " step " + std::to_string(step);
+			ASSERT_EQ(dataMap.getKeys(), reference.keys()) << where;
+			for (auto &entry : reference.entries) {
+				ASSERT_EQ(dataMap.getIntVector(entry.first), entry.second.values) << where << " key " << entry.first;
+			}
+			if (!reference.entries.empty()) {
+				std::string header, data, expectedHeader, expectedData;
+				dataMap.constructHeaderAndDataStrings(header, data, dataMap.getKeys());
+				reference.headerAndData(expectedHeader, expectedData);
+				ASSERT_EQ(header, expectedHeader) << where;
+				ASSERT_EQ(data, expectedData) << where;
+			}
+		}
+	}
+}
@@ -0,0 +1,221 @@
+#include <Brain/MarkovBrain/Gate/ProbabilisticGate.h>
+#include <Brain/MarkovBrain/GateListBuilder/GateListBuilder.h>
+#include <Genome/CircularGenome/CircularGenome.h>
+#include <Utilities/Random.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// everything translateGates reads into a gate
+std::string gateSignature(const std::shared_ptr<AbstractGate> &gate) {
+	std::string signature = gate->description() + gate->getTPMdescription();
+	if (auto probabilistic = std::dynamic_pointer_cast<ProbabilisticGate>(gate)) {
+		for (auto &row : probabilistic->table) {
+			for (double p : row) {
+				signature += " " + std::to_string(p);
+			}
+		}
+	}
+	return signature;
+}
+
+void expectSameTranslation(const GateTranslation &expected, const GateTranslation &actual, const std::string &where) {
+	ASSERT_EQ(expected.hasLayout, actual.hasLayout) << where;
+	EXPECT_EQ(expected.genomeSize, actual.genomeSize) << where;
+	EXPECT_EQ(expected.startSites, actual.startSites) << where;
+	EXPECT_EQ(expected.startGates, actual.startGates) << where;
+	EXPECT_EQ(expected.gateEnds, actual.gateEnds) << where;
+	ASSERT_EQ(expected.gates.size(), actual.gates.size()) << where;
+	for (size_t g = 0; g < expected.gates.size(); g++) {
+		EXPECT_EQ(gateSignature(expected.gates[g]), gateSignature(actual.gates[g])) << where << " gate " << g;
+	}
+}
+
+class gateListBuilder : public ::testing::Test {
+protected:
+	std::shared_ptr<ParametersTable> PT;
+	std::shared_ptr<ClassicGateListBuilder> builder;
+	const int nrNodes = 16;
+
+	void SetUp() override {
+		PT = Parameters::root->getTable("GATELIST_TEST::");
+		PT->setParameter("BRAIN_MARKOV_GATES_PROBABILISTIC-allow", true);
+		PT->setParameter("GENOME_CIRCULAR-mutationPointRate", 0.002);
+		PT->setParameter("GENOME_CIRCULAR-mutationCopyRate", 0.0005);
+		PT->setParameter("GENOME_CIRCULAR-mutationCopyMinSize", 8);
+		PT->setParameter("GENOME_CIRCULAR-mutationCopyMaxSize", 64);
+		PT->setParameter("GENOME_CIRCULAR-mutationDeleteRate", 0.0005);
+		PT->setParameter("GENOME_CIRCULAR-mutationDeleteMinSize", 8);
+		PT->setParameter("GENOME_CIRCULAR-mutationDeleteMaxSize", 64);
+		PT->setParameter("GENOME_CIRCULAR-sizeMin", 1000);
+		PT->setParameter("GENOME_CIRCULAR-sizeMax", 4000);
+		builder = std::make_shared<ClassicGateListBuilder>(PT);
+	}
+
+	// a random genome with start codons for every gate type in use
+	std::shared_ptr<CircularGenome<int>> makeGenome(std::mt19937 &gen, int size, int startsPerCodon) {
+		auto genome = std::make_shared<CircularGenome<int>>(256, size, PT);
+		std::uniform_int_distribution<int> value(0, 255), site(0, size - 2);
+		for (auto &s : genome->sites) {
+			s = value(gen);
+		}
+		auto &startCodes = builder->gateBuilder.gateStartCodes;
+		for (int codon = 0; codon < (int)startCodes.size(); codon++) {
+			if (startCodes[codon].size() != 0) {
+				for (int i = 0; i < startsPerCodon; i++) {
+					int start = site(gen);
+					genome->sites[start] = codon;
+					genome->sites[start + 1] = startCodes[codon][1];
+				}
+			}
+		}
+		genome->sitesChanged();
+		return genome;
+	}
+
+	// a copy of parent, as made for an offspring (before mutation)
+	std::shared_ptr<CircularGenome<int>> copyOf(std::shared_ptr<CircularGenome<int>> parent) {
+		auto child = std::make_shared<CircularGenome<int>>(PT);
+		child->copyFrom(parent);
+		return child;
+	}
+
+	// translate child from parentTranslation and from scratch and compare them
+	std::shared_ptr<GateTranslation> checkRetranslation(std::shared_ptr<CircularGenome<int>> parent, const GateTranslation &parentTranslation,
+	                                                    std::shared_ptr<CircularGenome<int>> child, const std::string &where) {
+		std::vector<AbstractGenome::SiteEdit> edits;
+		EXPECT_TRUE(child->getEditsFrom(parent, parent->getSitesVersion(), edits)) << where;
+		auto expected = builder->translateGates(child, nrNodes, PT);
+		auto actual = builder->retranslateGates(child, nrNodes, edits, parentTranslation, PT);
+		expectSameTranslation(*expected, *actual, where);
+		return actual;
+	}
+};
+
+TEST_F(gateListBuilder, RetranslateMatchesTranslateAfterMutate) {
+	for (unsigned seed = 1; seed <= 20; seed++) {
+		std::mt19937 gen(seed);
+		Random::getCommonGenerator().seed(seed);
+		auto parent = makeGenome(gen, 2000, 4);
+		auto translation = builder->translateGates(parent, nrNodes, PT);
+		ASSERT_TRUE(translation->hasLayout);
+		ASSERT_GT(translation->gates.size(), 0u);
+		// a line of descent, each child retranslated from its parent
+		for (int generation = 0; generation < 30; generation++) {
+			auto child = copyOf(parent);
+			child->mutate();
+			translation = checkRetranslation(parent, *translation, child,
+			                                 "seed " + std::to_string(seed) + " generation " + std::to_string(generation));
+			parent = child;
+		}
+	}
+}
+
+TEST_F(gateListBuilder, RetranslateMatchesTranslateForEditsAtGateStarts) {
+	std::mt19937 gen(3);
+	auto parent = makeGenome(gen, 1500, 4);
+	auto translation = builder->translateGates(parent, nrNodes, PT);
+	ASSERT_GT(translation->gates.size(), 0u);
+	std::uniform_int_distribution<int> value(0, 255);
+
+	for (int start : translation->startSites) {
+		for (int offset = -3; offset <= 3; offset++) {
+			int position = start + offset;
+			if (position < 0 || position + 4 > parent->countSites()) {
+				continue;
+			}
+			std::string where = "start " + std::to_string(start) + " offset " + std::to_string(offset);
+
+			auto point = copyOf(parent);  // point mutation on or next to the start codon
+			point->sites[position] = value(gen);
+			point->recordEdit(position, 1, 1);
+			checkRetranslation(parent, *translation, point, where + " point");
+
+			auto insertion = copyOf(parent);  // sites inserted before, into or after the start codon
+			std::vector<int> inserted = { value(gen), value(gen), value(gen) };
+			insertion->sites.insert(insertion->sites.begin() + position, inserted.begin(), inserted.end());
+			insertion->recordEdit(position, 0, (int)inserted.size());
+			checkRetranslation(parent, *translation, insertion, where + " insertion");
+
+			auto deletion = copyOf(parent);  // sites removed across the start codon
+			deletion->sites.erase(deletion->sites.begin() + position, deletion->sites.begin() + position + 4);
+			deletion->recordEdit(position, 4, 0);
+			checkRetranslation(parent, *translation, deletion, where + " deletion");
+		}
+	}
+
+	// several edits in one offspring, a later one moving sites an earlier one changed
+	auto child = copyOf(parent);
+	int first = translation->startSites.front();
+	child->sites.erase(child->sites.begin() + first, child->sites.begin() + first + 2);
+	child->recordEdit(first, 2, 0);
+	child->sites.insert(child->sites.begin(), { 1, 2, 3, 4, 5 });
+	child->recordEdit(0, 0, 5);
+	child->sites[first + 5] = value(gen);
+	child->recordEdit(first + 5, 1, 1);
+	checkRetranslation(parent, *translation, child, "several edits");
+}
+
+// start codon sites the way the gate list builder found them before
+// findCodonPairs: stepping a handler over the genome one readInt(0, codonMax)
+// at a time, so site i starts a gate if its codon and the codon at the next
+// site (wrapping to site 0) are a start pair
+std::vector<int> legacyCodonPairs(std::shared_ptr<AbstractGenome> genome, const std::vector<int> &secondCodon, int codonMax, int first, int last) {
+	auto handler = genome->newHandler(genome, true);
+	std::vector<int> codons;
+	for (int i = 0; i < genome->countSites(); i++) {
+		codons.push_back(handler->readInt(0, codonMax));
+	}
+	std::vector<int> starts;
+	for (int i = first; i <= last; i++) {
+		int codon = codons[i];
+		if (codon < (int)secondCodon.size() && secondCodon[codon] == codons[(i + 1) % codons.size()]) {
+			starts.push_back(i);
+		}
+	}
+	return starts;
+}
+
+TEST(codonPairs, CharGenomesMatchTheLegacyScan) {
+	std::mt19937 gen(9);
+	std::uniform_int_distribution<int> value(0, 255);
+	// codonMax 255 takes the 16 site at a time path, 15 and 3 the scalar one
+	for (int codonMax : { 255, 15, 3 }) {
+		std::uniform_int_distribution<int> codon(0, codonMax);
+		std::vector<int> secondCodon(codonMax + 1, -1);
+		std::vector<int> startCodons;
+		for (int c = 0; c <= codonMax; c += 1 + codonMax / 8) { // a few start pairs
+			secondCodon[c] = codon(gen);
+			startCodons.push_back(c);
+		}
+		for (int size : { 3, 15, 16, 17, 31, 33, 100, 1000, 1023 }) {
+			auto genome = std::make_shared<CircularGenome<unsigned char>>(256, size, nullptr);
+			for (auto &s : genome->sites) {
+				s = (unsigned char)value(gen);
+			}
+			for (int i = 0; i + 1 < size; i += 1 + value(gen) % 8) { // and many start pairs
+				int c = startCodons[value(gen) % startCodons.size()];
+				genome->sites[i] = (unsigned char)c;
+				genome->sites[i + 1] = (unsigned char)secondCodon[c];
+			}
+			// a start codon which wraps from the last site to site 0
+			genome->sites[size - 1] = 0;
+			genome->sites[0] = secondCodon[0];
+			for (auto range : std::vector<std::pair<int, int>>{ { 0, size - 1 }, { 0, size - 3 }, { 1, size - 2 }, { 5, size - 7 } }) {
+				std::string where = "codonMax " + std::to_string(codonMax) + " size " + std::to_string(size) +
+				                    " sites " + std::to_string(range.first) + " to " + std::to_string(range.second);
+				std::vector<int> starts;
+				ASSERT_TRUE(genome->findCodonPairs(secondCodon, codonMax, range.first, range.second, starts)) << where;
+				auto expected = range.first <= range.second ? legacyCodonPairs(genome, secondCodon, codonMax, range.first, range.second)
+				                                            : std::vector<int>();
+				EXPECT_EQ(starts, expected) << where;
+				if (range.second == size - 1) {
+					ASSERT_FALSE(starts.empty()) << where;
+					EXPECT_EQ(starts.back(), size - 1) << where;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,214 @@
+#include <Brain/MarkovBrain/Gate/DeterministicGate.h>
+#include <Brain/MarkovBrain/Gate/ProbabilisticGate.h>
+#include <Brain/MarkovBrain/GateProgram/GateProgramBatch.h>
+#include <Utilities/Random.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+// a random gate list over nrNodes nodes. Addresses may repeat (within a gate
+// and across gates), so outputs with several writers are covered.
+std::vector<std::shared_ptr<AbstractGate>> makeTestGates(std::mt19937 &gen, int nrNodes, int nrGates, bool probabilistic) {
+	std::vector<std::shared_ptr<AbstractGate>> gates;
+	std::uniform_int_distribution<int> ioCount(1, 4), node(0, nrNodes - 1), bit(0, 1), weight(0, 5);
+	for (int g = 0; g < nrGates; g++) {
+		std::vector<int> ins(ioCount(gen)), outs(ioCount(gen));
+		for (auto &a : ins) {
+			a = node(gen);
+		}
+		for (auto &a : outs) {
+			a = node(gen);
+		}
+		if (probabilistic && g % 2 == 1) {
+			std::vector<std::vector<int>> rawTable(1 << ins.size(), std::vector<int>(1 << outs.size()));
+			for (auto &row : rawTable) {
+				for (auto &w : row) {
+					w = weight(gen);
+				}
+			}
+			gates.push_back(std::make_shared<ProbabilisticGate>(std::make_pair(ins, outs), rawTable, g));
+		} else {
+			std::vector<std::vector<int>> table(1 << ins.size(), std::vector<int>(outs.size()));
+			for (auto &row : table) {
+				for (auto &v : row) {
+					v = bit(gen);
+				}
+			}
+			gates.push_back(std::make_shared<DeterministicGate>(std::make_pair(ins, outs), table, g));
+		}
+	}
+	return gates;
+}
+
+// input t of a fixed input sequence
+std::vector<double> testInputs(int t, int nrInputs) {
+	std::vector<double> inputs(nrInputs);
+	for (int i = 0; i < nrInputs; i++) {
+		inputs[i] = ((t * 7 + i * 3) % 5) < 2 ? 1.0 : 0.0;
+	}
+	return inputs;
+}
+
+// one brain update the way MarkovBrain did it before GateProgram
+void updateThroughGates(std::vector<std::shared_ptr<AbstractGate>> &gates, const std::vector<double> &inputs, std::vector<double> &nodes) {
+	std::vector<double> nextNodes(nodes.size(), 0.0);
+	for (size_t i = 0; i < inputs.size(); i++) {
+		nodes[i] = inputs[i];
+	}
+	for (auto &gate : gates) {
+		gate->update(nodes, nextNodes);
+	}
+	std::swap(nodes, nextNodes);
+}
+
+TEST(gateProgram, RunMatchesGateLoop) {
+	const int nrInputs = 4, nrOutputs = 3, nrNodes = 16, updates = 50;
+	for (unsigned seed = 1; seed <= 20; seed++) {
+		std::mt19937 gen(seed);
+		auto gates = makeTestGates(gen, nrNodes, 12, true);
+		GateProgram program;
+		program.compile(gates, nrInputs, nrOutputs);
+		ASSERT_GT(program.fallbackCount, 0) << "probabilistic gates should be run through update";
+
+		std::vector<double> expected(nrNodes, 0.0), nodes(nrNodes, 0.0), nextNodes;
+		// both paths draw from the same stream, so probabilistic gates agree
+		Random::StreamGenerator expectedStream(seed, 0, 0), stream(seed, 0, 0);
+		for (int t = 0; t < updates; t++) {
+			auto inputs = testInputs(t, nrInputs);
+			{
+				Random::ScopedStream useStream(expectedStream);
+				updateThroughGates(gates, inputs, expected);
+			}
+			{
+				Random::ScopedStream useStream(stream);
+				for (int i = 0; i < nrInputs; i++) {
+					nodes[i] = inputs[i];
+				}
+				nextNodes.assign(nrNodes, 0.0);
+				program.run(nodes, nextNodes);
+				std::swap(nodes, nextNodes);
+			}
+			ASSERT_EQ(nodes, expected) << "seed " << seed << " update " << t;
+		}
+	}
+}
+
+TEST(gateProgram, RunBitsMatchesGateLoop) {
+	const int nrInputs = 5, nrOutputs = 4, nrNodes = 70, updates = 50; // more than one word of bits
+	for (unsigned seed = 1; seed <= 20; seed++) {
+		std::mt19937 gen(seed);
+		auto gates = makeTestGates(gen, nrNodes, 40, false);
+		GateProgram program;
+		program.compile(gates, nrInputs, nrOutputs);
+		ASSERT_EQ(program.fallbackCount, 0);
+
+		std::vector<double> expected(nrNodes, 0.0), outputCounts(nrOutputs, 0.0);
+		std::vector<uint64_t> nodeBits((nrNodes + 63) / 64, 0), nextNodeBits(nodeBits.size(), 0);
+		for (int t = 0; t < updates; t++) {
+			auto inputs = testInputs(t, nrInputs);
+			updateThroughGates(gates, inputs, expected);
+			for (int i = 0; i < nrInputs; i++) {
+				uint64_t mask = uint64_t(1) << (i & 63);
+				nodeBits[i >> 6] = inputs[i] > 0.0 ? (nodeBits[i >> 6] | mask) : (nodeBits[i >> 6] & ~mask);
+			}
+			program.runBits(nodeBits, nextNodeBits, outputCounts);
+			std::swap(nodeBits, nextNodeBits);
+			for (int n = 0; n < nrNodes; n++) {
+				int bit = (nodeBits[n >> 6] >> (n & 63)) & 1;
+				EXPECT_EQ(bit, Bit(expected[n])) << "seed " << seed << " update " << t << " node " << n;
+			}
+			for (int i = 0; i < nrOutputs; i++) {
+				if (program.countsOutput(i)) {
+					EXPECT_EQ(outputCounts[i], expected[nrInputs + i]) << "seed " << seed << " update " << t << " output " << i;
+				}
+			}
+		}
+	}
+}
+
+TEST(gateProgramBatch, StepMatchesGateLoop) {
+	const int nrInputs = 4, nrOutputs = 3, updates = 50;
+	const int brainCount = 2 * GateProgramBatch::laneWidth() + 3; // padded lanes
+	std::mt19937 gen(7);
+	std::vector<std::vector<std::shared_ptr<AbstractGate>>> gateLists;
+	std::vector<GateProgram> programs(brainCount);
+	std::vector<int> sizes;
+	int maxNodes = 0;
+	for (int b = 0; b < brainCount; b++) {
+		int nrNodes = 8 + b % 5; // structurally different brains
+		sizes.push_back(nrNodes);
+		maxNodes = std::max(maxNodes, nrNodes);
+		gateLists.push_back(makeTestGates(gen, nrNodes, 4 + b % 7, false));
+		programs[b].compile(gateLists[b], nrInputs, nrOutputs);
+	}
+	std::vector<const GateProgram *> programPointers;
+	for (auto &program : programs) {
+		programPointers.push_back(&program);
+	}
+	GateProgramBatch batch;
+	batch.build(programPointers, maxNodes);
+
+	std::vector<std::vector<double>> expected;
+	std::vector<std::vector<uint32_t>> laneBits;
+	for (int b = 0; b < brainCount; b++) {
+		expected.emplace_back(sizes[b], 0.0);
+		laneBits.emplace_back(sizes[b], 0);
+	}
+	for (int t = 0; t < updates; t++) {
+		auto inputs = testInputs(t, nrInputs);
+		// as MarkovBrain::updateBatch, the lanes are loaded with node bits
+		for (int b = 0; b < brainCount; b++) {
+			uint32_t *laneNodes = batch.laneNodes(b);
+			for (int n = 0; n < sizes[b]; n++) {
+				laneNodes[n] = n < nrInputs ? inputs[n] > 0.0 : laneBits[b][n];
+			}
+		}
+		batch.step();
+		for (int b = 0; b < brainCount; b++) {
+			updateThroughGates(gateLists[b], inputs, expected[b]);
+			const uint32_t *laneNodes = batch.laneNodes(b);
+			for (int n = 0; n < sizes[b]; n++) {
+				EXPECT_EQ(static_cast<double>(laneNodes[n]), expected[b][n]) << "brain " << b << " update " << t << " node " << n;
+				laneBits[b][n] = laneNodes[n] != 0;
+			}
+		}
+	}
+}
+
+// ProbabilisticGate samples outputs from alias tables, so the outputs drawn for
+// each input should follow the normalized raw table row
+TEST(probabilisticGate, AliasTablesDrawFromTableRows) {
+	const int draws = 200000;
+	std::vector<int> ins = { 0, 1 }, outs = { 2, 3, 4 };
+	std::vector<std::vector<int>> rawTable = {
+		{ 1, 2, 3, 4, 5, 6, 7, 8 },
+		{ 0, 0, 0, 0, 0, 0, 0, 0 }, // becomes 1/8 each
+		{ 0, 0, 0, 0, 0, 9, 0, 0 }, // always column 5
+		{ 100, 1, 0, 0, 1, 0, 0, 30 },
+	};
+	ProbabilisticGate gate(std::make_pair(ins, outs), rawTable, 0);
+	Random::StreamGenerator stream(7);
+	Random::ScopedStream useStream(stream);
+	for (int input = 0; input < 4; input++) {
+		std::vector<double> nodes(5, 0.0);
+		nodes[0] = input & 1; // the gate reads its inputs in reverse order
+		nodes[1] = (input >> 1) & 1;
+		std::vector<int> counts(8, 0);
+		for (int i = 0; i < draws; i++) {
+			std::vector<double> nextNodes(5, 0.0);
+			gate.update(nodes, nextNodes);
+			counts[(int)nextNodes[2] * 4 + (int)nextNodes[3] * 2 + (int)nextNodes[4]]++;
+		}
+		double total = 0;
+		for (int w : rawTable[input]) {
+			total += w;
+		}
+		for (int column = 0; column < 8; column++) {
+			double p = total == 0 ? 1.0 / 8 : rawTable[input][column] / total;
+			double sigma = std::sqrt(p * (1 - p) / draws);
+			EXPECT_NEAR((double)counts[column] / draws, p, 5 * sigma + 1e-12) << "input " << input << " column " << column;
+		}
+	}
+}
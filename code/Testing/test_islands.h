@@ -0,0 +1,142 @@
+#include <Genome/CircularGenome/CircularGenome.h>
+#include <Optimizer/DistributedIslandsOptimizer/MigrantMessage.h>
+#include <Optimizer/DistributedIslandsOptimizer/SharedMemoryMailbox.h>
+#include <Organism/Organism.h>
+#include <Utilities/Random.h>
+
+#include <chrono>
+#include <fcntl.h>
+#include <memory>
+#include <string>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+// a name no other test run is using
+std::string testMailboxName(const std::string &test) {
+	return "/mabe_test_" + test + "_" + std::to_string(getpid());
+}
+
+bool sharedMemoryExists(const std::string &name) {
+	int fd = shm_open(name.c_str(), O_RDWR, 0600);
+	if (fd < 0) {
+		return false;
+	}
+	close(fd);
+	return true;
+}
+
+// every message takes 12 header bytes plus its payload, so with 100 byte
+// inboxes, 30 byte payloads (42 bytes) start and end all over the ring
+TEST(sharedMemoryMailbox, MessagesWrapAroundTheInbox) {
+	auto name = testMailboxName("wrap");
+	SharedMemoryMailbox box0(name, 0, 2, 100), box1(name, 1, 2, 100);
+	std::vector<SharedMemoryMailbox::Message> held, received;
+	for (int i = 0; i < 50; i++) {
+		std::string payload(30, static_cast<char>('a' + i % 26));
+		payload[0] = static_cast<char>(i);
+		ASSERT_TRUE(box0.send(1, i, payload, false, held)) << "message " << i;
+		if (i % 2 == 1) { // two messages fit, so read every other one
+			box1.receive(received);
+		}
+	}
+	EXPECT_TRUE(held.empty());
+	ASSERT_EQ(received.size(), 50u);
+	for (int i = 0; i < 50; i++) {
+		EXPECT_EQ(received[i].from, 0);
+		EXPECT_EQ(received[i].update, i);
+		std::string payload(30, static_cast<char>('a' + i % 26));
+		payload[0] = static_cast<char>(i);
+		EXPECT_EQ(received[i].payload, payload) << "message " << i;
+	}
+}
+
+TEST(sharedMemoryMailbox, FullInboxDropsOrWaits) {
+	auto name = testMailboxName("full");
+	SharedMemoryMailbox box0(name, 0, 2, 64), box1(name, 1, 2, 64);
+	std::vector<SharedMemoryMailbox::Message> held, received;
+	// 2 x 32 bytes fill it exactly
+	EXPECT_TRUE(box0.send(1, 1, std::string(20, 'x'), false, held));
+	EXPECT_TRUE(box0.send(1, 2, std::string(20, 'y'), false, held));
+	EXPECT_FALSE(box0.send(1, 3, "", false, held));
+	box1.receive(received);
+	ASSERT_EQ(received.size(), 2u);
+	EXPECT_EQ(received[1].payload, std::string(20, 'y'));
+	EXPECT_TRUE(box0.send(1, 3, "", false, held));
+	// a sender waiting for room reads its own inbox into held while it waits,
+	// so two islands sending to each other's full inboxes do not deadlock
+	EXPECT_TRUE(box1.send(0, 4, std::string(52, 'z'), false, held));
+	EXPECT_TRUE(box0.send(1, 5, std::string(40, 'w'), false, held));
+	EXPECT_FALSE(box0.send(1, 6, std::string(40, 'v'), false, held));
+	std::thread reader([&] {
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		box1.receive(received);
+	});
+	EXPECT_TRUE(box0.send(1, 6, std::string(40, 'v'), true, held));
+	reader.join();
+	ASSERT_EQ(held.size(), 1u);
+	EXPECT_EQ(held[0].from, 1);
+	EXPECT_EQ(held[0].payload, std::string(52, 'z'));
+	box1.receive(received);
+	ASSERT_EQ(received.size(), 5u);
+	EXPECT_EQ(received[4].payload, std::string(40, 'v'));
+}
+
+TEST(sharedMemoryMailbox, SendingToAClosedBoxFails) {
+	auto name = testMailboxName("closed");
+	std::vector<SharedMemoryMailbox::Message> held;
+	SharedMemoryMailbox box0(name, 0, 2, 64);
+	auto box1 = std::make_unique<SharedMemoryMailbox>(name, 1, 2, 64);
+	EXPECT_FALSE(box0.closed(1));
+	box1.reset();
+	EXPECT_TRUE(box0.closed(1));
+	EXPECT_FALSE(box0.send(1, 1, "hello", false, held));
+	EXPECT_FALSE(box0.send(1, 1, "hello", true, held)); // and does not wait
+}
+
+TEST(sharedMemoryMailbox, LastToCloseRemovesTheSharedMemory) {
+	auto name = testMailboxName("unlink");
+	auto box0 = std::make_unique<SharedMemoryMailbox>(name, 0, 3, 64);
+	auto box2 = std::make_unique<SharedMemoryMailbox>(name, 2, 3, 64);
+	EXPECT_TRUE(sharedMemoryExists(name));
+	box2.reset();
+	EXPECT_TRUE(sharedMemoryExists(name));
+	box0.reset();
+	EXPECT_TRUE(sharedMemoryExists(name)); // box 1 has not closed
+	{
+		SharedMemoryMailbox box1(name, 1, 3, 64);
+	}
+	EXPECT_FALSE(sharedMemoryExists(name));
+}
+
+TEST(migrantMessage, UnpackGivesBackWhatPackWasGiven) {
+	auto PT = Parameters::root->getTable("MIGRANT_TEST::");
+	Random::getCommonGenerator().seed(8);
+	std::vector<std::shared_ptr<Organism>> migrants;
+	for (int i = 0; i < 3; i++) {
+		std::unordered_map<std::string, std::shared_ptr<AbstractGenome>> genomes;
+		std::unordered_map<std::string, std::shared_ptr<AbstractBrain>> brains;
+		genomes["root::"] = std::make_shared<CircularGenome<int>>(256, 100 + i, PT);
+		genomes["other::"] = std::make_shared<CircularGenome<unsigned char>>(4, 50 + i, PT);
+		for (auto &genome : genomes) {
+			genome.second->fillRandom();
+		}
+		migrants.push_back(std::make_shared<Organism>(genomes, brains, PT));
+	}
+
+	auto unpacked = MigrantMessage::unpack(MigrantMessage::pack(migrants));
+	ASSERT_EQ(unpacked.size(), migrants.size());
+	for (size_t m = 0; m < migrants.size(); m++) {
+		// as makeMigrant does
+		for (auto &genome : migrants[m]->genomes) {
+			auto name = "GENOME_" + genome.first;
+			auto copy = genome.second->makeLike();
+			copy->deserialize(PT, unpacked[m], name);
+			EXPECT_EQ(copy->genomeToStr(), genome.second->genomeToStr()) << genome.first << " of migrant " << m;
+		}
+	}
+
+	EXPECT_TRUE(MigrantMessage::unpack(MigrantMessage::pack({})).empty());
+}
@@ -0,0 +1,120 @@
+#include <Utilities/KillList.h>
+
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+// all apply needs from an organism
+struct KillListTestOrganism {
+	int index;
+	int kills = 0;
+	KillListTestOrganism(int _index) : index(_index) {}
+	void kill() { kills++; }
+};
+
+void expectMarked(const KillList &killList, const std::set<size_t> &marked, size_t upTo) {
+	EXPECT_EQ(killList.size(), marked.size());
+	EXPECT_EQ(killList.empty(), marked.empty());
+	for (size_t i = 0; i < upTo; i++) {
+		EXPECT_EQ(killList.contains(i), marked.count(i) == 1) << "index " << i;
+	}
+}
+
+TEST(killList, RangesCrossWordBoundaries) {
+	KillList killList;
+	killList.insertRange(60, 200); // part word, two whole words, part word
+	std::set<size_t> marked;
+	for (size_t i = 60; i < 200; i++) {
+		marked.insert(i);
+	}
+	expectMarked(killList, marked, 300);
+	killList.insertRange(5, 5); // empty
+	expectMarked(killList, marked, 300);
+}
+
+TEST(killList, MarkingAgainDoesNotCount) {
+	KillList killList;
+	killList.insert(3);
+	killList.insert(70);
+	killList.insert(3);
+	killList.insertRange(64, 128); // a whole word with 70 already set
+	killList.insertRange(0, 10);   // part of a word with 3 already set
+	std::set<size_t> marked = { 3, 70 };
+	for (size_t i = 64; i < 128; i++) {
+		marked.insert(i);
+	}
+	for (size_t i = 0; i < 10; i++) {
+		marked.insert(i);
+	}
+	expectMarked(killList, marked, 200);
+	killList.clear();
+	marked.clear();
+	expectMarked(killList, marked, 200);
+	// random marks against a set
+	std::mt19937 gen(4);
+	std::uniform_int_distribution<size_t> index(0, 299);
+	for (int i = 0; i < 100; i++) {
+		size_t first = index(gen), last = first + index(gen) % 80;
+		if (i % 2) {
+			killList.insert(first);
+			marked.insert(first);
+		} else {
+			killList.insertRange(first, last);
+			for (size_t j = first; j < last; j++) {
+				marked.insert(j);
+			}
+		}
+	}
+	expectMarked(killList, marked, 400);
+}
+
+TEST(killList, MergeAtAnOffset) {
+	// as IslandsOptimizer merges each island's list, offset to where that
+	// island starts in the whole population
+	KillList whole, island;
+	whole.insert(2);
+	island.insert(0);
+	island.insert(63);
+	island.insertRange(100, 140);
+	whole.merge(island, 37);
+	std::set<size_t> marked = { 2, 37, 100 };
+	for (size_t i = 137; i < 177; i++) {
+		marked.insert(i);
+	}
+	expectMarked(whole, marked, 250);
+	// other is not changed, and merging it again adds nothing
+	EXPECT_EQ(island.size(), 42u);
+	whole.merge(island, 37);
+	expectMarked(whole, marked, 250);
+}
+
+TEST(killList, ApplyKillsMarkedAndKeepsOrder) {
+	std::vector<std::shared_ptr<KillListTestOrganism>> population;
+	for (int i = 0; i < 150; i++) {
+		population.push_back(std::make_shared<KillListTestOrganism>(i));
+	}
+	auto everyone = population;
+	KillList killList;
+	killList.insertRange(0, 10);
+	killList.insertRange(60, 130);
+	killList.insert(149);
+	killList.apply(population);
+	EXPECT_TRUE(killList.empty());
+	std::vector<int> survivors;
+	for (auto &org : population) {
+		survivors.push_back(org->index);
+	}
+	std::vector<int> expected;
+	for (int i = 10; i < 60; i++) {
+		expected.push_back(i);
+	}
+	for (int i = 130; i < 149; i++) {
+		expected.push_back(i);
+	}
+	EXPECT_EQ(survivors, expected);
+	for (auto &org : everyone) {
+		bool marked = org->index < 10 || (org->index >= 60 && org->index < 130) || org->index == 149;
+		EXPECT_EQ(org->kills, marked ? 1 : 0) << "organism " << org->index;
+	}
+}
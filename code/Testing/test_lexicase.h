@@ -0,0 +1,147 @@
+#include <Global.h>
+#include <Optimizer/LexicaseOptimizer/LexicaseSelector.h>
+#include <Utilities/Random.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// lexicase selection from pool the way LexicaseOptimizer::lexiSelect did it
+// (with keeper vectors), drawing from gen
+template <class Engine>
+int referenceLexiSelect(const std::vector<std::vector<double>> &scores, const std::vector<int> &pool,
+                        LexicaseSelector::EpsilonMode mode, double epsilon, Engine &gen) {
+	bool haveDelta = false;
+	for (auto &caseScores : scores) {
+		auto minmax = std::minmax_element(caseScores.begin(), caseScores.end());
+		haveDelta |= *minmax.first < *minmax.second;
+	}
+	if (!haveDelta) {
+		return pool[Random::getIndex(pool.size(), gen)];
+	}
+	auto median = [](std::vector<double> values) {
+		std::sort(values.begin(), values.end());
+		size_t middle = values.size() / 2;
+		return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+	};
+
+	std::vector<int> order(scores.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::shuffle(order.begin(), order.end(), gen);
+	std::vector<int> keepers = pool;
+	while (keepers.size() > 1 && order.size() > 0) {
+		int c = order.back();
+		order.pop_back();
+		std::vector<double> keeperScores;
+		for (int k : keepers) {
+			keeperScores.push_back(scores[c][k]);
+		}
+		double cutoff;
+		auto range = std::minmax_element(keeperScores.begin(), keeperScores.end());
+		if (mode == LexicaseSelector::SCORE) {
+			cutoff = *range.second - ((*range.second - *range.first) * epsilon);
+		} else if (mode == LexicaseSelector::MAD) {
+			double caseMedian = median(scores[c]);
+			std::vector<double> deviations;
+			for (double s : scores[c]) {
+				deviations.push_back(std::abs(s - caseMedian));
+			}
+			cutoff = *range.second - median(deviations);
+		} else {
+			size_t cullIndex = std::ceil(std::max((((1.0 - epsilon) * keeperScores.size()) - 1.0), 0.0));
+			std::nth_element(keeperScores.begin(), keeperScores.begin() + cullIndex, keeperScores.end());
+			cutoff = keeperScores[cullIndex];
+		}
+		keepers.erase(std::remove_if(keepers.begin(), keepers.end(), [&](int k) { return scores[c][k] < cutoff; }),
+		              keepers.end());
+	}
+	return keepers[Random::getIndex(keepers.size(), gen)];
+}
+
+// cases x organisms scores with few distinct values, so there are ties
+std::vector<std::vector<double>> makeLexicaseScores(std::mt19937 &gen, int cases, int organisms, int distinct) {
+	std::uniform_int_distribution<int> value(0, distinct - 1);
+	std::vector<std::vector<double>> scores(cases, std::vector<double>(organisms));
+	for (auto &caseScores : scores) {
+		for (auto &s : caseScores) {
+			s = value(gen) * 0.5;
+		}
+	}
+	return scores;
+}
+
+struct LexicaseSetup {
+	LexicaseSelector::EpsilonMode mode;
+	double epsilon;
+	int distinct; // 1 makes every score the same
+};
+
+const std::vector<LexicaseSetup> lexicaseSetups = {
+	{ LexicaseSelector::RANK, 0.0, 6 },
+	{ LexicaseSelector::RANK, 0.2, 6 },
+	{ LexicaseSelector::SCORE, 0.1, 20 },
+	{ LexicaseSelector::MAD, 0.0, 20 },
+	{ LexicaseSelector::RANK, 0.0, 1 },
+};
+
+TEST(lexicaseSelector, SelectMatchesReference) {
+	const int organisms = 70; // more than one word of keeper bits
+	std::mt19937 gen(5);
+	for (auto &setup : lexicaseSetups) {
+		auto scores = makeLexicaseScores(gen, 12, organisms, setup.distinct);
+		LexicaseSelector selector;
+		selector.setScores(scores, setup.mode, setup.epsilon);
+		for (int poolSize : { organisms, 9, organisms + 10 }) {
+			for (int i = 0; i < 50; i++) {
+				Random::StreamGenerator stream(1, poolSize, i), referenceStream(1, poolSize, i);
+				int selected;
+				{
+					Random::ScopedStream useStream(stream);
+					selected = selector.select(poolSize);
+				}
+				// select shuffles everyone and uses the first poolSize
+				std::vector<int> pool(organisms);
+				std::iota(pool.begin(), pool.end(), 0);
+				std::shuffle(pool.begin(), pool.end(), referenceStream);
+				pool.resize(std::min(poolSize, organisms));
+				EXPECT_EQ(selected, referenceLexiSelect(scores, pool, setup.mode, setup.epsilon, referenceStream))
+				    << "mode " << setup.mode << " pool " << poolSize << " selection " << i;
+			}
+		}
+	}
+}
+
+TEST(lexicaseSelector, SelectManyMatchesReferenceOnAnyThreadCount) {
+	const int organisms = 70, count = 200;
+	Random::getStreamSeed() = 42;
+	Global::update = 3;
+	ThreadPool serial(1), parallel(4);
+	std::mt19937 gen(6);
+	for (auto &setup : lexicaseSetups) {
+		auto scores = makeLexicaseScores(gen, 12, organisms, setup.distinct);
+		LexicaseSelector selector;
+		selector.setScores(scores, setup.mode, setup.epsilon);
+		for (int poolSize : { organisms, 9, organisms + 10 }) {
+			auto serialSelected = selector.selectMany(count, poolSize, serial);
+			auto parallelSelected = selector.selectMany(count, poolSize, parallel);
+			EXPECT_EQ(serialSelected, parallelSelected) << "mode " << setup.mode << " pool " << poolSize;
+			for (int i = 0; i < count; i++) {
+				// selection i draws its pool (when it is not everyone) and then
+				// selects from stream i
+				Random::StreamGenerator stream(Random::getStreamSeed("lexicase"), Global::update, i);
+				std::vector<int> pool(organisms);
+				std::iota(pool.begin(), pool.end(), 0);
+				if (poolSize < organisms) {
+					for (int p = 0; p < poolSize; p++) {
+						std::swap(pool[p], pool[p + stream.nextBelow(organisms - p)]);
+					}
+					pool.resize(poolSize);
+				}
+				EXPECT_EQ(serialSelected[i], referenceLexiSelect(scores, pool, setup.mode, setup.epsilon, stream))
+				    << "mode " << setup.mode << " pool " << poolSize << " selection " << i;
+			}
+		}
+	}
+}
@@ -0,0 +1,251 @@
+#include <Archivist/LODwAPArchivist/LODwAPArchivist.h>
+#include <Organism/LineageTree.h>
+#include <Organism/Organism.h>
+#include <Organism/Phylogeny.h>
+#include <Utilities/Data.h>
+#include <Utilities/Random.h>
+#include <Utilities/CSV.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// Evolves populations in a LineageTree with random parents (and, with
+// survive > 0, some organisms living on into the next update), and after
+// every update checks the MRCA and trunk found by walking down from the
+// trunk root against the full walk up the line of descent which
+// LODwAPArchivist used to do. Every pruneInterval updates the line of descent
+// is cut at the MRCA, as LODwAPArchivist does.
+void checkMRCAAgainstFullWalk(int populations, int popSize, int updates, int pruneInterval,
+                              double survive, unsigned seed) {
+	std::mt19937 gen(seed);
+	LineageTree tree;
+	std::vector<std::vector<int>> population(populations);
+	for (auto &pop : population) {
+		for (int i = 0; i < popSize; i++) {
+			pop.push_back(tree.add(-1));
+		}
+	}
+	int trunkWalks = 0;
+	for (int update = 0; update < updates; update++) {
+		for (auto &pop : population) {
+			std::vector<int> next;
+			for (int i = 0; i < popSize; i++) {
+				if (Random::P(survive, gen)) {
+					next.push_back(pop[i]);
+				}
+			}
+			while (static_cast<int>(next.size()) < popSize) {
+				int offspring = tree.add(update);
+				tree.addParent(offspring, pop[Random::getIndex(popSize, gen)]);
+				next.push_back(offspring);
+			}
+			for (int record : pop) {
+				if (std::find(next.begin(), next.end(), record) == next.end()) {
+					tree.release(record);
+				}
+			}
+			pop = next;
+		}
+
+		for (auto &pop : population) {
+			std::vector<int> LOD = tree.lineOfDescent(pop[0]);
+			int fullWalkMRCA = tree.mostRecentCommonAncestor(LOD);
+			std::vector<int> trunk;
+			int MRCA = tree.mostRecentCommonAncestor(pop[0], trunk);
+			ASSERT_EQ(MRCA, fullWalkMRCA) << "at update " << update << " (seed " << seed << ")";
+			ASSERT_LE(trunk.size(), LOD.size());
+			EXPECT_TRUE(std::equal(trunk.begin(), trunk.end(), LOD.begin()))
+				<< "the trunk should be the start of the line of descent at update " << update;
+			EXPECT_EQ(trunk.back(), MRCA);
+			trunkWalks += (trunk.size() < LOD.size());
+			if (update % pruneInterval == 0) {
+				tree.clearParents(MRCA);
+			}
+		}
+	}
+	if (populations == 1) {
+		EXPECT_GT(trunkWalks, 0) << "the population never coalesced, so the trunk walk was not tested";
+	}
+}
+
+TEST(lineageTree, IncrementalMRCAMatchesFullWalk) {
+	checkMRCAAgainstFullWalk(1, 50, 400, 10, 0.0, 101);
+	checkMRCAAgainstFullWalk(1, 20, 400, 1, 0.0, 7);
+	checkMRCAAgainstFullWalk(1, 100, 300, 37, 0.0, 2023);
+}
+
+TEST(lineageTree, IncrementalMRCAMatchesFullWalkOverlappingGenerations) {
+	checkMRCAAgainstFullWalk(1, 50, 400, 10, 0.5, 11);
+	checkMRCAAgainstFullWalk(1, 30, 400, 25, 0.9, 12);
+}
+
+TEST(lineageTree, IncrementalMRCAMatchesFullWalkSeveralPopulations) {
+	// each population has its own root, so these use the full walk
+	checkMRCAAgainstFullWalk(3, 30, 200, 10, 0.2, 5);
+}
+
+TEST(lineageTree, ReleasedAncestorsAreFreed) {
+	LineageTree tree;
+	int grandparent = tree.add(0);
+	int parent = tree.add(1);
+	tree.addParent(parent, grandparent);
+	int child = tree.add(2);
+	tree.addParent(child, parent);
+	tree.release(grandparent);
+	tree.release(parent);
+	EXPECT_EQ(tree.size(), 3u) << "ancestors of a record in use should be kept";
+	tree.release(child);
+	EXPECT_EQ(tree.size(), 0u) << "releasing the last descendant should free its ancestors";
+
+	int root = tree.add(0);
+	int a = tree.add(1), b = tree.add(1);
+	tree.addParent(a, root);
+	tree.addParent(b, root);
+	tree.release(root);
+	tree.clearParents(a);
+	EXPECT_EQ(tree.size(), 3u);
+	tree.clearParents(b);
+	EXPECT_EQ(tree.size(), 2u) << "a released record with no offspring left should be freed";
+}
+
+// What LODwAPArchivist::archive did at a prune before the MRCA was tracked
+// incrementally: build the whole line of descent of population[0], scan it
+// for the MRCA, and for each data write time up to the MRCA search the line
+// of descent from its start. Gives the rows (update, timeToCoalescence, ID)
+// it would have written, and returns the time of birth of the MRCA it would
+// have pruned at.
+struct ReferenceLODwAP {
+	std::vector<int> dataSequence;
+	int dataSeqIndex = 0;
+	std::vector<std::vector<int>> rows;
+
+	int prune(int record, int flush) {
+		auto &phylogeny = Phylogeny::get();
+		auto LOD = phylogeny.lineOfDescent(record);
+		int effectiveMRCA = flush ? LOD[LOD.size() > 1 ? LOD.size() - 2 : 0] : phylogeny.mostRecentCommonAncestor(LOD);
+		int realMRCA = flush ? phylogeny.mostRecentCommonAncestor(LOD) : effectiveMRCA;
+		while (dataSequence[dataSeqIndex] <= std::min(phylogeny.timeOfBirth(effectiveMRCA), Global::updatesPL->get())) {
+			int write = dataSequence[dataSeqIndex];
+			int currentIndex = 0;
+			while (phylogeny.timeOfBirth(LOD[currentIndex]) < write) {
+				currentIndex++;
+			}
+			int current = LOD[currentIndex - 1];
+			rows.push_back({ write, std::max(0, phylogeny.timeOfBirth(current) - phylogeny.timeOfBirth(realMRCA)),
+			                 phylogeny.ID(current) });
+			dataSeqIndex++;
+		}
+		return phylogeny.timeOfBirth(effectiveMRCA);
+	}
+};
+
+// the update, timeToCoalescence and ID columns of an LOD data file
+std::vector<std::vector<int>> readLODRows(const std::string &fileName) {
+	CSV csv(fileName);
+	std::vector<std::vector<int>> rows(csv.row_count());
+	for (std::string column : { "update", "timeToCoalescence", "ID" }) {
+		auto values = csv.singleColumn(column);
+		for (size_t row = 0; row < values.size(); row++) {
+			rows[row].push_back(static_cast<int>(std::stod(values[row])));
+		}
+	}
+	return rows;
+}
+
+// Evolves a population of Organisms (so their lineage is recorded in
+// Phylogeny, as in a run) with an LODwAPArchivist archiving every update,
+// and at every prune runs ReferenceLODwAP on the same lineage just before
+// the archivist does. The MRCA each prunes at, and the LOD data file the
+// archivist writes, must be the same. The run is flushed at the end.
+void checkLODwAPAgainstFullWalk(int popSize, int updates, int pruneInterval, double survive, unsigned seed) {
+	auto PT = Parameters::root->getTable("LODWAP_TEST_" + std::to_string(seed) + "::");
+	PT->setParameter("ARCHIVIST_DEFAULT-writePopFile", false);
+	PT->setParameter("ARCHIVIST_DEFAULT-writeMaxFile", false);
+	PT->setParameter("ARCHIVIST_LODWAP-writeOrganismsFile", false);
+	PT->setParameter("ARCHIVIST_LODWAP-dataSequence", std::string(":3"));
+	PT->setParameter("ARCHIVIST_LODWAP-pruneInterval", pruneInterval);
+	PT->setParameter("ARCHIVIST_LODWAP-filePrefix", "lodwap_test_" + std::to_string(seed) + "_");
+	int oldUpdates = Global::updatesPL->get();
+	Parameters::root->setParameter("GLOBAL-updates", updates);
+	std::string oldPrefix = FileManager::outputPrefix;
+	char dir[] = "/tmp/mabe_lodwap_XXXXXX";
+	ASSERT_NE(mkdtemp(dir), nullptr);
+	FileManager::outputPrefix = std::string(dir) + "/";
+
+	// as main sets up a run: a progenitor, and the first generation made in
+	// its image
+	std::mt19937 gen(seed);
+	std::unordered_map<std::string, std::shared_ptr<AbstractGenome>> genomes;
+	std::unordered_map<std::string, std::shared_ptr<AbstractBrain>> brains;
+	Global::update = -2;
+	auto progenitor = std::make_shared<Organism>(genomes, brains, PT);
+	Global::update = -1;
+	std::vector<std::shared_ptr<Organism>> population;
+	for (int i = 0; i < popSize; i++) {
+		population.push_back(std::make_shared<Organism>(progenitor, genomes, brains, PT));
+	}
+	{
+		LODwAPArchivist archivist({}, nullptr, PT);
+		ReferenceLODwAP reference;
+		reference.dataSequence = archivist.dataSequence;
+		int trunkWalks = 0;
+		// each update, as main does: make the next generation and archive. Then
+		// flush at the end of the run
+		for (Global::update = 0; Global::update <= updates; Global::update++) {
+			int flush = Global::update == updates;
+			if (!flush) {
+				std::vector<std::shared_ptr<Organism>> next;
+				for (auto &org : population) {
+					if (Random::P(survive, gen)) {
+						next.push_back(org);
+					}
+				}
+				while (static_cast<int>(next.size()) < popSize) {
+					next.push_back(
+					    std::make_shared<Organism>(population[Random::getIndex(popSize, gen)], genomes, brains, PT));
+				}
+				for (auto &org : population) {
+					if (std::find(next.begin(), next.end(), org) == next.end()) {
+						org->kill();
+					}
+				}
+				population = next;
+			}
+
+			if (Global::update % pruneInterval == 0 || flush) {
+				int record = population[0]->phylogenyRecord;
+				int prunedAt = reference.prune(record, flush);
+				std::vector<int> trunk;
+				Phylogeny::get().mostRecentCommonAncestor(record, trunk);
+				trunkWalks += trunk.size() < Phylogeny::get().lineOfDescent(record).size();
+				archivist.archive(population, flush);
+				ASSERT_EQ(archivist.last_prune_, prunedAt) << "at update " << Global::update << " (seed " << seed << ")";
+			} else {
+				archivist.archive(population);
+			}
+		}
+		EXPECT_GT(trunkWalks, 0) << "the population never coalesced, so the trunk walk was not tested";
+
+		FileManager::flush();
+		auto fileName = archivist.data_file_name_;
+		FileManager::closeFile(fileName);
+		auto written = readLODRows(FileManager::outputPrefix + fileName);
+		EXPECT_GT(written.size(), 10u);
+		EXPECT_EQ(written, reference.rows) << "seed " << seed;
+		std::remove((FileManager::outputPrefix + fileName).c_str());
+	}
+	rmdir(dir);
+	FileManager::outputPrefix = oldPrefix;
+	Parameters::root->setParameter("GLOBAL-updates", oldUpdates);
+}
+
+TEST(lineageTree, LODwAPMatchesFullWalk) {
+	checkLODwAPAgainstFullWalk(50, 300, 10, 0.0, 101);
+	checkLODwAPAgainstFullWalk(20, 200, 1, 0.0, 7);
+	checkLODwAPAgainstFullWalk(40, 300, 25, 0.6, 12);
+}
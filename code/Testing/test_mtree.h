@@ -0,0 +1,92 @@
+#include <Global.h>
+#include <Utilities/MTreeProgram.h>
+#include <Utilities/PopulationTable.h>
+#include <Utilities/Random.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// formulas like the ones optimizers and SteadyState are given
+const std::vector<std::string> testFormulas = {
+	"DM_AVE[score]",
+	"DM_SUM[score]",
+	"POW[1.05,DM_AVE[score]]",
+	"MAX[DM_AVE[score],DM_AVE[other]]",
+	"MIN[DM_AVE[score],DM_SUM[other],2]",
+	"(DM_AVE[score]+DM_AVE[other])/2",
+	"(DM_AVE[score]*DM_SUM[other])-(DM_AVE[other]^2)",
+	"IF[DM_AVE[score]-3,DM_AVE[other],DM_SUM[score]]",
+	"IF[DM_AVE[other]-5,MAX[DM_AVE[score],1],MIN[DM_AVE[score],1]]",
+	"ABS[DM_AVE[other]-DM_AVE[score]]",
+	"MOD[DM_SUM[score],3]",
+	"SIN[DM_AVE[score]]+COS[DM_AVE[other]]",
+	"SIGMOID[DM_AVE[score],0.5]",
+	"REMAP[DM_AVE[score],0,10,1,2]",
+	"DM_AVE[score]+UPDATE",
+	"RANDOM[0,DM_AVE[score]]+RANDOM[DM_AVE[other],10]",
+	"IF[RANDOM[0,1]-0.5,RANDOM[0,1],DM_AVE[score]]",
+	"VECT[0,3]/VECT[0,2]",
+};
+
+struct TestOrganism {
+	DataMap dataMap;
+};
+
+std::vector<std::shared_ptr<TestOrganism>> makeTestPopulation(std::mt19937 &gen, int size) {
+	std::uniform_real_distribution<double> value(-2.0, 12.0);
+	std::uniform_int_distribution<int> count(1, 4);
+	std::vector<std::shared_ptr<TestOrganism>> population;
+	for (int i = 0; i < size; i++) {
+		auto org = std::make_shared<TestOrganism>();
+		for (int c = count(gen); c > 0; c--) {
+			org->dataMap.append("score", value(gen));
+		}
+		org->dataMap.append("other", value(gen));
+		population.push_back(org);
+	}
+	return population;
+}
+
+TEST(mTreeProgram, EvalFirstMatchesTreeEval) {
+	std::mt19937 gen(11);
+	auto population = makeTestPopulation(gen, 50);
+	std::vector<std::vector<double>> vectorData = { { 1.0, 4.0, 9.0, 2.5 } };
+	Global::update = 17;
+	for (auto &formula : testFormulas) {
+		auto tree = stringToMTree(formula);
+		MTreeProgram program(tree);
+		for (size_t i = 0; i < population.size(); i++) {
+			// both draw the same random numbers, if they draw them in the same order
+			Random::getCommonGenerator().seed(i);
+			double expected = tree->eval(population[i]->dataMap, nullptr, vectorData)[0];
+			Random::getCommonGenerator().seed(i);
+			double actual = program.evalFirst(population[i]->dataMap, nullptr, vectorData);
+			EXPECT_EQ(actual, expected) << formula << " organism " << i;
+		}
+	}
+}
+
+TEST(mTreeProgram, EvalAllMatchesTreeEval) {
+	std::mt19937 gen(12);
+	auto population = makeTestPopulation(gen, 50);
+	PopulationTable table;
+	table.refresh(population);
+	for (auto &formula : testFormulas) {
+		if (formula.find("RANDOM") != std::string::npos || formula.find("VECT") != std::string::npos) {
+			continue;
+		}
+		auto tree = stringToMTree(formula);
+		MTreeProgram program(tree);
+		auto fromPopulation = program.evalAll(population);
+		auto fromTable = program.evalAll(table);
+		ASSERT_EQ(fromPopulation.size(), population.size());
+		ASSERT_EQ(fromTable.size(), population.size());
+		for (size_t i = 0; i < population.size(); i++) {
+			double expected = tree->eval(population[i]->dataMap, nullptr, {})[0];
+			EXPECT_EQ(fromPopulation[i], expected) << formula << " organism " << i;
+			EXPECT_EQ(fromTable[i], expected) << formula << " organism " << i;
+		}
+	}
+}
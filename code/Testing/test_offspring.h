@@ -0,0 +1,99 @@
+#include <Genome/CircularGenome/CircularGenome.h>
+#include <Global.h>
+#include <Optimizer/AbstractOptimizer.h>
+#include <Organism/Organism.h>
+#include <Utilities/Random.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// an optimizer which only makes offspring (with addOffspring/finishOffspring)
+class OffspringTestOptimizer : public AbstractOptimizer {
+public:
+	OffspringTestOptimizer(std::shared_ptr<ParametersTable> PT_) : AbstractOptimizer(PT_) {}
+	virtual void optimize(std::vector<std::shared_ptr<Organism>> &population) override {}
+};
+
+class offspringThreads : public ::testing::Test {
+protected:
+	std::shared_ptr<ParametersTable> genomePT;
+	std::vector<std::shared_ptr<Organism>> population;
+
+	void SetUp() override {
+		genomePT = Parameters::root->getTable("OFFSPRING_TEST::");
+		genomePT->setParameter("GENOME_CIRCULAR-mutationPointRate", 0.01);
+		genomePT->setParameter("GENOME_CIRCULAR-mutationCopyRate", 0.002);
+		genomePT->setParameter("GENOME_CIRCULAR-mutationCopyMinSize", 10);
+		genomePT->setParameter("GENOME_CIRCULAR-mutationCopyMaxSize", 50);
+		genomePT->setParameter("GENOME_CIRCULAR-mutationDeleteRate", 0.002);
+		genomePT->setParameter("GENOME_CIRCULAR-mutationDeleteMinSize", 10);
+		genomePT->setParameter("GENOME_CIRCULAR-mutationDeleteMaxSize", 50);
+		genomePT->setParameter("GENOME_CIRCULAR-sizeMin", 100);
+		Random::getCommonGenerator().seed(21);
+		Random::getStreamSeed() = 21;
+		Global::update = 5;
+		for (int i = 0; i < 8; i++) {
+			std::unordered_map<std::string, std::shared_ptr<AbstractGenome>> genomes;
+			std::unordered_map<std::string, std::shared_ptr<AbstractBrain>> brains;
+			genomes["root::"] = std::make_shared<CircularGenome<int>>(256, 400, genomePT);
+			genomes["root::"]->fillRandom();
+			population.push_back(std::make_shared<Organism>(genomes, brains, genomePT));
+		}
+	}
+
+	// 40 offspring of population (every fourth with two parents), made with
+	// OPTIMIZER-offspringThreads set to threads
+	std::vector<std::shared_ptr<Organism>> makeOffspring(int threads, int &firstID) {
+		auto PT = Parameters::root->getTable("OFFSPRING_TEST_" + std::to_string(threads) + "::");
+		PT->setParameter("OPTIMIZER-offspringThreads", threads);
+		OffspringTestOptimizer optimizer(PT);
+		std::vector<std::shared_ptr<Organism>> offspring;
+		firstID = Organism::getNextID();
+		for (int i = 0; i < 40; i++) {
+			auto &parent = population[(i * 3) % population.size()];
+			if (i % 4 == 3) {
+				optimizer.addOffspring(offspring, { parent, population[i % population.size()] });
+			} else {
+				optimizer.addOffspring(offspring, parent);
+			}
+		}
+		optimizer.finishOffspring(offspring);
+		return offspring;
+	}
+
+	static const std::vector<int> &sitesOf(const std::shared_ptr<AbstractGenome> &genome) {
+		return std::dynamic_pointer_cast<CircularGenome<int>>(genome)->sites;
+	}
+};
+
+// IDs are given out by one counter, so two runs never make offspring with the
+// same IDs. Instead, every run (one thread, four threads and all cores) is
+// checked against making each offspring alone from the stream keyed on its
+// ID, so any number of threads gives the same offspring for the same IDs.
+TEST_F(offspringThreads, OffspringDependOnlyOnTheirIDs) {
+	for (int threads : { 1, 4, 0 }) {
+		int firstID;
+		auto offspring = makeOffspring(threads, firstID);
+		ASSERT_EQ(offspring.size(), 40u) << threads << " threads";
+		bool mutated = false;
+		for (int i = 0; i < (int)offspring.size(); i++) {
+			EXPECT_EQ(offspring[i]->ID, firstID + i) << threads << " threads";
+			std::unordered_map<std::string, std::shared_ptr<AbstractGenome>> genomes;
+			std::unordered_map<std::string, std::shared_ptr<AbstractBrain>> brains;
+			Random::StreamGenerator stream(Random::getStreamSeed("offspring"), Global::update, offspring[i]->ID);
+			Random::ScopedStream useStream(stream);
+			auto &parents = offspring[i]->parents;
+			if (parents.size() > 1) {
+				parents[0]->makeMutatedPartsFromMany(parents, genomes, brains);
+			} else {
+				parents[0]->makeMutatedPartsFrom(parents[0], genomes, brains);
+			}
+			EXPECT_EQ(sitesOf(offspring[i]->genomes["root::"]), sitesOf(genomes["root::"]))
+			    << threads << " threads, offspring " << i;
+			mutated |= sitesOf(offspring[i]->genomes["root::"]) != sitesOf(parents[0]->genomes["root::"]);
+		}
+		EXPECT_TRUE(mutated);
+	}
+}
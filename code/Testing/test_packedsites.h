@@ -0,0 +1,197 @@
+#include <Utilities/Data.h>
+#include <Utilities/PackedSites.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+std::string randomBytes(std::mt19937 &gen, size_t count) {
+	std::uniform_int_distribution<int> byte(0, 255);
+	std::string bytes;
+	for (size_t i = 0; i < count; i++) {
+		bytes += static_cast<char>(byte(gen));
+	}
+	return bytes;
+}
+
+// the operations of a delta: (length, jump) for a COPY, (length, 0) with
+// literal set for a LITERAL
+struct DeltaOp {
+	bool literal;
+	uint64_t length;
+	int64_t jump;
+};
+
+std::vector<DeltaOp> deltaOps(const std::string &delta) {
+	std::vector<DeltaOp> ops;
+	size_t pos = 0;
+	auto varint = [&]() {
+		uint64_t value = 0;
+		for (int shift = 0; pos < delta.size(); shift += 7) {
+			auto byte = static_cast<unsigned char>(delta[pos++]);
+			value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+			if ((byte & 0x80) == 0) {
+				break;
+			}
+		}
+		return value;
+	};
+	while (pos < delta.size()) {
+		uint64_t header = varint();
+		if (header & 1) {
+			ops.push_back({ true, header >> 1, 0 });
+			pos += header >> 1;
+		} else {
+			uint64_t zigzag = varint();
+			ops.push_back({ false, header >> 1, static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1) });
+		}
+	}
+	return ops;
+}
+
+std::string deltaRoundTrip(const std::string &base, const std::string &target) {
+	return PackedSites::deltaDecode(base, PackedSites::deltaEncode(base, target));
+}
+
+TEST(packedSites, DeltaOfEmptyGenomes) {
+	std::mt19937 gen(1);
+	auto bytes = randomBytes(gen, 100);
+	EXPECT_EQ(PackedSites::deltaEncode("", ""), "");
+	EXPECT_EQ(deltaRoundTrip("", ""), "");
+	EXPECT_EQ(PackedSites::deltaEncode(bytes, ""), "");
+	EXPECT_EQ(deltaRoundTrip(bytes, ""), "");
+	EXPECT_EQ(deltaRoundTrip("", bytes), bytes);
+	auto ops = deltaOps(PackedSites::deltaEncode("", bytes));
+	ASSERT_EQ(ops.size(), 1u);
+	EXPECT_TRUE(ops[0].literal);
+	EXPECT_EQ(ops[0].length, 100u);
+}
+
+TEST(packedSites, DeltaWithNoSharedRuns) {
+	std::mt19937 gen(2);
+	auto base = randomBytes(gen, 5000), target = randomBytes(gen, 3000);
+	auto delta = PackedSites::deltaEncode(base, target);
+	EXPECT_EQ(PackedSites::deltaDecode(base, delta), target);
+	auto ops = deltaOps(delta);
+	ASSERT_EQ(ops.size(), 1u);
+	EXPECT_TRUE(ops[0].literal);
+	// and runs shorter than a copy are literals too
+	EXPECT_EQ(deltaRoundTrip("abcdefg", "abcdefg"), "abcdefg");
+	EXPECT_TRUE(deltaOps(PackedSites::deltaEncode("abcdefg", "abcdefg"))[0].literal);
+}
+
+TEST(packedSites, DeltaWithALongCopy) {
+	std::mt19937 gen(3);
+	auto base = randomBytes(gen, 100000);
+	auto target = base;
+	target[60000] ^= 1;                                  // a point mutation
+	target.insert(80000, "inserted");                    // an insertion
+	target.erase(20000, 300);                            // and a deletion
+	auto delta = PackedSites::deltaEncode(base, target);
+	EXPECT_EQ(PackedSites::deltaDecode(base, delta), target);
+	EXPECT_LT(delta.size(), 100u);
+	auto ops = deltaOps(delta);
+	ASSERT_FALSE(ops.empty());
+	EXPECT_FALSE(ops[0].literal);
+	EXPECT_EQ(ops[0].length, 20000u);
+	EXPECT_EQ(ops[0].jump, 0);
+}
+
+TEST(packedSites, DeltaWithANegativeJump) {
+	std::mt19937 gen(4);
+	auto base = randomBytes(gen, 10000);
+	// the second half of base, then the first half
+	auto target = base.substr(5000) + base.substr(0, 5000);
+	auto delta = PackedSites::deltaEncode(base, target);
+	EXPECT_EQ(PackedSites::deltaDecode(base, delta), target);
+	auto ops = deltaOps(delta);
+	ASSERT_EQ(ops.size(), 2u);
+	EXPECT_EQ(ops[0].jump, 5000);
+	EXPECT_EQ(ops[1].jump, -10000); // back from the end of base to its start
+	EXPECT_EQ(ops[1].length, 5000u);
+}
+
+// writes organisms with a "GENOME_root::" genome which mutates a little from
+// one to the next, and checks every reference written reads back. Returns
+// the references.
+std::vector<std::string> checkSidecar(const std::string &fileName, std::mt19937 &gen, int organisms, bool delta) {
+	std::vector<std::string> references, sites;
+	std::uniform_int_distribution<int> site(0, 1999);
+	auto genome = randomBytes(gen, 2000);
+	for (int i = 0; i < organisms; i++) {
+		genome[site(gen)] ^= 0x55;
+		DataMap orgMap;
+		orgMap.set("ID", i);
+		orgMap.set("GENOME_root::" + PackedSites::packedSuffix, genome);
+		PackedSites::writeOrganism(orgMap, fileName, delta);
+		references.push_back(orgMap.getStringVector("GENOME_root::_sites")[0]);
+		sites.push_back(genome);
+		EXPECT_TRUE(PackedSites::isReference(references.back()));
+	}
+	PackedSites::closeFile(fileName);
+	for (int i = 0; i < organisms; i++) {
+		EXPECT_EQ(PackedSites::read(fileName, references[i]), sites[i]) << references[i];
+	}
+	return references;
+}
+
+TEST(packedSites, SidecarRoundTrip) {
+	std::string fileName = "test_packed_organisms.csv";
+	auto sitesName = PackedSites::sitesFileName(fileName);
+	EXPECT_EQ(sitesName, "test_packed_organisms.sites");
+	std::mt19937 gen(5);
+
+	// more organisms than maxDeltaChain, so some FULL blocks come between
+	// the DELTA blocks
+	auto references = checkSidecar(fileName, gen, 3 * PackedSites::maxDeltaChain, true);
+	EXPECT_EQ(references[0].substr(0, 3), "@0:");
+	std::ifstream sitesFile(sitesName, std::ios::binary | std::ios::ate);
+	EXPECT_LT(sitesFile.tellg(), 10 * 2000) << "most genomes should be deltas";
+	sitesFile.close();
+
+	// loaders may read on several threads at once
+	std::vector<std::string> expected;
+	for (auto &reference : references) {
+		expected.push_back(PackedSites::read(fileName, reference));
+	}
+	std::vector<int> mismatches(4, 0);
+	std::vector<std::thread> readers;
+	for (int r = 0; r < 4; r++) {
+		readers.emplace_back([&, r] {
+			for (int pass = 0; pass < 20; pass++) {
+				for (size_t i = r; i < references.size(); i++) {
+					mismatches[r] += PackedSites::read(fileName, references[i]) != expected[i];
+				}
+			}
+		});
+	}
+	for (auto &reader : readers) {
+		reader.join();
+	}
+	EXPECT_EQ(mismatches, std::vector<int>(4, 0));
+
+	// a closed file is appended to, so offsets carry on
+	auto more = checkSidecar(fileName, gen, 5, false);
+	EXPECT_NE(more[0].substr(0, 3), "@0:");
+	for (int i = 0; i < (int)references.size(); i++) {
+		EXPECT_EQ(PackedSites::read(fileName, references[i]).size(), 2000u);
+	}
+
+	// a file FileManager starts afresh (truncating it) starts at offset 0
+	FileManager::files.erase(fileName);
+	FileManager::fileStates.erase(fileName);
+	FileManager::files.erase(sitesName);
+	FileManager::fileStates.erase(sitesName);
+	auto afresh = checkSidecar(fileName, gen, 5, true);
+	EXPECT_EQ(afresh[0].substr(0, 3), "@0:");
+
+	FileManager::files.erase(fileName);
+	FileManager::fileStates.erase(fileName);
+	FileManager::files.erase(sitesName);
+	FileManager::fileStates.erase(sitesName);
+	std::remove(fileName.c_str());
+	std::remove(sitesName.c_str());
+}
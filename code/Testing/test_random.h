@@ -0,0 +1,58 @@
+#include <Utilities/Random.h>
+
+#include <vector>
+
+TEST(streamGenerator, SameKeySameNumbers) {
+	Random::StreamGenerator a(101, 5, 42), b(101, 5, 42);
+	for (int i = 0; i < 100; i++) {
+		EXPECT_EQ(a(), b()) << "streams with the same key should match at draw " << i;
+	}
+}
+
+TEST(streamGenerator, DifferentKeysDifferentNumbers) {
+	Random::StreamGenerator a(101, 5, 42), b(101, 5, 43), c(101, 42, 5);
+	int sameAB = 0, sameAC = 0;
+	for (int i = 0; i < 100; i++) {
+		auto va = a();
+		sameAB += (va == b());
+		sameAC += (va == c());
+	}
+	EXPECT_EQ(sameAB, 0) << "streams for different organisms should not match";
+	EXPECT_EQ(sameAC, 0) << "swapping update and ID should give a different stream";
+}
+
+TEST(streamGenerator, SeekIsRandomAccess) {
+	Random::StreamGenerator a(7, 1, 2);
+	std::vector<uint64_t> first;
+	for (int i = 0; i < 10; i++) {
+		first.push_back(a());
+	}
+	a.seek(5);
+	EXPECT_EQ(a(), first[5]) << "seek(5) should make the next draw the 6th value";
+	EXPECT_EQ(a.position(), 6u);
+}
+
+TEST(streamGenerator, RangesAreRespected) {
+	Random::StreamGenerator s(3, 0, 0);
+	bool sawLow = false, sawHigh = false;
+	for (int i = 0; i < 10000; i++) {
+		int v = Random::getInt(-2, 2, s);
+		EXPECT_TRUE(v >= -2 && v <= 2) << "getInt(-2,2) gave " << v;
+		sawLow |= (v == -2);
+		sawHigh |= (v == 2);
+		double d = Random::getDouble(1.5, 2.5, s);
+		EXPECT_TRUE(d >= 1.5 && d < 2.5) << "getDouble(1.5,2.5) gave " << d;
+	}
+	EXPECT_TRUE(sawLow && sawHigh) << "getInt should reach both ends of its range";
+}
+
+TEST(scopedStream, RoutesCallsWithoutGenerator) {
+	Random::StreamGenerator expected(11, 2, 3), installed(11, 2, 3);
+	{
+		Random::ScopedStream useStream(installed);
+		for (int i = 0; i < 20; i++) {
+			EXPECT_EQ(Random::getInt(0, 1000), Random::getInt(0, 1000, expected));
+		}
+	}
+	EXPECT_EQ(Random::getLocalStream(), nullptr) << "ScopedStream should restore the common generator";
+}
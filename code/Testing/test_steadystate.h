@@ -0,0 +1,124 @@
+#include <Archivist/DefaultArchivist.h>
+#include <Global.h>
+#include <Group/SteadyState.h>
+#include <Optimizer/AbstractOptimizer.h>
+#include <Organism/Organism.h>
+#include <Utilities/Random.h>
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// SteadyState never runs the optimizer or asks the world for anything in
+// these tests, they only supply the parameters and the evaluation
+class SteadyStateTestOptimizer : public AbstractOptimizer {
+public:
+	SteadyStateTestOptimizer(std::shared_ptr<ParametersTable> PT_) : AbstractOptimizer(PT_) {}
+	virtual void optimize(std::vector<std::shared_ptr<Organism>> &population) override {}
+};
+
+class SteadyStateTestWorld : public AbstractWorld {
+public:
+	SteadyStateTestWorld() : AbstractWorld(nullptr) {}
+	virtual std::unordered_map<std::string, std::unordered_set<std::string>> requiredGroups() override {
+		return { { "root::", {} } };
+	}
+	virtual void evaluate(std::map<std::string, std::shared_ptr<Group>> &groups, int analyze, int visualize,
+	                      int debug) override {}
+};
+
+// reaches the steps worker uses (with populationMutex held)
+class SteadyStateTester : public SteadyState {
+public:
+	using SteadyState::SteadyState;
+	using SteadyState::insert;
+	using SteadyState::scores;
+	using SteadyState::selectParent;
+	using SteadyState::selectReplaced;
+};
+
+class steadyState : public ::testing::Test {
+protected:
+	const int popSize = 10;
+	std::shared_ptr<ParametersTable> PT;
+	std::map<std::string, std::shared_ptr<Group>> groups;
+
+	void SetUp() override {
+		PT = Parameters::root->getTable("STEADY_STATE_TEST::");
+		PT->setParameter("STEADY_STATE-tournamentSize", 3);
+		PT->setParameter("STEADY_STATE-replaceTournamentSize", 4);
+		Random::getCommonGenerator().seed(31);
+		Global::update = 0;
+		std::vector<std::shared_ptr<Organism>> population;
+		for (int i = 0; i < popSize; i++) {
+			population.push_back(makeOrganism(i));
+		}
+		groups["root::"] = std::make_shared<Group>(population, std::make_shared<SteadyStateTestOptimizer>(PT),
+		                                           std::make_shared<DefaultArchivist>(PT));
+	}
+
+	std::shared_ptr<Organism> makeOrganism(double score) {
+		std::unordered_map<std::string, std::shared_ptr<AbstractGenome>> genomes;
+		std::unordered_map<std::string, std::shared_ptr<AbstractBrain>> brains;
+		auto org = std::make_shared<Organism>(genomes, brains, PT);
+		org->dataMap.set("score", score);
+		return org;
+	}
+};
+
+// organism i scores i, so the index selected is the best (or worst) of the
+// tournament. The best of 3 uniform draws from 10 is at most i with
+// probability ((i+1)/10)^3, and the worst of 4 is at least i with probability
+// ((10-i)/10)^4.
+TEST_F(steadyState, TournamentsPickTheBestAndWorstOfTheirDraws) {
+	SteadyStateTester steady(std::make_shared<SteadyStateTestWorld>(), groups);
+	for (int i = 0; i < popSize; i++) {
+		steady.scores.push_back(i);
+	}
+	const int draws = 100000;
+	std::vector<int> parents(popSize, 0), replaced(popSize, 0);
+	for (int i = 0; i < draws; i++) {
+		int parent = steady.selectParent();
+		int worst = steady.selectReplaced();
+		ASSERT_TRUE(parent >= 0 && parent < popSize);
+		ASSERT_TRUE(worst >= 0 && worst < popSize);
+		parents[parent]++;
+		replaced[worst]++;
+	}
+	int atMost = 0, atLeast = draws;
+	for (int i = 0; i < popSize; i++) {
+		atMost += parents[i];
+		double p = std::pow((i + 1.0) / popSize, 3);
+		EXPECT_NEAR((double)atMost / draws, p, 0.01) << "parent at most " << i;
+		double q = std::pow((double)(popSize - i) / popSize, 4);
+		EXPECT_NEAR((double)atLeast / draws, q, 0.01) << "replaced at least " << i;
+		atLeast -= replaced[i];
+	}
+	// (and a tournament can be all one organism, even the worst)
+	EXPECT_GT(parents[0], 0);
+	EXPECT_GT(replaced[popSize - 1], 0);
+}
+
+// STEADY_STATE-birthsPerUpdate = -1 is one update per popSize births
+TEST_F(steadyState, InsertAdvancesUpdateEveryPopSizeBirths) {
+	SteadyStateTester steady(std::make_shared<SteadyStateTestWorld>(), groups);
+	auto &population = groups["root::"]->population;
+	for (auto &org : population) {
+		steady.scores.push_back(org->dataMap.getAverage("score"));
+	}
+	for (int birth = 1; birth <= 3 * popSize; birth++) {
+		auto offspring = makeOrganism(100 + birth);
+		bool updateDone = steady.insert(offspring);
+		EXPECT_EQ(updateDone, birth % popSize == 0) << "birth " << birth;
+		EXPECT_EQ(Global::update, birth / popSize) << "birth " << birth;
+		ASSERT_EQ((int)population.size(), popSize);
+		ASSERT_EQ(steady.scores.size(), population.size());
+		for (int i = 0; i < popSize; i++) {
+			EXPECT_EQ(steady.scores[i], population[i]->dataMap.getAverage("score"));
+			EXPECT_TRUE(population[i]->alive);
+		}
+	}
+}
@@ -1,7 +1,25 @@
 #include <gtest/gtest.h>
 #include <iostream>
 
+#include "test_aliastable.h"
+#include "test_columnar.h"
+#include "test_csv.h"
+#include "test_datamap.h"
+#include "test_gatelist.h"
+#include "test_gateprogram.h"
 #include "test_graycode.h"
+#include "test_islands.h"
+#include "test_killlist.h"
+#include "test_lexicase.h"
+#include "test_lineage.h"
+#include "test_mtree.h"
+#include "test_offspring.h"
+#include "test_packedsites.h"
+#include "test_random.h"
+#include "test_steadystate.h"
+
+// Parameters.cpp prints this with -v, main.cpp gets it from gitversion.h
+const char *gitversion = "";
 
 int main(int argc, char* argv[]) {
 	testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,101 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+// Walker's alias method (built with Vose's algorithm). build() takes a weight
+// for each index, after which draw() returns an index with probability
+// weight / total weight using one index and one double, no matter how the
+// weights are spread. Weights which are not > 0 (including NaN) are never
+// drawn.
+
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+#include "Random.h"
+
+class AliasTable {
+private:
+  std::vector<double> threshold; // keep index i if a draw in [0,1) is below this
+  std::vector<int> alias;        // otherwise use this index
+  std::vector<int> small, large; // kept to save allocations between builds
+
+public:
+  AliasTable() = default;
+
+  // build the table for count weights into threshold and alias (count values
+  // each, so they can be rows of larger arrays), with small and large as
+  // scratch space. Returns false (leaving threshold and alias unchanged) if no
+  // weight is > 0 or the weights add up to infinity.
+  static bool build(const double *weights, int count, double *threshold,
+                    int *alias, std::vector<int> &small,
+                    std::vector<int> &large) {
+    double total = 0;
+    for (int i = 0; i < count; i++) {
+      if (weights[i] > 0) {
+        total += weights[i];
+      }
+    }
+    if (!(total > 0) || std::isinf(total)) {
+      return false;
+    }
+    small.clear();
+    large.clear();
+    for (int i = 0; i < count; i++) {
+      threshold[i] = (weights[i] > 0) ? weights[i] * count / total : 0;
+      alias[i] = i;
+      (threshold[i] < 1 ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+      int less = small.back();
+      small.pop_back();
+      int more = large.back();
+      alias[less] = more;
+      threshold[more] -= 1 - threshold[less];
+      if (threshold[more] < 1) {
+        large.pop_back();
+        small.push_back(more);
+      }
+    }
+    // whatever is left is 1 give or take rounding
+    for (int i : large) {
+      threshold[i] = 1;
+    }
+    for (int i : small) {
+      threshold[i] = 1;
+    }
+    return true;
+  }
+
+  // returns false (and leaves the table empty) if no weight is > 0 or the
+  // weights add up to infinity
+  bool build(const std::vector<double> &weights) {
+    int count = static_cast<int>(weights.size());
+    threshold.resize(count);
+    alias.resize(count);
+    if (!build(weights.data(), count, threshold.data(), alias.data(), small,
+               large)) {
+      threshold.clear();
+      alias.clear();
+      return false;
+    }
+    return true;
+  }
+
+  int size() const { return static_cast<int>(threshold.size()); }
+
+  template <typename Engine> int draw(Engine &gen) const {
+    int i = Random::getIndex(size(), gen);
+    return (Random::getDouble(1, gen) < threshold[i]) ? i : alias[i];
+  }
+  int draw() const {
+    return Random::withGenerator([&](auto &gen) { return draw(gen); });
+  }
+};
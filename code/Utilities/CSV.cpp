@@ -2,6 +2,7 @@
 
 
 #include "CSV.h"
+#include "Filesystem.h"
 #include <algorithm>
 #include <cmath>
 #include <fstream>
@@ -12,8 +13,16 @@
 #include <set>
 #include <sstream>
 #include <vector>
+#include <cstring>
 
-CSVReader::input CSVReader::symbol(char c) {
+#if defined(OS_UNIX)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+CSVReader::input CSVReader::symbol(char c) const {
   return c == delimiter_ ? input::delim
                          : c == quotation_ ? input::quote
                                            : c == ' ' ? input::wh_sp
@@ -91,6 +100,47 @@ std::vector<std::string> CSVReader::parseLine(const std::string &s) {
   return fields_;
 }
 
+const char *CSVReader::parseField(const char *begin, const char *end,
+                                  std::string *value) const {
+  if (value) {
+    value->clear();
+  }
+  state curr = state::precw; // (the same as following a delimiter)
+  auto p = begin;
+  for (; p < end; ++p) {
+    curr = Transition[static_cast<int>(curr)][static_cast<int>(symbol(*p))];
+    if (curr == state::delim) {
+      return p;
+    }
+    if (curr == state::CRASH) {
+      std::cout << "cannot parse : unexpected character" << std::endl;
+      std::cout << std::string(begin, end) << std::endl;
+      std::cout << std::string(p - begin, ' ') << "^" << std::endl;
+      exit(1);
+    }
+    if (curr == state::field || curr == state::openq) {
+      if (curr == state::openq) {
+        // nothing but a quote leaves a quoted field, so take the rest of it
+        // at once (this is what makes skipping a long genome cheap)
+        auto close = static_cast<const char *>(std::memchr(p, quotation_, end - p));
+        auto stop = close ? close : end;
+        if (value) {
+          value->append(p, stop);
+        }
+        p = stop - 1;
+      } else if (value) {
+        *value += *p;
+      }
+    }
+  }
+  if (curr == state::openq) {
+    std::cout << "cannot parse : missing quotation" << std::endl;
+    std::cout << std::string(begin, end) << std::endl;
+    exit(1);
+  }
+  return p;
+}
+
 std::vector<std::string> CSV::singleColumn(std::string column) {
   if (!hasColumn(column)) {
     std::cout << " Error : could not find column " << column
@@ -255,3 +305,127 @@ void CSV::merge(CSV merge_csv, std::string column) {
   }
 }
 
+MappedCSV::MappedCSV(std::string fn, char s, char se)
+    : reader_(s, se), delimiter_(s), quotation_(se), file_name_(fn) {
+
+#if defined(OS_UNIX)
+  int fd = open(file_name_.c_str(), O_RDONLY);
+  struct stat file_stat;
+  if (fd != -1 && fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+    size_ = file_stat.st_size;
+    void *mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping != MAP_FAILED) {
+      data_ = static_cast<const char *>(mapping);
+      mapped_ = true;
+    }
+  }
+  if (fd != -1) {
+    close(fd);
+  }
+#endif
+  if (!mapped_) {
+    std::ifstream file(file_name_, std::ios::binary);
+    if (!file.is_open()) {
+      std::cout << " Error: cannot open csv file "
+                << file_name_ << std::endl;
+      exit(1);
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    buffer_ = contents.str();
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+  }
+
+  // index the lines (as getline would split them)
+  size_t pos = 0;
+  while (pos < size_) {
+    line_starts_.push_back(pos);
+    auto newline = static_cast<const char *>(std::memchr(data_ + pos, '\n', size_ - pos));
+    pos = newline ? newline - data_ + 1 : size_ + 1;
+  }
+  if (line_starts_.empty()) { // empty file
+    line_starts_.push_back(0);
+    pos = 1;
+  }
+  line_starts_.push_back(pos);
+
+  // header line
+  auto header_end = line_starts_[1] - 1;
+  column_names_ = reader_.parseLine(std::string(data_, header_end));
+  line_starts_.erase(line_starts_.begin());
+
+  // ensure column names are unique
+  for (size_t i = 0; i < column_names_.size(); i++) {
+    if (!column_indices_.emplace(column_names_[i], static_cast<int>(i)).second) {
+      std::cout << "Error: CSV file " << file_name_
+                << " does not have unique Header names" << std::endl;
+      exit(1);
+    }
+  }
+
+  // ensure all rows have correct number of columns (skipping over the fields
+  // without copying them, so this stays cheap for long quoted genomes)
+  for (size_t row = 0; row < row_count(); row++) {
+    auto p = data_ + line_starts_[row];
+    auto row_end = data_ + line_starts_[row + 1] - 1;
+    size_t fields = 1;
+    while ((p = reader_.parseField(p, row_end, nullptr)) != row_end) {
+      fields++;
+      p++;
+    }
+    if (fields != column_names_.size()) {
+      badRow(row);
+    }
+  }
+}
+
+MappedCSV::~MappedCSV() {
+#if defined(OS_UNIX)
+  if (mapped_) {
+    munmap(const_cast<char *>(data_), size_);
+  }
+#endif
+}
+
+void MappedCSV::badRow(size_t row) const {
+  std::cout << " Error: incorrect number of columns in CSV file "
+            << file_name_ << " (row " << row + 1 << ")" << std::endl;
+  exit(1);
+}
+
+std::string MappedCSV::field(size_t row, int column) const {
+  if (row >= row_count() || column < 0 ||
+      column >= static_cast<int>(column_names_.size())) {
+    std::cout << " Error : no row " << row << " column " << column
+              << " in file " << file_name_ << std::endl;
+    exit(1);
+  }
+  auto p = data_ + line_starts_[row];
+  auto row_end = data_ + line_starts_[row + 1] - 1;
+  for (int i = 0; i < column; i++) {
+    p = reader_.parseField(p, row_end, nullptr);
+    if (p == row_end) {
+      badRow(row);
+    }
+    p++;
+  }
+  std::string value;
+  reader_.parseField(p, row_end, &value);
+  return value;
+}
+
+std::vector<std::string> MappedCSV::row(size_t row) const {
+  if (row >= row_count()) {
+    std::cout << " Error : no row " << row << " in file " << file_name_ << std::endl;
+    exit(1);
+  }
+  auto start = line_starts_[row];
+  auto data_line = reader_.parseLine(
+      std::string(data_ + start, line_starts_[row + 1] - 1 - start));
+  // ensure the row has the correct number of columns
+  if (column_names_.size() != data_line.size()) {
+    badRow(row);
+  }
+  return data_line;
+}
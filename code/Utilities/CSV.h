@@ -12,6 +12,8 @@
 #include <sstream>
 #include <vector>
 #include <array>
+#include <string>
+#include <unordered_map>
 
 // can parse a csv string into a vector of strings
 // The delimiter and quotation character can be specified:
@@ -49,7 +51,7 @@ class CSVReader {
     //{state::CRASH, state::CRASH, state::CRASH, state::CRASH}  // CRASH 6
   }};
 
-  CSVReader::input symbol(char);
+  CSVReader::input symbol(char) const;
   void doStateAction(state, char, const std::string&, const int&);
   void showLineAndErrorChar(const std::string&, const int&);
 
@@ -58,6 +60,11 @@ public:
   CSVReader(char d) : delimiter_(d) {}
   CSVReader(char d, char oq) : delimiter_(d), quotation_(oq) {}
   std::vector<std::string> parseLine(const std::string &);
+  // parses just the field starting at begin (of a line ending at end)
+  // exactly as parseLine would, into value (if not nullptr). Returns where
+  // the field ends: the delimiter after it, or end
+  const char *parseField(const char *begin, const char *end,
+                         std::string *value) const;
 };
 
 // parses a csv file and stores in memory.
@@ -115,3 +122,50 @@ public:
   }
 };
 
+// a csv file which is memory-mapped and indexed (where each row starts)
+// rather than parsed. Fields are only parsed when they are asked for, so
+// something can be picked out of a very large file (the greatest organisms
+// of a snapshot by score, say) by reading just the columns it needs.
+// Fields are parsed as CSVReader parses them.
+class MappedCSV {
+
+  mutable CSVReader reader_;
+  char delimiter_, quotation_;
+  std::string file_name_;
+
+  const char *data_ = nullptr; // the file contents
+  size_t size_ = 0;
+  bool mapped_ = false;   // else data_ is buffer_
+  std::string buffer_;    // where mmap is not available
+
+  std::vector<std::string> column_names_;
+  std::unordered_map<std::string, int> column_indices_;
+  // where each row starts in data_, and then where a row after the last
+  // would start (so row r ends one before line_starts_[r + 1])
+  std::vector<size_t> line_starts_;
+
+  void badRow(size_t) const;
+
+public:
+  MappedCSV(std::string fn, char s, char se);
+  MappedCSV(std::string fn) : MappedCSV(fn, ',', '"') {}
+  ~MappedCSV();
+  MappedCSV(const MappedCSV &) = delete;
+  MappedCSV &operator=(const MappedCSV &) = delete;
+
+  std::string fileName() const { return file_name_; }
+  size_t row_count() const { return line_starts_.size() - 1; }
+  const std::vector<std::string> &column_names() const { return column_names_; }
+
+  // position of a column, or -1 if there is no such column
+  int columnIndex(const std::string &name) const {
+    auto found = column_indices_.find(name);
+    return found == column_indices_.end() ? -1 : found->second;
+  }
+
+  // one value (only the fields up to this one are parsed)
+  std::string field(size_t row, int column) const;
+
+  // every value of a row
+  std::vector<std::string> row(size_t row) const;
+};
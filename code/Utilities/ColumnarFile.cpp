@@ -0,0 +1,646 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+#include "ColumnarFile.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+
+static const char fileMagic[] = "MABECOL1";
+static const char groupMagic[] = "MCRG";
+
+// little-endian encoding helpers
+
+static void putUInt(std::string &out, uint64_t value, int bytes) {
+  for (int i = 0; i < bytes; i++) {
+    out += static_cast<char>((value >> (8 * i)) & 0xff);
+  }
+}
+
+static uint64_t getUInt(const char *in, int bytes) {
+  uint64_t value = 0;
+  for (int i = 0; i < bytes; i++) {
+    value |= static_cast<uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+  }
+  return value;
+}
+
+static void putVarint(std::string &out, uint64_t value) {
+  while (value >= 0x80) {
+    out += static_cast<char>((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  out += static_cast<char>(value);
+}
+
+// reads a varint from data at pos (advancing pos); false if data ends first
+static bool getVarint(const std::string &data, size_t &pos, uint64_t &value) {
+  value = 0;
+  for (int shift = 0; pos < data.size() && shift < 64; shift += 7) {
+    auto byte = static_cast<unsigned char>(data[pos++]);
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Columnar::isColumnarFile(const std::string &fileName) {
+  return fileName.size() >= fileExtension.size() &&
+         fileName.compare(fileName.size() - fileExtension.size(),
+                          fileExtension.size(), fileExtension) == 0;
+}
+
+size_t Columnar::Values::size() const {
+  switch (type) {
+  case BOOL:
+    return bools.size();
+  case INT:
+    return ints.size();
+  case DOUBLE:
+    return doubles.size();
+  default:
+    return strings.size();
+  }
+}
+
+std::string Columnar::Values::text(size_t row) const {
+  switch (type) {
+  case BOOL:
+    return std::to_string(bools[row]);
+  case INT:
+    return std::to_string(ints[row]);
+  case DOUBLE:
+    return std::to_string(doubles[row]);
+  default:
+    return "\"" + strings[row] + "\"";
+  }
+}
+
+static void putDouble(std::string &out, double value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  putUInt(out, bits, 8);
+}
+
+static double getDouble(const char *in) {
+  uint64_t bits = getUInt(in, 8);
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// DICTIONARY encode rows [0, rows) of double or string values into out, if
+// no more than half of them are different (else returns false)
+static bool encodeDictionary(const Columnar::Values &values, size_t rows, std::string &out) {
+  std::vector<uint32_t> indices;
+  std::string dictionary;
+  uint32_t size = 0;
+  auto index = [&](auto &known, const auto &key, auto putValue) {
+    auto found = known.emplace(key, size);
+    if (found.second) {
+      size++;
+      putValue();
+    }
+    indices.push_back(found.first->second);
+    return size <= rows / 2;
+  };
+  if (values.type == Columnar::DOUBLE) {
+    std::unordered_map<uint64_t, uint32_t> known; // by bits, so -0.0 and nan stay as they are
+    for (size_t row = 0; row < rows; row++) {
+      uint64_t bits;
+      std::memcpy(&bits, &values.doubles[row], sizeof(bits));
+      if (!index(known, bits, [&] { putDouble(dictionary, values.doubles[row]); })) {
+        return false;
+      }
+    }
+  } else {
+    std::unordered_map<std::string, uint32_t> known;
+    for (size_t row = 0; row < rows; row++) {
+      auto const &value = values.strings[row];
+      if (!index(known, value, [&] {
+            putVarint(dictionary, value.size());
+            dictionary += value;
+          })) {
+        return false;
+      }
+    }
+  }
+  out.clear();
+  putVarint(out, size);
+  out += dictionary;
+  for (auto i : indices) {
+    putVarint(out, i);
+  }
+  return true;
+}
+
+// encode rows [0, rows) of values (not DICTIONARY, see encodeDictionary)
+static std::string encode(const Columnar::Values &values, size_t rows,
+                          Columnar::Encoding encoding) {
+  std::string out;
+  switch (encoding) {
+  case Columnar::BIT_PACKED:
+    out.assign((rows + 7) / 8, '\0');
+    for (size_t row = 0; row < rows; row++) {
+      if (values.bools[row]) {
+        out[row / 8] |= static_cast<char>(1 << (row % 8));
+      }
+    }
+    break;
+  case Columnar::DELTA_VARINT: {
+    int64_t previous = 0;
+    for (size_t row = 0; row < rows; row++) {
+      int64_t delta = static_cast<int64_t>(values.ints[row]) - previous;
+      previous = values.ints[row];
+      putVarint(out, (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63));
+    }
+    break;
+  }
+  case Columnar::VARINT_LENGTH:
+    for (size_t row = 0; row < rows; row++) {
+      putVarint(out, values.strings[row].size());
+      out += values.strings[row];
+    }
+    break;
+  default: // PLAIN
+    for (size_t row = 0; row < rows; row++) {
+      switch (values.type) {
+      case Columnar::BOOL:
+        out += static_cast<char>(values.bools[row] ? 1 : 0);
+        break;
+      case Columnar::INT:
+        putUInt(out, static_cast<uint32_t>(values.ints[row]), 4);
+        break;
+      case Columnar::DOUBLE:
+        putDouble(out, values.doubles[row]);
+        break;
+      case Columnar::STRING:
+        putUInt(out, values.strings[row].size(), 4);
+        out += values.strings[row];
+        break;
+      }
+    }
+    break;
+  }
+  return out;
+}
+
+// decode rows values from data; false if data is not as long as it should be
+static bool decode(const std::string &data, uint32_t rows, Columnar::Encoding encoding,
+                   Columnar::Values &values) {
+  size_t pos = 0;
+  uint64_t value;
+  switch (encoding) {
+  case Columnar::BIT_PACKED:
+    if (data.size() != (rows + 7) / 8) {
+      return false;
+    }
+    for (uint32_t row = 0; row < rows; row++) {
+      values.bools.push_back((data[row / 8] >> (row % 8)) & 1);
+    }
+    return true;
+  case Columnar::DELTA_VARINT: {
+    int64_t previous = 0;
+    for (uint32_t row = 0; row < rows; row++) {
+      if (!getVarint(data, pos, value)) {
+        return false;
+      }
+      previous += static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+      values.ints.push_back(static_cast<int32_t>(previous));
+    }
+    return pos == data.size();
+  }
+  case Columnar::VARINT_LENGTH:
+    for (uint32_t row = 0; row < rows; row++) {
+      if (!getVarint(data, pos, value) || value > data.size() - pos) {
+        return false;
+      }
+      values.strings.push_back(data.substr(pos, value));
+      pos += value;
+    }
+    return pos == data.size();
+  case Columnar::DICTIONARY: {
+    Columnar::Values dictionary;
+    dictionary.type = values.type;
+    uint64_t size;
+    if (values.type == Columnar::BOOL || values.type == Columnar::INT ||
+        !getVarint(data, pos, size) || size > data.size()) {
+      return false;
+    }
+    for (uint64_t i = 0; i < size; i++) {
+      if (values.type == Columnar::DOUBLE) {
+        if (pos + 8 > data.size()) {
+          return false;
+        }
+        dictionary.doubles.push_back(getDouble(&data[pos]));
+        pos += 8;
+      } else {
+        if (!getVarint(data, pos, value) || value > data.size() - pos) {
+          return false;
+        }
+        dictionary.strings.push_back(data.substr(pos, value));
+        pos += value;
+      }
+    }
+    for (uint32_t row = 0; row < rows; row++) {
+      if (!getVarint(data, pos, value) || value >= size) {
+        return false;
+      }
+      if (values.type == Columnar::DOUBLE) {
+        values.doubles.push_back(dictionary.doubles[value]);
+      } else {
+        values.strings.push_back(dictionary.strings[value]);
+      }
+    }
+    return pos == data.size();
+  }
+  case Columnar::PLAIN:
+    for (uint32_t row = 0; row < rows; row++) {
+      switch (values.type) {
+      case Columnar::BOOL:
+        if (pos + 1 > data.size()) {
+          return false;
+        }
+        values.bools.push_back(data[pos++] != 0);
+        break;
+      case Columnar::INT:
+        if (pos + 4 > data.size()) {
+          return false;
+        }
+        values.ints.push_back(static_cast<int32_t>(getUInt(&data[pos], 4)));
+        pos += 4;
+        break;
+      case Columnar::DOUBLE:
+        if (pos + 8 > data.size()) {
+          return false;
+        }
+        values.doubles.push_back(getDouble(&data[pos]));
+        pos += 8;
+        break;
+      case Columnar::STRING:
+        if (pos + 4 > data.size()) {
+          return false;
+        }
+        value = getUInt(&data[pos], 4);
+        pos += 4;
+        if (value > data.size() - pos) {
+          return false;
+        }
+        values.strings.push_back(data.substr(pos, value));
+        pos += value;
+        break;
+      }
+    }
+    return pos == data.size();
+  }
+  return false;
+}
+
+ColumnarWriter::ColumnarWriter(std::vector<Columnar::Column> _columns, bool _compress,
+                               size_t _rowGroupRows)
+    : columns(std::move(_columns)), compress(_compress),
+      rowGroupRows(std::max<size_t>(1, _rowGroupRows)) {
+  for (size_t c = 0; c < columns.size(); c++) {
+    values.push_back({columns[c].type, {}, {}, {}, {}});
+    if (columns[c].name == "update" && columns[c].type == Columnar::INT) {
+      updateColumn = static_cast<int>(c);
+    }
+  }
+}
+
+std::string ColumnarWriter::fileHeader() const {
+  std::string header(fileMagic, 8);
+  putUInt(header, columns.size(), 4);
+  for (auto const &c : columns) {
+    header += static_cast<char>(c.type);
+    putUInt(header, c.name.size(), 4);
+    header += c.name;
+  }
+  return header;
+}
+
+Columnar::Values &ColumnarWriter::next(Columnar::Type type, const char *typeName) {
+  if (column >= columns.size() || (columns[column].type < type && groupTaken)) {
+    std::cout << "  ERROR :: in ColumnarWriter, a " << typeName << " value can not be "
+              << (column >= columns.size() ? "added past the last column"
+                                           : "written to column \"" + columns[column].name + "\"")
+              << ". The columns of a columnar data file are set once its first row group has "
+                 "been written.\n  Exiting."
+              << std::endl;
+    exit(1);
+  }
+  if (columns[column].type < type) {
+    widen(column, type);
+  }
+  return values[column++];
+}
+
+void ColumnarWriter::widen(size_t c, Columnar::Type type) {
+  auto &v = values[c];
+  Columnar::Values wider{type, {}, {}, {}, {}};
+  for (size_t row = 0; row < v.size(); row++) {
+    switch (type) {
+    case Columnar::INT:
+      wider.ints.push_back(v.bools[row]);
+      break;
+    case Columnar::DOUBLE:
+      wider.doubles.push_back(v.type == Columnar::BOOL ? v.bools[row] : v.ints[row]);
+      break;
+    default:
+      wider.strings.push_back(v.text(row));
+    }
+  }
+  v = std::move(wider);
+  columns[c].type = type;
+  if (static_cast<int>(c) == updateColumn) {
+    updateColumn = -1;
+  } else if (columns[c].name == "update" && type == Columnar::INT) {
+    updateColumn = static_cast<int>(c);
+  }
+}
+
+void ColumnarWriter::add(bool value) {
+  auto &v = next(Columnar::BOOL, "bool");
+  switch (v.type) {
+  case Columnar::BOOL:
+    v.bools.push_back(value);
+    break;
+  case Columnar::INT:
+    v.ints.push_back(value);
+    break;
+  case Columnar::DOUBLE:
+    v.doubles.push_back(value);
+    break;
+  default:
+    v.strings.push_back(std::to_string(value));
+  }
+}
+
+void ColumnarWriter::add(int value) {
+  auto &v = next(Columnar::INT, "int");
+  switch (v.type) {
+  case Columnar::INT:
+    v.ints.push_back(value);
+    break;
+  case Columnar::DOUBLE:
+    v.doubles.push_back(value);
+    break;
+  default:
+    v.strings.push_back(std::to_string(value));
+  }
+}
+
+void ColumnarWriter::add(double value) {
+  auto &v = next(Columnar::DOUBLE, "double");
+  if (v.type == Columnar::DOUBLE) {
+    v.doubles.push_back(value);
+  } else {
+    v.strings.push_back(std::to_string(value));
+  }
+}
+
+void ColumnarWriter::add(const std::string &value) {
+  next(Columnar::STRING, "string").strings.push_back(value);
+}
+
+bool ColumnarWriter::endRow() {
+  if (column != columns.size()) {
+    std::cout << "  ERROR :: in ColumnarWriter, a row ended with " << column << " of "
+              << columns.size() << " columns.\n  Exiting." << std::endl;
+    exit(1);
+  }
+  column = 0;
+  rows++;
+  if (readyRows == 0) {
+    if (updateColumn == -1) {
+      if (rows >= rowGroupRows) {
+        readyRows = rows;
+      }
+    } else if (rows > rowGroupRows) {
+      // a group only ends between updates
+      auto const &updates = values[updateColumn].ints;
+      if (updates[rows - 1] != updates[rows - 2]) {
+        readyRows = rows - 1;
+      }
+    }
+  }
+  return readyRows > 0;
+}
+
+std::string ColumnarWriter::takeRowGroup(bool all) {
+  size_t groupRows = all ? rows : readyRows;
+  if (groupRows == 0) {
+    return "";
+  }
+  groupTaken = true;
+  std::string group(groupMagic, 4);
+  putUInt(group, groupRows, 4);
+  int32_t firstUpdate = 0, lastUpdate = 0;
+  if (updateColumn != -1) {
+    firstUpdate = values[updateColumn].ints[0];
+    lastUpdate = values[updateColumn].ints[groupRows - 1];
+  }
+  putUInt(group, static_cast<uint32_t>(firstUpdate), 4);
+  putUInt(group, static_cast<uint32_t>(lastUpdate), 4);
+
+  std::vector<std::string> data;
+  for (auto &v : values) {
+    auto encoding = Columnar::PLAIN;
+    data.emplace_back();
+    if (compress) {
+      if (v.type == Columnar::BOOL) {
+        encoding = Columnar::BIT_PACKED;
+      } else if (v.type == Columnar::INT) {
+        encoding = Columnar::DELTA_VARINT;
+      } else if (encodeDictionary(v, groupRows, data.back())) {
+        encoding = Columnar::DICTIONARY;
+      } else if (v.type == Columnar::STRING) {
+        encoding = Columnar::VARINT_LENGTH;
+      }
+    }
+    if (encoding != Columnar::DICTIONARY) {
+      data.back() = encode(v, groupRows, encoding);
+    }
+    group += static_cast<char>(encoding);
+    putUInt(group, data.back().size(), 8);
+
+    // drop the rows taken (any left belong to the next update)
+    v.bools.erase(v.bools.begin(), v.bools.begin() + std::min(groupRows, v.bools.size()));
+    v.ints.erase(v.ints.begin(), v.ints.begin() + std::min(groupRows, v.ints.size()));
+    v.doubles.erase(v.doubles.begin(), v.doubles.begin() + std::min(groupRows, v.doubles.size()));
+    v.strings.erase(v.strings.begin(), v.strings.begin() + std::min(groupRows, v.strings.size()));
+  }
+  for (auto const &d : data) {
+    group += d;
+  }
+  rows -= groupRows;
+  readyRows = 0;
+  return group;
+}
+
+ColumnarReader::ColumnarReader(const std::string &_fileName)
+    : fileName(_fileName), file(_fileName, std::ios::binary) {
+  if (!file.is_open()) {
+    fail("it could not be opened");
+  }
+  char buffer[17];
+  if (!file.read(buffer, 12) || std::memcmp(buffer, fileMagic, 8) != 0) {
+    fail("it is not a columnar data file");
+  }
+  auto columnCount = getUInt(buffer + 8, 4);
+  for (uint64_t c = 0; c < columnCount; c++) {
+    if (!file.read(buffer, 5)) {
+      fail("its header is cut short");
+    }
+    Columnar::Column column;
+    column.type = static_cast<Columnar::Type>(buffer[0]);
+    if (column.type < Columnar::BOOL || column.type > Columnar::STRING) {
+      fail("column " + std::to_string(c) + " has an unknown type");
+    }
+    column.name.resize(getUInt(buffer + 1, 4));
+    if (!file.read(&column.name[0], column.name.size())) {
+      fail("its header is cut short");
+    }
+    columns.push_back(column);
+  }
+
+  // find the row groups (skipping over their data)
+  while (file.read(buffer, 16)) {
+    if (std::memcmp(buffer, groupMagic, 4) != 0) {
+      fail("row group " + std::to_string(rowGroups.size()) + " is damaged");
+    }
+    RowGroup group;
+    group.rows = static_cast<uint32_t>(getUInt(buffer + 4, 4));
+    group.firstUpdate = static_cast<int32_t>(getUInt(buffer + 8, 4));
+    group.lastUpdate = static_cast<int32_t>(getUInt(buffer + 12, 4));
+    for (size_t c = 0; c < columns.size(); c++) {
+      if (!file.read(buffer, 9)) {
+        fail("row group " + std::to_string(rowGroups.size()) + " is cut short");
+      }
+      group.encodings.push_back(static_cast<Columnar::Encoding>(buffer[0]));
+      group.sizes.push_back(getUInt(buffer + 1, 8));
+    }
+    uint64_t offset = file.tellg();
+    for (auto size : group.sizes) {
+      group.offsets.push_back(offset);
+      offset += size;
+    }
+    file.seekg(offset);
+    rowGroups.push_back(group);
+  }
+  if (file.gcount() != 0) {
+    fail("it ends part way into a row group");
+  }
+  file.clear();
+  file.seekg(0, std::ios::end);
+  if (!rowGroups.empty() &&
+      static_cast<uint64_t>(file.tellg()) < rowGroups.back().offsets.back() + rowGroups.back().sizes.back()) {
+    fail("the last row group is cut short");
+  }
+}
+
+void ColumnarReader::fail(const std::string &problem) const {
+  std::cout << "  ERROR :: ColumnarReader can not read \"" << fileName << "\", " << problem
+            << ".\n  Exiting." << std::endl;
+  exit(1);
+}
+
+int ColumnarReader::findColumn(const std::string &name) const {
+  for (size_t c = 0; c < columns.size(); c++) {
+    if (columns[c].name == name) {
+      return static_cast<int>(c);
+    }
+  }
+  return -1;
+}
+
+size_t ColumnarReader::rowCount() const {
+  size_t rows = 0;
+  for (auto const &group : rowGroups) {
+    rows += group.rows;
+  }
+  return rows;
+}
+
+Columnar::Values ColumnarReader::readColumn(size_t group, size_t column) {
+  auto const &g = rowGroups.at(group);
+  std::string data(g.sizes.at(column), '\0');
+  file.clear();
+  file.seekg(g.offsets[column]);
+  if (!file.read(&data[0], data.size())) {
+    fail("column \"" + columns[column].name + "\" of row group " + std::to_string(group) +
+         " could not be read");
+  }
+  Columnar::Values values;
+  values.type = columns[column].type;
+  if (!decode(data, g.rows, g.encodings[column], values)) {
+    fail("column \"" + columns[column].name + "\" of row group " + std::to_string(group) +
+         " is damaged");
+  }
+  return values;
+}
+
+Columnar::Values ColumnarReader::readColumn(const std::string &name) {
+  int column = findColumn(name);
+  if (column == -1) {
+    fail("it has no column \"" + name + "\"");
+  }
+  Columnar::Values values;
+  values.type = columns[column].type;
+  for (size_t group = 0; group < rowGroups.size(); group++) {
+    auto groupValues = readColumn(group, column);
+    values.bools.insert(values.bools.end(), groupValues.bools.begin(), groupValues.bools.end());
+    values.ints.insert(values.ints.end(), groupValues.ints.begin(), groupValues.ints.end());
+    values.doubles.insert(values.doubles.end(), groupValues.doubles.begin(),
+                          groupValues.doubles.end());
+    values.strings.insert(values.strings.end(), groupValues.strings.begin(),
+                          groupValues.strings.end());
+  }
+  return values;
+}
+
+void ColumnarReader::writeCSV(std::ostream &out) {
+  if (columns.empty()) {
+    return;
+  }
+  std::string line;
+  for (auto const &c : columns) {
+    line += "," + c.name;
+  }
+  out << line.substr(1) << "\n";
+  for (size_t group = 0; group < rowGroups.size(); group++) {
+    std::vector<Columnar::Values> groupValues;
+    for (size_t c = 0; c < columns.size(); c++) {
+      groupValues.push_back(readColumn(group, c));
+    }
+    for (uint32_t row = 0; row < rowGroups[group].rows; row++) {
+      line.clear();
+      for (auto const &v : groupValues) {
+        line += ',';
+        line += v.text(row);
+      }
+      out << line.substr(1) << "\n";
+    }
+  }
+}
+
+void ColumnarReader::writeCSV(const std::string &csvFileName) {
+  std::ofstream out(csvFileName);
+  if (!out.is_open()) {
+    std::cout << "  ERROR :: ColumnarReader can not write \"" << csvFileName
+              << "\".\n  Exiting." << std::endl;
+    exit(1);
+  }
+  writeCSV(out);
+}
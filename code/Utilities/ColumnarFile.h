@@ -0,0 +1,155 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+// A typed, columnar binary alternative to the csv data files (pop, max,
+// snapshot data and LOD data files when ARCHIVIST-outputFormat is columnar).
+// A file has a fixed schema (the column names and types) and then row
+// groups, each holding whole updates (a group ends at the first change of the
+// "update" column after rowGroupRows rows). Each column of a group is stored
+// together, so a reader can skip the columns it doesn't need.
+//
+// The column types come from the rows written before the first row group.
+// Until then a column is widened if a row needs it (bool to int to double to
+// string, numbers becoming the text the csv file would have held); after
+// that a value wider than its column stops the run, and numbers written to a
+// string column are stored as text.
+//
+// file:      "MABECOL1", uint32 columnCount,
+//            per column: uint8 type, uint32 name length, name
+// row group: "MCRG", uint32 rows, int32 first update, int32 last update,
+//            per column: uint8 encoding, uint64 bytes,
+//            then the data of each column, in order
+//
+// All numbers are little-endian. Without compression every column is PLAIN
+// (bools one byte each, int32s, doubles, strings as uint32 length and bytes).
+// With compression bools are BIT_PACKED, ints are DELTA_VARINT (the zigzag
+// varint difference from the row before), and doubles and strings are
+// DICTIONARY (varint value count, the values, then a varint index for each
+// row) if no more than half of the values in the group are different, else
+// doubles stay PLAIN and strings are VARINT_LENGTH (varint length and bytes).
+//
+// ColumnarReader::writeCSV gives back exactly the csv file MABE would have
+// written (mabe -c converts files from the command line).
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Columnar {
+
+enum Type : uint8_t { BOOL = 1, INT = 2, DOUBLE = 3, STRING = 4 };
+enum Encoding : uint8_t {
+  PLAIN = 0,
+  BIT_PACKED = 1,
+  DELTA_VARINT = 2,
+  VARINT_LENGTH = 3,
+  DICTIONARY = 4
+};
+
+const std::string fileExtension = ".mcol";
+bool isColumnarFile(const std::string &fileName); // does it end in fileExtension
+
+struct Column {
+  std::string name;
+  Type type;
+};
+
+// the values of one column (of a row group, or a row group being built);
+// only the vector for the column's type is used
+struct Values {
+  Type type;
+  std::vector<char> bools;
+  std::vector<int32_t> ints;
+  std::vector<double> doubles;
+  std::vector<std::string> strings;
+
+  size_t size() const;
+  // value row as it is written in a MABE csv file
+  std::string text(size_t row) const;
+};
+
+} // namespace Columnar
+
+class ColumnarWriter {
+public:
+  ColumnarWriter(std::vector<Columnar::Column> _columns, bool _compress,
+                 size_t _rowGroupRows);
+
+  const std::vector<Columnar::Column> &getColumns() const { return columns; }
+  std::string fileHeader() const;
+
+  // add the values of a row, one column at a time, in column order. Values
+  // may go to a column of a wider type (see above)
+  void add(bool value);
+  void add(int value);
+  void add(double value);
+  void add(const std::string &value);
+  // returns true once a row group is ready to be taken
+  bool endRow();
+
+  // encode and remove the rows of the ready row group, or (if all) every
+  // row held (ends the current group early)
+  std::string takeRowGroup(bool all = false);
+  bool empty() const { return rows == 0; }
+
+private:
+  std::vector<Columnar::Column> columns;
+  std::vector<Columnar::Values> values; // the rows held, by column
+  bool compress;
+  size_t rowGroupRows;
+  int updateColumn = -1; // the INT column named "update" (if there is one)
+  size_t column = 0;     // the column the next add goes to
+  size_t rows = 0;       // rows held
+  size_t readyRows = 0;  // rows in the ready group (0 if none is ready)
+  bool groupTaken = false; // the columns are fixed once a group is taken
+
+  Columnar::Values &next(Columnar::Type type, const char *typeName);
+  // change column c to type, converting the values held
+  void widen(size_t c, Columnar::Type type);
+};
+
+class ColumnarReader {
+public:
+  struct RowGroup {
+    uint32_t rows;
+    int32_t firstUpdate;
+    int32_t lastUpdate;
+    std::vector<Columnar::Encoding> encodings; // by column
+    std::vector<uint64_t> sizes;
+    std::vector<uint64_t> offsets; // where each column's data starts in the file
+  };
+
+  explicit ColumnarReader(const std::string &_fileName);
+
+  const std::vector<Columnar::Column> &getColumns() const { return columns; }
+  int findColumn(const std::string &name) const; // -1 if there is no such column
+  const std::vector<RowGroup> &getRowGroups() const { return rowGroups; }
+  size_t rowCount() const;
+
+  // read one column of one row group (only that column's data is read)
+  Columnar::Values readColumn(size_t group, size_t column);
+  // every row of a column
+  Columnar::Values readColumn(const std::string &name);
+
+  void writeCSV(std::ostream &out);
+  void writeCSV(const std::string &csvFileName);
+
+private:
+  std::string fileName;
+  std::ifstream file;
+  std::vector<Columnar::Column> columns;
+  std::vector<RowGroup> rowGroups;
+
+  [[noreturn]] void fail(const std::string &problem) const;
+};
@@ -9,12 +9,21 @@
 //         github.com/Hintzelab/MABE/wiki/License
 
 #include "Data.h"
+#include "PackedSites.h"
 
+#include <algorithm>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
 #include <fstream>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 
 
 // global variables that should be accessible to all
@@ -26,63 +35,357 @@ std::map<std::string, std::ofstream>
     FileManager::files; // list of files (NAME,ofstream)
 std::map<std::string, bool>
     FileManager::fileStates; // list of files states (NAME,open?)
+bool FileManager::bufferedOutput = false;
+size_t FileManager::bufferSize = 1 << 20;
+std::map<std::string, std::string> FileManager::buffers;
+std::map<std::string, std::unique_ptr<ColumnarWriter>> FileManager::columnarWriters;
+bool FileManager::columnarCompression = true;
+size_t FileManager::columnarRowGroupRows = 1000;
 std::map<std::string, int> DataMap::knownOutputBehaviors = {
     {"LIST", LIST},     {"AVE", AVE},     {"SUM", SUM}, {"PROD", PROD},
     {"STDERR", STDERR}, {"FIRST", FIRST}, {"VAR", VAR}};
 
+// columnar data files and packed sites files are binary: data is written as
+// is (not as lines), and the files are opened in binary mode (which only
+// matters on windows)
+static bool isBinaryFile(const std::string &fileName) {
+  return Columnar::isColumnarFile(fileName) || PackedSites::isSitesFile(fileName);
+}
+
+static std::ios::openmode openMode(const std::string &fileName) {
+  return isBinaryFile(fileName) ? std::ios::out | std::ios::binary : std::ios::out;
+}
+
+// Opens, writes and closes files for buffered output on its own thread, in the
+// order jobs are queued. Only this thread touches these files
+// (FileManager::files just records which files have been started). If more
+// than maxQueuedBytes are waiting, queueJob blocks until the thread catches up.
+class BackgroundFileWriter {
+public:
+  enum JobType { CREATE, APPEND, WRITE, CLOSE, FLUSH };
+  struct Job {
+    JobType type;
+    std::string fileName;
+    std::string data; // path for CREATE and APPEND, then (for CREATE) header
+  };
+
+  BackgroundFileWriter(size_t _maxQueuedBytes)
+      : maxQueuedBytes(_maxQueuedBytes), writer(&BackgroundFileWriter::run, this) {}
+
+  ~BackgroundFileWriter() {
+    {
+      std::lock_guard<std::mutex> lock(queueMutex);
+      stopping = true;
+    }
+    jobReady.notify_one();
+    writer.join();
+  }
+
+  void queueJob(Job job) {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    jobDone.wait(lock, [&] { return jobs.empty() || queuedBytes < maxQueuedBytes; });
+    queuedBytes += job.data.size();
+    jobs.push_back(std::move(job));
+    jobReady.notify_one();
+  }
+
+  // returns when every queued job is done
+  void wait() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    jobDone.wait(lock, [&] { return jobs.empty() && !working; });
+  }
+
+private:
+  std::map<std::string, std::ofstream> files;
+  std::deque<Job> jobs;
+  size_t queuedBytes = 0;
+  size_t maxQueuedBytes;
+  bool working = false;
+  bool stopping = false;
+  std::mutex queueMutex;
+  std::condition_variable jobReady;
+  std::condition_variable jobDone;
+  std::thread writer; // last, so that it starts after everything else is set up
+
+  void doJob(Job &job) {
+    auto &file = files[job.fileName];
+    switch (job.type) {
+    case CREATE: {
+      auto path = job.data.substr(0, job.data.find('\n'));
+      file.open(path, openMode(path));
+      file << job.data.substr(job.data.find('\n') + 1);
+      break;
+    }
+    case APPEND:
+      file.open(job.data, openMode(job.data) | std::ios::app);
+      break;
+    case WRITE:
+      file << job.data;
+      break;
+    case CLOSE:
+      file.close();
+      break;
+    case FLUSH:
+      for (auto &f : files) {
+        if (f.second.is_open()) {
+          f.second.flush();
+        }
+      }
+      break;
+    }
+  }
+
+  void run() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (true) {
+      jobReady.wait(lock, [&] { return stopping || !jobs.empty(); });
+      if (jobs.empty()) { // stopping
+        return;
+      }
+      Job job = std::move(jobs.front());
+      jobs.pop_front();
+      working = true;
+      lock.unlock();
+      doJob(job);
+      lock.lock();
+      working = false;
+      queuedBytes -= job.data.size();
+      jobDone.notify_all();
+    }
+  }
+};
+
+static std::unique_ptr<BackgroundFileWriter> backgroundWriter;
+
+// static objects are destroyed in reverse order, so this runs while the
+// buffers and the writer still exist
+static struct FlushOnExit {
+  ~FlushOnExit() {
+    FileManager::flush();
+    backgroundWriter.reset();
+  }
+} flushOnExit;
+
+void FileManager::setBufferedOutput(bool buffered, size_t _bufferSize) {
+  flush();
+  bufferedOutput = buffered;
+  bufferSize = _bufferSize;
+  if (bufferedOutput && backgroundWriter == nullptr) {
+    // let a few full buffers queue up before writeToFile has to wait
+    backgroundWriter = std::make_unique<BackgroundFileWriter>(8 * bufferSize);
+  }
+}
+
+void FileManager::setColumnarOutput(bool compression, size_t rowGroupRows) {
+  columnarCompression = compression;
+  columnarRowGroupRows = rowGroupRows;
+}
+
+void FileManager::finishRowGroup(const std::string &fileName, ColumnarWriter &writer) {
+  if (!writer.empty()) {
+    writeToFile(fileName, writer.takeRowGroup(true), writer.fileHeader());
+  }
+}
+
+void FileManager::flush() {
+  for (auto &writer : columnarWriters) {
+    finishRowGroup(writer.first, *writer.second);
+  }
+  if (backgroundWriter == nullptr) {
+    return;
+  }
+  for (auto &buffer : buffers) {
+    if (!buffer.second.empty()) {
+      backgroundWriter->queueJob({BackgroundFileWriter::WRITE, buffer.first,
+                                  std::move(buffer.second)});
+      buffer.second.clear();
+    }
+  }
+  backgroundWriter->queueJob({BackgroundFileWriter::FLUSH, "", ""});
+  backgroundWriter->wait();
+}
+
 void FileManager::writeToFile(const std::string &fileName,
                               const std::string &data,
                               const std::string &header) {
   openFile(
       fileName,
       header); // make sure that the file is open and ready to be written to
-  files[fileName] << data << "\n" << std::flush;
+  bool lines = !isBinaryFile(fileName);
+  if (bufferedOutput) {
+    std::string &buffer = buffers[fileName];
+    buffer += data;
+    if (lines) {
+      buffer += '\n';
+    }
+    if (buffer.size() >= bufferSize) {
+      backgroundWriter->queueJob({BackgroundFileWriter::WRITE, fileName, std::move(buffer)});
+      buffer.clear();
+      buffer.reserve(bufferSize + data.size() + 1);
+    }
+    return;
+  }
+  files[fileName] << data;
+  if (lines) {
+    files[fileName] << "\n";
+  }
+  files[fileName] << std::flush;
+}
+
+// the header as it starts a file (columnar headers are binary, not a line)
+static std::string headerLine(const std::string &fileName, const std::string &header) {
+  if (header.empty() || isBinaryFile(fileName)) {
+    return header;
+  }
+  return header + "\n";
 }
 
 void FileManager::openFile(const std::string &fileName, const std::string &header) {
+  if (bufferedOutput) {
+    // files[fileName] is left closed, it only records that the file was started
+    if (files.find(fileName) == files.end()) {
+      files.emplace(make_pair(fileName, std::ofstream()));
+      fileStates[fileName] = true;
+      backgroundWriter->queueJob(
+          {BackgroundFileWriter::CREATE, fileName,
+           std::string(outputPrefix) + fileName + "\n" + headerLine(fileName, header)});
+    } else if (fileStates[fileName] == false) {
+      fileStates[fileName] = true;
+      backgroundWriter->queueJob({BackgroundFileWriter::APPEND, fileName,
+                                  std::string(outputPrefix) + fileName});
+    }
+    return;
+  }
   if (files.find(fileName) ==
       files.end()) { // if file has not be initialized yet
     files.emplace(make_pair(fileName, std::ofstream())); // make an ofstream for the
                                                     // new file and place in
                                                     // FileManager::files
     files[fileName].open(
-        std::string(outputPrefix) +
-        fileName);               // clear file contents and open in write mode
+        std::string(outputPrefix) + fileName,
+        openMode(fileName));     // clear file contents and open in write mode
     fileStates[fileName] = true; // this file is now open
-    if (!header.empty()) { // if there is a header string, write this to the new
-                           // file
-      files[fileName] << header << "\n";
-    }
+    // if there is a header string, write this to the new file
+    files[fileName] << headerLine(fileName, header);
   }
   if (fileStates[fileName] == false) { // if file is closed ...
     files[fileName].open(std::string(outputPrefix) + fileName,
-                         std::ios::out |
+                         openMode(fileName) |
                              std::ios::app); // open file in append mode
+    fileStates[fileName] = true;
   }
 }
 
 void FileManager::closeFile(const std::string &fileName) {
+  auto writer = columnarWriters.find(fileName);
+  if (writer != columnarWriters.end()) {
+    // a file which is closed is usually done with (i.e. snapshots), so its
+    // writer goes (a new one is made if the file is written to again)
+    finishRowGroup(fileName, *writer->second);
+    columnarWriters.erase(writer);
+  }
   if (files.find(fileName) == files.end()) {
     std::cout << "  In FileManager::closeFile :: ERROR, attempt to close file '"
          << fileName
          << "' but this file has not been opened or created! Exiting." << std::endl;
     exit(1);
   }
-  files[fileName].close();
+  if (bufferedOutput) {
+    std::string &buffer = buffers[fileName];
+    if (!buffer.empty()) {
+      backgroundWriter->queueJob({BackgroundFileWriter::WRITE, fileName, std::move(buffer)});
+      buffer.clear();
+    }
+    backgroundWriter->queueJob({BackgroundFileWriter::CLOSE, fileName, ""});
+  } else {
+    files[fileName].close();
+  }
   fileStates[fileName] = false; // make a note that this file is closed
 }
 
 // copy constructor
 DataMap::DataMap(std::shared_ptr<DataMap> source) {
-  boolData = source->boolData;
-  doubleData = source->doubleData;
-  intData = source->intData;
-  stringData = source->stringData;
-  for (auto entry : source->inUse) {
-    inUse[entry.first] = entry.second;
+  entries = source->entries;
+  entryOf = source->entryOf;
+}
+
+// the symbol table shared by all DataMaps. Symbols are only ever added, so a
+// symbol ID stays good for the whole run.
+struct SymbolTable {
+  std::shared_mutex mutex;
+  std::unordered_map<std::string, int> IDs;
+  std::vector<std::string> names;
+};
+
+// made on first use, so DataMaps can be used by other static initializers
+static SymbolTable &symbols() {
+  static SymbolTable table;
+  return table;
+}
+
+// ID of key in the symbol table. If key is not in the table, it is added if
+// add is set, otherwise -1 is returned.
+static int lookupSymbol(const std::string &key, bool add) {
+  // each thread keeps its own copy of the symbols it has used, so most calls
+  // are one hash (or one compare, when the same key is used several times in
+  // a row, i.e. by set) with no locking
+  thread_local std::unordered_map<std::string, int> known;
+  thread_local const std::pair<const std::string, int> *last = nullptr;
+  if (last != nullptr && last->first == key) {
+    return last->second;
+  }
+  auto found = known.find(key);
+  if (found == known.end()) {
+    SymbolTable &table = symbols();
+    int symbol;
+    if (add) {
+      std::lock_guard<std::shared_mutex> lock(table.mutex);
+      auto added = table.IDs.emplace(key, (int)table.names.size());
+      if (added.second) {
+        table.names.push_back(key);
+      }
+      symbol = added.first->second;
+    } else {
+      std::shared_lock<std::shared_mutex> lock(table.mutex);
+      auto inTable = table.IDs.find(key);
+      if (inTable == table.IDs.end()) {
+        return -1;
+      }
+      symbol = inTable->second;
+    }
+    found = known.emplace(key, symbol).first;
   }
-  // inUse = source->inUse; // replaced with for loop.
-  outputBehavior = source->outputBehavior;
+  last = &*found;
+  return found->second;
+}
+
+int DataMap::intern(const std::string &key) { return lookupSymbol(key, true); }
+
+int DataMap::findSymbol(const std::string &key) {
+  return lookupSymbol(key, false);
+}
+
+int DataMap::symbolCount() {
+  SymbolTable &table = symbols();
+  std::shared_lock<std::shared_mutex> lock(table.mutex);
+  return (int)table.names.size();
+}
+
+std::vector<std::pair<std::string, DataMap::Entry *>> DataMap::sortedEntries() {
+  std::vector<std::pair<std::string, Entry *>> inUse;
+  {
+    SymbolTable &table = symbols();
+    std::shared_lock<std::shared_mutex> lock(table.mutex);
+    for (auto &entry : entries) {
+      if (entry.type != NONE) {
+        inUse.emplace_back(table.names[entry.symbol], &entry);
+      }
+    }
+  }
+  std::sort(inUse.begin(), inUse.end(),
+            [](const std::pair<std::string, Entry *> &a,
+               const std::pair<std::string, Entry *> &b) { return a.first < b.first; });
+  return inUse;
 }
 
 
@@ -109,7 +412,7 @@ void DataMap::constructHeaderAndDataStrings(std::string &headerStr, std::string
       // therefore if we apply that mask the the outputBehavior, we can see if
       // that type of output is needed.
 
-      OB = outputBehavior[i];
+      OB = getOutputBehavior(i);
 
       if (typeOfKey == STRING || typeOfKey == STRINGSOLO) {
         if (!(OB == LIST || OB == FIRST || OB == NO_OUTPUT)) {
@@ -207,6 +510,106 @@ void DataMap::constructHeaderAndDataStrings(std::string &headerStr, std::string
     dataStr.erase(dataStr.begin());     // clip off the leading separator
   }
 }
+void DataMap::writeColumnarRow(const std::string &fileName,
+                               const std::vector<std::string> &keys, bool aveOnly) {
+  // calls value(column name, value) for each column, as
+  // constructHeaderAndDataStrings would write them
+  auto forEachColumn = [&](auto &&value) {
+    for (auto const &i : keys) {
+      dataMapType typeOfKey = findKeyInData(i);
+      if (typeOfKey == NONE) {
+        std::cout << "  in DataMap::writeToFile() - key \"" << i
+                  << "\" can not be found in data map!\n  exiting." << std::endl;
+        exit(1);
+      }
+      unsigned int OB = getOutputBehavior(i);
+      bool isString = typeOfKey == STRING || typeOfKey == STRINGSOLO;
+      if (isString && !(OB == LIST || OB == FIRST || OB == NO_OUTPUT)) {
+        std::cout << "  in DataMap::writeColumnarRow :: attempt to write "
+                     "string not in either LIST or FIRST formatte. This is not "
+                     "allowed! Key was '" << i << "'. Exiting..." << std::endl;
+        exit(1);
+      }
+      if (aveOnly) {
+        OB = isString ? static_cast<unsigned int>(NO_OUTPUT) : OB & (AVE | FIRST);
+      }
+
+      if (OB & FIRST) {
+        auto warnEmpty = [&] {
+          std::cout << "  WARNING!! In DataMap::writeColumnarRow :: "
+                       "while getting value for FIRST with key \""
+                    << i << "\" vector is empty!" << std::endl;
+        };
+        if (typeOfKey == BOOL || typeOfKey == BOOLSOLO) {
+          const auto &values = getBoolVector(i);
+          if (values.empty()) {
+            warnEmpty();
+          }
+          value(i, values.empty() ? false : static_cast<bool>(values[0]));
+        }
+        if (typeOfKey == DOUBLE || typeOfKey == DOUBLESOLO) {
+          const auto &values = getDoubleVector(i);
+          if (values.empty()) {
+            warnEmpty();
+          }
+          value(i, values.empty() ? 0.0 : values[0]);
+        }
+        if (typeOfKey == INT || typeOfKey == INTSOLO) {
+          const auto &values = getIntVector(i);
+          if (values.empty()) {
+            warnEmpty();
+          }
+          value(i, values.empty() ? 0 : values[0]);
+        }
+        if (isString) {
+          const auto &values = getStringVector(i);
+          if (values.empty()) {
+            warnEmpty();
+          }
+          value(i, values.empty() ? std::string("0") : values[0]);
+        }
+      }
+      if (OB & AVE) {
+        value(i + "_AVE", getAverage(i));
+      }
+      if (OB & VAR) {
+        value(i + "_VAR", getVariance(i));
+      }
+      if (OB & SUM) {
+        value(i + "_SUM", getSum(i));
+      }
+      if (OB & PROD) {
+        std::cout << "  WARNING OUTPUT METHOD PROD IS HAS YET TO BE WRITTEN!" << std::endl;
+      }
+      if (OB & STDERR) {
+        std::cout << "  WARNING OUTPUT METHOD STDERR IS HAS YET TO BE WRITTEN!" << std::endl;
+      }
+      if (OB & LIST) {
+        value(i + "_LIST", getStringOfVector(i));
+      }
+    }
+  };
+
+  auto &writer = FileManager::columnarWriters[fileName];
+  if (writer == nullptr) { // the first row sets the file's columns
+    std::vector<Columnar::Column> columns;
+    auto column = [&](const std::string &name, auto v) {
+      using T = decltype(v);
+      columns.push_back({name, std::is_same<T, bool>::value ? Columnar::BOOL
+                               : std::is_same<T, int>::value ? Columnar::INT
+                               : std::is_same<T, double>::value ? Columnar::DOUBLE
+                                                                : Columnar::STRING});
+    };
+    forEachColumn(column);
+    writer = std::make_unique<ColumnarWriter>(columns, FileManager::columnarCompression,
+                                              FileManager::columnarRowGroupRows);
+  }
+  forEachColumn([&](const std::string &, const auto &v) { writer->add(v); });
+  if (writer->endRow()) {
+    FileManager::writeToFile(fileName, writer->takeRowGroup(), writer->fileHeader());
+  }
+}
+
 ///////////////////////////////////////
 // need to add support for output prefix directory
 // need to add support for population file name prefixes
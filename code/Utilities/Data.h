@@ -18,8 +18,10 @@
 #include <map>
 #include <memory>
 #include <unordered_map>
+#include <variant>
 #include <vector>
 
+#include "ColumnarFile.h"
 #include "Utilities.h"
 
 class FileManager {
@@ -31,18 +33,49 @@ public:
 
   static std::string outputPrefix;
 
+  // if bufferedOutput is set, writeToFile adds data to a buffer for each file
+  // and full buffers are written to disk by a background thread, so callers
+  // do not wait on the file system. Data is only sure to be on disk after
+  // flush (which is also called when the program exits).
+  static bool bufferedOutput;
+  static size_t bufferSize; // bytes held for a file before they are written
+  static std::map<std::string, std::string> buffers; // (NAME,unwritten data)
+
   static const char separator = ',';
 
+  // files ending in Columnar::fileExtension are written in the columnar
+  // binary format (see ColumnarFile.h). DataMap::writeToFile adds rows to a
+  // writer for the file, and row groups are written as they fill (and when
+  // the file is closed or flushed)
+  static std::map<std::string, std::unique_ptr<ColumnarWriter>> columnarWriters;
+  static bool columnarCompression;
+  static size_t columnarRowGroupRows;
+  static void setColumnarOutput(bool compression, size_t rowGroupRows);
+
   static void writeToFile(const std::string &fileName, const std::string &data,
                           const std::string &header = ""); // fileName, data, header
                                                       // - used when you want to
                                                       // output formatted data
                                                       // (i.e. genomes)
+                                                      // (binary files, i.e.
+                                                      // columnar, get data
+                                                      // as is, with no
+                                                      // newline)
   static void openFile(const std::string &fileName,
                        const std::string &header = ""); // open file and write header
                                                    // to file if file is new and
                                                    // header is provided
   static void closeFile(const std::string &fileName);   // close file
+
+  // turn buffered output on (or off) with bufferSize bytes per file
+  static void setBufferedOutput(bool buffered, size_t _bufferSize);
+  // write all buffered data (and partial row groups) and wait until it is on
+  // disk
+  static void flush();
+
+private:
+  // write the rows a columnar file's writer still holds
+  static void finishRowGroup(const std::string &fileName, ColumnarWriter &writer);
 };
 
 class DataMap {
@@ -57,9 +90,6 @@ public:
     VAR = 64,
 	 NO_OUTPUT = 128
   };                               // 0 = do not save or default..?
-  std::map<std::string, int> outputBehavior; // Defines how each element should be written
-                                   // to file - if element not found, LIST
-                                   // (write out list) is used.
   static std::map<std::string, int> knownOutputBehaviors;
 
 private:
@@ -75,13 +105,93 @@ private:
     STRINGSOLO = 14
   }; // NONE = not found in this data map
 
-  std::unordered_map<std::string, std::vector<bool>> boolData;
-  std::unordered_map<std::string, std::vector<double>> doubleData;
-  std::unordered_map<std::string, std::vector<int>> intData;
-  std::unordered_map<std::string, std::vector<std::string>> stringData;
+  // Keys are interned once into a symbol table shared by all DataMaps (see
+  // intern), and each DataMap keeps its entries in a flat vector, found
+  // through entryOf (symbol ID -> index in entries). Entries are never removed
+  // (clear only sets type to NONE), so outputBehavior outlives the data.
+  struct Entry {
+    int symbol;
+    dataMapType type = NONE; // NONE = key is not in use
+    int outputBehavior = 0;  // Defines how this element should be written to file
+    std::variant<std::vector<bool>, std::vector<double>, std::vector<int>,
+                 std::vector<std::string>>
+        values;
+  };
+  std::vector<Entry> entries;
+  std::vector<int> entryOf; // -1 if this DataMap has no entry for a symbol
 
-  std::map<std::string, dataMapType>
-      inUse; // holds list of keys with type 1=bool, 2=double, 3=int, 4=string
+protected: // (so that tests can reach the symbol table)
+  // return the ID of key in the symbol table, adding it if it is new
+  static int intern(const std::string &key);
+  // return the ID of key in the symbol table, or -1 if it is not there (for
+  // lookups, so keys which are only asked for are not added)
+  static int findSymbol(const std::string &key);
+  // how many keys are in the symbol table
+  static int symbolCount();
+
+private:
+
+  inline Entry *findEntry(int symbol) {
+    return (symbol >= 0 && symbol < (int)entryOf.size() && entryOf[symbol] >= 0)
+               ? &entries[entryOf[symbol]]
+               : nullptr;
+  }
+  // return entry for key, making a new (NONE) entry if needed
+  inline Entry &entryFor(const std::string &key) {
+    int symbol = intern(key);
+    if (symbol >= (int)entryOf.size()) {
+      entryOf.resize(symbol + 1, -1);
+    }
+    if (entryOf[symbol] < 0) {
+      entryOf[symbol] = (int)entries.size();
+      entries.push_back(Entry());
+      entries.back().symbol = symbol;
+    }
+    return entries[entryOf[symbol]];
+  }
+  // the values in entry, as type T (making them if needed)
+  template <class T> static inline std::vector<T> &valuesOf(Entry &entry) {
+    if (!std::holds_alternative<std::vector<T>>(entry.values)) {
+      entry.values = std::vector<T>();
+    }
+    return std::get<std::vector<T>>(entry.values);
+  }
+  // keys in use (and their entries), in the order output files use
+  std::vector<std::pair<std::string, Entry *>> sortedEntries();
+
+  template <class T>
+  static inline double sumOf(const std::vector<T> &values, bool average) {
+    double returnValue = 0;
+    for (auto e : values) {
+      returnValue += (double)e;
+    }
+    if (average && values.size() > 1) {
+      returnValue /= values.size();
+    }
+    return returnValue;
+  }
+
+  // getAverage or getSum for an already interned key
+  inline double getSumOrAverage(const std::string &key, int symbol, bool average) {
+    Entry *entry = findEntry(symbol);
+    dataMapType typeOfKey = (entry == nullptr) ? NONE : entry->type;
+    if (typeOfKey == BOOL || typeOfKey == BOOLSOLO) {
+      return sumOf(std::get<std::vector<bool>>(entry->values), average);
+    } else if (typeOfKey == DOUBLE || typeOfKey == DOUBLESOLO) {
+      return sumOf(std::get<std::vector<double>>(entry->values), average);
+    } else if (typeOfKey == INT || typeOfKey == INTSOLO) {
+      return sumOf(std::get<std::vector<int>>(entry->values), average);
+    } else if (typeOfKey == STRING || typeOfKey == STRINGSOLO) {
+      std::cout << "  in DataMap::getAverage attempt to use with vector of type "
+              "string associated key \""
+           << key << "\".\n  Cannot average strings!\n  Exiting." << std::endl;
+      exit(1);
+    }
+    std::cout << "  in DataMap::getAverage attempt to get average from "
+            "nonexistent key \""
+         << key << "\".\n  Exiting." << std::endl;
+    exit(1);
+  }
 
 public:
   DataMap() = default;
@@ -90,24 +200,28 @@ public:
   DataMap(std::shared_ptr<DataMap> source);
 
   inline void setOutputBehavior(const std::string &key, int _outputBehavior) {
-    outputBehavior[key] = _outputBehavior;
+    entryFor(key).outputBehavior = _outputBehavior;
+  }
+
+  // how key will be written to file (0 if it has not been set)
+  inline int getOutputBehavior(const std::string &key) {
+    Entry *entry = findEntry(findSymbol(key));
+    return (entry == nullptr) ? 0 : entry->outputBehavior;
   }
 
   // find key in this data map and return type (NONE = not found)
   inline dataMapType findKeyInData(const std::string &key, bool printType = false) {
+    Entry *entry = findEntry(findSymbol(key));
+    dataMapType typeOfKey = (entry == nullptr) ? NONE : entry->type;
     if (printType) {
-      std::cout << key << "is of type " << inUse[key] << std::endl;
-    }
-    if (inUse.find(key) != inUse.end()) {
-      return inUse[key];
-    } else {
-      return NONE;
+      std::cout << key << "is of type " << typeOfKey << std::endl;
     }
+    return typeOfKey;
   }
 
   // find key in this data map and return type (NONE = not found)
   inline bool isKeySolo(const std::string &key) {
-    if (inUse.find(key) != inUse.end()) {
+    if (findKeyInData(key) != NONE) {
       return ((findKeyInData(key) == BOOLSOLO) ||
               (findKeyInData(key) == DOUBLESOLO) ||
               (findKeyInData(key) == INTSOLO) ||
@@ -141,8 +255,8 @@ public:
   // return vector of strings will all keys in this data map
   inline std::vector<std::string> getKeys() {
     std::vector<std::string> keys;
-    for (auto e : inUse) {
-		 if (outputBehavior[e.first] != NO_OUTPUT) keys.push_back(e.first); // just push back the whole key
+    for (auto e : sortedEntries()) {
+		 if (e.second->outputBehavior != NO_OUTPUT) keys.push_back(e.first); // just push back the whole key
     }
     return (keys);
   }
@@ -150,12 +264,13 @@ public:
   // set functions (bool,double,int,string) that take a **single** value -
   // either make new map entry or replace existing
   inline void set(const std::string &key, const bool &value) {
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry &entry = entryFor(key);
+    dataMapType typeOfKey = entry.type;
     if (typeOfKey == NONE || typeOfKey == BOOL ||
         typeOfKey ==
             BOOLSOLO) { // if key is unused or associates with correct type
-      boolData[key] = std::vector<bool>({value});
-      inUse[key] = BOOLSOLO; // since this is set with SET, it is a single value
+      valuesOf<bool>(entry) = std::vector<bool>({value});
+      entry.type = BOOLSOLO; // since this is set with SET, it is a single value
     } else {
       std::cout << "  ERROR :: a call to DataMap::set was called where the key was "
               "already in use with another type."
@@ -166,16 +281,16 @@ public:
            << findKeyInData(key) << ". Exiting." << std::endl;
       exit(1);
     }
-	 setOutputBehavior(key, FIRST);
+	 entry.outputBehavior = FIRST;
   }
   inline void set(const std::string &key, const double &value) {
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry &entry = entryFor(key);
+    dataMapType typeOfKey = entry.type;
     if (typeOfKey == NONE || typeOfKey == DOUBLE ||
         typeOfKey ==
             DOUBLESOLO) { // if key is unused or associates with correct type
-      doubleData[key] = std::vector<double>({value});
-      inUse[key] =
-          DOUBLESOLO; // since this is set with SET, it is a single value
+      valuesOf<double>(entry) = std::vector<double>({value});
+      entry.type = DOUBLESOLO; // since this is set with SET, it is a single value
     } else {
       std::cout << "  ERROR :: a call to DataMap::set was called where the key was "
               "already in use with another type."
@@ -186,15 +301,16 @@ public:
            << findKeyInData(key) << ". Exiting." << std::endl;
       exit(1);
     }
-	 setOutputBehavior(key, FIRST);
+	 entry.outputBehavior = FIRST;
   }
   inline void set(const std::string &key, const int &value) {
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry &entry = entryFor(key);
+    dataMapType typeOfKey = entry.type;
     if (typeOfKey == NONE || typeOfKey == INT ||
         typeOfKey ==
             INTSOLO) { // if key is unused or associates with correct type
-      intData[key] = std::vector<int>({value});
-      inUse[key] = INTSOLO; // since this is set with SET, it is a single value
+      valuesOf<int>(entry) = std::vector<int>({value});
+      entry.type = INTSOLO; // since this is set with SET, it is a single value
     } else {
       std::cout << "  ERROR :: a call to DataMap::set was called where the key was "
               "already in use with another type."
@@ -205,15 +321,16 @@ public:
            << findKeyInData(key) << ". Exiting." << std::endl;
       exit(1);
     }
-	 setOutputBehavior(key, FIRST);
+	 entry.outputBehavior = FIRST;
   }
   inline void set(const std::string &key, const std::string &value) {
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry &entry = entryFor(key);
+    dataMapType typeOfKey = entry.type;
     if (typeOfKey == NONE || typeOfKey == STRING ||
         typeOfKey ==
             STRINGSOLO) { // if key is unused or associates with correct type
-      stringData[key] = std::vector<std::string>({value});
-      inUse[key] = STRINGSOLO;
+      valuesOf<std::string>(entry) = std::vector<std::string>({value});
+      entry.type = STRINGSOLO;
     } else {
       std::cout << "  ERROR :: a call to DataMap::set was called where the key was "
               "already in use with another type."
@@ -224,19 +341,20 @@ public:
            << findKeyInData(key) << ". Exiting." << std::endl;
       exit(1);
     }
-	 setOutputBehavior(key, FIRST);
+	 entry.outputBehavior = FIRST;
   }
 
   // set functions (bool,double,int,string) that take a **vector** of value -
   // either make new map entry or replace existing
   // outputBehavior is set as though there was an append (i.e. list)
   inline void set(const std::string &key, const std::vector<bool> &value) {
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry &entry = entryFor(key);
+    dataMapType typeOfKey = entry.type;
     if (typeOfKey == NONE || typeOfKey == BOOL ||
         typeOfKey ==
             BOOLSOLO) { // if key is unused or associates with correct type
-      boolData[key] = value;
-      inUse[key] = BOOL;
+      valuesOf<bool>(entry) = value;
+      entry.type = BOOL;
     } else {
       std::cout << "  ERROR :: a call to DataMap::set was called where the key was "
               "already in use with another type."
@@ -247,15 +365,16 @@ public:
            << findKeyInData(key) << ". Exiting." << std::endl;
       exit(1);
     }
-	setOutputBehavior(key, LIST | AVE);
+	entry.outputBehavior = LIST | AVE;
   }
   inline void set(const std::string &key, const std::vector<double> &value) {
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry &entry = entryFor(key);
+    dataMapType typeOfKey = entry.type;
     if (typeOfKey == NONE || typeOfKey == DOUBLE ||
         typeOfKey ==
             DOUBLESOLO) { // if key is unused or associates with correct type
-      doubleData[key] = value;
-      inUse[key] = DOUBLE;
+      valuesOf<double>(entry) = value;
+      entry.type = DOUBLE;
     } else {
       std::cout << "  ERROR :: a call to DataMap::set was called where the key was "
               "already in use with another type."
@@ -266,15 +385,16 @@ public:
            << findKeyInData(key) << ". Exiting." << std::endl;
       exit(1);
     }
-	setOutputBehavior(key, LIST | AVE);
+	entry.outputBehavior = LIST | AVE;
   }
   inline void set(const std::string &key, const std::vector<int> &value) {
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry &entry = entryFor(key);
+    dataMapType typeOfKey = entry.type;
     if (typeOfKey == NONE || typeOfKey == INT ||
         typeOfKey ==
             INTSOLO) { // if key is unused or associates with correct type
-      intData[key] = value;
-      inUse[key] = INT;
+      valuesOf<int>(entry) = value;
+      entry.type = INT;
     } else {
       std::cout << "  ERROR :: a call to DataMap::set was called where the key was "
               "already in use with another type."
@@ -285,15 +405,16 @@ public:
            << findKeyInData(key) << ". Exiting." << std::endl;
       exit(1);
     }
-	setOutputBehavior(key, LIST | AVE);
+	entry.outputBehavior = LIST | AVE;
   }
   inline void set(const std::string &key, const std::vector<std::string> &value) {
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry &entry = entryFor(key);
+    dataMapType typeOfKey = entry.type;
     if (typeOfKey == NONE || typeOfKey == STRING ||
         typeOfKey ==
             STRINGSOLO) { // if key is unused or associates with correct type
-      stringData[key] = value;
-      inUse[key] = STRING;
+      valuesOf<std::string>(entry) = value;
+      entry.type = STRING;
     } else {
       std::cout << "  ERROR :: a call to DataMap::set was called where the key was "
               "already in use with another type."
@@ -304,21 +425,22 @@ public:
            << findKeyInData(key) << ". Exiting." << std::endl;
       exit(1);
     }
-	setOutputBehavior(key, LIST);
+	entry.outputBehavior = LIST;
   }
 
   // append a value to the end of vector associated with key. If key is not
   // found, start a new vector for key
   inline void append(const std::string &key, const bool &value) {
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry &entry = entryFor(key);
+    dataMapType typeOfKey = entry.type;
     if (typeOfKey == NONE) { // this key is not in data map, use Set.
       set(key, value);
-      inUse[key] = BOOL; // set the in use to be a list rather then a solo
+      entry.type = BOOL; // set the in use to be a list rather then a solo
     } else if (typeOfKey == BOOL ||
                typeOfKey == BOOLSOLO) { // if this key is in data map as a
                                         // string, append to vector
-      boolData[key].push_back(value);
-      inUse[key] = BOOL;
+      valuesOf<bool>(entry).push_back(value);
+      entry.type = BOOL;
     } else {
       std::cout << "  In DataMap::append :: attempt to append value \"" << value
            << "\" of type bool to \"" << key
@@ -326,18 +448,19 @@ public:
            << lookupDataMapTypeName(typeOfKey) << ".\n  exiting." << std::endl;
       exit(1);
     }
-	setOutputBehavior(key, LIST | AVE);
+	entry.outputBehavior = LIST | AVE;
   }
   inline void append(const std::string &key, const double &value) {
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry &entry = entryFor(key);
+    dataMapType typeOfKey = entry.type;
     if (typeOfKey == NONE) { // this key is not in data map, use Set.
       set(key, value);
-      inUse[key] = DOUBLE; // set the in use to be a list rather then a solo
+      entry.type = DOUBLE; // set the in use to be a list rather then a solo
     } else if (typeOfKey == DOUBLE ||
                typeOfKey == DOUBLESOLO) { // if this key is in data map as a
                                           // string, append to vector
-      doubleData[key].push_back(value);
-      inUse[key] = DOUBLE;
+      valuesOf<double>(entry).push_back(value);
+      entry.type = DOUBLE;
     } else {
       std::cout << "  In DataMap::append :: attempt to append value \"" << value
            << "\" of type double to \"" << key
@@ -345,18 +468,19 @@ public:
            << lookupDataMapTypeName(typeOfKey) << ".\n  exiting." << std::endl;
       exit(1);
     }
-	setOutputBehavior(key, LIST | AVE);
+	entry.outputBehavior = LIST | AVE;
   }
   inline void append(const std::string &key, const int &value) {
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry &entry = entryFor(key);
+    dataMapType typeOfKey = entry.type;
     if (typeOfKey == NONE) { // this key is not in data map, use Set.
       set(key, value);
-      inUse[key] = INT; // set the in use to be a list rather then a solo
+      entry.type = INT; // set the in use to be a list rather then a solo
     } else if (typeOfKey == INT ||
                typeOfKey == INTSOLO) { // if this key is in data map as a
                                        // string, append to vector
-      intData[key].push_back(value);
-      inUse[key] = INT; // set the in use to be a list rather then a solo
+      valuesOf<int>(entry).push_back(value);
+      entry.type = INT; // set the in use to be a list rather then a solo
     } else {
       std::cout << "  In DataMap::append :: attempt to append value \"" << value
            << "\" of type int to \"" << key
@@ -364,18 +488,19 @@ public:
            << lookupDataMapTypeName(typeOfKey) << ".\n  exiting." << std::endl;
       exit(1);
     }
-	setOutputBehavior(key, LIST | AVE);
+	entry.outputBehavior = LIST | AVE;
   }
   inline void append(const std::string &key, const std::string &value) {
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry &entry = entryFor(key);
+    dataMapType typeOfKey = entry.type;
     if (typeOfKey == NONE) { // this key is not in data map, use Set.
       set(key, value);
-      inUse[key] = STRING; // set the in use to be a list rather then a solo
+      entry.type = STRING; // set the in use to be a list rather then a solo
     } else if (typeOfKey == STRING ||
                typeOfKey == STRINGSOLO) { // if this key is in data map as a
                                           // string, append to vector
-      stringData[key].push_back(value);
-      inUse[key] = STRING; // set the in use to be a list rather then a solo
+      valuesOf<std::string>(entry).push_back(value);
+      entry.type = STRING; // set the in use to be a list rather then a solo
     } else {
       std::cout << "  In DataMap::append :: attempt to append value \"" << value
            << "\" of type string to \"" << key
@@ -383,20 +508,21 @@ public:
            << lookupDataMapTypeName(typeOfKey) << ".\n  exiting." << std::endl;
       exit(1);
     }
-	setOutputBehavior(key, LIST);
+	entry.outputBehavior = LIST;
   }
 
   // append a vector of values to the end of vector associated with key. If key
   // is not found, start a new vector for key
   inline void append(const std::string &key, const std::vector<bool> &value) {
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry &entry = entryFor(key);
+    dataMapType typeOfKey = entry.type;
     if (typeOfKey == NONE) { // this key is not in data map, use Set.
       set(key, value);
     } else if (typeOfKey == BOOL ||
                typeOfKey == BOOLSOLO) { // if this key is in data map as a
                                         // string, append to vector
-      boolData[key].insert(boolData[key].end(), value.begin(), value.end());
-      inUse[key] = BOOL; // may have been solo - make sure it's list
+      valuesOf<bool>(entry).insert(valuesOf<bool>(entry).end(), value.begin(), value.end());
+      entry.type = BOOL; // may have been solo - make sure it's list
     } else {
       std::cout << "  In DataMap::append :: attempt to append a vector of type bool "
               "to \""
@@ -404,16 +530,17 @@ public:
            << lookupDataMapTypeName(typeOfKey) << ".\n  exiting." << std::endl;
       exit(1);
     }
-	setOutputBehavior(key, LIST | AVE);
+	entry.outputBehavior = LIST | AVE;
   }
   inline void append(const std::string &key, const std::vector<double> &value) {
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry &entry = entryFor(key);
+    dataMapType typeOfKey = entry.type;
     if (typeOfKey == NONE) { // this key is not in data map, use Set.
       set(key, value);
     } else if (typeOfKey == DOUBLE) { // if this key is in data map as a string,
                                       // append to vector
-      doubleData[key].insert(doubleData[key].end(), value.begin(), value.end());
-      inUse[key] = DOUBLE; // may have been solo - make sure it's list
+      valuesOf<double>(entry).insert(valuesOf<double>(entry).end(), value.begin(), value.end());
+      entry.type = DOUBLE; // may have been solo - make sure it's list
     } else {
       std::cout << "  In DataMap::append :: attempt to append a vector of type "
               "double to \""
@@ -421,16 +548,17 @@ public:
            << lookupDataMapTypeName(typeOfKey) << ".\n  exiting." << std::endl;
       exit(1);
     }
-	setOutputBehavior(key, LIST | AVE);
+	entry.outputBehavior = LIST | AVE;
   }
   inline void append(const std::string &key, const std::vector<int> &value) {
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry &entry = entryFor(key);
+    dataMapType typeOfKey = entry.type;
     if (typeOfKey == NONE) { // this key is not in data map, use Set.
       set(key, value);
     } else if (typeOfKey == INT) { // if this key is in data map as a string,
                                    // append to vector
-      intData[key].insert(intData[key].end(), value.begin(), value.end());
-      inUse[key] = INT; // may have been solo - make sure it's list
+      valuesOf<int>(entry).insert(valuesOf<int>(entry).end(), value.begin(), value.end());
+      entry.type = INT; // may have been solo - make sure it's list
     } else {
       std::cout << "  In DataMap::append :: attempt to append a vector of type int "
               "to \""
@@ -438,16 +566,17 @@ public:
            << lookupDataMapTypeName(typeOfKey) << ".\n  exiting." << std::endl;
       exit(1);
     }
-	setOutputBehavior(key, LIST | AVE);
+	entry.outputBehavior = LIST | AVE;
   }
   inline void append(const std::string &key, const std::vector<std::string> &value) {
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry &entry = entryFor(key);
+    dataMapType typeOfKey = entry.type;
     if (typeOfKey == NONE) { // this key is not in data map, use Set.
       set(key, value);
     } else if (typeOfKey == STRING) { // if this key is in data map as a string,
                                       // concat new string with existing value
-		stringData[key] = { stringData[key][0] + value[0] };
-      inUse[key] = STRING; // may have been solo - make sure it's list
+		valuesOf<std::string>(entry) = { valuesOf<std::string>(entry)[0] + value[0] };
+      entry.type = STRING; // may have been solo - make sure it's list
     } else {
       std::cout << "  In DataMap::append :: attempt to append a vector of type "
               "string to \""
@@ -455,7 +584,7 @@ public:
            << lookupDataMapTypeName(typeOfKey) << ".\n  exiting." << std::endl;
       exit(1);
     }
-	setOutputBehavior(key, LIST);
+	entry.outputBehavior = LIST;
   }
 
   // merge contents of two data maps - if common keys are found behavior is determined by 'replace'
@@ -482,19 +611,19 @@ public:
 		  if (replace == 2 || replace == 0 || (replace == 1 && typeOfKey == NONE)) {
 			  if (typeOfOtherKey == BOOL || typeOfOtherKey == BOOLSOLO) {
 				  set(key, otherDataMap.getBoolVector(key));
-				  outputBehavior[key] = otherDataMap.outputBehavior[key];
+				  setOutputBehavior(key, otherDataMap.getOutputBehavior(key));
 			  }
 			  if (typeOfOtherKey == DOUBLE || typeOfOtherKey == DOUBLESOLO) {
 				  set(key, otherDataMap.getDoubleVector(key));
-				  outputBehavior[key] = otherDataMap.outputBehavior[key];
+				  setOutputBehavior(key, otherDataMap.getOutputBehavior(key));
 			  }
 			  if (typeOfOtherKey == INT || typeOfOtherKey == INTSOLO) {
 				  set(key, otherDataMap.getIntVector(key));
-				  outputBehavior[key] = otherDataMap.outputBehavior[key];
+				  setOutputBehavior(key, otherDataMap.getOutputBehavior(key));
 			  }
 			  if (typeOfOtherKey == STRING || typeOfOtherKey == STRINGSOLO) {
 				  set(key, otherDataMap.getStringVector(key));
-				  outputBehavior[key] = otherDataMap.outputBehavior[key];
+				  setOutputBehavior(key, otherDataMap.getOutputBehavior(key));
 			  }
 		  }
 	  }
@@ -502,9 +631,10 @@ public:
 
   inline std::vector<bool> getBoolVector(
       const std::string &key) { // retrieve a double from a dataMap with "key"
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry *entry = findEntry(findSymbol(key));
+    dataMapType typeOfKey = (entry == nullptr) ? NONE : entry->type;
     if (typeOfKey == BOOL || typeOfKey == BOOLSOLO) {
-      return boolData[key];
+      return valuesOf<bool>(*entry);
     } else {
       std::cout << "  in DataMap::getBoolVector :: attempt to use getBoolVector "
               "with key \""
@@ -517,9 +647,10 @@ public:
   }
   inline std::vector<double> getDoubleVector(
       const std::string &key) { // retrieve a double from a dataMap with "key"
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry *entry = findEntry(findSymbol(key));
+    dataMapType typeOfKey = (entry == nullptr) ? NONE : entry->type;
     if (typeOfKey == DOUBLE || typeOfKey == DOUBLESOLO) {
-      return doubleData[key];
+      return valuesOf<double>(*entry);
     } else {
       std::cout << "  in DataMap::getDoubleVector :: attempt to use getDoubleVector "
               "with key \""
@@ -532,9 +663,10 @@ public:
   }
   inline std::vector<int> getIntVector(
       const std::string &key) { // retrieve a double from a dataMap with "key"
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry *entry = findEntry(findSymbol(key));
+    dataMapType typeOfKey = (entry == nullptr) ? NONE : entry->type;
     if (typeOfKey == INT || typeOfKey == INTSOLO) {
-      return intData[key];
+      return valuesOf<int>(*entry);
     } else {
       std::cout << "  in DataMap::getIntVector :: attempt to use getIntVector with "
               "key \""
@@ -547,9 +679,10 @@ public:
   }
   inline std::vector<std::string> getStringVector(
       const std::string &key) { // retrieve a double from a dataMap with "key"
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry *entry = findEntry(findSymbol(key));
+    dataMapType typeOfKey = (entry == nullptr) ? NONE : entry->type;
     if (typeOfKey == STRING || typeOfKey == STRINGSOLO) {
-      return stringData[key];
+      return valuesOf<std::string>(*entry);
     } else {
       std::cout << "  in DataMap::getStringVector :: attempt to use getStringVector "
               "with key \""
@@ -566,26 +699,27 @@ public:
                                                        // if not already string,
                                                        // will be converted
     std::string returnString = "";
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry *entry = findEntry(findSymbol(key));
+    dataMapType typeOfKey = (entry == nullptr) ? NONE : entry->type;
     if (typeOfKey == NONE) {
       std::cout << "  In DataMap::GetString() :: key \"" << key
            << "\" is not in data map!\n  exiting." << std::endl;
       exit(1);
     } else {
       if (typeOfKey == BOOL || typeOfKey == BOOLSOLO) {
-        for (auto e : boolData[key]) {
+        for (auto e : valuesOf<bool>(*entry)) {
           returnString += to_string(e) + ",";
         }
       } else if (typeOfKey == DOUBLE || typeOfKey == DOUBLESOLO) {
-        for (auto e : doubleData[key]) {
+        for (auto e : valuesOf<double>(*entry)) {
           returnString += std::to_string(e) + ",";
         }
       } else if (typeOfKey == INT || typeOfKey == INTSOLO) {
-        for (auto e : intData[key]) {
+        for (auto e : valuesOf<int>(*entry)) {
           returnString += std::to_string(e) + ",";
         }
       } else if (typeOfKey == STRING || typeOfKey == STRINGSOLO) {
-        for (auto e : stringData[key]) {
+        for (auto e : valuesOf<std::string>(*entry)) {
           returnString += e + ",";
         }
       }
@@ -600,30 +734,31 @@ public:
   // get ave of values in a vector - must be bool, double or, int
   inline double
   getAverage(std::string key) { // not ref, we may need to change to a "{LIST}" key
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry *entry = findEntry(findSymbol(key));
+    dataMapType typeOfKey = (entry == nullptr) ? NONE : entry->type;
     double returnValue = 0;
     if (typeOfKey == BOOL || typeOfKey == BOOLSOLO) {
-      for (auto e : boolData[key]) {
+      for (auto e : valuesOf<bool>(*entry)) {
         returnValue += (double)e;
       }
-      if (boolData[key].size() > 1) {
-        returnValue /= boolData[key].size();
+      if (valuesOf<bool>(*entry).size() > 1) {
+        returnValue /= valuesOf<bool>(*entry).size();
       } // else vector is  size 1, no div needed or vector is empty, returnValue
         // will be 0
     } else if (typeOfKey == DOUBLE || typeOfKey == DOUBLESOLO) {
-      for (auto e : doubleData[key]) {
+      for (auto e : valuesOf<double>(*entry)) {
         returnValue += (double)e;
       }
-      if (doubleData[key].size() > 1) {
-        returnValue /= doubleData[key].size();
+      if (valuesOf<double>(*entry).size() > 1) {
+        returnValue /= valuesOf<double>(*entry).size();
       } // else vector is  size 1, no div needed or vector is empty, returnValue
         // will be 0
     } else if (typeOfKey == INT || typeOfKey == INTSOLO) {
-      for (auto e : intData[key]) {
+      for (auto e : valuesOf<int>(*entry)) {
         returnValue += (double)e;
       }
-      if (intData[key].size() > 1) {
-        returnValue /= intData[key].size();
+      if (valuesOf<int>(*entry).size() > 1) {
+        returnValue /= valuesOf<int>(*entry).size();
       } // else vector is  size 1, no div needed or vector is empty, returnValue
         // will be 0
     } else if (typeOfKey == STRING || typeOfKey == STRINGSOLO) {
@@ -642,46 +777,47 @@ public:
 
   inline double
   getVariance(std::string key) { // not ref, we may need to change to a "{LIST}" key
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry *entry = findEntry(findSymbol(key));
+    dataMapType typeOfKey = (entry == nullptr) ? NONE : entry->type;
     double averageValue(0);
     double varianceValue(0);
     if (typeOfKey == BOOL || typeOfKey == BOOLSOLO) {
-      for (auto e : boolData[key]) {
+      for (auto e : valuesOf<bool>(*entry)) {
         averageValue += (double)e;
       }
-      averageValue /= boolData[key].size();
-      for (auto e : boolData[key]) {
+      averageValue /= valuesOf<bool>(*entry).size();
+      for (auto e : valuesOf<bool>(*entry)) {
         varianceValue +=
             ((double)e - averageValue) * ((double)e - averageValue);
       }
-      if (boolData[key].size() > 0)
-        varianceValue /= boolData[key].size() - 1;
+      if (valuesOf<bool>(*entry).size() > 0)
+        varianceValue /= valuesOf<bool>(*entry).size() - 1;
       else
         varianceValue = 0;
     } else if (typeOfKey == DOUBLE || typeOfKey == DOUBLESOLO) {
-      for (auto e : doubleData[key]) {
+      for (auto e : valuesOf<double>(*entry)) {
         averageValue += (double)e;
       }
-      averageValue /= doubleData[key].size();
-      for (auto e : doubleData[key]) {
+      averageValue /= valuesOf<double>(*entry).size();
+      for (auto e : valuesOf<double>(*entry)) {
         varianceValue +=
             ((double)e - averageValue) * ((double)e - averageValue);
       }
-      if (doubleData[key].size() > 0)
-        varianceValue /= doubleData[key].size() - 1;
+      if (valuesOf<double>(*entry).size() > 0)
+        varianceValue /= valuesOf<double>(*entry).size() - 1;
       else
         varianceValue = 0;
     } else if (typeOfKey == INT || typeOfKey == INTSOLO) {
-      for (auto e : intData[key]) {
+      for (auto e : valuesOf<int>(*entry)) {
         averageValue += (double)e;
       }
-      averageValue /= intData[key].size();
-      for (auto e : intData[key]) {
+      averageValue /= valuesOf<int>(*entry).size();
+      for (auto e : valuesOf<int>(*entry)) {
         varianceValue +=
             ((double)e - averageValue) * ((double)e - averageValue);
       }
-      if (intData[key].size() > 0)
-        varianceValue /= intData[key].size() - 1;
+      if (valuesOf<int>(*entry).size() > 0)
+        varianceValue /= valuesOf<int>(*entry).size() - 1;
       else
         varianceValue = 0;
     } else if (typeOfKey == STRING || typeOfKey == STRINGSOLO) {
@@ -701,30 +837,31 @@ public:
   // get ave of values in a vector - must be bool, double or, int
   inline double
   getSum(std::string key) { // not ref, we may need to change to a "{LIST}" key
-    dataMapType typeOfKey = findKeyInData(key);
+    Entry *entry = findEntry(findSymbol(key));
+    dataMapType typeOfKey = (entry == nullptr) ? NONE : entry->type;
     double returnValue = 0;
     if (typeOfKey == BOOL || typeOfKey == BOOLSOLO) {
-      for (auto e : boolData[key]) {
+      for (auto e : valuesOf<bool>(*entry)) {
         returnValue += (double)e;
       }
-      // if (boolData[key].size() > 1) {
-      //	returnValue /= boolData[key].size();
+      // if (valuesOf<bool>(*entry).size() > 1) {
+      //	returnValue /= valuesOf<bool>(*entry).size();
       //} // else vector is  size 1, no div needed or vector is empty,
       //returnValue will be 0
     } else if (typeOfKey == DOUBLE || typeOfKey == DOUBLESOLO) {
-      for (auto e : doubleData[key]) {
+      for (auto e : valuesOf<double>(*entry)) {
         returnValue += (double)e;
       }
-      // if (doubleData[key].size() > 1) {
-      //	returnValue /= doubleData[key].size();
+      // if (valuesOf<double>(*entry).size() > 1) {
+      //	returnValue /= valuesOf<double>(*entry).size();
       //} // else vector is  size 1, no div needed or vector is empty,
       //returnValue will be 0
     } else if (typeOfKey == INT || typeOfKey == INTSOLO) {
-      for (auto e : intData[key]) {
+      for (auto e : valuesOf<int>(*entry)) {
         returnValue += (double)e;
       }
-      // if (intData[key].size() > 1) {
-      //	returnValue /= intData[key].size();
+      // if (valuesOf<int>(*entry).size() > 1) {
+      //	returnValue /= valuesOf<int>(*entry).size();
       //} // else vector is  size 1, no div needed or vector is empty,
       //returnValue will be 0
     } else if (typeOfKey == STRING || typeOfKey == STRINGSOLO) {
@@ -741,32 +878,38 @@ public:
     return returnValue;
   }
 
+  // a key which has been looked up ahead of time, for code which reads the same
+  // key from many DataMaps (i.e. compiled MTrees)
+  struct Column {
+    std::string key;
+    int symbol;
+  };
+  static inline Column getColumn(const std::string &key) { return {key, intern(key)}; }
+
+  // same results as getAverage(key) and getSum(key)
+  inline double getAverage(const Column &column) {
+    return getSumOrAverage(column.key, column.symbol, true);
+  }
+  inline double getSum(const Column &column) {
+    return getSumOrAverage(column.key, column.symbol, false);
+  }
+
   // Clear a field in a DataMap
   inline void clear(const std::string &key) {
     dataMapType typeOfKey = findKeyInData(key);
     if (typeOfKey != NONE) {
-      if (typeOfKey == BOOL || typeOfKey == BOOLSOLO) { // data is bool
-        boolData.erase(key);
-      } else if (typeOfKey == DOUBLE ||
-                 typeOfKey == DOUBLESOLO) { // data is double
-        doubleData.erase(key);
-      } else if (typeOfKey == INT || typeOfKey == INTSOLO) { // data is int
-        intData.erase(key);
-      } else if (typeOfKey == STRING ||
-                 typeOfKey == STRINGSOLO) { // data is string
-        stringData.erase(key);
-      }
-      inUse.erase(key);
+      Entry &entry = entryFor(key);
+      entry.values = std::vector<bool>();
+      entry.type = NONE;
     }
   }
 
   // Clear all data in a DataMap
   inline void clearMap() {
-    boolData.clear();
-    doubleData.clear();
-    intData.clear();
-    stringData.clear();
-    inUse.clear();
+    for (auto &entry : entries) {
+      entry.values = std::vector<bool>();
+      entry.type = NONE;
+    }
   }
 
   inline bool
@@ -779,21 +922,30 @@ public:
   void constructHeaderAndDataStrings(std::string &headerStr, std::string &dataStr,
                                      const std::vector<std::string> &keys,
                                      bool aveOnly = false);
+  // the same columns as constructHeaderAndDataStrings, added as a typed row
+  // to the writer for a columnar file
+  void writeColumnarRow(const std::string &fileName, const std::vector<std::string> &keys,
+                        bool aveOnly = false);
 
   inline void writeToFile(const std::string &fileName,
                           const std::vector<std::string> &keys = {},
                           bool aveOnly = false) {
     // Set("score{LIST}",10.0);
 
-    if (FileManager::files.find(fileName) ==
-        FileManager::files
-            .end()) { // first make sure that the dataFile has been set up.
+    if (FileManager::files.find(fileName) == FileManager::files.end() &&
+        FileManager::columnarWriters.find(fileName) ==
+            FileManager::columnarWriters
+                .end()) { // first make sure that the dataFile has been set up.
       if (keys.size() == 0) { // if no keys are given
         FileManager::fileColumns[fileName] = getKeys();
       } else {
         FileManager::fileColumns[fileName] = keys;
       }
     }
+    if (Columnar::isColumnarFile(fileName)) {
+      writeColumnarRow(fileName, FileManager::fileColumns[fileName], aveOnly);
+      return;
+    }
     std::string headerStr = "";
     std::string dataStr = "";
 
@@ -808,7 +960,7 @@ public:
   inline std::vector<std::string> getColumnNames() {
     std::vector<std::string> columnNames;
 
-    for (auto element : inUse) {
+    for (auto element : sortedEntries()) {
       //if (outputBehavior.find(element.first) == outputBehavior.end()) {
       //  // this element has no defined output behavior, so it will be LIST
       //  // (default) or FIRST (if it's a solo value)
@@ -820,7 +972,7 @@ public:
       //  }
       //} else { // there is an output behavior defined
 		 {
-        auto OB = outputBehavior[element.first];
+        auto OB = element.second->outputBehavior;
         if (OB & AVE) {
           columnNames.push_back(element.first + "_AVE");
         }
@@ -871,7 +1023,7 @@ public:
         if (entryType == DOUBLE || entryType == DOUBLESOLO) {
           copyDataMap.set(prefix + "_" + key, getDoubleVector(key));
         }
-        copyDataMap.setOutputBehavior(prefix + "_" + key, outputBehavior[key]);
+        copyDataMap.setOutputBehavior(prefix + "_" + key, getOutputBehavior(key));
       }
     } else {
       for (auto key : getKeys()) {
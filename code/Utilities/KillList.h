@@ -0,0 +1,105 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+// The organisms an optimizer wants removed from the population, kept as a
+// bitmap over population indices. Marking an organism sets a bit, and
+// apply() kills the marked organisms and closes the gaps they leave by
+// moving the survivors down (in order) in one pass, so no organisms are
+// hashed and the survivors' reference counts are not touched.
+//
+// Indices refer to the population as it is when apply() is called, so
+// nothing may be removed from or inserted into the population (other than at
+// the end) between marking and apply().
+
+#pragma once
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class KillList {
+private:
+  std::vector<uint64_t> bits;
+  size_t count = 0;
+
+  void grow(size_t words) {
+    if (bits.size() < words) {
+      bits.resize(words, 0);
+    }
+  }
+
+public:
+  KillList() = default;
+
+  void clear() {
+    std::fill(bits.begin(), bits.end(), 0);
+    count = 0;
+  }
+
+  // mark population[index]
+  void insert(size_t index) {
+    grow(index / 64 + 1);
+    uint64_t bit = 1ULL << (index % 64);
+    count += !(bits[index / 64] & bit);
+    bits[index / 64] |= bit;
+  }
+
+  // mark population[first] to population[last - 1]
+  void insertRange(size_t first, size_t last) {
+    for (size_t index = first; index < last;) {
+      if (index % 64 == 0 && index + 64 <= last) {
+        grow(index / 64 + 1);
+        count += 64 - std::bitset<64>(bits[index / 64]).count();
+        bits[index / 64] = ~0ULL;
+        index += 64;
+      } else {
+        insert(index++);
+      }
+    }
+  }
+
+  // mark everything other marks, with other's indices moved up by offset
+  void merge(const KillList &other, size_t offset) {
+    for (size_t w = 0; w < other.bits.size(); w++) {
+      for (size_t bit = 0; bit < 64 && (other.bits[w] >> bit); bit++) {
+        if ((other.bits[w] >> bit) & 1) {
+          insert(offset + w * 64 + bit);
+        }
+      }
+    }
+  }
+
+  bool contains(size_t index) const {
+    return index / 64 < bits.size() && (bits[index / 64] >> (index % 64)) & 1;
+  }
+
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+
+  // kill each marked organism and remove it from population (keeping the
+  // order of the rest), then clear
+  template <class T> void apply(std::vector<std::shared_ptr<T>> &population) {
+    size_t kept = 0;
+    for (size_t i = 0; i < population.size(); i++) {
+      if (contains(i)) {
+        population[i]->kill();
+      } else {
+        if (kept != i) {
+          population[kept] = std::move(population[i]);
+        }
+        kept++;
+      }
+    }
+    population.resize(kept);
+    clear();
+  }
+};
@@ -0,0 +1,84 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+// A bounded key -> value map which forgets the least recently used entry when
+// it is full. All functions lock, so one cache can be shared by threads.
+// Values are handed out by copy, so use a shared_ptr for anything large.
+
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+template <class Key, class Value> class LRUCache {
+private:
+  std::list<std::pair<Key, Value>> entries; // most recently used first
+  std::unordered_map<Key, typename std::list<std::pair<Key, Value>>::iterator> lookup;
+  size_t capacity;
+  std::mutex cacheMutex;
+
+  void trim() {
+    while (entries.size() > capacity) {
+      lookup.erase(entries.back().first);
+      entries.pop_back();
+    }
+  }
+
+public:
+  LRUCache(size_t _capacity = 0) : capacity(_capacity) {}
+
+  // a capacity of 0 turns the cache off (nothing is stored)
+  void setCapacity(size_t _capacity) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    capacity = _capacity;
+    trim();
+  }
+
+  // if key is in the cache, set value and return true
+  bool get(const Key &key, Value &value) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto found = lookup.find(key);
+    if (found == lookup.end()) {
+      return false;
+    }
+    entries.splice(entries.begin(), entries, found->second);
+    value = found->second->second;
+    return true;
+  }
+
+  void put(const Key &key, const Value &value) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto found = lookup.find(key);
+    if (found != lookup.end()) {
+      found->second->second = value;
+      entries.splice(entries.begin(), entries, found->second);
+      return;
+    }
+    if (capacity == 0) {
+      return;
+    }
+    entries.emplace_front(key, value);
+    lookup[key] = entries.begin();
+    trim();
+  }
+
+  size_t size() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return entries.size();
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    entries.clear();
+    lookup.clear();
+  }
+};
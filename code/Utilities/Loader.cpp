@@ -14,6 +14,7 @@
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <utility>
 
@@ -77,7 +78,7 @@ std::vector<std::pair<OrgID, OrgAttributesMap>> Loader::loadPopulation(const std
       org_ids.begin(), org_ids.end(), std::back_inserter(final_population),
       [this](OrgID ID) {
         if (ID < 0) return std::make_pair(ID, OrgAttributesMap()); // default organism
-        else return std::make_pair(ID, all_organism_infos.at(ID).attributes_map); // loaded organism
+        else return std::make_pair(ID, attributesMap(ID)); // loaded organism
       });
 
   return final_population;
@@ -96,7 +97,7 @@ void Loader::showFinalPopulation(std::vector<OrgID> org_ids) {
   std::map<std::string, std::vector<OrgID>> orgs_from_files; // TODO C
   for (auto org_index : org_ids)
     if (org_index > -1) {
-      orgs_from_files[all_organism_infos.at(org_index).from_file].push_back( all_organism_infos.at(org_index).orig_ID );
+      orgs_from_files[loaded_files.at(all_organism_infos.at(org_index).file).file_name].push_back( all_organism_infos.at(org_index).orig_ID );
     }
   for (auto &f : orgs_from_files) {
     std::cout << "From file " << f.first << "\n  Loading organisms with IDs : ";
@@ -367,8 +368,7 @@ std::vector<std::vector<long>> Loader::keywordMatch(std::string attribute,
   for (const auto &p : collection_org_lists.at(resource)) {
     const auto from_pop = p;
     for (const auto &o : from_pop)
-      if (all_organism_infos.at(o).attributes_map.find(attribute) ==
-          all_organism_infos.at(o).attributes_map.end()) {
+      if (!hasAttribute(o, attribute)) {
         std::cout << "error: while trying to match " << value << "  "
                   << resource << " contains organisms without attribute "
                   << attribute << std::endl;
@@ -377,8 +377,9 @@ std::vector<std::vector<long>> Loader::keywordMatch(std::string attribute,
     std::vector<long> pop;
     std::copy_if(std::begin(from_pop), std::end(from_pop),
                  std::back_inserter(pop), [&](long index) {
-                   return all_organism_infos.at(index).attributes_map.at(attribute) ==
-                          value;
+                   std::string org_value;
+                   this->attribute(index, attribute, org_value);
+                   return org_value == value;
                  });
     coll.push_back(pop);
   }
@@ -401,19 +402,18 @@ Loader::keywordGreatest(size_t number, std::string attribute, const std::string
       exit(1);
     }
     for (const auto &o : from_pop)
-      if (all_organism_infos.at(o).attributes_map.find(attribute) ==
-          all_organism_infos.at(o).attributes_map.end()) {
+      if (!hasAttribute(o, attribute)) {
         std::cout << "error:  trying to get greatest " << number
                   << " from collection, but  " << resource
                   << " contains organisms without attribute " << attribute
                   << std::endl;
         exit(1);
       }
+    auto values = numericAttribute(from_pop, attribute);
     std::vector<long> pop(number);
     std::partial_sort_copy( from_pop.begin(), from_pop.end(), pop.begin(), pop.end(),
         [&](long lhs, long rhs) {
-          return std::stod(all_organism_infos.at(lhs).attributes_map.at(attribute)) >
-                 std::stod(all_organism_infos.at(rhs).attributes_map.at(attribute));
+          return values.at(lhs) > values.at(rhs);
         });
     coll.push_back(pop);
   }
@@ -436,18 +436,18 @@ Loader::keywordLeast(size_t number, std::string attribute, const std::string &re
       exit(1);
     }
     for (const auto &o : from_pop)
-      if (all_organism_infos.at(o).attributes_map.find(attribute) == all_organism_infos.at(o).attributes_map.end()) {
+      if (!hasAttribute(o, attribute)) {
         std::cout << "error:  trying to get least" << number
                   << " from collection, but  " << resource
                   << " contains organisms without attribute " << attribute
                   << std::endl;
         exit(1);
       }
+    auto values = numericAttribute(from_pop, attribute);
     std::vector<long> pop(number);
     std::partial_sort_copy( from_pop.begin(), from_pop.end(), pop.begin(), pop.end(),
         [&](long lhs, long rhs) {
-          return std::stod(all_organism_infos.at(lhs).attributes_map.at(attribute)) <
-                 std::stod(all_organism_infos.at(rhs).attributes_map.at(attribute));
+          return values.at(lhs) < values.at(rhs);
         });
     coll.push_back(pop);
   }
@@ -520,52 +520,147 @@ std::vector<std::string> Loader::expandFiles(const std::string &file) {
 
 std::pair<long, long> Loader::generatePopulation(const std::string &file_name) {
 
-  // store organism file in memory-mapped CSV
-  CSV org_file_data = CSV(file_name);
+  // memory-map the organism file; only the ID column is read now
+  LoadedFile loaded;
+  loaded.file_name = file_name;
+  loaded.organisms = std::make_unique<MappedCSV>(file_name);
+  const auto &org_file_data = *loaded.organisms;
+  auto id_column = org_file_data.columnIndex("ID");
+  if (id_column == -1) {
+    std::cout << " Error : could not find column ID in file " << file_name
+              << std::endl;
+    exit(1);
+  }
   // setup the range of indices needed to identify all organisms from this file
   std::pair<long,long> file_contents_pair = std::make_pair(long(all_organism_infos.size()), long(org_file_data.row_count()));
 
-  // search for the _data version of the organism file
+  // search for the _data version of the organism file, and find the row of
+  // each ID in it (its other columns are merged into the organisms' attributes)
   std::string data_file_name(dataVersionOfFilename(file_name));
+  std::unordered_map<std::string, long> data_rows; // -2 if an ID is in more than one row
   if (fileExists(data_file_name)) {
-    // store _data file in memory_mapped CSV
-	  auto data_file_data = CSV(data_file_name);
-    // merge the _data file data into the organism file data
-	  org_file_data.merge(data_file_data, "ID");
+    loaded.data = std::make_unique<MappedCSV>(data_file_name);
+    auto data_id_column = loaded.data->columnIndex("ID");
+    if (data_id_column == -1) {
+      std::cout << " Error : could not find column ID to merge from file "
+                << data_file_name << std::endl;
+      exit(1);
+    }
+    for (size_t row = 0; row < loaded.data->row_count(); row++) {
+      auto inserted = data_rows.emplace(loaded.data->field(row, data_id_column), long(row));
+      if (!inserted.second) {
+        inserted.first->second = -2;
+      }
+    }
   }
 
-  // for each ID in the organism+_data data (in future, we will be able to assume it's in the org file)
-  for (const std::string &id : org_file_data.singleColumn("ID")) {
+  std::unordered_set<std::string> ids;
+  for (size_t row = 0; row < org_file_data.row_count(); row++) {
+    auto id = org_file_data.field(row, id_column);
+    if (!ids.insert(id).second) {
+      std::cout << "Error: CSV file " << file_name
+                << " does not have unique values in column ID" << std::endl;
+      exit(1);
+    }
     // create an internal organism
     OrganismInfo org_info;
+    org_info.file = loaded_files.size();
+    org_info.row = row;
+    org_info.data_row = -1;
     org_info.orig_ID = std::stoi(id);
-    org_info.from_file = file_name;
-    // stick all the attributes_map into the organism
-    for (const std::string &attribute : org_file_data.column_names()) {
-      // making sure to use the per-file-unique-ID
-      org_info.attributes_map.insert(std::make_pair(attribute, org_file_data.lookUp("ID", id, attribute)));
-    }
-    // Make sure the original ID,File,Update show up in the first generation's datamap store the original id
-    org_info.attributes_map.insert(std::make_pair("loadedFrom.ID",id));
-    // store the orginal file from which it was pulled
-    org_info.attributes_map.insert(std::make_pair("loadedFrom.File",file_name));
-    // store the orginal update
-    if (org_info.attributes_map.find("update") != org_info.attributes_map.end()) { 
-      org_info.attributes_map.insert(std::make_pair("loadedFrom.Update",org_file_data.lookUp("ID", id, "update")));
+    if (loaded.data) {
+      auto data_row = data_rows.find(id);
+      if (data_row == data_rows.end()) {
+        std::cout << "Error: CSV file " << data_file_name
+                  << " does not have some matching values for column ID" << std::endl;
+        exit(1);
+      }
+      if (data_row->second == -2) {
+        std::cout << "Error : multiple entries found for requested lookup value"
+                  << id << " from column ID from file " << data_file_name << std::endl;
+        exit(1);
+      }
+      org_info.data_row = data_row->second;
     }
     all_organism_infos.push_back(org_info);
   }
+  loaded_files.push_back(std::move(loaded));
 
   return file_contents_pair;
 } // end Loader::generatePopulation
 
 
+bool Loader::attribute(long index, const std::string &name, std::string &value) const {
+  const auto &org_info = all_organism_infos.at(index);
+  const auto &loaded = loaded_files.at(org_info.file);
+  // the organisms file first (columns of the _data file are only merged in
+  // if the organisms file doesn't have them)
+  auto column = loaded.organisms->columnIndex(name);
+  if (column != -1) {
+    value = loaded.organisms->field(org_info.row, column);
+    return true;
+  }
+  if (loaded.data && (column = loaded.data->columnIndex(name)) != -1) {
+    value = loaded.data->field(org_info.data_row, column);
+    return true;
+  }
+  return false;
+}
+
+bool Loader::hasAttribute(long index, const std::string &name) const {
+  const auto &loaded = loaded_files.at(all_organism_infos.at(index).file);
+  return loaded.organisms->columnIndex(name) != -1 ||
+         (loaded.data && loaded.data->columnIndex(name) != -1);
+}
+
+std::unordered_map<long, double> Loader::numericAttribute(const std::vector<long> &pop,
+                                                          const std::string &name) const {
+  std::unordered_map<long, double> values;
+  std::string value;
+  for (auto index : pop) {
+    if (values.find(index) == values.end()) {
+      attribute(index, name, value);
+      values[index] = std::stod(value);
+    }
+  }
+  return values;
+}
+
+OrgAttributesMap Loader::attributesMap(long index) const {
+  const auto &org_info = all_organism_infos.at(index);
+  const auto &loaded = loaded_files.at(org_info.file);
+  OrgAttributesMap attributes_map;
+  // stick all the attributes into the organism
+  auto values = loaded.organisms->row(org_info.row);
+  const auto &names = loaded.organisms->column_names();
+  for (size_t i = 0; i < names.size(); i++) {
+    attributes_map.insert(std::make_pair(names[i], values[i]));
+  }
+  if (loaded.data) {
+    // and only the extra columns from the _data file
+    values = loaded.data->row(org_info.data_row);
+    const auto &data_names = loaded.data->column_names();
+    for (size_t i = 0; i < data_names.size(); i++) {
+      attributes_map.insert(std::make_pair(data_names[i], values[i]));
+    }
+  }
+  // Make sure the original ID,File,Update show up in the first generation's datamap store the original id
+  attributes_map.insert(std::make_pair("loadedFrom.ID", attributes_map.at("ID")));
+  // store the orginal file from which it was pulled
+  attributes_map.insert(std::make_pair("loadedFrom.File", loaded.file_name));
+  // store the orginal update
+  if (attributes_map.find("update") != attributes_map.end()) {
+    attributes_map.insert(std::make_pair("loadedFrom.Update", attributes_map.at("update")));
+  }
+  return attributes_map;
+}
+
 void Loader::printOrganism(long i) {
 
   // strictly for debugging purposes 
   if (i != -1)
     std::cout << "\tID: " << all_organism_infos.at(i).orig_ID << " from file "
-              << all_organism_infos.at(i).from_file << std::endl;
+              << loaded_files.at(all_organism_infos.at(i).file).file_name << std::endl;
   else
     std::cout << "\trandom default organism" << std::endl;
 } // end Loader::printOrganism
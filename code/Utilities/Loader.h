@@ -9,6 +9,9 @@
 #include <vector>
 #include <set>
 #include <regex>
+#include <memory>
+
+#include "CSV.h"
 
 typedef std::unordered_map<std::string,std::string> OrgAttributesMap;
 typedef long OrgID;
@@ -16,10 +19,23 @@ typedef long OrgID;
 class Loader {
 public:
 private:
-  struct OrganismInfo { // all of the organisms info pulled from organisms_files and data_files
-    OrgAttributesMap attributes_map;
+  // the organisms and _data files of a file named in the loader (both
+  // memory-mapped, see MappedCSV)
+  struct LoadedFile {
+    std::string file_name;
+    std::unique_ptr<MappedCSV> organisms;
+    std::unique_ptr<MappedCSV> data; // nullptr if there is no _data file
+  };
+
+  std::vector<LoadedFile> loaded_files;
+
+  struct OrganismInfo { // where an organism is in the files it was pulled from
+    // attributes are only read from the files when an expression needs them,
+    // and whole attribute maps only for the organisms finally loaded
+    size_t file;   // index in loaded_files
+    size_t row;    // row in the organisms file
+    long data_row; // row in the _data file (-1 if there is none)
     // long ID;	// not used, since ID is known from position in all_organism_infos
-    std::string from_file;  // name of organism file this org was pulled from
     int orig_ID; // ID in the original file
   };
 
@@ -71,6 +87,15 @@ private:
 
   void printOrganism(long); // strictly to debug all_organism_infos entries
 
+  // reads one attribute of an organism (from its organisms file, or else its
+  // _data file). returns false if neither file has the attribute
+  bool attribute(long, const std::string &, std::string &) const;
+  bool hasAttribute(long, const std::string &) const;
+  // reads attribute as a number for every organism in a population
+  std::unordered_map<long, double> numericAttribute(const std::vector<long> &,
+                                                    const std::string &) const;
+  OrgAttributesMap attributesMap(long) const; // every attribute of an organism
+
 public:
   std::vector<std::pair<OrgID, OrgAttributesMap>> loadPopulation(const std::string &);
 };
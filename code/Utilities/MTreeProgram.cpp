@@ -0,0 +1,350 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+#include "MTreeProgram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <set>
+
+namespace {
+
+// fewest branches each node type needs to be compiled. Nodes with fewer
+// branches (or types not listed here) are run through the MTree.
+const std::map<std::string, size_t> minimumBranches = {
+    {"CONST", 0},    {"DM_AVE", 0}, {"DM_SUM", 0}, {"UPDATE", 0},
+    {"SUM", 0},      {"MULT", 0},   {"SUBTRACT", 2}, {"DIVIDE", 2},
+    {"POW", 2},      {"MOD", 2},    {"ABS", 1},    {"SIN", 1},
+    {"COS", 1},      {"MIN", 1},    {"MAX", 1},    {"REMAP", 1},
+    {"SIGMOID", 2},  {"VECT", 2},   {"RANDOM", 2}, {"IF", 3},
+    {"MANY", 1}};
+
+// the MTree versions of these evaluate some branches more than once, or in an
+// order the compiler picks, so they can only be compiled if their branches
+// always give the same value
+const std::set<std::string> needsRepeatableBranches = {"SUBTRACT", "DIVIDE",
+                                                       "POW", "MOD", "RANDOM"};
+
+// true if evaluating node may draw random numbers (or may do anything else we
+// do not know about)
+bool mayChangeState(const std::shared_ptr<Abstract_MTree> &node) {
+  const std::string type = node->type();
+  if (type == "RANDOM" || minimumBranches.find(type) == minimumBranches.end()) {
+    return true;
+  }
+  for (auto &b : node->branches) {
+    if (mayChangeState(b)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+MTreeProgram::MTreeProgram(std::shared_ptr<Abstract_MTree> _tree)
+    : tree(std::move(_tree)) {
+  if (tree->type() == "MANY" && !tree->branches.empty()) {
+    for (auto &b : tree->branches) {
+      outputRegisters.push_back(compile(b));
+    }
+  } else {
+    outputRegisters.push_back(compile(tree));
+  }
+}
+
+int MTreeProgram::newRegister() {
+  registers.push_back(0);
+  return static_cast<int>(registers.size()) - 1;
+}
+
+int MTreeProgram::compile(const std::shared_ptr<Abstract_MTree> &node) {
+  const std::string type = node->type();
+  const auto &branches = node->branches;
+
+  auto required = minimumBranches.find(type);
+  bool compilable = required != minimumBranches.end() &&
+                    branches.size() >= required->second &&
+                    !(type == "SIGMOID" && branches.size() == 3);
+  if (compilable && needsRepeatableBranches.count(type)) {
+    for (auto &b : branches) {
+      compilable = compilable && !mayChangeState(b);
+    }
+  }
+  if (!compilable) {
+    int out = newRegister();
+    instructions.push_back({TREE, out, static_cast<int>(fallbacks.size()), 0, 0, 0});
+    fallbacks.push_back(node);
+    return out;
+  }
+
+  if (type == "CONST") {
+    int out = newRegister();
+    instructions.push_back(
+        {CONST, out, 0, 0, 0, std::dynamic_pointer_cast<CONST_MTree>(node)->value});
+    return out;
+  }
+  if (type == "DM_AVE" || type == "DM_SUM") {
+    const std::string key =
+        (type == "DM_AVE") ? std::dynamic_pointer_cast<fromDataMapAve_MTree>(node)->key
+                           : std::dynamic_pointer_cast<fromDataMapSum_MTree>(node)->key;
+    auto found = std::find_if(columns.begin(), columns.end(),
+                              [&](const DataMap::Column &c) { return c.key == key; });
+    int column = static_cast<int>(found - columns.begin());
+    if (found == columns.end()) {
+      columns.push_back(DataMap::getColumn(key));
+    }
+    int out = newRegister();
+    instructions.push_back(
+        {(type == "DM_AVE") ? DM_AVE : DM_SUM, out, column, 0, 0, 0, ifDepth > 0});
+    return out;
+  }
+  if (type == "UPDATE") {
+    int out = newRegister();
+    instructions.push_back({UPDATE, out, 0, 0, 0, 0});
+    return out;
+  }
+  if (type == "IF") {
+    // only the branch which is picked is run
+    int condition = compile(branches[0]);
+    int out = newRegister();
+    size_t jumpToElse = instructions.size();
+    instructions.push_back({JUMP_IF_NOT_POSITIVE, out, condition, 0, 0, 0});
+    ifDepth++;
+    instructions.push_back({MOVE, out, compile(branches[1]), 0, 0, 0});
+    size_t jumpToEnd = instructions.size();
+    instructions.push_back({JUMP, out, 0, 0, 0, 0});
+    instructions[jumpToElse].jump = static_cast<int>(instructions.size());
+    instructions.push_back({MOVE, out, compile(branches[2]), 0, 0, 0});
+    ifDepth--;
+    instructions[jumpToEnd].jump = static_cast<int>(instructions.size());
+    return out;
+  }
+
+  // everything else runs the branches it uses once, in order, and then works
+  // on the values
+  size_t used = branches.size();
+  if (type == "REMAP") {
+    used = (branches.size() > 4) ? 5 : (branches.size() > 2) ? 3 : 1;
+  } else if (type == "SIGMOID") {
+    used = (branches.size() > 2) ? 4 : 2;
+  } else if (required->second > 0 && type != "MIN" && type != "MAX" && type != "MANY") {
+    used = required->second;
+  }
+  std::vector<int> values;
+  for (size_t i = 0; i < used; i++) {
+    values.push_back(compile(branches[i]));
+  }
+  if (type == "MANY") { // inside a formula, MANY gives its first value
+    return values[0];
+  }
+  if (type == "REMAP") { // fill in the default ranges
+    values.resize(5, -1);
+    for (size_t i = used; i < 5; i++) {
+      values[i] = compile(std::make_shared<CONST_MTree>((i % 2) ? 0 : 1));
+    }
+  }
+  const std::map<std::string, OpCode> opCodes = {
+      {"SUM", SUM}, {"MULT", MULT},   {"SUBTRACT", SUBTRACT}, {"DIVIDE", DIVIDE},
+      {"POW", POW}, {"MOD", MOD},     {"ABS", ABS},           {"SIN", SIN},
+      {"COS", COS}, {"MIN", MIN},     {"MAX", MAX},           {"REMAP", REMAP},
+      {"SIGMOID", SIGMOID}, {"VECT", VECT}, {"RANDOM", RANDOM}};
+  int out = newRegister();
+  instructions.push_back({opCodes.at(type), out, static_cast<int>(args.size()),
+                          static_cast<int>(values.size()), 0, 0});
+  args.insert(args.end(), values.begin(), values.end());
+  return out;
+}
+
+template <bool fromTable>
+void MTreeProgram::runWith(DataMap &dataMap, const std::shared_ptr<ParametersTable> &PT,
+                           const std::vector<std::vector<double>> &vectorData) {
+  double *reg = registers.data();
+  const int instructionCount = static_cast<int>(instructions.size());
+  int next = 0;
+  while (next < instructionCount) {
+    const Instruction &in = instructions[next++];
+    const int *arg = args.data() + (in.argCount > 0 ? in.a : 0);
+    switch (in.op) {
+    case CONST:
+      reg[in.out] = in.value;
+      break;
+    case DM_AVE:
+      reg[in.out] = (fromTable && averageValues[in.a])
+                        ? (*averageValues[in.a])[tableRow]
+                        : dataMap.getAverage(columns[in.a]);
+      break;
+    case DM_SUM:
+      reg[in.out] = (fromTable && sumValues[in.a]) ? (*sumValues[in.a])[tableRow]
+                                                   : dataMap.getSum(columns[in.a]);
+      break;
+    case UPDATE:
+      reg[in.out] = (double)Global::update;
+      break;
+    case SUM: {
+      double value = 0;
+      for (int i = 0; i < in.argCount; i++) {
+        value += reg[arg[i]];
+      }
+      reg[in.out] = value;
+      break;
+    }
+    case MULT: {
+      double value = 1;
+      for (int i = 0; i < in.argCount; i++) {
+        value *= reg[arg[i]];
+      }
+      reg[in.out] = value;
+      break;
+    }
+    case SUBTRACT:
+      reg[in.out] = reg[arg[0]] - reg[arg[1]];
+      break;
+    case DIVIDE:
+      reg[in.out] = (reg[arg[1]] == 0) ? 0 : reg[arg[0]] / reg[arg[1]];
+      break;
+    case POW:
+      reg[in.out] = pow(reg[arg[0]], reg[arg[1]]);
+      break;
+    case MOD: {
+      int temp = ((int)reg[arg[1]] == 0) ? (int)1 : (int)reg[arg[1]];
+      reg[in.out] = (int)reg[arg[0]] % temp;
+      break;
+    }
+    case ABS:
+      reg[in.out] = std::abs(reg[arg[0]]);
+      break;
+    case SIN:
+      reg[in.out] = sin(reg[arg[0]]);
+      break;
+    case COS:
+      reg[in.out] = cos(reg[arg[0]]);
+      break;
+    case MIN: {
+      double value = reg[arg[0]];
+      for (int i = 1; i < in.argCount; i++) {
+        value = std::min(value, reg[arg[i]]);
+      }
+      reg[in.out] = value;
+      break;
+    }
+    case MAX: {
+      double value = reg[arg[0]];
+      for (int i = 1; i < in.argCount; i++) {
+        value = std::max(value, reg[arg[i]]);
+      }
+      reg[in.out] = value;
+      break;
+    }
+    case REMAP: {
+      double v = reg[arg[0]];
+      double oldMin = reg[arg[1]];
+      double oldMax = reg[arg[2]];
+      double newMin = reg[arg[3]];
+      double newMax = reg[arg[4]];
+      reg[in.out] = ((std::max(std::min(v, oldMax), oldMin) - oldMin) *
+                     (1 / (oldMax - oldMin)) * (newMax - newMin)) +
+                    newMin;
+      break;
+    }
+    case SIGMOID: {
+      double v = reg[arg[0]];
+      double e = reg[arg[1]];
+      if (in.argCount > 2) {
+        double oldMin = reg[arg[2]];
+        double oldMax = reg[arg[3]];
+        v = ((std::max(std::min(v, oldMax), oldMin)) - oldMin) * (1 / (oldMax - oldMin));
+      } else {
+        v = std::max(std::min(v, 1.0), 0.0);
+      }
+      reg[in.out] = (v <= .5) ? pow(v * 2, e) / 2 : 1 - pow((1 - v) * 2, e) / 2;
+      break;
+    }
+    case VECT: {
+      int whichVect = std::max(0, (int)reg[arg[0]] % (int)vectorData.size());
+      int whichVal =
+          std::max(0, (int)reg[arg[1]] % (int)vectorData[whichVect].size());
+      reg[in.out] = vectorData[whichVect][whichVal];
+      break;
+    }
+    case RANDOM:
+      reg[in.out] = Random::getDouble(reg[arg[0]], reg[arg[1]]);
+      break;
+    case MOVE:
+      reg[in.out] = reg[in.a];
+      break;
+    case JUMP:
+      next = in.jump;
+      break;
+    case JUMP_IF_NOT_POSITIVE:
+      if (!(reg[in.a] > 0)) {
+        next = in.jump;
+      }
+      break;
+    case TREE:
+      reg[in.out] = fallbacks[in.a]->eval(dataMap, PT, vectorData)[0];
+      break;
+    }
+  }
+}
+
+void MTreeProgram::run(DataMap &dataMap, const std::shared_ptr<ParametersTable> &PT,
+                       const std::vector<std::vector<double>> &vectorData) {
+  runWith<false>(dataMap, PT, vectorData);
+}
+
+void MTreeProgram::runRow(DataMap &dataMap, const std::shared_ptr<ParametersTable> &PT,
+                          const std::vector<std::vector<double>> &vectorData) {
+  runWith<true>(dataMap, PT, vectorData);
+}
+
+std::vector<double>
+MTreeProgram::eval(DataMap &dataMap, const std::shared_ptr<ParametersTable> &PT,
+                   const std::vector<std::vector<double>> &vectorData) {
+  run(dataMap, PT, vectorData);
+  std::vector<double> output;
+  for (int r : outputRegisters) {
+    output.push_back(registers[r]);
+  }
+  return output;
+}
+
+double MTreeProgram::evalFirst(DataMap &dataMap,
+                               const std::shared_ptr<ParametersTable> &PT,
+                               const std::vector<std::vector<double>> &vectorData) {
+  run(dataMap, PT, vectorData);
+  return registers[outputRegisters[0]];
+}
+
+std::vector<double>
+MTreeProgram::evalAll(PopulationTable &table, const std::shared_ptr<ParametersTable> &PT,
+                      const std::vector<std::vector<double>> &vectorData) {
+  // columns only read inside an IF are looked up as before, so rows which do
+  // not have that key are not read
+  averageValues.assign(columns.size(), nullptr);
+  sumValues.assign(columns.size(), nullptr);
+  for (auto &in : instructions) {
+    if (in.conditional) {
+      continue;
+    }
+    if (in.op == DM_AVE) {
+      averageValues[in.a] = &table.averages(columns[in.a]);
+    } else if (in.op == DM_SUM) {
+      sumValues[in.a] = &table.sums(columns[in.a]);
+    }
+  }
+  std::vector<double> results(table.size());
+  for (tableRow = 0; tableRow < table.size(); tableRow++) {
+    runRow(table.row(tableRow), PT, vectorData);
+    results[tableRow] = registers[outputRegisters[0]];
+  }
+  return results;
+}
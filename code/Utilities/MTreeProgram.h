@@ -0,0 +1,125 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "MTree.h"
+#include "PopulationTable.h"
+
+// An MTree compiled into a flat list of instructions. Each node writes its
+// result into a register (a double), DataMap keys are turned into
+// DataMap::Columns when the program is built, and nothing is allocated while
+// the program runs. eval gives the same results as the MTree it was built
+// from (including the order random numbers are drawn in). Nodes which can not
+// be compiled (node types the compiler does not know, or nodes that would
+// evaluate a random branch in a different order) are run by calling eval on
+// that part of the original tree.
+// A program holds its registers, so each thread needs its own program.
+class MTreeProgram {
+private:
+  enum OpCode {
+    CONST,
+    DM_AVE,
+    DM_SUM,
+    UPDATE,
+    SUM,
+    MULT,
+    SUBTRACT,
+    DIVIDE,
+    POW,
+    MOD,
+    ABS,
+    SIN,
+    COS,
+    MIN,
+    MAX,
+    REMAP,
+    SIGMOID,
+    VECT,
+    RANDOM,
+    MOVE,
+    JUMP,
+    JUMP_IF_NOT_POSITIVE, // jump if register a is not > 0
+    TREE                  // run fallbacks[a]->eval
+  };
+
+  struct Instruction {
+    OpCode op;
+    int out;        // register written to
+    int a;          // first argument (register, column or fallback)
+    int argCount;   // number of arguments in args, starting at a
+    int jump;       // next instruction for JUMP and JUMP_IF_NOT_POSITIVE
+    double value;   // for CONST
+    bool conditional = false; // only run when an IF picks it
+  };
+
+  std::shared_ptr<Abstract_MTree> tree;
+  std::vector<Instruction> instructions;
+  std::vector<int> args; // registers used by instructions with many arguments
+  std::vector<DataMap::Column> columns;
+  std::vector<std::shared_ptr<Abstract_MTree>> fallbacks;
+  std::vector<int> outputRegisters;
+  std::vector<double> registers;
+  // when running over a PopulationTable, the table columns for each column
+  std::vector<const std::vector<double> *> averageValues;
+  std::vector<const std::vector<double> *> sumValues;
+  size_t tableRow = 0;
+  int ifDepth = 0; // while compiling
+
+
+  int compile(const std::shared_ptr<Abstract_MTree> &node);
+  int newRegister();
+  void run(DataMap &dataMap, const std::shared_ptr<ParametersTable> &PT,
+           const std::vector<std::vector<double>> &vectorData);
+  template <bool fromTable>
+  void runWith(DataMap &dataMap, const std::shared_ptr<ParametersTable> &PT,
+               const std::vector<std::vector<double>> &vectorData);
+  // run reading DM_AVE and DM_SUM from averageValues and sumValues at tableRow
+  void runRow(DataMap &dataMap, const std::shared_ptr<ParametersTable> &PT,
+              const std::vector<std::vector<double>> &vectorData);
+
+public:
+  MTreeProgram() = default;
+  MTreeProgram(std::shared_ptr<Abstract_MTree> _tree);
+
+  // number of instructions which call back into the MTree
+  int fallbackCount() const { return static_cast<int>(fallbacks.size()); }
+
+  // same as tree->eval(dataMap, PT, vectorData)
+  std::vector<double> eval(DataMap &dataMap,
+                           const std::shared_ptr<ParametersTable> &PT = nullptr,
+                           const std::vector<std::vector<double>> &vectorData = {});
+
+  // same as tree->eval(dataMap, PT, vectorData)[0]
+  double evalFirst(DataMap &dataMap,
+                   const std::shared_ptr<ParametersTable> &PT = nullptr,
+                   const std::vector<std::vector<double>> &vectorData = {});
+
+  // evalFirst for population[i]->dataMap, for each i in order
+  template <class Population>
+  std::vector<double> evalAll(Population &population,
+                              const std::shared_ptr<ParametersTable> &PT = nullptr,
+                              const std::vector<std::vector<double>> &vectorData = {}) {
+    std::vector<double> results(population.size());
+    for (size_t i = 0; i < population.size(); i++) {
+      results[i] = evalFirst(population[i]->dataMap, PT, vectorData);
+    }
+    return results;
+  }
+
+  // evalFirst for each row of table, in order. DM_AVE and DM_SUM are read
+  // from the table's columns.
+  std::vector<double> evalAll(PopulationTable &table,
+                              const std::shared_ptr<ParametersTable> &PT = nullptr,
+                              const std::vector<std::vector<double>> &vectorData = {});
+};
@@ -0,0 +1,288 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+#include "PackedSites.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <unordered_map>
+
+enum BlockType : char { FULL = 0, DELTA = 1 };
+enum DeltaOp { COPY = 0, LITERAL = 1 };
+
+// copies shorter than this are written as literals
+static const size_t minCopy = 8;
+
+static void putVarint(std::string &out, uint64_t value) {
+  while (value >= 0x80) {
+    out += static_cast<char>((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  out += static_cast<char>(value);
+}
+
+static bool getVarint(const std::string &data, size_t &pos, uint64_t &value) {
+  value = 0;
+  for (int shift = 0; pos < data.size() && shift < 64; shift += 7) {
+    auto byte = static_cast<unsigned char>(data[pos++]);
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static uint64_t hashOf(const char *bytes) {
+  uint64_t hash = 14695981039346656037ull; // FNV-1a
+  for (size_t i = 0; i < minCopy; i++) {
+    hash = (hash ^ static_cast<unsigned char>(bytes[i])) * 1099511628211ull;
+  }
+  return hash;
+}
+
+std::string PackedSites::deltaEncode(const std::string &base, const std::string &target) {
+  // where each run of minCopy bytes first appears in base
+  std::unordered_map<uint64_t, size_t> runs;
+  for (size_t i = 0; i + minCopy <= base.size(); i++) {
+    runs.emplace(hashOf(&base[i]), i);
+  }
+
+  std::string delta;
+  size_t literalStart = 0;
+  auto endLiteral = [&](size_t end) {
+    if (end > literalStart) {
+      putVarint(delta, ((end - literalStart) << 1) | LITERAL);
+      delta.append(target, literalStart, end - literalStart);
+    }
+  };
+  size_t expected = 0; // where in base a copy would carry on from
+  size_t t = 0;
+  while (t + minCopy <= target.size()) {
+    size_t from = std::string::npos;
+    if (expected + minCopy <= base.size() &&
+        std::memcmp(&base[expected], &target[t], minCopy) == 0) {
+      from = expected;
+    } else {
+      auto found = runs.find(hashOf(&target[t]));
+      if (found != runs.end() && std::memcmp(&base[found->second], &target[t], minCopy) == 0) {
+        from = found->second;
+      }
+    }
+    if (from == std::string::npos) {
+      t++;
+      expected++; // most changes are point mutations, so stay in step
+      continue;
+    }
+    size_t length = minCopy;
+    while (from + length < base.size() && t + length < target.size() &&
+           base[from + length] == target[t + length]) {
+      length++;
+    }
+    endLiteral(t);
+    putVarint(delta, (length << 1) | COPY);
+    auto jump = static_cast<int64_t>(from) - static_cast<int64_t>(expected);
+    putVarint(delta, (static_cast<uint64_t>(jump) << 1) ^ static_cast<uint64_t>(jump >> 63));
+    t += length;
+    expected = from + length;
+    literalStart = t;
+  }
+  endLiteral(target.size());
+  return delta;
+}
+
+static void badDelta() {
+  std::cout << "  ERROR :: in PackedSites::deltaDecode, the delta does not fit its base. "
+               "The sites file may be damaged.\n  Exiting."
+            << std::endl;
+  exit(1);
+}
+
+std::string PackedSites::deltaDecode(const std::string &base, const std::string &delta) {
+  std::string target;
+  size_t pos = 0;
+  size_t expected = 0;
+  uint64_t header, value;
+  while (pos < delta.size()) {
+    if (!getVarint(delta, pos, header)) {
+      badDelta();
+    }
+    uint64_t length = header >> 1;
+    if ((header & 1) == LITERAL) {
+      if (length > delta.size() - pos) {
+        badDelta();
+      }
+      target.append(delta, pos, length);
+      pos += length;
+      expected += length;
+    } else {
+      if (!getVarint(delta, pos, value)) {
+        badDelta();
+      }
+      auto from = static_cast<int64_t>(expected) +
+                  (static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1));
+      if (from < 0 || static_cast<uint64_t>(from) > base.size() ||
+          length > base.size() - from) {
+        badDelta();
+      }
+      target.append(base, from, length);
+      expected = from + length;
+    }
+  }
+  return target;
+}
+
+std::string PackedSites::sitesFileName(const std::string &organismFileName) {
+  auto dot = organismFileName.find_last_of('.');
+  auto slash = organismFileName.find_last_of("/\\");
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+    return organismFileName + fileExtension;
+  }
+  return organismFileName.substr(0, dot) + fileExtension;
+}
+
+bool PackedSites::isSitesFile(const std::string &fileName) {
+  return fileName.size() >= fileExtension.size() &&
+         fileName.compare(fileName.size() - fileExtension.size(), fileExtension.size(),
+                          fileExtension) == 0;
+}
+
+bool PackedSites::isReference(const std::string &value) {
+  return !value.empty() && value[0] == '@' && value.find(':') != std::string::npos;
+}
+
+// what is known about a sites file being written
+struct SitesFile {
+  uint64_t size = 0; // bytes written so far
+  struct Block {
+    uint64_t offset;
+    uint64_t length;
+    std::string sites; // the sites it holds (decoded)
+    int chain;         // how many deltas were stacked to make it
+  };
+  std::map<std::string, Block> last; // the last block of each genome
+};
+
+static std::map<std::string, SitesFile> sitesFiles;
+
+void PackedSites::writeOrganism(DataMap &orgMap, const std::string &organismFileName,
+                                bool delta) {
+  auto sitesName = sitesFileName(organismFileName);
+  auto &file = sitesFiles[sitesName];
+  if (FileManager::files.find(sitesName) == FileManager::files.end()) {
+    // FileManager will start the file afresh (a closed file is reopened to
+    // append, so then the size carries on)
+    file = SitesFile();
+  }
+  for (auto const &key : orgMap.getKeys()) {
+    if (key.size() <= packedSuffix.size() ||
+        key.compare(key.size() - packedSuffix.size(), packedSuffix.size(), packedSuffix) != 0) {
+      continue;
+    }
+    auto genome = key.substr(0, key.size() - packedSuffix.size());
+    auto sites = orgMap.getStringVector(key)[0];
+
+    std::string block(1, FULL);
+    block += sites;
+    int chain = 0;
+    auto last = file.last.find(genome);
+    if (delta && last != file.last.end() && last->second.chain < maxDeltaChain) {
+      std::string deltaBlock(1, DELTA);
+      putVarint(deltaBlock, last->second.offset);
+      putVarint(deltaBlock, last->second.length);
+      deltaBlock += deltaEncode(last->second.sites, sites);
+      if (deltaBlock.size() < block.size()) {
+        block = std::move(deltaBlock);
+        chain = last->second.chain + 1;
+      }
+    }
+    FileManager::writeToFile(sitesName, block);
+    orgMap.clear(key);
+    orgMap.set(genome + "_sites",
+               "@" + std::to_string(file.size) + ":" + std::to_string(block.size()));
+    if (delta) {
+      file.last[genome] = {file.size, block.size(), std::move(sites), chain};
+    }
+    file.size += block.size();
+  }
+  orgMap.writeToFile(organismFileName);
+}
+
+void PackedSites::closeFile(const std::string &organismFileName) {
+  FileManager::closeFile(organismFileName);
+  auto sitesName = sitesFileName(organismFileName);
+  auto file = sitesFiles.find(sitesName);
+  if (file != sitesFiles.end()) {
+    file->second.last.clear();
+    FileManager::closeFile(sitesName);
+  }
+}
+
+// the block at offset (with length bytes) of the sites file, decoded
+static std::string readBlock(std::ifstream &file, const std::string &sitesName,
+                             uint64_t offset, uint64_t length, int depth) {
+  std::string block(length, '\0');
+  file.clear();
+  file.seekg(offset);
+  if (length == 0 || !file.read(&block[0], length) || depth > PackedSites::maxDeltaChain) {
+    std::cout << "  ERROR :: could not read the packed sites at " << offset << ":" << length
+              << " in \"" << sitesName << "\". The file may be damaged or cut short.\n  Exiting."
+              << std::endl;
+    exit(1);
+  }
+  if (block[0] == FULL) {
+    return block.substr(1);
+  }
+  size_t pos = 1;
+  uint64_t baseOffset, baseLength;
+  if (block[0] != DELTA || !getVarint(block, pos, baseOffset) ||
+      !getVarint(block, pos, baseLength) || baseOffset >= offset) {
+    std::cout << "  ERROR :: the packed sites at " << offset << ":" << length << " in \""
+              << sitesName << "\" are damaged.\n  Exiting." << std::endl;
+    exit(1);
+  }
+  auto base = readBlock(file, sitesName, baseOffset, baseLength, depth + 1);
+  return PackedSites::deltaDecode(base, block.substr(pos));
+}
+
+std::string PackedSites::read(const std::string &organismFileName, const std::string &reference) {
+  // organisms are usually loaded from a few files, so keep the last one open
+  // (one for each thread, as organisms may be loaded on several)
+  thread_local std::string openName;
+  thread_local std::ifstream file;
+  auto sitesName = sitesFileName(organismFileName);
+  if (sitesName != openName) {
+    file.close();
+    file.clear();
+    file.open(sitesName, std::ios::binary);
+    if (!file.is_open()) {
+      std::cout << "  ERROR :: the organisms in \"" << organismFileName
+                << "\" have packed genomes, but their sites file \"" << sitesName
+                << "\" could not be opened.\n  Exiting." << std::endl;
+      exit(1);
+    }
+    openName = sitesName;
+  }
+  uint64_t offset = 0, length = 0;
+  auto colon = reference.find(':');
+  try {
+    offset = std::stoull(reference.substr(1, colon - 1));
+    length = std::stoull(reference.substr(colon + 1));
+  } catch (const std::exception &) {
+    std::cout << "  ERROR :: \"" << reference << "\" in \"" << organismFileName
+              << "\" is not a packed sites reference.\n  Exiting." << std::endl;
+    exit(1);
+  }
+  return readBlock(file, sitesName, offset, length, 0);
+}
@@ -0,0 +1,61 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+// Organism files with packed genomes (ARCHIVIST-organismFileFormat packed or
+// packedDelta). Genomes which support it (see
+// AbstractGenome::serializePacked) pack their sites into bytes, and rather
+// than going into the organism file as text, the bytes are appended to a
+// sites file next to it (snapshot_organisms_10.csv has
+// snapshot_organisms_10.sites) and the organism file holds a reference,
+// "@offset:length". The organism file stays a small csv, and loading an
+// organism only reads (and decodes) that organism's sites.
+//
+// A block in a sites file is either FULL (a 0 byte, then the packed sites)
+// or DELTA (a 1 byte, varint offset and length of the block it is based on,
+// then the edits which turn that block into this one, see deltaEncode). With
+// packedDelta, a genome is stored as a delta against the previous genome of
+// the same name in the file when that is smaller (on a line of descent
+// file, the previous genome is an ancestor). At most maxDeltaChain deltas
+// are stacked before a FULL block, so reading a genome never reads more
+// than that many blocks.
+
+#pragma once
+
+#include <string>
+
+#include "Data.h"
+
+namespace PackedSites {
+
+// DataMap keys ending in this hold packed sites (from serializePacked)
+// until writeOrganism moves them to the sites file
+const std::string packedSuffix = "_sitesPacked";
+const std::string fileExtension = ".sites";
+const int maxDeltaChain = 16;
+
+std::string sitesFileName(const std::string &organismFileName);
+bool isSitesFile(const std::string &fileName); // does it end in fileExtension
+bool isReference(const std::string &value);     // is it "@offset:length"
+
+// write orgMap as a row of organismFileName, moving any packed sites in it
+// to the sites file (delta encoded if delta, see above)
+void writeOrganism(DataMap &orgMap, const std::string &organismFileName, bool delta);
+// close organismFileName and its sites file (like FileManager::closeFile)
+void closeFile(const std::string &organismFileName);
+
+// the packed sites reference (from a row of organismFileName) refers to
+std::string read(const std::string &organismFileName, const std::string &reference);
+
+// the edits which make target from base (copies of runs of base, and new
+// bytes), and back
+std::string deltaEncode(const std::string &base, const std::string &target);
+std::string deltaDecode(const std::string &base, const std::string &delta);
+
+} // namespace PackedSites
@@ -9,6 +9,7 @@
 //         github.com/Hintzelab/MABE/wiki/License
 
 #include "Parameters.h"
+#include "ColumnarFile.h"
 #include "Utilities.h"
 
 #include <regex>
@@ -20,6 +21,7 @@ bool Parameters::save_files;
 std::string Parameters::save_file_prefix = "./";
 
 long long ParametersTable::nextTableID = 0;
+std::mutex ParametersTable::tablesMutex;
 
 template <> inline const bool ParametersEntry<bool>::getBool() { return get(); }
 
@@ -116,6 +118,10 @@ void Parameters::readCommandLine(
         for usage examples. Note: using -l will ignore all other command 
         line arguments.
 
+  -c : "convert" - list of columnar data files (see ARCHIVIST-outputFormat)
+        to convert to csv. Each file.mcol is written to file.csv. Note: using
+        -c will not run MABE.
+
   -v : "version" - show git commit hash from when compiled
 
 )";
@@ -176,6 +182,23 @@ MASTER = default 100 # by default :)
       dont_run = true;
       break;
     }
+    case 'c':
+      for (; i < argc - 1; i++) {
+        std::string filename(argv[i + 1]);
+        if (std::regex_match(filename, command_line_argument_flag)) {
+          break;
+        }
+        std::string csvFilename =
+            (Columnar::isColumnarFile(filename)
+                 ? filename.substr(0, filename.size() - Columnar::fileExtension.size())
+                 : filename) +
+            ".csv";
+        ColumnarReader(filename).writeCSV(csvFilename);
+        std::cout << "converted \"" << filename << "\" to \"" << csvFilename << "\""
+                  << std::endl;
+      }
+      dont_run = true;
+      break;
     case 's': 
       save_files = true;
       if (i < argc - 1) {
@@ -17,6 +17,7 @@
 
 #include <type_traits>
 #include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <map>
@@ -25,6 +26,7 @@
 #include <unordered_map>
 #include <set>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 const std::string MABE_pretty_logo =
@@ -509,6 +511,12 @@ public:
 };
 
 class ParametersTable {
+public:
+  // a lookup can add an entry to a table, so ParameterLinks (which may look
+  // up parameters from evaluation threads) take this lock when they have to
+  // look in a table. Tables are not otherwise locked.
+  static std::mutex tablesMutex;
+
 private:
   static long long nextTableID;
   long long ID;
@@ -1272,21 +1280,59 @@ public:
 
 template <typename T> class ParameterLink {
 public:
+  using EntriesCache = std::map<long long, std::shared_ptr<ParametersEntry<T>>>;
+
   std::string name;
   std::shared_ptr<ParametersEntry<T>> entry; // points to a parameters entry
   std::shared_ptr<ParametersTable> table;    // the table that owns this entry
-  std::map<long long, std::shared_ptr<ParametersEntry<T>>>
-      entriesCache; // used to track entries in other name spaces
 
+private:
+  // used to track entries in other name spaces. get(PT) is called from
+  // evaluation threads, so it reads entriesCache without locking: a published
+  // cache is never changed, a miss publishes a copy with the new entry (while
+  // holding ParametersTable::tablesMutex), and old copies are kept in
+  // cacheVersions until the link is destroyed.
+  std::atomic<const EntriesCache *> entriesCache;
+  std::vector<std::unique_ptr<const EntriesCache>> cacheVersions;
+
+  // call with ParametersTable::tablesMutex held
+  void publish(std::unique_ptr<const EntriesCache> cache) {
+    entriesCache.store(cache.get(), std::memory_order_release);
+    cacheVersions.push_back(std::move(cache));
+  }
+
+  // call with ParametersTable::tablesMutex held
+  void cacheEntry(const std::shared_ptr<ParametersTable> &lookupTable) {
+    auto cache = std::make_unique<EntriesCache>(
+        *entriesCache.load(std::memory_order_relaxed));
+    (*cache)[lookupTable->getID()] =
+        std::dynamic_pointer_cast<ParametersEntry<T>>(
+            lookupTable->getEntry(name));
+    publish(std::move(cache));
+  }
+
+public:
   ParameterLink(std::string _name, std::shared_ptr<ParametersEntry<T>> _entry,
                 std::shared_ptr<ParametersTable> _table)
-      : name(_name), entry(_entry), table(_table) {}
+      : name(_name), entry(_entry), table(_table) {
+    auto cache = std::make_unique<const EntriesCache>();
+    entriesCache.store(cache.get());
+    cacheVersions.push_back(std::move(cache));
+  }
 
   ~ParameterLink() = default;
 
   T get() { return entry->get(); }
 
-  T get(std::shared_ptr<ParametersTable> lookupTable) {
+  T get(const std::shared_ptr<ParametersTable> &lookupTable) {
+    return getEntry(lookupTable)->get();
+  }
+
+  // the entry get(lookupTable) reads from. This is a reference into a
+  // published cache (which is never changed or freed while the link lives), so
+  // reading through it does not touch the entry's reference count.
+  const std::shared_ptr<ParametersEntry<T>> &
+  getEntry(const std::shared_ptr<ParametersTable> &lookupTable) {
     // cout << "in lookup with PT    with name: " << name << endl;
     if (lookupTable == nullptr) {
       std::cout << "  in ParameterLink::get(lookupTable) :: while looking up \""
@@ -1296,17 +1342,23 @@ public:
                 << std::endl;
       exit(1);
     }
-    auto mapRecord = entriesCache.find(lookupTable->getID());
-    if (mapRecord ==
-        entriesCache.end()) { // if the cache does not contain this table
-      T lookupValue;
-      lookupTable->lookup(name, lookupValue);
-      entriesCache[lookupTable->getID()] =
-          std::dynamic_pointer_cast<ParametersEntry<T>>(
-              lookupTable->getEntry(name));
-      return lookupValue;
+    const EntriesCache *cache = entriesCache.load(std::memory_order_acquire);
+    auto mapRecord = cache->find(lookupTable->getID());
+    if (mapRecord != cache->end()) {
+      return mapRecord->second;
     }
-    return entriesCache[lookupTable->getID()]->get();
+    // the cache does not contain this table
+    std::lock_guard<std::mutex> lock(ParametersTable::tablesMutex);
+    cache = entriesCache.load(std::memory_order_relaxed);
+    mapRecord = cache->find(lookupTable->getID());
+    if (mapRecord != cache->end()) { // another thread looked it up first
+      return mapRecord->second;
+    }
+    T lookupValue;
+    lookupTable->lookup(name, lookupValue); // makes a local entry if needed
+    cacheEntry(lookupTable);
+    return entriesCache.load(std::memory_order_relaxed)
+        ->at(lookupTable->getID());
   }
 
   // T lookup() {
@@ -1318,26 +1370,30 @@ public:
   //}
 
   void set(T value) {
+    std::lock_guard<std::mutex> lock(ParametersTable::tablesMutex);
     table->setParameter(name, value);
-    entriesCache[table->getID()] =
-        std::dynamic_pointer_cast<ParametersEntry<T>>(table->getEntry(name));
+    cacheEntry(table);
   }
 
   void set(T value, std::shared_ptr<ParametersTable> lookupTable) {
+    std::lock_guard<std::mutex> lock(ParametersTable::tablesMutex);
     lookupTable->setParameter(name, value);
-    entriesCache[lookupTable->getID()] =
-        std::dynamic_pointer_cast<ParametersEntry<T>>(
-            lookupTable->getEntry(name));
+    cacheEntry(lookupTable);
   }
 
-  void clearCache() { entriesCache.clear(); }
+  void clearCache() {
+    std::lock_guard<std::mutex> lock(ParametersTable::tablesMutex);
+    publish(std::make_unique<const EntriesCache>());
+  }
 
   void clearCache(std::shared_ptr<ParametersTable> _table) {
-    auto mapRecord = entriesCache.find(_table->getID());
-    if (mapRecord !=
-        entriesCache
-            .end()) { // if the cache contain this _table(parameterstable)
-      entriesCache.erase(mapRecord); // remove the entry from the entiresCache
+    std::lock_guard<std::mutex> lock(ParametersTable::tablesMutex);
+    const EntriesCache *cache = entriesCache.load(std::memory_order_relaxed);
+    if (cache->find(_table->getID()) !=
+        cache->end()) { // if the cache contain this _table(parameterstable)
+      auto updated = std::make_unique<EntriesCache>(*cache);
+      updated->erase(_table->getID()); // remove the entry from the cache
+      publish(std::move(updated));
     }
     // else do nothing, there is not entry for _table in this PL
   }
@@ -1350,6 +1406,65 @@ public:
   }
 };
 
+// set PARAMETERS_CHECK_VALUES to 1 to have ParameterValue::get() check that
+// the parameter has not been changed since the value was bound
+#ifndef PARAMETERS_CHECK_VALUES
+#define PARAMETERS_CHECK_VALUES 0
+#endif
+
+// A parameter value looked up once, when bound. ParameterLink::get(PT) finds
+// PT in a map on every call, so code which reads parameters over and over
+// (i.e. for every mutation or every brain update) can bind ParameterValues
+// when it is built and then get() is a plain read.
+// Parameters are not expected to change once they have been bound.
+template <typename T> class ParameterValue {
+private:
+  T value = T();
+  std::shared_ptr<ParametersEntry<T>> entry;
+  std::string name;
+
+public:
+  ParameterValue() = default;
+  ParameterValue(const std::shared_ptr<ParameterLink<T>> &link) { bind(link); }
+  ParameterValue(const std::shared_ptr<ParameterLink<T>> &link,
+                 const std::shared_ptr<ParametersTable> &lookupTable) {
+    bind(link, lookupTable);
+  }
+
+  // same value as link->get()
+  void bind(const std::shared_ptr<ParameterLink<T>> &link) {
+    entry = link->entry;
+    name = link->name;
+    value = entry->get();
+  }
+
+  // same value as link->get(lookupTable)
+  void bind(const std::shared_ptr<ParameterLink<T>> &link,
+            const std::shared_ptr<ParametersTable> &lookupTable) {
+    entry = link->getEntry(lookupTable);
+    name = link->name;
+    value = entry->get();
+  }
+
+  const T &get() const {
+#if PARAMETERS_CHECK_VALUES == 1
+    if (entry == nullptr) {
+      std::cout << "  in ParameterValue::get() :: value was never bound.\n"
+                   "  exiting..."
+                << std::endl;
+      exit(1);
+    }
+    if (!(entry->get() == value)) {
+      std::cout << "  in ParameterValue::get() :: parameter \"" << name
+                << "\" was changed after it was bound.\n  exiting..."
+                << std::endl;
+      exit(1);
+    }
+#endif
+    return value;
+  }
+};
+
 class Parameters {
 public:
   static std::shared_ptr<ParametersTable> root;
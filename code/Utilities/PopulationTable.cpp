@@ -0,0 +1,90 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+#include "PopulationTable.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "../Global.h"
+
+void PopulationTable::refreshRows(const std::vector<DataMap *> &newRows) {
+  bool keep = update == Global::update && newRows.size() >= rows.size() &&
+              std::equal(rows.begin(), rows.end(), newRows.begin());
+  if (!keep) {
+    invalidate();
+  }
+  update = Global::update;
+  rows = newRows;
+}
+
+void PopulationTable::invalidate() {
+  averageColumns.clear();
+  sumColumns.clear();
+}
+
+const std::vector<double> &
+PopulationTable::fill(std::unordered_map<int, TableColumn> &columns,
+                      const DataMap::Column &column, bool average) {
+  auto found = columns.find(column.symbol);
+  if (found == columns.end()) {
+    found = columns.emplace(column.symbol, TableColumn{column, {}}).first;
+  }
+  // only rows added since the column was last read are looked up
+  std::vector<double> &values = found->second.values;
+  size_t filled = values.size();
+  values.resize(rows.size());
+  for (size_t i = filled; i < rows.size(); i++) {
+    values[i] = average ? rows[i]->getAverage(column) : rows[i]->getSum(column);
+  }
+  return values;
+}
+
+void PopulationTable::setColumn(const std::string &key,
+                                const std::vector<double> &values) {
+  if (values.size() != rows.size()) {
+    std::cout << "  ERROR :: in PopulationTable::setColumn, column \"" << key
+              << "\" has " << values.size() << " values but the table has "
+              << rows.size() << " rows.\n  Exiting." << std::endl;
+    exit(1);
+  }
+  auto column = DataMap::getColumn(key);
+  averageColumns[column.symbol] = TableColumn{column, values};
+  sumColumns.erase(column.symbol);
+}
+
+double PopulationTable::sum(const std::vector<double> &values) {
+  double total = 0;
+  for (double v : values) {
+    total += v;
+  }
+  return total;
+}
+
+double PopulationTable::mean(const std::vector<double> &values) {
+  return values.empty() ? 0 : sum(values) / values.size();
+}
+
+double PopulationTable::variance(const std::vector<double> &values) {
+  double average = mean(values);
+  double total = 0;
+  for (double v : values) {
+    total += (v - average) * (v - average);
+  }
+  return (values.size() > 1) ? total / (values.size() - 1) : 0;
+}
+
+double PopulationTable::max(const std::vector<double> &values) {
+  return values.empty() ? 0 : *std::max_element(values.begin(), values.end());
+}
+
+double PopulationTable::min(const std::vector<double> &values) {
+  return values.empty() ? 0 : *std::min_element(values.begin(), values.end());
+}
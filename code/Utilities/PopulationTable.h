@@ -0,0 +1,87 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "Data.h"
+
+// Population data held by column. Each column is one contiguous vector with a
+// value for each row (organism), so code that needs one key from every
+// organism (the pop file, optimizer formulas) reads it with a single pass over
+// an array rather than a DataMap lookup per organism.
+// Columns are filled from the organisms' DataMaps the first time they are
+// asked for in an update (or given with setColumn), and are then reused by
+// everyone sharing the table (a Group's optimizer and archivist share one).
+// Values set in a DataMap after its column was read are not seen until the
+// next update (or invalidate).
+class PopulationTable {
+private:
+  struct TableColumn {
+    DataMap::Column column;
+    std::vector<double> values;
+  };
+
+  int update = -1;
+  std::vector<DataMap *> rows;
+  // by DataMap symbol
+  std::unordered_map<int, TableColumn> averageColumns;
+  std::unordered_map<int, TableColumn> sumColumns;
+
+  const std::vector<double> &fill(std::unordered_map<int, TableColumn> &columns,
+                                  const DataMap::Column &column, bool average);
+
+public:
+  PopulationTable() = default;
+
+  // use population[i]->dataMap as row i. If the rows from the last call are
+  // still the first rows (same update, organisms only added to the end) the
+  // columns already read are kept, otherwise everything is cleared.
+  template <class Population> void refresh(Population &population) {
+    std::vector<DataMap *> newRows(population.size());
+    for (size_t i = 0; i < population.size(); i++) {
+      newRows[i] = &population[i]->dataMap;
+    }
+    refreshRows(newRows);
+  }
+  void refreshRows(const std::vector<DataMap *> &newRows);
+
+  // forget all columns (i.e. after changing values which have been read)
+  void invalidate();
+
+  size_t size() const { return rows.size(); }
+  DataMap &row(size_t i) { return *rows[i]; }
+
+  // value of DataMap::getAverage (or getSum) for each row
+  const std::vector<double> &averages(const DataMap::Column &column) {
+    return fill(averageColumns, column, true);
+  }
+  const std::vector<double> &sums(const DataMap::Column &column) {
+    return fill(sumColumns, column, false);
+  }
+  const std::vector<double> &averages(const std::string &key) {
+    return averages(DataMap::getColumn(key));
+  }
+
+  // set the averages column for key (i.e. values just written to every
+  // organism's DataMap). values must have one value per row.
+  void setColumn(const std::string &key, const std::vector<double> &values);
+
+  // reductions over a column. These add in row order, so they give the same
+  // values as the loops they replace (and as DataMap's AVE and VAR output).
+  static double sum(const std::vector<double> &values);
+  static double mean(const std::vector<double> &values);
+  static double variance(const std::vector<double> &values);
+  static double max(const std::vector<double> &values);
+  static double min(const std::vector<double> &values);
+};
@@ -17,6 +17,9 @@
 
 #include <random>
 #include <climits> // UINT_MAX
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
 
 namespace Random {
 
@@ -38,44 +41,175 @@ inline Generator &getCommonGenerator() {
   return common;
 }
 
+// Seed used to key StreamGenerators (set in main along with the common
+// generator's seed)
+inline uint64_t &getStreamSeed() {
+  static uint64_t streamSeed = 0;
+  return streamSeed;
+}
+
+// Seed for streams used for one purpose other than evaluating organisms (i.e.
+// "offspring"). Streams keyed on the same values (update, index, ...) for
+// different purposes are independent.
+inline uint64_t getStreamSeed(const char *purpose) {
+  uint64_t tag = 0xcbf29ce484222325ULL; // FNV-1a hash of purpose
+  for (; *purpose != 0; purpose++) {
+    tag = (tag ^ static_cast<unsigned char>(*purpose)) * 0x100000001b3ULL;
+  }
+  return getStreamSeed() ^ tag;
+}
+
+// StreamGenerator is a counter based generator. The n-th number of a stream is
+// a hash (the SplitMix64 finalizer) of the stream's key and n, so a stream
+// carries no state beyond two integers, streams with different keys are
+// independent, and a stream can be made anywhere from the values it is keyed
+// on (e.g. seed, update, organism ID) with no shared state. This is what makes
+// it possible to draw numbers from many threads and get the same results no
+// matter which thread does the work or in what order.
+class StreamGenerator {
+  uint64_t key;
+  uint64_t counter = 0;
+
+  static uint64_t mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+public:
+  using result_type = uint64_t;
+
+  StreamGenerator(uint64_t seed = 0, uint64_t streamA = 0,
+                  uint64_t streamB = 0) {
+    // hash each value in turn so that (a,b) and (b,a) give different keys
+    key = mix(mix(mix(seed + 0x9e3779b97f4a7c15ULL) ^ streamA) + streamB);
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return UINT64_MAX; }
+
+  result_type operator()() { return mix(key + (++counter) * 0x9e3779b97f4a7c15ULL); }
+
+  // streams can be moved to any position without generating the values between
+  uint64_t position() const { return counter; }
+  void seek(uint64_t position) { counter = position; }
+
+  // [0,1) with 53 bits of precision
+  double nextDouble() { return ((*this)() >> 11) * 0x1.0p-53; }
+
+  // [0,range) with no modulo bias (Lemire's multiply and reject), range <= 2^32
+  uint64_t nextBelow(uint64_t range) {
+    uint64_t m = ((*this)() >> 32) * range;
+    if ((m & 0xffffffffULL) < range) {
+      uint64_t threshold = ((1ULL << 32) - range) % range;
+      while ((m & 0xffffffffULL) < threshold) {
+        m = ((*this)() >> 32) * range;
+      }
+    }
+    return m >> 32;
+  }
+};
+
+// the stream used by this thread, if any (see ScopedStream)
+inline StreamGenerator *&getLocalStream() {
+  static thread_local StreamGenerator *local = nullptr;
+  return local;
+}
+
+// While a ScopedStream exists, all of the functions below which are not given
+// a generator will draw from "stream" (on the thread that created the
+// ScopedStream) rather than the common generator. This lets parallel code give
+// each job its own stream without changing the code that draws the numbers.
+class ScopedStream {
+  StreamGenerator *previous;
+
+public:
+  ScopedStream(StreamGenerator &stream) : previous(getLocalStream()) {
+    getLocalStream() = &stream;
+  }
+  ~ScopedStream() { getLocalStream() = previous; }
+  ScopedStream(const ScopedStream &) = delete;
+  ScopedStream &operator=(const ScopedStream &) = delete;
+};
+
+// calls f with this threads stream (if one is set) or the common generator
+template <typename Function> inline auto withGenerator(Function f) {
+  if (getLocalStream() != nullptr) {
+    return f(*getLocalStream());
+  }
+  return f(getCommonGenerator());
+}
+
+// only generators (classes) may be passed as the last argument of the
+// functions below, this keeps i.e. getInt(int, size_t) from matching them.
+template <typename Engine>
+using IfEngine = typename std::enable_if<std::is_class<Engine>::value>::type;
+
 // result = Random::getDouble(7.2, 9.5);
 // result is in [7.2, 9.5)
-inline double getDouble(const double lower, const double upper,
-                        Generator &gen = getCommonGenerator()) {
+template <typename Engine, typename = IfEngine<Engine>>
+inline double getDouble(const double lower, const double upper, Engine &gen) {
   return std::uniform_real_distribution<double>(lower, upper)(gen);
 }
+inline double getDouble(const double lower, const double upper,
+                        StreamGenerator &gen) {
+  return lower + gen.nextDouble() * (upper - lower);
+}
+inline double getDouble(const double lower, const double upper) {
+  return withGenerator([&](auto &gen) { return getDouble(lower, upper, gen); });
+}
 
 // result = Random::getDouble(9.5);
 // result is in [0, 9.5)
-inline double getDouble(const double upper,
-                        Generator &gen = getCommonGenerator()) {
+template <typename Engine, typename = IfEngine<Engine>>
+inline double getDouble(const double upper, Engine &gen) {
   return getDouble(0, upper, gen);
 }
+inline double getDouble(const double upper) { return getDouble(0, upper); }
 
 // result = Random::getInt(7, 9);
 // result is in [7, 9]
-inline int getInt(const int lower, const int upper,
-                  Generator &gen = getCommonGenerator()) {
+template <typename Engine, typename = IfEngine<Engine>>
+inline int getInt(const int lower, const int upper, Engine &gen) {
   return std::uniform_int_distribution<int>(lower, upper)(gen);
 }
+inline int getInt(const int lower, const int upper, StreamGenerator &gen) {
+  return lower + static_cast<int>(gen.nextBelow(
+                     static_cast<uint64_t>(static_cast<int64_t>(upper) - lower) + 1));
+}
+inline int getInt(const int lower, const int upper) {
+  return withGenerator([&](auto &gen) { return getInt(lower, upper, gen); });
+}
 
 // result = Random::getInt(9);
 // result is in [0, 9]
-inline int getInt(const int upper, Generator &gen = getCommonGenerator()) {
+template <typename Engine, typename = IfEngine<Engine>>
+inline int getInt(const int upper, Engine &gen) {
   return getInt(0, upper, gen);
 }
+inline int getInt(const int upper) { return getInt(0, upper); }
 
 // Returns a random valid index of a container which has "container_size"
 // elements.
-inline int getIndex(const int container_size,
-                    Generator &gen = getCommonGenerator()) {
+template <typename Engine, typename = IfEngine<Engine>>
+inline int getIndex(const int container_size, Engine &gen) {
   return getInt(0, container_size - 1, gen);
 }
+inline int getIndex(const int container_size) {
+  return getInt(0, container_size - 1);
+}
 
 // Returns true with "probability" probability
-inline bool P(const double probability, Generator &gen = getCommonGenerator()) {
+template <typename Engine, typename = IfEngine<Engine>>
+inline bool P(const double probability, Engine &gen) {
   return std::bernoulli_distribution(probability)(gen);
 }
+inline bool P(const double probability, StreamGenerator &gen) {
+  return gen.nextDouble() < probability;
+}
+inline bool P(const double probability) {
+  return withGenerator([&](auto &gen) { return P(probability, gen); });
+}
 
 /**
  * (FROM EMPIRICAL)
@@ -83,7 +217,8 @@ inline bool P(const double probability, Generator &gen = getCommonGenerator()) {
  *
  * @param mean The mean of the distribution.
  **/
-inline uint32_t EmpGetRandPoisson(const double mean, Generator &gen = getCommonGenerator()) {
+template <typename Engine, typename = IfEngine<Engine>>
+inline uint32_t EmpGetRandPoisson(const double mean, Engine &gen) {
 	// Draw from a Poisson Dist with mean; if cannot calculate, return UINT_MAX.
 	// Uses Rejection Method
 	const double a = exp(-mean);
@@ -96,17 +231,24 @@ inline uint32_t EmpGetRandPoisson(const double mean, Generator &gen = getCommonG
 	}
 	return k;
 }
+inline uint32_t EmpGetRandPoisson(const double mean) {
+  return withGenerator([&](auto &gen) { return EmpGetRandPoisson(mean, gen); });
+}
 
 /**
  * (FROM EMPIRICAL)
  * Generate a random variable drawn from a Poisson distribution.
  **/
-inline uint32_t EmpGetRandPoisson(const double n, double p, Generator &gen = getCommonGenerator()) {
+template <typename Engine, typename = IfEngine<Engine>>
+inline uint32_t EmpGetRandPoisson(const double n, double p, Engine &gen) {
   //emp_assert(p >= 0.0 && p <= 1.0, p);
   // Optimizes for speed and calculability using symetry of the distribution
   if (p > .5) return (uint32_t)n - EmpGetRandPoisson(n * (1 - p), gen);
   else return EmpGetRandPoisson(n * p, gen);
 }
+inline uint32_t EmpGetRandPoisson(const double n, double p) {
+  return withGenerator([&](auto &gen) { return EmpGetRandPoisson(n, p, gen); });
+}
 
 /**
  * (FROM EMPIRICAL)
@@ -116,14 +258,18 @@ inline uint32_t EmpGetRandPoisson(const double n, double p, Generator &gen = get
  * @see Random::GetApproxRandBinomial
  * @see emp::Binomial in source/tools/Distribution.h
  **/
-inline uint32_t EmpGetFullRandBinomial(const double n, const double p, Generator &gen = getCommonGenerator()) {
+template <typename Engine, typename = IfEngine<Engine>>
+inline uint32_t EmpGetFullRandBinomial(const double n, const double p, Engine &gen) {
   //emp_assert(p >= 0.0 && p <= 1.0, p);
   //emp_assert(n >= 0.0, n);
   // Actually try n Bernoulli events, each with probability p
   uint32_t k = 0;
-  for (uint32_t i = 0; i < n; ++i) if (P(p)) k++;
+  for (uint32_t i = 0; i < n; ++i) if (P(p, gen)) k++;
   return k;
 }
+inline uint32_t EmpGetFullRandBinomial(const double n, const double p) {
+  return withGenerator([&](auto &gen) { return EmpGetFullRandBinomial(n, p, gen); });
+}
 
 /**
  * (FROM EMPIRICAL)
@@ -137,7 +283,8 @@ inline uint32_t EmpGetFullRandBinomial(const double n, const double p, Generator
  * @see Random::GetFullRandBinomial
  * @see emp::Binomial in source/tools/Distribution.h
  **/
-inline uint32_t EmpGetRandBinomial(const int n, const double p, Generator &gen = getCommonGenerator()) {
+template <typename Engine, typename = IfEngine<Engine>>
+inline uint32_t EmpGetRandBinomial(const int n, const double p, Engine &gen) {
   //emp_assert(p >= 0.0 && p <= 1.0, p);
   //emp_assert(n >= 0.0, n);
   // Approximate Binomial if appropriate
@@ -156,20 +303,29 @@ inline uint32_t EmpGetRandBinomial(const int n, const double p, Generator &gen =
   // otherwise, actually generate the randBinomial
   return EmpGetFullRandBinomial(n, p, gen);
 }
+inline uint32_t EmpGetRandBinomial(const int n, const double p) {
+  return withGenerator([&](auto &gen) { return EmpGetRandBinomial(n, p, gen); });
+}
 
 // Returns how many successes you get by doing "tests" number of trials
 // with "probability" of success
-inline int getBinomial(const int tests, const double probability,
-                       Generator &gen = getCommonGenerator()) {
+template <typename Engine, typename = IfEngine<Engine>>
+inline int getBinomial(const int tests, const double probability, Engine &gen) {
   return EmpGetRandBinomial(tests, probability, gen);
   //return std::binomial_distribution<>(tests, probability)(gen);
 }
+inline int getBinomial(const int tests, const double probability) {
+  return withGenerator([&](auto &gen) { return getBinomial(tests, probability, gen); });
+}
 
 // Returns a double drawn from a normal (Gaussian) distribution with mean "mu"
 // and
 // standard deviation "sigma".
-inline double getNormal(const double mu, const double sigma,
-                        Generator &gen = getCommonGenerator()) {
+template <typename Engine, typename = IfEngine<Engine>>
+inline double getNormal(const double mu, const double sigma, Engine &gen) {
   return std::normal_distribution<>(mu, sigma)(gen);
 }
+inline double getNormal(const double mu, const double sigma) {
+  return withGenerator([&](auto &gen) { return getNormal(mu, sigma, gen); });
+}
 }
@@ -40,11 +40,11 @@ void {{MODULE_NAME}}Optimizer::optimize(std::vector<std::shared_ptr<Organism>> &
 
     // kill list is used in clean up (see below) do determine with organaims will be removed from the population
 	killList.clear();
+    // this will kill every organism in the current generation (killList holds
+    // indices into population)
+	killList.insertRange(0, popSize);
 
 	for (size_t i = 0; i < popSize; i++) {
-        // this will kill every organism in the current generation
-		killList.insert(population[i]);
-        
         // calculate the max value for all organisms
 		double opVal = optimizeValueMT->eval(population[i]->dataMap, PT)[0];
         
@@ -61,8 +61,9 @@ void {{MODULE_NAME}}Optimizer::optimize(std::vector<std::shared_ptr<Organism>> &
 
 	for (int i = 0; i < popSize; i++) {
 		auto parent = population[Random::getIndex(popSize)];
-		population.push_back(parent->makeMutatedOffspringFrom(parent));// add to population
+		addOffspring(population, parent);// add to population
 	}
+	finishOffspring(population); // makes offspring now if OPTIMIZER-offspringThreads is not -1
     
     // the population is currently double the size (all old orgs and new orgs)
 
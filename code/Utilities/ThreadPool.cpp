@@ -0,0 +1,87 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(int nrThreads) {
+  if (nrThreads <= 0) {
+    nrThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  }
+  // the calling thread is also a worker, so we only need nrThreads-1 more
+  for (int i = 1; i < nrThreads; i++) {
+    workers.emplace_back(&ThreadPool::workerLoop, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    stopping = true;
+  }
+  jobReady.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+void ThreadPool::runIndexes(const std::function<void(int)> &task, int count) {
+  int index;
+  while ((index = nextIndex.fetch_add(1)) < count) {
+    task(index);
+  }
+}
+
+void ThreadPool::workerLoop() {
+  int lastBatch = 0;
+  while (true) {
+    const std::function<void(int)> *task;
+    int count;
+    {
+      std::unique_lock<std::mutex> lock(poolMutex);
+      jobReady.wait(lock, [&] { return stopping || batchID != lastBatch; });
+      if (stopping) {
+        return;
+      }
+      lastBatch = batchID;
+      task = job;
+      count = jobCount;
+    }
+    runIndexes(*task, count);
+    {
+      std::lock_guard<std::mutex> lock(poolMutex);
+      activeWorkers--;
+    }
+    jobDone.notify_one();
+  }
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)> &task) {
+  if (workers.empty() || count <= 1) { // nothing to share, just do the work
+    for (int i = 0; i < count; i++) {
+      task(i);
+    }
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    job = &task;
+    jobCount = count;
+    nextIndex = 0;
+    activeWorkers = static_cast<int>(workers.size());
+    batchID++;
+  }
+  jobReady.notify_all();
+  runIndexes(task, count);
+  std::unique_lock<std::mutex> lock(poolMutex);
+  jobDone.wait(lock, [&] { return activeWorkers == 0; });
+  job = nullptr;
+}
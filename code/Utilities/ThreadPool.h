@@ -0,0 +1,58 @@
+//  MABE is a product of The Hintze Lab @ MSU
+//     for general research information:
+//         hintzelab.msu.edu
+//     for MABE documentation:
+//         github.com/Hintzelab/MABE/wiki
+//
+//  Copyright (c) 2015 Michigan State University. All rights reserved.
+//     to view the full license, visit:
+//         github.com/Hintzelab/MABE/wiki/License
+
+// A small fixed size pool of worker threads. The pool is used to spread
+// independent jobs (i.e. evaluating each organism in a population) over
+// several cores. Jobs are handed out by index, so a job must only depend on
+// its index (and not on which thread runs it or in what order jobs are run)
+// if results should not depend on the number of threads.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+private:
+  std::vector<std::thread> workers;
+
+  std::mutex poolMutex;
+  std::condition_variable jobReady; // signaled when a new batch is posted
+  std::condition_variable jobDone;  // signaled when a worker leaves a batch
+
+  const std::function<void(int)> *job = nullptr; // batch being worked on
+  int jobCount = 0;                  // number of indexes in current batch
+  std::atomic<int> nextIndex{0};     // next index to hand out
+  int batchID = 0;                   // increments with each new batch
+  int activeWorkers = 0;             // workers still inside current batch
+  bool stopping = false;
+
+  void workerLoop();
+  void runIndexes(const std::function<void(int)> &task, int count);
+
+public:
+  // nrThreads <= 0 will use std::thread::hardware_concurrency()
+  ThreadPool(int nrThreads = 1);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  // number of threads which will run jobs (including the calling thread)
+  int size() const { return static_cast<int>(workers.size()) + 1; }
+
+  // run task(i) for i in [0,count). The calling thread also works on the
+  // batch. Returns after all indexes have been run.
+  void parallelFor(int count, const std::function<void(int)> &task);
+};
@@ -10,6 +10,8 @@
 
 #include "AbstractWorld.h"
 
+#include <Utilities/Random.h>
+
 /*
 #include <math.h>
 
@@ -27,3 +29,46 @@ std::shared_ptr<ParameterLink<std::string>> AbstractWorld::worldTypePL =
         "WORLD-worldType", std::string("This_string_is_set_by_modules.h"),
         "This_string_is_set_by_modules.h");
 ////// WORLD-worldType is actually set by Modules.h //////
+
+std::shared_ptr<ParameterLink<int>> AbstractWorld::threadsPL =
+    Parameters::register_parameter(
+        "WORLD-threads", 1,
+        "number of threads used to evaluate organisms (only used by worlds "
+        "which evaluate organisms one at a time). 0 = use all available cores");
+
+void AbstractWorld::evaluateSolo(std::shared_ptr<Organism> org, int analyze,
+                                 int visualize, int debug) {
+  std::cout << "  In AbstractWorld::evaluateSolo :: this world ("
+            << worldTypePL->get(PT)
+            << ") does not provide evaluateSolo and so can not be used with "
+               "evaluatePopulation.\n  Exiting."
+            << std::endl;
+  exit(1);
+}
+
+void AbstractWorld::evaluatePopulation(
+    std::vector<std::shared_ptr<Organism>> &population, int analyze,
+    int visualize, int debug) {
+  if (evaluationPool == nullptr) {
+    evaluationPool = std::make_shared<ThreadPool>(threadsPL->get(PT));
+  }
+  int popSize = population.size();
+
+  // each organism draws from its own stream (keyed on seed, update and ID) so
+  // that it gets the same random numbers no matter which thread evaluates it.
+  auto evaluateOne = [&](int i) {
+    Random::StreamGenerator orgStream(Random::getStreamSeed(), Global::update,
+                                      population[i]->ID);
+    Random::ScopedStream useOrgStream(orgStream);
+    evaluateSolo(population[i], analyze, visualize, debug);
+  };
+
+  if (visualize || debug) {
+    // visualize and debug output must be written in order
+    for (int i = 0; i < popSize; i++) {
+      evaluateOne(i);
+    }
+  } else {
+    evaluationPool->parallelFor(popSize, evaluateOne);
+  }
+}
@@ -18,11 +18,13 @@
 #include <Utilities/Utilities.h>
 #include <Utilities/Data.h>
 #include <Utilities/Parameters.h>
+#include <Utilities/ThreadPool.h>
 
 class AbstractWorld {
 public:
   static std::shared_ptr<ParameterLink<bool>> debugPL;
   static std::shared_ptr<ParameterLink<std::string>> worldTypePL;
+  static std::shared_ptr<ParameterLink<int>> threadsPL;
 
   const std::shared_ptr<ParametersTable> PT;
 
@@ -43,4 +45,21 @@ public:
 
   virtual void evaluate(std::map<std::string, std::shared_ptr<Group>> &groups,
 	  int analyze = 0, int visualize = 0, int debug = 0) = 0;
+
+  // evaluate a single organism. Worlds which evaluate organisms one at a time
+  // should provide this so they can use evaluatePopulation.
+  // evaluateSolo may be called from more then one thread at a time, so it must
+  // only change the organism it is given (and that organisms dataMap/brains).
+  virtual void evaluateSolo(std::shared_ptr<Organism> org, int analyze,
+                            int visualize, int debug);
+
+  // call evaluateSolo on every organism in population, spreading the work
+  // over WORLD-threads threads. Each organism is given its own random number
+  // stream (see Random::StreamGenerator) so results are the same for any
+  // number of threads.
+  void evaluatePopulation(std::vector<std::shared_ptr<Organism>> &population,
+                          int analyze, int visualize, int debug);
+
+private:
+  std::shared_ptr<ThreadPool> evaluationPool; // created on first use
 };
@@ -914,8 +914,8 @@ BerryWorld::BerryWorld(std::shared_ptr<ParametersTable> PT_)
   moveMin = moveMinPL->get(PT);
   moveMinPerTurn = moveMinPerTurnPL->get(PT);
   snapToGrid = snapToGridPL->get(PT);
-  worldX = worldSizeXPL->get(PT);
-  worldY = worldSizeYPL->get(PT);
+  configWorldX = worldSizeXPL->get(PT);
+  configWorldY = worldSizeYPL->get(PT);
   worldHasWall = worldHasWallPL->get(PT);
   alwaysEat = alwaysEatPL->get(PT);
   allowMoveAndEat = allowMoveAndEatPL->get(PT) || alwaysEat;
@@ -943,12 +943,12 @@ BerryWorld::BerryWorld(std::shared_ptr<ParametersTable> PT_)
   for (auto e : tempList) { // collect foods for this trigger in a std::vector
     std::vector<int> foodsInThisTrigger;
     convertCSVListToVector_BERRY(e, foodsInThisTrigger, '+');
-    triggerFoods.push_back(foodsInThisTrigger);
+    configTriggerFoods.push_back(foodsInThisTrigger);
   }
   convertCSVListToVector_BERRY(triggerFoodLevelsPL->get(PT), tempList);
   for (auto e : tempList) {
     load_value(e, tempValue);
-    triggerFoodLevels.push_back(tempValue);
+    configTriggerFoodLevels.push_back(tempValue);
   }
 
   // get the rules (these may have ','s in them and '[]'s ... am I mad?!
@@ -961,11 +961,11 @@ BerryWorld::BerryWorld(std::shared_ptr<ParametersTable> PT_)
 
   bool inElement = false;
   if (tempString.size() > 0) {
-    triggerFoodEvents.push_back("");
+    configTriggerFoodEvents.push_back("");
   }
   for (auto c : tempString) {
     if (c == ',' && !inElement) {
-      triggerFoodEvents.push_back("");
+      configTriggerFoodEvents.push_back("");
     } else {
       if (c == '[') {
         inElement = true;
@@ -973,14 +973,9 @@ BerryWorld::BerryWorld(std::shared_ptr<ParametersTable> PT_)
       if (c == ']') {
         inElement = false;
       }
-      triggerFoodEvents.back().push_back(c);
+      configTriggerFoodEvents.back().push_back(c);
     }
   } // end get trigger rules
-  // backup triggers from config files. if using random maps we won't need
-  // these, but if useing file maps, these will allow resets
-  configTriggerFoods = triggerFoods;
-  configTriggerFoodLevels = triggerFoodLevels;
-  configTriggerFoodEvents = triggerFoodEvents;
 
   if (cloneScoreRulePL->get(PT) == "ALL") {
     cloneScoreRule = 0;
@@ -1012,6 +1007,14 @@ BerryWorld::BerryWorld(std::shared_ptr<ParametersTable> PT_)
     exit(1);
   }
 
+  // steadyState mode evaluates organisms one at a time (see evaluateSolo)
+  if (Global::modePL->get() == "steadyState" && evaluateGroupSizePL->get(PT) != 1) {
+    std::cout << "    In Berry world, steadyState mode evaluates each organism "
+                 "alone, so WORLD_BERRY_GROUP-groupSize must be 1 (it is "
+              << evaluateGroupSizePL->get(PT) << ").\n    exiting." << std::endl;
+    exit(1);
+  }
+
   ////////////////////////////////////////////////////////
   // setup food and poison ///////////////////////////////
   ////////////////////////////////////////////////////////
@@ -1250,6 +1253,7 @@ BerryWorld::BerryWorld(std::shared_ptr<ParametersTable> PT_)
   if (mapFiles[0] != "NONE") {
     std::cout << "Berry World loading maps..." << std::endl;
     for (auto mapFile : mapFiles) {
+      mapNames[mapFile]; // every file has a list (runWorld only reads them)
       std::ifstream FILE(mapFile);
       if (!FILE.is_open()) {
         std::cout << "  failed to open file: " << mapFile << "\n  exiting."
@@ -1445,8 +1449,6 @@ BerryWorld::BerryWorld(std::shared_ptr<ParametersTable> PT_)
     exit(1);
   }
 
-  foodCounts.resize(10, 0); // this will hold counts on map
-
   if (!alwaysEat) {
     requiredOutputs += 1; // brain needs extra output for eat
   }
@@ -1495,8 +1497,20 @@ void BerryWorld::evaluate(std::map<std::string, std::shared_ptr<Group>> &groups,
   }
 }
 
+void BerryWorld::evaluateSolo(std::shared_ptr<Organism> org, int analyse,
+                              int visualize, int debug) {
+  // evaluate org as the only member of a population (with groupSize 1, this
+  // is just what evaluate does for each organism)
+  std::map<std::string, std::shared_ptr<Group>> soloGroups;
+  soloGroups[groupNameSpacePL->get(PT)] = std::make_shared<Group>();
+  soloGroups[groupNameSpacePL->get(PT)]->population.push_back(org);
+  for (int i = 0; i < evaluationsPerGenerationPL->get(PT); i++) {
+    runWorld(soloGroups, analyse, visualize, debug);
+  }
+}
+
 void BerryWorld::runWorld(std::map<std::string, std::shared_ptr<Group>> &groups,
-                          int analyse, int visualize, int debug) {
+                          int analyse, int visualize, int debug) const {
   auto tempPopulation =
       groups[groupNameSpacePL->get(PT)]->population; // make a copy of the
                                                      // population so we can
@@ -1590,6 +1604,21 @@ void BerryWorld::runWorld(std::map<std::string, std::shared_ptr<Group>> &groups,
   auto alwaysStartOn = alwaysStartOnPL->get(PT);
 
   Vector2d<int> foodMap; // what food is here?
+  int worldX = configWorldX;
+  int worldY = configWorldY;
+  std::vector<int> foodCounts; // how much of each food is on the map?
+
+  std::vector<WorldMap::ResourceGenerator>
+      generators; // index will act as lookup key in generator events
+  std::map<int, std::vector<int>> generatorEvents; // each vector<int> holds
+                                                   // indexes for generators to
+                                                   // run when world update (t)
+                                                   // = key.
+
+  // triggers from the config file and this map
+  std::vector<std::vector<int>> triggerFoods = configTriggerFoods;
+  std::vector<int> triggerFoodLevels = configTriggerFoodLevels;
+  std::vector<std::string> triggerFoodEvents = configTriggerFoodEvents;
 
   std::vector<Point2d> validSpaces;
   std::vector<int> startFacing;
@@ -1641,7 +1670,7 @@ void BerryWorld::runWorld(std::map<std::string, std::shared_ptr<Group>> &groups,
       for (auto FILENAME : FILENAMES) {
         if (whichMaps[i + 1] ==
             "*") { // if the map name is * then include all maps from FILENAME
-          for (auto mapName : mapNames[FILENAME]) {
+          for (auto mapName : mapNames.at(FILENAME)) {
             whichMapsActual.push_back(FILENAME);
             whichMapsActual.push_back(mapName);
           }
@@ -1650,7 +1679,7 @@ void BerryWorld::runWorld(std::map<std::string, std::shared_ptr<Group>> &groups,
                                                    // maps from FILENAME
           int numPicks;
           load_value(whichMaps[i + 1], numPicks);
-          int avalibleMaps = mapNames[FILENAME].size();
+          int avalibleMaps = mapNames.at(FILENAME).size();
           if (numPicks > avalibleMaps) {
             std::cout << "  In Berry world, while selecting maps from file "
                       << FILENAME << " number of maps requested is > number of "
@@ -1661,11 +1690,11 @@ void BerryWorld::runWorld(std::map<std::string, std::shared_ptr<Group>> &groups,
           auto picks = pickUnique(avalibleMaps, numPicks);
           for (auto pick : picks) {
             whichMapsActual.push_back(FILENAME);
-            whichMapsActual.push_back(mapNames[FILENAME][pick]);
+            whichMapsActual.push_back(mapNames.at(FILENAME)[pick]);
           }
-        } else if (find(mapNames[FILENAME].begin(), mapNames[FILENAME].end(),
+        } else if (find(mapNames.at(FILENAME).begin(), mapNames.at(FILENAME).end(),
                         whichMaps[i + 1]) !=
-                   mapNames[FILENAME].end()) { // If the map name is a name, and
+                   mapNames.at(FILENAME).end()) { // If the map name is a name, and
                                                // that name is in FILENAME,
                                                // include that
           whichMapsActual.push_back(FILENAME);
@@ -1683,7 +1712,6 @@ void BerryWorld::runWorld(std::map<std::string, std::shared_ptr<Group>> &groups,
     whichMapsActual = {"NONE", "NONE"};
   }
 
-  generators.clear();
   std::vector<WorldMap::ResourceGenerator> savedGenerators;
 
   // for each map in whichMapsActual, run evaluation (if NONE, make a random
@@ -1695,43 +1723,27 @@ void BerryWorld::runWorld(std::map<std::string, std::shared_ptr<Group>> &groups,
                 << whichMapsActual[whichMapIndex + 1] << std::endl;
     }
     if (whichMapsActual[0] != "NONE") {
-      worldX = worldMaps[whichMapsActual[whichMapIndex]]
-                        [whichMapsActual[whichMapIndex + 1]]
-                            .worldX;
-      worldY = worldMaps[whichMapsActual[whichMapIndex]]
-                        [whichMapsActual[whichMapIndex + 1]]
-                            .worldY;
-      foodMap = worldMaps[whichMapsActual[whichMapIndex]]
-                         [whichMapsActual[whichMapIndex + 1]]
-                             .data;
-      validSpaces = worldMaps[whichMapsActual[whichMapIndex]]
-                             [whichMapsActual[whichMapIndex + 1]]
-                                 .startLocations;
-      startFacing = worldMaps[whichMapsActual[whichMapIndex]]
-                             [whichMapsActual[whichMapIndex + 1]]
-                                 .startFacing;
-      generators = worldMaps[whichMapsActual[whichMapIndex]]
-                            [whichMapsActual[whichMapIndex + 1]]
-                                .generators;
+      const WorldMap &worldMap = worldMaps.at(whichMapsActual[whichMapIndex])
+                                     .at(whichMapsActual[whichMapIndex + 1]);
+      worldX = worldMap.worldX;
+      worldY = worldMap.worldY;
+      foodMap = worldMap.data;
+      validSpaces = worldMap.startLocations;
+      startFacing = worldMap.startFacing;
+      generators = worldMap.generators;
       savedGenerators = generators;
 
       // combine trigger info from comfig file with map trigger info
       triggerFoods = configTriggerFoods;
       triggerFoodLevels = configTriggerFoodLevels;
       triggerFoodEvents = configTriggerFoodEvents;
-      for (auto triggerFood : worldMaps[whichMapsActual[whichMapIndex]]
-                                       [whichMapsActual[whichMapIndex + 1]]
-                                           .triggerFoods) {
+      for (auto triggerFood : worldMap.triggerFoods) {
         triggerFoods.push_back(triggerFood);
       }
-      for (auto triggerFoodLevel : worldMaps[whichMapsActual[whichMapIndex]]
-                                            [whichMapsActual[whichMapIndex + 1]]
-                                                .triggerFoodLevels) {
+      for (auto triggerFoodLevel : worldMap.triggerFoodLevels) {
         triggerFoodLevels.push_back(triggerFoodLevel);
       }
-      for (auto triggerFoodEvent : worldMaps[whichMapsActual[whichMapIndex]]
-                                            [whichMapsActual[whichMapIndex + 1]]
-                                                .triggerFoodEvents) {
+      for (auto triggerFoodEvent : worldMap.triggerFoodEvents) {
         triggerFoodEvents.push_back(triggerFoodEvent);
       }
     } else { // no whichMaps were provided... generate an uninitalize map.
@@ -2248,7 +2260,7 @@ void BerryWorld::runWorld(std::map<std::string, std::shared_ptr<Group>> &groups,
             }
 
             // convert move output to an action
-            moveOutput = actionLookup[moveOutput];
+            moveOutput = actionLookup.at(moveOutput);
 
             ////////////////////////
             // update world --- food
@@ -2366,7 +2378,7 @@ void BerryWorld::runWorld(std::map<std::string, std::shared_ptr<Group>> &groups,
                   (int)currentLoc.x,
                   (int)currentLoc.y); // which grid space is this?
               auto targetLoc =
-                  moveOnGrid(harvester, moveDistance,
+                  moveOnGrid(harvester, moveDistance, worldX, worldY,
                              moveOffset); // where are we going (if we move)?
               Point2d targetSpace(
                   (int)targetLoc.x,
@@ -2988,7 +3000,7 @@ BerryWorld::requiredGroups() {
 }
 
 Point2d BerryWorld::moveOnGrid(std::shared_ptr<Harvester> harvester, double distance,
-                   int offset) {
+                               int worldX, int worldY, int offset) const {
   Point2d newLoc;
   // cout << "deltas: " << moveDeltas[harvester->face].x << "," <<
   // moveDeltas[harvester->face].y << endl;
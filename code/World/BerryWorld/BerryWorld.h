@@ -255,13 +255,6 @@ public:
     bool loadMap(std::ifstream &ss, const std::string fileName);
   };
 
-  std::vector<WorldMap::ResourceGenerator>
-      generators; // index will act as lookup key in generator events
-  std::map<int, std::vector<int>> generatorEvents; // each vector<int> holds
-                                                   // indexes for generators to
-                                                   // run when world update (t)
-                                                   // = key.
-
   enum mapValues { EMPTY = 0, WALL = 9 };
 
   class Harvester {
@@ -318,8 +311,8 @@ public:
   std::vector<std::vector<int>> replaceRules;
   std::vector<double> poisonRules;
 
-  int worldX;
-  int worldY;
+  int configWorldX; // size of generated maps (maps from files have their own)
+  int configWorldY;
   bool worldHasWall;
 
   double moveDefault;
@@ -348,30 +341,32 @@ public:
 
   std::vector<std::vector<std::vector<Point2d>>> perfectSensorSites;
 
-  std::vector<int> foodCounts;
-
-  std::vector<std::vector<int>> triggerFoods; // = { 1,1,3 };
-  std::vector<int> triggerFoodLevels;         // = { 10,0,0 };
+  // triggers from config files (maps from files may add more)
+  std::vector<std::vector<int>> configTriggerFoods; // = { 1,1,3 };
+  std::vector<int> configTriggerFoodLevels;         // = { 10,0,0 };
   std::vector<std::string>
-      triggerFoodEvents; // = { "R[2,3]","T*10+Q","G[1,1,2,0,0,2]" };
-  // backup triggers from config files
-  std::vector<std::vector<int>> configTriggerFoods;
-  std::vector<int> configTriggerFoodLevels;
-  std::vector<std::string> configTriggerFoodEvents;
+      configTriggerFoodEvents; // = { "R[2,3]","T*10+Q","G[1,1,2,0,0,2]" };
 
   BerryWorld(std::shared_ptr<ParametersTable> PT_);
   virtual ~BerryWorld() = default;
 
   virtual void evaluate(std::map<std::string, std::shared_ptr<Group>> &groups,
                         int analyse, int visualize, int debug) override;
+  // (steadyState mode, only with groupSize 1) may be called from many threads
+  // at once
+  virtual void evaluateSolo(std::shared_ptr<Organism> org, int analyse,
+                            int visualize, int debug) override;
+  // const: everything which changes during an evaluation (maps, food counts,
+  // generators and triggers) is local to runWorld
   void runWorld(std::map<std::string, std::shared_ptr<Group>> &groups,
-                int analyse, int visualize, int debug);
+                int analyse, int visualize, int debug) const;
 
   virtual std::unordered_map<std::string, std::unordered_set<std::string>>
   requiredGroups() override;
 
-  // takes x,y and updates them by moving one step in facing
+  // takes x,y and updates them by moving one step in facing (on a worldX by
+  // worldY map)
   Point2d moveOnGrid(std::shared_ptr<Harvester> harvester, double distance,
-                     int offset = 0);
+                     int worldX, int worldY, int offset = 0) const;
 };
 
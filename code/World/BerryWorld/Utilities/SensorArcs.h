@@ -869,8 +869,9 @@ public:
 		}
 	}
 
-	void senseTotals(Vector2d<int>& worldgrid, int& orgx, int& orgy, int& orgf, std::vector<int>& values, int blocker = -1, bool wrap = false) {
+	void senseTotals(Vector2d<int>& worldgrid, int& orgx, int& orgy, int& orgf, std::vector<int>& values, int blocker = -1, bool wrap = false) const {
 
+		const auto &arc = this->angles.at(orgf);
 		bool blocked = false;
 		int currentIndex = 0;
 
@@ -884,8 +885,8 @@ public:
 			while (currentIndex != -1) {
 				//std::cout << currentIndex << "  :  " << this->angles[orgf]->locationsTree[currentIndex].locationID << "  :  " << this->angles[orgf]->cX(currentIndex) << "," << this->angles[orgf]->cY(currentIndex) << "  "
 				//<< this->angles[orgf]->cX(currentIndex) + orgx << "," << this->angles[orgf]->cY(currentIndex) + orgy << "  <>  " << worldgrid(this->angles[orgf]->cX(currentIndex) + orgx, this->angles[orgf]->cY(currentIndex) + orgy) << endl;
-				currentX = loopMod(this->angles[orgf]->cX(currentIndex) + orgx, worldgrid.x());
-				currentY = loopMod(this->angles[orgf]->cY(currentIndex) + orgy, worldgrid.y());
+				currentX = loopMod(arc->cX(currentIndex) + orgx, worldgrid.x());
+				currentY = loopMod(arc->cY(currentIndex) + orgy, worldgrid.y());
 				blocked = worldgrid(currentX, currentY) == blocker;
 				//if (!this->angles[orgf]->isBlockingOnly(currentIndex)) {
 				values[worldgrid(currentX, currentY)]++;
@@ -893,7 +894,7 @@ public:
 				//std::cout << " isBlockingOnly" << endl;
 				//}
 				//std::cout << blocker << "    " << ((blocked) ? "blocked" : "open") << endl;
-				currentIndex = this->angles[orgf]->advanceIndex(currentIndex, blocked);
+				currentIndex = arc->advanceIndex(currentIndex, blocked);
 				//std::cout << " nextIndex: " << currentIndex << endl;
 			}
 		}
@@ -901,8 +902,8 @@ public:
 			while (currentIndex != -1) {
 				//std::cout << currentIndex << "  :  " << this->angles[orgf]->locationsTree[currentIndex].locationID << "  :  " << this->angles[orgf]->cX(currentIndex) << "," << this->angles[orgf]->cY(currentIndex) << "  "
 				//<< this->angles[orgf]->cX(currentIndex) + orgx << "," << this->angles[orgf]->cY(currentIndex) + orgy << "  <>  " << worldgrid(this->angles[orgf]->cX(currentIndex) + orgx, this->angles[orgf]->cY(currentIndex) + orgy) << endl;
-				currentX = this->angles[orgf]->cX(currentIndex) + orgx, worldgrid.x();
-				currentY = this->angles[orgf]->cY(currentIndex) + orgy, worldgrid.y();
+				currentX = arc->cX(currentIndex) + orgx, worldgrid.x();
+				currentY = arc->cY(currentIndex) + orgy, worldgrid.y();
 				blocked = worldgrid(currentX, currentY) == blocker;
 				//if (!this->angles[orgf]->isBlockingOnly(currentIndex)) {
 				values[worldgrid(currentX, currentY)]++;
@@ -910,7 +911,7 @@ public:
 				//std::cout << " isBlockingOnly" << endl;
 				//}
 				//std::cout << blocker << "    " << ((blocked) ? "blocked" : "open") << endl;
-				currentIndex = this->angles[orgf]->advanceIndex(currentIndex, blocked);
+				currentIndex = arc->advanceIndex(currentIndex, blocked);
 				//std::cout << " nextIndex: " << currentIndex << endl;
 			}
 		}
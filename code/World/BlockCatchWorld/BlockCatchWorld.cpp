@@ -419,11 +419,13 @@ void BlockCatchWorld::evaluateSolo(std::shared_ptr<Organism> org, int analyse, i
 		int directionCounter = 0;
 
 		// determine number of tests for this pattern if patternStartPosiont is ALL_CLEAR
+		// (kept local, evaluateSolo may be running on more then one thread)
+		int patternRepeats = repeats;
 		if (patternStartPositions == 1){
-			repeats = (worldXMax - (patternSizes[patternIndex] + paddleWidth)) + 1;
+			patternRepeats = (worldXMax - (patternSizes[patternIndex] + paddleWidth)) + 1;
 		}
 		
-		for (int repeat = 0; repeat < repeats; repeat++) {
+		for (int repeat = 0; repeat < patternRepeats; repeat++) {
 
 			//get worldX and start height for pattern;
 			int worldX = Random::getInt(worldXMin, worldXMax);
@@ -655,10 +657,7 @@ void BlockCatchWorld::evaluateSolo(std::shared_ptr<Organism> org, int analyse, i
 }
 
 void BlockCatchWorld::evaluate(std::map<std::string, std::shared_ptr<Group>>& groups, int analyse, int visualize, int debug) {
-	int popSize = groups[groupName]->population.size();
-	for (int i = 0; i < popSize; i++) {
-		evaluateSolo(groups[groupName]->population[i], analyse, visualize, debug);
-	}
+	evaluatePopulation(groups[groupName]->population, analyse, visualize, debug);
 
 	if (visualizeBest > 0 && Global::update % visualizeBest == 0 && Global::update > 0) {
 		// get best org (org with best score)
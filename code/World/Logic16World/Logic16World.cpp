@@ -55,6 +55,10 @@ std::shared_ptr<ParameterLink<std::string>> Logic16World::logicShuffleMethodPL =
 std::shared_ptr<ParameterLink<bool>> Logic16World::normalizeScorePL = Parameters::register_parameter("WORLD_LOGIC16-normalizeScore",
 	true, "if true, scores will be normalized between 0 and 1. if false, every correct output will add 1 to score - each test logic will add up to 4.");
 
+std::shared_ptr<ParameterLink<bool>> Logic16World::batchBrainsPL = Parameters::register_parameter("WORLD_LOGIC16-batchBrains",
+	false, "if true, all brains are updated together in batches (faster for brains that support it, i.e. deterministic Markov brains).\n"
+	"This runs on one thread, and brains that use random numbers will not get the same numbers as when false.");
+
 Logic16World::Logic16World(std::shared_ptr<ParametersTable> PT_) : AbstractWorld(PT_) {
 
 	groupName = groupNamePL->get(PT);
@@ -79,6 +83,7 @@ Logic16World::Logic16World(std::shared_ptr<ParametersTable> PT_) : AbstractWorld
 	evaluationsPerGeneration = evaluationsPerGenerationPL->get(PT);
 
 	normalizeScore = normalizeScorePL->get(PT);
+	batchBrains = batchBrainsPL->get(PT);
 
 	logicShuffleTime = logicShuffleTimePL->get(PT);
 	if (logicShuffleMethodPL->get(PT) == "NONE") {
@@ -155,9 +160,56 @@ void Logic16World::evaluate(std::map<std::string, std::shared_ptr<Group>> &group
 		} // else do nothing, we already checked for bad shuffle type in constructor
 	}
 
-	int popSize = groups[groupName]->population.size();
-	for (int i = 0; i < popSize; i++) {
-		evaluateSolo(groups[groupName]->population[i], analyze, visualize, debug);
+	if (batchBrains && !visualize && !debug) {
+		evaluateBatch(groups[groupName]->population);
+	}
+	else {
+		evaluatePopulation(groups[groupName]->population, analyze, visualize, debug);
+	}
+}
+
+void Logic16World::evaluateBatch(std::vector<std::shared_ptr<Organism>> &population) {
+	if (population.empty()) {
+		return;
+	}
+	std::vector<std::shared_ptr<AbstractBrain>> brains;
+	for (auto &org : population) {
+		brains.push_back(org->brains[brainName]);
+	}
+
+	std::vector<std::vector<double>> logicScores(population.size(), std::vector<double>(16));
+
+	for (int repeats = evaluationsPerGeneration; repeats > 0; --repeats) {
+		for (auto &brain : brains) {
+			brain->resetBrain();
+		}
+		for (int InputIndex = 0; InputIndex < 4; InputIndex++) {
+			bool in0 = questions[InputIndex][0];
+			bool in1 = questions[InputIndex][1];
+
+			for (auto &brain : brains) {
+				if (resetBrainBetweenInputs) {
+					brain->resetBrain();
+				}
+				brain->setInput(0, in0);
+				brain->setInput(1, in1);
+			}
+
+			for (int i = 0; i < brainUpdates; i++) { // update all brains one or more times
+				brains[0]->updateBatch(brains);
+			}
+
+			for (size_t o = 0; o < brains.size(); o++) {
+				int outputCount = 0;
+				for (auto logic : testLogic) {
+					logicScores[o][logic] += (double)(logic_tables[logic][in0][in1] == Bit(brains[o]->readOutput(outputCount++)));
+				}
+			}
+		}
+	}
+
+	for (size_t o = 0; o < population.size(); o++) {
+		saveScores(population[o], logicScores[o]);
 	}
 }
 
@@ -195,6 +247,10 @@ void Logic16World::evaluateSolo(std::shared_ptr<Organism> org, int analyze, int
 		}
 	}
 
+	saveScores(org, logicScores);
+}
+
+void Logic16World::saveScores(std::shared_ptr<Organism> org, std::vector<double> &logicScores) {
 	double score = 0;
 	for (auto logic : testLogicUsed) {
 		// collect scores
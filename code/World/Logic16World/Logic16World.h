@@ -30,8 +30,10 @@ public:
 	static std::shared_ptr<ParameterLink<std::string>> logicShuffleMethodPL;
 
 	static std::shared_ptr<ParameterLink<bool>> normalizeScorePL;
+	static std::shared_ptr<ParameterLink<bool>> batchBrainsPL;
 
 	bool normalizeScore;
+	bool batchBrains;
 
 	int logicShuffleTime;
 	int logicShuffleMethod;
@@ -79,7 +81,11 @@ public:
 	virtual ~Logic16World() = default;
 
 	virtual void evaluate(std::map<std::string, std::shared_ptr<Group>> &groups, int analyze, int visualize, int debug);
-	void evaluateSolo(std::shared_ptr<Organism> org, int analyze, int visualize, int debug);
+	void evaluateSolo(std::shared_ptr<Organism> org, int analyze, int visualize, int debug) override;
+	// evaluate every organism in lockstep with AbstractBrain::updateBatch
+	void evaluateBatch(std::vector<std::shared_ptr<Organism>> &population);
+	// save scores (indexed by logic) to org's dataMap
+	void saveScores(std::shared_ptr<Organism> org, std::vector<double> &logicScores);
 
 	virtual std::unordered_map<std::string, std::unordered_set<std::string>>
 		requiredGroups() override;
@@ -12,6 +12,7 @@
 #include <module_factories.h>
 #include <Global.h>
 #include <Group/Group.h>
+#include <Group/SteadyState.h>
 #include <Organism/Organism.h>
 #include <Utilities/Utilities.h>
 #include <Utilities/Data.h>
@@ -120,6 +121,10 @@ int main(int argc, const char *argv[]) {
     exit(1);
   }
   FileManager::outputPrefix = output_prefix;
+  FileManager::setBufferedOutput(Global::bufferedOutputPL->get(),
+                                 std::max(1, Global::outputBufferSizePL->get()) * 1024);
+  FileManager::setColumnarOutput(Global::columnarCompressionPL->get(),
+                                 std::max(1, Global::columnarRowGroupSizePL->get()));
 
   // set up random number generator
   if (Global::randomSeedPL->get() == -1) {
@@ -133,9 +138,11 @@ int main(int argc, const char *argv[]) {
     int temp = rd();
 #endif
     Random::getCommonGenerator().seed(temp);
+    Random::getStreamSeed() = temp;
     std::cout << "Generating Random Seed\n  " << temp << "\n";
   } else {
     Random::getCommonGenerator().seed(Global::randomSeedPL->get());
+    Random::getStreamSeed() = Global::randomSeedPL->get();
     std::cout << "Using Random Seed: " << Global::randomSeedPL->get() << "\n";
   }
 
@@ -182,6 +189,21 @@ int main(int argc, const char *argv[]) {
       Global::update++; // advance time to create new population(s)
     }
 
+    // the run is finished... flush any data that has not been output yet
+    for (auto const &group : groups) {
+      group.second->archive(1);
+    }
+  } else if (Global::modePL->get() == "steadyState") {
+    ////////////////////////////////////////////////////////////////////////////////////
+    // steady state mode - evolution without generations
+    ////////////////////////////////////////////////////////////////////////////////////
+    std::cout << "\n  You are running MABE in steadyState mode."
+              << "\n"
+              << "\n";
+
+    SteadyState steadyState(world, groups);
+    steadyState.run(groups, userExitFlag);
+
     // the run is finished... flush any data that has not been output yet
     for (auto const &group : groups) {
       group.second->archive(1);
@@ -449,9 +471,13 @@ constructAllGroupsFrom(const std::shared_ptr<AbstractWorld> &world,
     popFileColumns.push_back("update");
     popFileColumns.insert(popFileColumns.end(), world->popFileColumns.begin(),
                           world->popFileColumns.end());
-    popFileColumns.insert(popFileColumns.end(),
-                          optimizer->popFileColumns.begin(),
-                          optimizer->popFileColumns.end());
+    // in steadyState mode the optimizer is not run (so none of its columns
+    // are set), SteadyState sets its own
+    auto const &optimizerColumns = Global::modePL->get() == "steadyState"
+                                       ? SteadyState::popFileColumns
+                                       : optimizer->popFileColumns;
+    popFileColumns.insert(popFileColumns.end(), optimizerColumns.begin(),
+                          optimizerColumns.end());
     for (auto const &genome : progenitor->genomes) {
       for (auto const &c : genome.second->popFileColumns) {
         (genome.first == "root::") ? popFileColumns.push_back(c)